@@ -78,6 +78,34 @@ else()
   message(STATUS "Building WITHOUT libtiff")
 endif()
 
+##################################################################
+# libpng
+##################################################################
+if (BUILD_LIBPNG)
+  find_package(PNG REQUIRED)
+  include_directories(${PNG_INCLUDE_DIRS})
+  message("Using libpng at ${PNG_LIBRARY}")
+  list(APPEND DALI_LIBS ${PNG_LIBRARIES})
+else()
+  message(STATUS "Building WITHOUT libpng, PNG images will be decoded with OpenCV")
+endif()
+
+##################################################################
+# libwebp
+##################################################################
+if (BUILD_LIBWEBP)
+  find_path(WEBP_INCLUDE_DIR NAMES webp/decode.h)
+  find_library(WEBP_LIBRARY NAMES webp)
+  if (NOT WEBP_INCLUDE_DIR OR NOT WEBP_LIBRARY)
+    message(FATAL_ERROR "libwebp not found. Use -DBUILD_LIBWEBP=OFF to build without it")
+  endif()
+  include_directories(${WEBP_INCLUDE_DIR})
+  message("Using libwebp at ${WEBP_LIBRARY}")
+  list(APPEND DALI_LIBS ${WEBP_LIBRARY})
+else()
+  message(STATUS "Building WITHOUT libwebp")
+endif()
+
 ##################################################################
 # PyBind
 ##################################################################
@@ -0,0 +1,173 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <benchmark/benchmark.h>
+#include <cmath>
+#include <memory>
+#include <random>
+#include <utility>
+#include <vector>
+
+#include "dali/benchmark/dali_bench.h"
+#include "dali/pipeline/operators/detection/box_encoder.h"
+#include "dali/pipeline/util/bounding_box.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Default boxes of SSD300 - 8732 anchors in ltrb format
+ */
+std::vector<float> SSDAnchors() {
+  const int fmap[] = { 38, 19, 10, 5, 3, 1 };
+  const int boxes_per_cell[] = { 4, 6, 6, 6, 4, 4 };
+  const float scales[] = { 0.07f, 0.15f, 0.33f, 0.51f, 0.69f, 0.87f, 1.05f };
+  std::vector<float> anchors;
+  auto add = [&](float cx, float cy, float w, float h) {
+    anchors.push_back(std::max(cx - w / 2, 0.0f));
+    anchors.push_back(std::max(cy - h / 2, 0.0f));
+    anchors.push_back(std::min(cx + w / 2, 1.0f));
+    anchors.push_back(std::min(cy + h / 2, 1.0f));
+  };
+  for (int l = 0; l < 6; l++) {
+    float s = scales[l], s2 = std::sqrt(scales[l] * scales[l + 1]);
+    for (int y = 0; y < fmap[l]; y++) {
+      for (int x = 0; x < fmap[l]; x++) {
+        float cx = (x + 0.5f) / fmap[l], cy = (y + 0.5f) / fmap[l];
+        add(cx, cy, s, s);
+        add(cx, cy, s2, s2);
+        for (int r = 2; r < boxes_per_cell[l]; r += 2) {
+          float ar = std::sqrt(static_cast<float>(r));
+          add(cx, cy, s * ar, s / ar);
+          add(cx, cy, s / ar, s * ar);
+        }
+      }
+    }
+  }
+  return anchors;
+}
+
+std::vector<float> RandomBoxes(int n) {
+  std::mt19937 rng(42);
+  std::uniform_real_distribution<float> dist(0, 1);
+  std::vector<float> boxes;
+  for (int i = 0; i < n; i++) {
+    float x0 = dist(rng), x1 = dist(rng), y0 = dist(rng), y1 = dist(rng);
+    boxes.insert(boxes.end(), { std::min(x0, x1), std::min(y0, y1),
+                                std::max(x0, x1), std::max(y0, y1) });
+  }
+  return boxes;
+}
+
+std::vector<BoundingBox> ToBoxes(const std::vector<float> &ltrb) {
+  std::vector<BoundingBox> boxes;
+  for (size_t i = 0; i < ltrb.size(); i += BoundingBox::kSize)
+    boxes.push_back(BoundingBox::FromLtrb(&ltrb[i], BoundingBox::NoBounds()));
+  return boxes;
+}
+
+/**
+ * @brief The matching as implemented before the vectorized version: full IoU matrix
+ *        in array-of-structures layout, searched column-wise for each anchor.
+ */
+std::vector<std::pair<unsigned, unsigned>> LegacyMatch(const std::vector<BoundingBox> &boxes,
+                                                       const std::vector<BoundingBox> &anchors,
+                                                       float criteria) {
+  const size_t num_anchors = anchors.size();
+  std::vector<float> ious(boxes.size() * num_anchors);
+  for (size_t b = 0; b < boxes.size(); b++) {
+    float *row = &ious[b * num_anchors];
+    unsigned best_idx = 0;
+    for (size_t a = 0; a < num_anchors; a++) {
+      row[a] = boxes[b].IntersectionOverUnion(anchors[a]);
+      if (row[a] >= row[best_idx])
+        best_idx = a;
+    }
+    row[best_idx] = 2.;
+  }
+  std::vector<std::pair<unsigned, unsigned>> matches;
+  for (size_t a = 0; a < num_anchors; a++) {
+    unsigned best_idx = 0;
+    for (size_t b = 1; b < boxes.size(); b++) {
+      if (ious[b * num_anchors + a] >= ious[best_idx * num_anchors + a])
+        best_idx = b;
+    }
+    if (ious[best_idx * num_anchors + a] > criteria)
+      matches.push_back({best_idx, a});
+  }
+  return matches;
+}
+
+}  // namespace
+
+BENCHMARK_DEFINE_F(DALIBenchmark, BoxEncoderLegacyMatching)(benchmark::State& st) {
+  auto anchors = ToBoxes(SSDAnchors());
+  auto boxes = ToBoxes(RandomBoxes(st.range(0)));
+  for (auto _ : st) {
+    auto matches = LegacyMatch(boxes, anchors, 0.5f);
+    benchmark::DoNotOptimize(matches.data());
+  }
+}
+
+BENCHMARK_REGISTER_F(DALIBenchmark, BoxEncoderLegacyMatching)
+->Arg(10)->Arg(50)->Arg(100)
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+BENCHMARK_DEFINE_F(DALIBenchmark, BoxEncoderCPU)(benchmark::State& st) {
+  const int num_boxes = st.range(0);
+  const int batch_size = 1;
+  auto op_ptr = InstantiateOperator(OpSpec("BoxEncoder")
+                                      .AddArg("device", "cpu")
+                                      .AddArg("batch_size", batch_size)
+                                      .AddArg("num_threads", 1)
+                                      .AddArg("anchors", SSDAnchors())
+                                      .AddArg("criteria", 0.5f)
+                                      .AddInput("bboxes", "cpu")
+                                      .AddInput("labels", "cpu")
+                                      .AddOutput("encoded_bboxes", "cpu")
+                                      .AddOutput("encoded_labels", "cpu"));
+
+  auto boxes = std::make_shared<TensorVector<CPUBackend>>(batch_size);
+  auto labels = std::make_shared<TensorVector<CPUBackend>>(batch_size);
+  auto box_data = RandomBoxes(num_boxes);
+  (*boxes)[0].set_type(TypeInfo::Create<float>());
+  (*boxes)[0].Resize({num_boxes, static_cast<int>(BoundingBox::kSize)});
+  std::copy(box_data.begin(), box_data.end(), (*boxes)[0].mutable_data<float>());
+  (*labels)[0].set_type(TypeInfo::Create<int>());
+  (*labels)[0].Resize({num_boxes});
+  auto *label_data = (*labels)[0].mutable_data<int>();
+  for (int i = 0; i < num_boxes; i++)
+    label_data[i] = i + 1;
+
+  ThreadPool tp(1, 0, false);
+  HostWorkspace ws;
+  ws.AddInput(boxes);
+  ws.AddInput(labels);
+  ws.AddOutput(std::make_shared<TensorVector<CPUBackend>>(batch_size));
+  ws.AddOutput(std::make_shared<TensorVector<CPUBackend>>(batch_size));
+  ws.SetThreadPool(&tp);
+
+  for (auto _ : st) {
+    op_ptr->Run(ws);
+  }
+}
+
+BENCHMARK_REGISTER_F(DALIBenchmark, BoxEncoderCPU)
+->Arg(10)->Arg(50)->Arg(100)
+->Unit(benchmark::kMicrosecond)
+->UseRealTime();
+
+}  // namespace dali
@@ -18,6 +18,7 @@
 #include "dali/pipeline/pipeline.h"
 #include "dali/util/image.h"
 #include "dali/pipeline/operators/displacement/displacement_filter_impl_cpu.h"
+#include "dali/pipeline/operators/displacement/jitter.h"
 #include "dali/pipeline/operators/displacement/rotate.h"
 #include "dali/pipeline/operators/displacement/sphere.h"
 #include "dali/pipeline/operators/displacement/water.h"
@@ -139,5 +140,7 @@ std::vector<float> affine_mat = { 1.0f, 0.8f, 0.0f, 0.0f, 1.2f, 0.0f };
 DALI_BENCHMARK_DISPLACEMENT_CASE(WarpAffine<CPUBackend>,
                                  OpSpec("WarpAffine").AddArg("matrix", affine_mat));
 DALI_BENCHMARK_DISPLACEMENT_CASE(Water<CPUBackend>, OpSpec("Water"));
+DALI_BENCHMARK_DISPLACEMENT_CASE(Sphere<CPUBackend>, OpSpec("Sphere"));
+DALI_BENCHMARK_DISPLACEMENT_CASE(Jitter<CPUBackend>, OpSpec("Jitter"));
 
 }  // namespace dali
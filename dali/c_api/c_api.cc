@@ -242,6 +242,36 @@ void daliCopyTensorNTo(daliPipelineHandle* pipe_handle, void* dst, int n, device
   }
 }
 
+void daliSetMemoryBudget(daliPipelineHandle* pipe_handle, size_t host_bytes, size_t gpu_bytes) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  pipeline->SetMemoryBudget(host_bytes, gpu_bytes);
+}
+
+bool daliGetMemoryUsage(daliPipelineHandle* pipe_handle, const char *op_name,
+                        daliMemoryUsage *usage) {
+  dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
+  DALI_ENFORCE(usage != nullptr, "Output pointer must not be null");
+  dali::MemoryStats stats;
+  if (op_name) {
+    auto by_op = pipeline->MemoryUsageByOperator();
+    auto it = by_op.find(op_name);
+    if (it == by_op.end()) {
+      *usage = {};
+      return false;
+    }
+    stats = it->second;
+  } else {
+    stats = pipeline->MemoryUsage();
+  }
+  usage->host = stats.Current(dali::MemoryKind::Host);
+  usage->pinned = stats.Current(dali::MemoryKind::Pinned);
+  usage->gpu = stats.Current(dali::MemoryKind::GPU);
+  usage->peak_host = stats.Peak(dali::MemoryKind::Host);
+  usage->peak_pinned = stats.Peak(dali::MemoryKind::Pinned);
+  usage->peak_gpu = stats.Peak(dali::MemoryKind::GPU);
+  return true;
+}
+
 void daliDeletePipeline(daliPipelineHandle* pipe_handle) {
   dali::Pipeline* pipeline = reinterpret_cast<dali::Pipeline*>(pipe_handle->pipe);
   dali::DeviceWorkspace* ws = reinterpret_cast<dali::DeviceWorkspace*>(pipe_handle->ws);
@@ -31,6 +31,11 @@ extern "C" {
     GPU = 1
   };
 
+  struct daliMemoryUsage {
+    size_t host, pinned, gpu;
+    size_t peak_host, peak_pinned, peak_gpu;
+  };
+
   /**
    * @brief Create DALI pipeline. Setting batch_size,
    * num_threads or device_id here overrides
@@ -150,6 +155,21 @@ extern "C" {
                                     device_type_t dst_type, cudaStream_t stream,
                                     bool non_blocking);
 
+  /**
+   * @brief Set the budget for the host (including pinned) and GPU memory
+   * allocated by the pipeline, 0 means unlimited.
+   */
+  DLL_PUBLIC void daliSetMemoryBudget(daliPipelineHandle* pipe_handle,
+                                      size_t host_bytes, size_t gpu_bytes);
+
+  /**
+   * @brief Get the memory allocated by operator `op_name`,
+   * or by the whole pipeline if `op_name` is NULL.
+   * @return false if the operator did not allocate any memory
+   */
+  DLL_PUBLIC bool daliGetMemoryUsage(daliPipelineHandle* pipe_handle, const char *op_name,
+                                     daliMemoryUsage *usage);
+
   /**
    * @brief Delete the pipeline object.
    */
@@ -0,0 +1,53 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include "dali/core/philox.h"
+
+namespace dali {
+
+namespace {
+
+void ExpectBlock(const Philox4x32_10::Block &block, uint32_t v0, uint32_t v1,
+                 uint32_t v2, uint32_t v3) {
+  EXPECT_EQ(block[0], v0);
+  EXPECT_EQ(block[1], v1);
+  EXPECT_EQ(block[2], v2);
+  EXPECT_EQ(block[3], v3);
+}
+
+}  // namespace
+
+// Known answers from the Random123 reference implementation
+TEST(Philox4x32_10, KnownAnswers) {
+  ExpectBlock(Philox4x32_10::Generate(0, 0, 0),
+              0x6627e8d5u, 0xe169c58du, 0xbc57ac4cu, 0x9b00dbd8u);
+  ExpectBlock(Philox4x32_10::Generate(~0ull, ~0ull, ~0ull),
+              0x408f276du, 0x41c83b0eu, 0xa20bc7c6u, 0x6d5451fdu);
+  ExpectBlock(Philox4x32_10::Generate(0x299f31d0a4093822ull,
+                                      0x0370734413198a2eull, 0x85a308d3243f6a88ull),
+              0xd16cfe09u, 0x94fdccebu, 0x5001e420u, 0x24126ea1u);
+}
+
+TEST(Philox4x32_10, CounterAndKeyChangeResult) {
+  auto a = Philox4x32_10::Generate(42, 1, 2);
+  auto b = Philox4x32_10::Generate(42, 1, 3);
+  auto c = Philox4x32_10::Generate(43, 1, 2);
+  auto d = Philox4x32_10::Generate(42, 1, 2);
+  EXPECT_NE(a[0], b[0]);
+  EXPECT_NE(a[0], c[0]);
+  ExpectBlock(d, a[0], a[1], a[2], a[3]);
+}
+
+}  // namespace dali
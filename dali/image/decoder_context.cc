@@ -0,0 +1,31 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/image/decoder_context.h"
+#include "dali/image/jpeg_mem.h"
+
+namespace dali {
+
+DecoderContext::DecoderContext() = default;
+DecoderContext::~DecoderContext() = default;
+DecoderContext::DecoderContext(DecoderContext &&) = default;
+DecoderContext &DecoderContext::operator=(DecoderContext &&) = default;
+
+jpeg::Decompressor *DecoderContext::JpegDecompressor() {
+  if (!jpeg_)
+    jpeg_.reset(new jpeg::Decompressor());
+  return jpeg_.get();
+}
+
+}  // namespace dali
@@ -0,0 +1,68 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_IMAGE_DECODER_CONTEXT_H_
+#define DALI_IMAGE_DECODER_CONTEXT_H_
+
+#include <memory>
+#include <vector>
+#include "dali/core/common.h"
+
+namespace dali {
+
+namespace jpeg {
+class Decompressor;
+}  // namespace jpeg
+
+/**
+ * @brief Decoder state reused by consecutive decoding calls on the same thread
+ *
+ * Setting up a decoder (e.g. the libjpeg decompressor with its error and source managers)
+ * and allocating its temporary buffers is a noticeable fraction of the time needed to
+ * decode a small image. Images given a DecoderContext (see Image::SetDecoderContext) keep
+ * that state there, instead of creating it anew.
+ *
+ * A context must not be used by more than one thread at a time.
+ */
+class DecoderContext {
+ public:
+  DLL_PUBLIC DecoderContext();
+  DLL_PUBLIC ~DecoderContext();
+  DLL_PUBLIC DecoderContext(DecoderContext &&);
+  DLL_PUBLIC DecoderContext &operator=(DecoderContext &&);
+
+  /**
+   * @brief Returns the libjpeg decompressor, created on first use
+   */
+  DLL_PUBLIC jpeg::Decompressor *JpegDecompressor();
+
+  /**
+   * @brief Returns a temporary buffer of at least `size` bytes
+   *
+   * The buffer is only reallocated when it grows; its contents are not preserved.
+   */
+  inline uint8_t *Scratch(size_t size) {
+    if (scratch_.size() < size)
+      scratch_.resize(size);
+    return scratch_.data();
+  }
+
+ private:
+  std::unique_ptr<jpeg::Decompressor> jpeg_;
+  std::vector<uint8_t> scratch_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_IMAGE_DECODER_CONTEXT_H_
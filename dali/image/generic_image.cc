@@ -27,6 +27,15 @@ std::pair<std::shared_ptr<uint8_t>, Image::Shape>
 GenericImage::DecodeImpl(DALIImageType image_type,
                          const uint8_t *encoded_buffer,
                          size_t length) const {
+  return DecodeOpenCv(image_type, encoded_buffer, length, GetCropWindowGenerator());
+}
+
+
+std::pair<std::shared_ptr<uint8_t>, Image::Shape>
+GenericImage::DecodeOpenCv(DALIImageType image_type,
+                           const uint8_t *encoded_buffer,
+                           size_t length,
+                           const CropWindowGenerator &crop_generator) const {
   // Decode image to tmp cv::Mat
   cv::Mat decoded_image = cv::imdecode(
     cv::Mat(1, length, CV_8UC1, (void *) (encoded_buffer)),         //NOLINT
@@ -38,7 +47,6 @@ GenericImage::DecodeImpl(DALIImageType image_type,
   DALI_ENFORCE(decoded_image.data != nullptr, "Unsupported image type.");
 
   // If required, crop the image
-  auto crop_generator = GetCropWindowGenerator();
   if (crop_generator) {
       cv::Mat decoded_image_roi;
       auto crop = crop_generator({H, W});
@@ -31,6 +31,13 @@ class GenericImage : public Image {
   DecodeImpl(DALIImageType image_type, const uint8_t *encoded_buffer, size_t length) const override;
 
   Shape PeekShapeImpl(const uint8_t *encoded_buffer, size_t length) const override;
+
+  /**
+   * @brief Decodes with OpenCV, cropping with `crop_generator` (if set)
+   */
+  std::pair<std::shared_ptr<uint8_t>, Shape>
+  DecodeOpenCv(DALIImageType image_type, const uint8_t *encoded_buffer, size_t length,
+               const CropWindowGenerator &crop_generator) const;
 };
 
 }  // namespace dali
@@ -58,9 +58,31 @@ void Image::Decode() {
   auto decoded = DecodeImpl(image_type_, encoded_image_, length_);
   decoded_image_ = decoded.first;
   shape_ = decoded.second;
+  if (output_allocator_ && decoded_image_.get() != external_output_) {
+    // the decoder has used its own buffer - move the result to the user's memory
+    auto output = AllocateOutput(shape_);
+    std::memcpy(output.get(), decoded_image_.get(), volume(shape_));
+    decoded_image_ = output;
+  }
   decoded_ = true;
 }
 
+DecoderContext &Image::GetDecoderContext() const {
+  if (context_)
+    return *context_;
+  if (!own_context_)
+    own_context_.reset(new DecoderContext());
+  return *own_context_;
+}
+
+std::shared_ptr<uint8_t> Image::AllocateOutput(const Shape &shape) const {
+  if (output_allocator_) {
+    external_output_ = output_allocator_(shape);
+    return { external_output_, [](uint8_t *) {} };
+  }
+  return { new uint8_t[volume(shape)], [](uint8_t *data) { delete [] data; } };
+}
+
 
 std::shared_ptr<uint8_t> Image::GetImage() const {
   DALI_ENFORCE(decoded_, "Image not decoded. Run Decode()");
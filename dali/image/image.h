@@ -25,6 +25,7 @@
 #include <functional>
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
+#include "dali/image/decoder_context.h"
 #include "dali/pipeline/operators/operator.h"
 #include "dali/util/crop_window.h"
 #include "dali/kernels/tensor_shape.h"
@@ -33,13 +34,14 @@ namespace dali {
 
 static const char *kKnownImageExtensions[] = {".jpg", ".jpeg", ".png", ".gif",
                                               ".bmp", ".tif",  ".tiff",
-                                              ".pnm", ".ppm", ".pgm", ".pbm"};
+                                              ".pnm", ".ppm", ".pgm", ".pbm", ".webp"};
 
 DLL_PUBLIC bool HasKnownImageExtension(const std::string &image_path);
 
 class Image {
  public:
   using Shape = kernels::TensorShape<3>;
+  using OutputAllocator = std::function<uint8_t *(const Shape &)>;
 
   /**
    * Perform image decoding. Actual implementation is defined
@@ -109,6 +111,23 @@ class Image {
     return use_fast_idct_;
   }
 
+  /**
+   * Sets the decoder state reused between images decoded on the same thread.
+   * The context must outlive the decoding; without one, temporary state is used.
+   */
+  inline void SetDecoderContext(DecoderContext *context) {
+    context_ = context;
+  }
+
+  /**
+   * Makes Decode(...) store the image in the memory returned by `allocate`,
+   * which is called with the shape of the decoded image. GetImage() then
+   * returns a non-owning pointer to that memory.
+   */
+  inline void SetOutputAllocator(OutputAllocator allocate) {
+    output_allocator_ = std::move(allocate);
+  }
+
   virtual ~Image() = default;
   DISABLE_COPY_MOVE_ASSIGN(Image);
 
@@ -140,6 +159,17 @@ class Image {
     return crop_window_generator_;
   }
 
+  /**
+   * Gets the decoder context set by the user or, if there's none, a temporary one
+   */
+  DecoderContext &GetDecoderContext() const;
+
+  /**
+   * Allocates the buffer for the decoded image. Decoders that use it, instead of
+   * allocating the memory themselves, write directly to the user's output, if any.
+   */
+  std::shared_ptr<uint8_t> AllocateOutput(const Shape &shape) const;
+
  private:
   const uint8_t *encoded_image_;
   const size_t length_;
@@ -149,6 +179,10 @@ class Image {
   Shape shape_;
   CropWindowGenerator crop_window_generator_;
   std::shared_ptr<uint8_t> decoded_image_ = nullptr;
+  DecoderContext *context_ = nullptr;
+  mutable std::unique_ptr<DecoderContext> own_context_;
+  OutputAllocator output_allocator_;
+  mutable uint8_t *external_output_ = nullptr;
 };
 
 
@@ -23,6 +23,9 @@
 #include "dali/image/tiff.h"
 #endif
 #include "dali/image/pnm.h"
+#if LIBWEBP_ENABLED
+#include "dali/image/webp.h"
+#endif
 
 namespace dali {
 
@@ -59,6 +62,13 @@ bool CheckIsPNM(const uint8_t *pnm, int size) {
 }
 
 
+bool CheckIsWebP(const uint8_t *webp, int size) {
+  // RIFF container: "RIFF", 4 bytes of size, "WEBP"
+  return (size >= 12 && webp[0] == 'R' && webp[1] == 'I' && webp[2] == 'F' && webp[3] == 'F' &&
+          webp[8] == 'W' && webp[9] == 'E' && webp[10] == 'B' && webp[11] == 'P');
+}
+
+
 constexpr std::array<int, 4> header_intel = {77, 77, 0, 42};
 constexpr std::array<int, 4> header_motorola = {73, 73, 42, 0};
 
@@ -83,7 +93,8 @@ std::unique_ptr<Image>
 ImageFactory::CreateImage(const uint8_t *encoded_image, size_t length, DALIImageType image_type) {
   DALI_ENFORCE(CheckIsPNG(encoded_image, length) + CheckIsBMP(encoded_image, length) +
                CheckIsGIF(encoded_image, length) + CheckIsJPEG(encoded_image, length) +
-               CheckIsTiff(encoded_image, length) + CheckIsPNM(encoded_image, length) == 1,
+               CheckIsTiff(encoded_image, length) + CheckIsPNM(encoded_image, length) +
+               CheckIsWebP(encoded_image, length) == 1,
                "Encoded image has ambiguous format");
   if (CheckIsPNG(encoded_image, length)) {
     return std::make_unique<PngImage>(encoded_image, length, image_type);
@@ -100,6 +111,12 @@ ImageFactory::CreateImage(const uint8_t *encoded_image, size_t length, DALIImage
     return std::make_unique<TiffImage_Libtiff>(encoded_image, length, image_type);
 #else
     return std::make_unique<TiffImage>(encoded_image, length, image_type);
+#endif
+  } else if (CheckIsWebP(encoded_image, length)) {
+#if LIBWEBP_ENABLED
+    return std::make_unique<WebpImage>(encoded_image, length, image_type);
+#else
+    return std::make_unique<GenericImage>(encoded_image, length, image_type);
 #endif
   }
   return std::make_unique<GenericImage>(encoded_image, length, image_type);
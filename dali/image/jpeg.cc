@@ -103,14 +103,13 @@ JpegImage::DecodeImpl(DALIImageType type, const uint8 *jpeg, size_t length) cons
   int cropped_w = 0;
   uint8_t* result = jpeg::Uncompress(
     jpeg, length, flags, nullptr /* nwarn */,
-    [&decoded_image, &cropped_h, &cropped_w](int width, int height, int channels) -> uint8* {
-      decoded_image.reset(
-        new uint8_t[height * width * channels],
-        [](uint8_t* data){ delete [] data; } );
+    [this, &decoded_image, &cropped_h, &cropped_w](int width, int height, int channels) -> uint8* {
+      decoded_image = AllocateOutput({height, width, channels});
       cropped_h = height;
       cropped_w = width;
       return decoded_image.get();
-    });
+    },
+    GetDecoderContext().JpegDecompressor());
 
   if (result == nullptr) {
     // Failed to decode, fallback
@@ -128,7 +127,8 @@ Image::Shape JpegImage::PeekShapeImpl(const uint8_t *encoded_buffer,
   int height = 0, width = 0, components = 0;
 #ifdef DALI_USE_JPEG_TURBO
   DALI_ENFORCE(
-    jpeg::GetImageInfo(encoded_buffer, length, &width, &height, &components) == true);
+    jpeg::GetImageInfo(encoded_buffer, length, &width, &height, &components,
+                       GetDecoderContext().JpegDecompressor()));
 #else
   DALI_ENFORCE(get_jpeg_size(encoded_buffer, length, &height, &width));
 #endif
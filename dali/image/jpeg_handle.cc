@@ -162,10 +162,12 @@ void MemSkipInputData(j_decompress_ptr cinfo, int64 jump) {
 void SetSrc(j_decompress_ptr cinfo, const void *data,
             uint64 datasize, bool try_recover_truncated_jpeg) {
   MemSourceMgr *src;
-
-  cinfo->src = reinterpret_cast<struct jpeg_source_mgr *>(
-      (*cinfo->mem->alloc_small)(reinterpret_cast<j_common_ptr>(cinfo),
-                                 JPOOL_PERMANENT, sizeof(MemSourceMgr)));
+  // a decompressor reused for another image already has the source manager
+  if (cinfo->src == nullptr) {
+    cinfo->src = reinterpret_cast<struct jpeg_source_mgr *>(
+        (*cinfo->mem->alloc_small)(reinterpret_cast<j_common_ptr>(cinfo),
+                                   JPOOL_PERMANENT, sizeof(MemSourceMgr)));
+  }
 
   src = reinterpret_cast<MemSourceMgr *>(cinfo->src);
   src->pub.init_source = MemInitSource;
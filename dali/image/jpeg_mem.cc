@@ -25,6 +25,7 @@ limitations under the License.
 #include <memory>
 #include <string>
 #include <utility>
+#include <vector>
 #include "dali/image/jpeg_handle.h"
 #include "dali/core/error_handling.h"
 
@@ -47,11 +48,15 @@ enum JPEGErrors {
 class FewerArgsForCompiler {
  public:
   FewerArgsForCompiler(int datasize, const UncompressFlags& flags, int64* nwarn,
-                       std::function<uint8*(int, int, int)> allocate_output)
+                       std::function<uint8*(int, int, int)> allocate_output,
+                       std::function<void(const uint8*)> on_row = {},
+                       Decompressor* decompressor = nullptr)
       : datasize_(datasize),
         flags_(flags),
         pnwarn_(nwarn),
         allocate_output_(std::move(allocate_output)),
+        on_row_(std::move(on_row)),
+        decompressor_(decompressor),
         height_read_(0),
         height_(0),
         stride_(0) {
@@ -62,6 +67,9 @@ class FewerArgsForCompiler {
   const UncompressFlags flags_;
   int64* const pnwarn_;
   std::function<uint8*(int, int, int)> allocate_output_;
+  // If set, the output buffer holds just one row, which is passed to on_row_ once decoded
+  std::function<void(const uint8*)> on_row_;
+  Decompressor* const decompressor_;
   int height_read_;  // number of scanline lines successfully read
   int height_;
   int stride_;
@@ -87,6 +95,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
   int stride = flags.stride;              // may be 0
   int64* const nwarn = argball->pnwarn_;  // may be NULL
   auto color_space = flags.color_space;
+  const bool streaming = static_cast<bool>(argball->on_row_);
 
   // Can't decode if the ratio is not recognized by libjpeg
   if ((ratio != 1) && (ratio != 2) && (ratio != 4) && (ratio != 8)) {
@@ -101,24 +110,27 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
   // if empty image, return
   if (datasize == 0 || srcdata == nullptr) return nullptr;
 
+#if !defined(LIBJPEG_TURBO_VERSION)
+  // without libjpeg-turbo, crop requires the full image to be decoded first
+  if (streaming && flags.crop) return nullptr;
+#endif
+
   // Declare temporary buffer pointer here so that we can free on error paths
   JSAMPLE* tempdata = nullptr;
 
   // Initialize libjpeg structures to have a memory source
   // Modify the usual jpeg error manager to catch fatal errors.
   JPEGErrors error = JPEGERRORS_OK;
-  struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr jerr;
-  cinfo.err = jpeg_std_error(&jerr);
+  Decompressor* const decompressor = argball->decompressor_;
   jmp_buf jpeg_jmpbuf;
-  cinfo.client_data = &jpeg_jmpbuf;
-  jerr.error_exit = CatchError;
   if (setjmp(jpeg_jmpbuf)) {
+    // CatchError has destroyed the decompressor
+    decompressor->Invalidate();
     delete[] tempdata;
     return nullptr;
   }
 
-  jpeg_create_decompress(&cinfo);
+  struct jpeg_decompress_struct& cinfo = *decompressor->Acquire(&jpeg_jmpbuf);
   SetSrc(&cinfo, srcdata, datasize, flags.try_recover_truncated_jpeg);
   jpeg_read_header(&cinfo, TRUE);
 
@@ -136,7 +148,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
       break;
     default:
       ERROR_LOG << " Invalid components value " << components << std::endl;
-      jpeg_destroy_decompress(&cinfo);
+      jpeg_abort_decompress(&cinfo);
       return nullptr;
   }
 
@@ -164,12 +176,12 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
   if (cinfo.output_width <= 0 || cinfo.output_height <= 0) {
     ERROR_LOG << "Invalid image size: " << cinfo.output_width << " x "
               << cinfo.output_height << std::endl;
-    jpeg_destroy_decompress(&cinfo);
+    jpeg_abort_decompress(&cinfo);
     return nullptr;
   }
   if (total_size >= (1LL << 29)) {
     ERROR_LOG << "Image too large: " << total_size << std::endl;
-    jpeg_destroy_decompress(&cinfo);
+    jpeg_abort_decompress(&cinfo);
     return nullptr;
   }
 
@@ -194,7 +206,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
                 << " for image_width: " << cinfo.output_width
                 << " and image_height: " << cinfo.output_height
                 << std::endl;
-      jpeg_destroy_decompress(&cinfo);
+      jpeg_abort_decompress(&cinfo);
       return nullptr;
     }
 
@@ -227,7 +239,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
   } else if (stride < min_stride) {
     ERROR_LOG << "Incompatible stride: " << stride
               << " < " << min_stride << std::endl;
-    jpeg_destroy_decompress(&cinfo);
+    jpeg_abort_decompress(&cinfo);
     return nullptr;
   }
 
@@ -248,7 +260,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
                                              target_output_height, components);
 #endif
   if (dstdata == nullptr) {
-    jpeg_destroy_decompress(&cinfo);
+    jpeg_abort_decompress(&cinfo);
     return nullptr;
   }
   JSAMPLE* output_line = static_cast<JSAMPLE*>(dstdata);
@@ -344,6 +356,13 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
       } else {
         for (size_t line = cinfo.output_scanline; line < static_cast<size_t>(max_scanlines_to_read);
              ++line) {
+          if (streaming) {
+            // The row buffer still holds the line above, if there was one
+            if (line == skipped_scanlines)
+              memset(output_line, 0, min_stride);
+            argball->on_row_(output_line);
+            continue;
+          }
           if (line == 0) {
             // If even the first line is missing, fill with black color
             memset(output_line, 0, min_stride);
@@ -361,25 +380,28 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
       break;
     }
     DALI_ENFORCE(num_lines_read == 1);
-    output_line += stride;
+    if (streaming)
+      argball->on_row_(output_line);
+    else
+      output_line += stride;
   }
   delete[] tempdata;
   tempdata = nullptr;
 
 #if defined(LIBJPEG_TURBO_VERSION)
   if (flags.crop && cinfo.output_scanline < cinfo.output_height) {
-    // Skip the rest of scanlines, required by jpeg_destroy_decompress.
+    // Skip the rest of scanlines, required by jpeg_finish_decompress.
     jpeg_skip_scanlines(&cinfo,
                         cinfo.output_height - flags.crop_y - flags.crop_height);
     // After this, cinfo.output_height must be equal to cinfo.output_height;
-    // otherwise, jpeg_destroy_decompress would fail.
+    // otherwise, jpeg_finish_decompress would fail.
   }
 #endif
 
   // Convert the RGB data to RGBA, with alpha set to 0xFF to indicate
   // opacity.
   // RGBRGBRGB... --> RGBARGBARGBA...
-  if (components == 4) {
+  if (components == 4 && !streaming) {
     // Start on the last line.
     JSAMPLE* scanlineptr = static_cast<JSAMPLE*>(
         dstdata + static_cast<int64>(target_output_height - 1) * stride);
@@ -425,7 +447,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
     default:
       // will never happen, should be catched by the previous switch
       ERROR_LOG << "Invalid components value " << components << std::endl;
-      jpeg_destroy_decompress(&cinfo);
+      jpeg_abort_decompress(&cinfo);
       return nullptr;
   }
 
@@ -465,7 +487,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
                 << " and image_height: " << cinfo.output_height
                 << std::endl;
       delete[] dstdata;
-      jpeg_destroy_decompress(&cinfo);
+      jpeg_abort_decompress(&cinfo);
       return nullptr;
     }
 
@@ -474,7 +496,7 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
                                         target_output_height, components);
     if (dstdata == nullptr) {
       delete[] full_image;
-      jpeg_destroy_decompress(&cinfo);
+      jpeg_abort_decompress(&cinfo);
       return nullptr;
     }
 
@@ -502,12 +524,61 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
   }
 #endif
 
-  jpeg_destroy_decompress(&cinfo);
+  jpeg_abort_decompress(&cinfo);
   return dstdata;
 }
 
+// Reads the header with the given decompressor; kept separate from
+// GetImageInfo so that no local objects are live across setjmp.
+bool GetImageInfoLow(const void* srcdata, int datasize, int* width,
+                     int* height, int* components,
+                     Decompressor* const decompressor) {
+  jmp_buf jpeg_jmpbuf;
+  if (setjmp(jpeg_jmpbuf)) {
+    // CatchError has destroyed the decompressor
+    decompressor->Invalidate();
+    return false;
+  }
+
+  // set up, read header, set image parameters, save size
+  j_decompress_ptr cinfo = decompressor->Acquire(&jpeg_jmpbuf);
+  SetSrc(cinfo, srcdata, datasize, false);
+
+  jpeg_read_header(cinfo, TRUE);
+  // computes the same output size as jpeg_start_decompress, which, for
+  // progressive images, would also read all the coefficients
+  jpeg_calc_output_dimensions(cinfo);
+  if (width) *width = cinfo->output_width;
+  if (height) *height = cinfo->output_height;
+  if (components) *components = cinfo->output_components;
+
+  jpeg_abort_decompress(cinfo);
+
+  return true;
+}
+
 }  // anonymous namespace
 
+Decompressor::~Decompressor() {
+  if (created_)
+    jpeg_destroy_decompress(&cinfo_);
+}
+
+j_decompress_ptr Decompressor::Acquire(jmp_buf* jmpbuf) {
+  cinfo_.client_data = jmpbuf;
+  if (created_) {
+    // Releases the memory of the previous image and resets the state,
+    // even if the previous call bailed out in the middle of decoding.
+    jpeg_abort_decompress(&cinfo_);
+  } else {
+    cinfo_.err = jpeg_std_error(&jerr_);
+    jerr_.error_exit = CatchError;
+    jpeg_create_decompress(&cinfo_);
+    created_ = true;
+  }
+  return &cinfo_;
+}
+
 // -----------------------------------------------------------------------------
 //  We do the apparently silly thing of packing 5 of the arguments
 //  into a structure that is then passed to another routine
@@ -518,9 +589,12 @@ uint8* UncompressLow(const void* srcdata, FewerArgsForCompiler* argball) {
 //  it out a little.
 uint8* Uncompress(const void* srcdata, int datasize,
                   const UncompressFlags& flags, int64* nwarn,
-                  std::function<uint8*(int, int, int)> allocate_output) {
-  FewerArgsForCompiler argball(datasize, flags, nwarn,
-                               std::move(allocate_output));
+                  std::function<uint8*(int, int, int)> allocate_output,
+                  Decompressor* decompressor) {
+  Decompressor local_decompressor;
+  FewerArgsForCompiler argball(
+      datasize, flags, nwarn, std::move(allocate_output), {},
+      decompressor ? decompressor : &local_decompressor);
   uint8* const dstdata = UncompressLow(srcdata, &argball);
 
   const float fraction_read =
@@ -545,6 +619,43 @@ uint8* Uncompress(const void* srcdata, int datasize,
   return dstdata;
 }
 
+bool UncompressRows(const void* srcdata, int datasize,
+                    const UncompressFlags& flags, int64* nwarn,
+                    std::function<void(int, int, int)> on_header,
+                    std::function<void(const uint8*)> on_row,
+                    Decompressor* decompressor) {
+  UncompressFlags row_flags = flags;
+  row_flags.stride = 0;
+  std::vector<uint8> row;
+  Decompressor local_decompressor;
+  FewerArgsForCompiler argball(
+      datasize, row_flags, nwarn,
+      [&](int width, int height, int components) {
+        on_header(width, height, components);
+        row.resize(static_cast<size_t>(width) * components);
+        return row.data();
+      },
+      on_row, decompressor ? decompressor : &local_decompressor);
+  uint8* const rowdata = UncompressLow(srcdata, &argball);
+
+  const float fraction_read =
+      argball.height_ == 0
+          ? 1.0
+          : (static_cast<float>(argball.height_read_) / argball.height_);
+  if (rowdata == nullptr ||
+      fraction_read < std::min(1.0f, flags.min_acceptable_fraction)) {
+    return false;
+  }
+
+  // Pass the unread lines as black
+  if (argball.height_read_ != argball.height_) {
+    std::fill(row.begin(), row.end(), 0);
+    for (int y = argball.height_read_; y < argball.height_; y++)
+      on_row(row.data());
+  }
+  return true;
+}
+
 uint8* Uncompress(const void* srcdata, int datasize,
                   const UncompressFlags& flags, int* pwidth, int* pheight,
                   int* pcomponents, int64* nwarn) {
@@ -566,7 +677,7 @@ uint8* Uncompress(const void* srcdata, int datasize,
 // Computes image information from jpeg header.
 // Returns true on success; false on failure.
 bool GetImageInfo(const void* srcdata, int datasize, int* width, int* height,
-                  int* components) {
+                  int* components, Decompressor* decompressor) {
   // Init in case of failure
   if (width) *width = 0;
   if (height) *height = 0;
@@ -575,31 +686,10 @@ bool GetImageInfo(const void* srcdata, int datasize, int* width, int* height,
   // If empty image, return
   if (datasize == 0 || srcdata == nullptr) return false;
 
-  // Initialize libjpeg structures to have a memory source
-  // Modify the usual jpeg error manager to catch fatal errors.
-  struct jpeg_decompress_struct cinfo;
-  struct jpeg_error_mgr jerr;
-  jmp_buf jpeg_jmpbuf;
-  cinfo.err = jpeg_std_error(&jerr);
-  cinfo.client_data = &jpeg_jmpbuf;
-  jerr.error_exit = CatchError;
-  if (setjmp(jpeg_jmpbuf)) {
-    return false;
-  }
-
-  // set up, read header, set image parameters, save size
-  jpeg_create_decompress(&cinfo);
-  SetSrc(&cinfo, srcdata, datasize, false);
-
-  jpeg_read_header(&cinfo, TRUE);
-  jpeg_start_decompress(&cinfo);  // required to transfer image size to cinfo
-  if (width) *width = cinfo.output_width;
-  if (height) *height = cinfo.output_height;
-  if (components) *components = cinfo.output_components;
-
-  jpeg_destroy_decompress(&cinfo);
-
-  return true;
+  Decompressor local_decompressor;
+  if (!decompressor) decompressor = &local_decompressor;
+  return GetImageInfoLow(srcdata, datasize, width, height, components,
+                         decompressor);
 }
 
 // -----------------------------------------------------------------------------
@@ -23,6 +23,7 @@ limitations under the License.
 #ifndef DALI_IMAGE_JPEG_MEM_H_
 #define DALI_IMAGE_JPEG_MEM_H_
 
+#include <setjmp.h>
 #include <functional>
 #include <string>
 #include "dali/core/common.h"
@@ -77,6 +78,31 @@ struct UncompressFlags {
   int crop_height = 0;
 };
 
+// Decompression state which can be reused by consecutive decoding calls.
+// Creating the libjpeg decompressor (with its error and source managers and
+// memory pools) takes a noticeable fraction of the time needed to decode a
+// small image; passing the same Decompressor to the functions below avoids it.
+// A Decompressor must not be used by more than one thread at a time.
+class Decompressor {
+ public:
+  Decompressor() = default;
+  ~Decompressor();
+  Decompressor(const Decompressor&) = delete;
+  Decompressor& operator=(const Decompressor&) = delete;
+
+  // Returns the decompressor, ready to read a new image. Errors are reported
+  // with a longjmp to `jmpbuf`, after which Invalidate() must be called.
+  j_decompress_ptr Acquire(jmp_buf* jmpbuf);
+
+  // Marks the decompressor as destroyed by the error handler
+  void Invalidate() { created_ = false; }
+
+ private:
+  struct jpeg_decompress_struct cinfo_;
+  struct jpeg_error_mgr jerr_;
+  bool created_ = false;
+};
+
 // Uncompress some raw JPEG data given by the pointer srcdata and the length
 // datasize.
 // - width and height are the address where to store the size of the
@@ -101,12 +127,26 @@ uint8* Uncompress(const void* srcdata, int datasize,
 // for freeing the memory *even along error paths*.
 uint8* Uncompress(const void* srcdata, int datasize,
                   const UncompressFlags& flags, int64* nwarn,
-                  std::function<uint8*(int, int, int)> allocate_output);
+                  std::function<uint8*(int, int, int)> allocate_output,
+                  Decompressor* decompressor = nullptr);
+
+// Streaming version of Uncompress.  Instead of storing the whole image, passes
+// the decoded rows (after cropping, if requested) to on_row, one by one, top to
+// bottom; the row buffer is reused, so the callback must consume the data
+// before returning.  on_header is called with (width, height, components) of
+// the output before the first row.  Unread lines of a truncated image are
+// passed as black rows.  flags.stride is ignored.  Returns false on error;
+// in that case some rows may have already been passed to on_row.
+bool UncompressRows(const void* srcdata, int datasize,
+                    const UncompressFlags& flags, int64* nwarn,
+                    std::function<void(int, int, int)> on_header,
+                    std::function<void(const uint8*)> on_row,
+                    Decompressor* decompressor = nullptr);
 
 // Read jpeg header and get image information.  Returns true on success.
 // The width, height, and components points may be null.
 bool GetImageInfo(const void* srcdata, int datasize, int* width, int* height,
-                  int* components);
+                  int* components, Decompressor* decompressor = nullptr);
 
 // Note: (format & 0xff) = number of components (<=> bytes per pixels)
 enum Format {
@@ -0,0 +1,109 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <string>
+#include <vector>
+#include "dali/image/jpeg_mem.h"
+
+namespace dali {
+namespace jpeg {
+
+namespace {
+
+std::string MakeJpeg(int width, int height, int seed) {
+  std::mt19937 rng(seed);
+  std::uniform_int_distribution<int> dist(0, 255);
+  std::vector<uint8> pixels(width * height * 3);
+  for (auto &p : pixels)
+    p = dist(rng);
+  CompressFlags flags;
+  flags.format = FORMAT_RGB;
+  std::string jpeg = Compress(pixels.data(), width, height, flags);
+  EXPECT_FALSE(jpeg.empty());
+  return jpeg;
+}
+
+std::vector<uint8> Decode(const std::string &jpeg, const UncompressFlags &flags,
+                          Decompressor *decompressor) {
+  std::vector<uint8> out;
+  uint8 *result = Uncompress(
+      jpeg.data(), jpeg.size(), flags, nullptr,
+      [&](int width, int height, int components) {
+        out.resize(width * height * components);
+        return out.data();
+      },
+      decompressor);
+  if (!result)
+    out.clear();
+  return out;
+}
+
+}  // namespace
+
+TEST(JpegDecompressor, ReuseGivesSameResults) {
+  std::vector<std::string> jpegs = {
+    MakeJpeg(37, 23, 1), MakeJpeg(64, 64, 2), MakeJpeg(8, 120, 3), MakeJpeg(37, 23, 4)
+  };
+  UncompressFlags gray;
+  gray.components = 1;
+  gray.color_space = DALI_GRAY;
+  UncompressFlags crop;
+  crop.components = 3;
+  crop.crop = true;
+  crop.crop_x = 3;
+  crop.crop_y = 5;
+  crop.crop_width = 5;
+  crop.crop_height = 7;
+
+  Decompressor decompressor;
+  for (int iter = 0; iter < 2; iter++) {
+    for (auto &jpeg : jpegs) {
+      for (auto &flags : { UncompressFlags(), gray, crop }) {
+        auto ref = Decode(jpeg, flags, nullptr);
+        ASSERT_FALSE(ref.empty());
+        EXPECT_EQ(Decode(jpeg, flags, &decompressor), ref);
+      }
+      int w = 0, h = 0, c = 0;
+      ASSERT_TRUE(GetImageInfo(jpeg.data(), jpeg.size(), &w, &h, &c, &decompressor));
+      int ref_w = 0, ref_h = 0, ref_c = 0;
+      ASSERT_TRUE(GetImageInfo(jpeg.data(), jpeg.size(), &ref_w, &ref_h, &ref_c));
+      EXPECT_EQ(w, ref_w);
+      EXPECT_EQ(h, ref_h);
+      EXPECT_EQ(c, ref_c);
+    }
+  }
+}
+
+TEST(JpegDecompressor, RecoversAfterError) {
+  auto jpeg = MakeJpeg(40, 30, 5);
+  UncompressFlags flags;
+  auto ref = Decode(jpeg, flags, nullptr);
+  ASSERT_FALSE(ref.empty());
+
+  Decompressor decompressor;
+  std::string garbage = jpeg.substr(0, 2) + std::string(100, '\x5a');
+  EXPECT_TRUE(Decode(garbage, flags, &decompressor).empty());
+  EXPECT_FALSE(GetImageInfo(garbage.data(), garbage.size(), nullptr, nullptr, nullptr,
+                            &decompressor));
+  EXPECT_EQ(Decode(jpeg, flags, &decompressor), ref);
+
+  // bailing out in the middle of decoding
+  EXPECT_TRUE(Decode(jpeg.substr(0, jpeg.size() / 2), flags, &decompressor).empty());
+  EXPECT_EQ(Decode(jpeg, flags, &decompressor), ref);
+}
+
+}  // namespace jpeg
+}  // namespace dali
@@ -0,0 +1,173 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/image/jpeg_transform.h"
+#include <setjmp.h>
+#include <algorithm>
+#include <cstring>
+#include <string>
+#include <vector>
+#include "dali/image/jpeg_handle.h"
+
+namespace dali {
+namespace jpeg {
+
+namespace {
+
+inline int DivCeil(int x, int y) {
+  return (x + y - 1) / y;
+}
+
+/**
+ * @brief Copies (or flips) the blocks of the crop window of one component
+ *
+ * `x_blocks`, `y_blocks` - the origin of the crop window, in blocks;
+ * the extent is that of the destination array
+ */
+void CopyBlocks(j_decompress_ptr srcinfo, jvirt_barray_ptr src, jvirt_barray_ptr dst,
+                int x_blocks, int y_blocks, int width_blocks, int height_blocks,
+                int v_samp, bool flip) {
+  for (int blk_y = 0; blk_y < height_blocks; blk_y += v_samp) {
+    JBLOCKARRAY dst_rows = (*srcinfo->mem->access_virt_barray)(
+        reinterpret_cast<j_common_ptr>(srcinfo), dst, blk_y, v_samp, TRUE);
+    JBLOCKARRAY src_rows = (*srcinfo->mem->access_virt_barray)(
+        reinterpret_cast<j_common_ptr>(srcinfo), src, blk_y + y_blocks, v_samp, FALSE);
+    for (int offset_y = 0; offset_y < v_samp; offset_y++) {
+      JBLOCKROW src_row = src_rows[offset_y] + x_blocks;
+      JBLOCKROW dst_row = dst_rows[offset_y];
+      if (!flip) {
+        std::memcpy(dst_row, src_row, width_blocks * sizeof(JBLOCK));
+        continue;
+      }
+      // mirroring a block negates the coefficients of odd horizontal frequencies
+      for (int blk_x = 0; blk_x < width_blocks; blk_x++) {
+        const JCOEF *src_blk = src_row[width_blocks - 1 - blk_x];
+        JCOEF *dst_blk = dst_row[blk_x];
+        for (int k = 0; k < DCTSIZE2; k += 2) {
+          dst_blk[k] = src_blk[k];
+          dst_blk[k + 1] = -src_blk[k + 1];
+        }
+      }
+    }
+  }
+}
+
+// Kept separate from TransformLossless so that no objects with destructors
+// are live across setjmp
+bool TransformLosslessLow(const void *srcdata, int datasize, const LosslessTransform &t,
+                          std::string *output, Decompressor *const decompressor,
+                          JOCTET *buffer, int bufsize) {
+  struct jpeg_compress_struct dstinfo;
+  struct jpeg_error_mgr dst_jerr;
+  std::memset(&dstinfo, 0, sizeof(dstinfo));
+  jmp_buf src_jmpbuf, dst_jmpbuf;
+  if (setjmp(src_jmpbuf)) {
+    // CatchError has destroyed the decompressor
+    decompressor->Invalidate();
+    jpeg_destroy_compress(&dstinfo);
+    return false;
+  }
+  if (setjmp(dst_jmpbuf)) {
+    // CatchError has destroyed the compressor; the decompressor is reset when reused
+    return false;
+  }
+
+  j_decompress_ptr srcinfo = decompressor->Acquire(&src_jmpbuf);
+  SetSrc(srcinfo, srcdata, datasize, false);
+  jpeg_read_header(srcinfo, TRUE);
+
+  if (srcinfo->jpeg_color_space != JCS_GRAYSCALE && srcinfo->jpeg_color_space != JCS_YCbCr) {
+    jpeg_abort_decompress(srcinfo);
+    return false;
+  }
+  // in a single-component image, an MCU is just one block
+  const bool single = srcinfo->num_components == 1;
+  const int max_h = single ? 1 : srcinfo->max_h_samp_factor;
+  const int max_v = single ? 1 : srcinfo->max_v_samp_factor;
+  const int mcu_w = max_h * DCTSIZE;
+  const int mcu_h = max_v * DCTSIZE;
+  const int W = srcinfo->image_width;
+  const int H = srcinfo->image_height;
+  if (t.crop_width <= 0 || t.crop_height <= 0 || t.crop_x < 0 || t.crop_y < 0 ||
+      t.crop_x + t.crop_width > W || t.crop_y + t.crop_height > H ||
+      t.crop_x % mcu_w != 0 || t.crop_y % mcu_h != 0 ||
+      (t.flip_horizontal && t.crop_width % mcu_w != 0)) {
+    jpeg_abort_decompress(srcinfo);
+    return false;
+  }
+
+  // the arrays for the result cover whole iMCUs and must be requested before they are
+  // realized by jpeg_read_coefficients
+  const int width_mcus = DivCeil(t.crop_width, mcu_w);
+  const int height_mcus = DivCeil(t.crop_height, mcu_h);
+  jvirt_barray_ptr dst_coef[MAX_COMPONENTS];
+  for (int c = 0; c < srcinfo->num_components; c++) {
+    const jpeg_component_info *comp = srcinfo->comp_info + c;
+    const int h_samp = single ? 1 : comp->h_samp_factor;
+    const int v_samp = single ? 1 : comp->v_samp_factor;
+    dst_coef[c] = (*srcinfo->mem->request_virt_barray)(
+        reinterpret_cast<j_common_ptr>(srcinfo), JPOOL_IMAGE, FALSE,
+        width_mcus * h_samp, height_mcus * v_samp, v_samp);
+  }
+  jvirt_barray_ptr *src_coef = jpeg_read_coefficients(srcinfo);
+  if (src_coef == nullptr) {
+    // the source has suspended - the data is corrupted
+    jpeg_abort_decompress(srcinfo);
+    return false;
+  }
+
+  for (int c = 0; c < srcinfo->num_components; c++) {
+    const jpeg_component_info *comp = srcinfo->comp_info + c;
+    const int h_samp = single ? 1 : comp->h_samp_factor;
+    const int v_samp = single ? 1 : comp->v_samp_factor;
+    CopyBlocks(srcinfo, src_coef[c], dst_coef[c],
+               t.crop_x / mcu_w * h_samp, t.crop_y / mcu_h * v_samp,
+               width_mcus * h_samp, height_mcus * v_samp, v_samp, t.flip_horizontal);
+  }
+
+  dstinfo.err = jpeg_std_error(&dst_jerr);
+  dstinfo.client_data = &dst_jmpbuf;
+  dst_jerr.error_exit = CatchError;
+  jpeg_create_compress(&dstinfo);
+  jpeg_copy_critical_parameters(srcinfo, &dstinfo);
+  dstinfo.image_width = t.crop_width;
+  dstinfo.image_height = t.crop_height;
+  SetDest(&dstinfo, buffer, bufsize, output);
+  jpeg_write_coefficients(&dstinfo, dst_coef);
+  jpeg_finish_compress(&dstinfo);
+  jpeg_destroy_compress(&dstinfo);
+
+  jpeg_abort_decompress(srcinfo);
+  return true;
+}
+
+}  // namespace
+
+bool TransformLossless(const void *srcdata, int datasize, const LosslessTransform &transform,
+                       std::string *output, Decompressor *decompressor) {
+  output->clear();
+  if (datasize == 0 || srcdata == nullptr) return false;
+  Decompressor local_decompressor;
+  // the result is smaller than the input, except for tiny crops of tiny images;
+  // if the buffer fills up, it is appended to the output and reused
+  std::vector<JOCTET> buffer(std::max(datasize, 4096));
+  bool ok = TransformLosslessLow(srcdata, datasize, transform, output,
+                                 decompressor ? decompressor : &local_decompressor,
+                                 buffer.data(), buffer.size());
+  if (!ok) output->clear();
+  return ok;
+}
+
+}  // namespace jpeg
+}  // namespace dali
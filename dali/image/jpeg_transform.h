@@ -0,0 +1,55 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_IMAGE_JPEG_TRANSFORM_H_
+#define DALI_IMAGE_JPEG_TRANSFORM_H_
+
+#include <string>
+#include "dali/core/common.h"
+#include "dali/image/jpeg_mem.h"
+
+namespace dali {
+namespace jpeg {
+
+/**
+ * @brief Crop window and flip applied by TransformLossless
+ */
+struct LosslessTransform {
+  int crop_x = 0;
+  int crop_y = 0;
+  int crop_width = 0;
+  int crop_height = 0;
+  bool flip_horizontal = false;
+};
+
+/**
+ * @brief Crops and, optionally, flips a JPEG image horizontally on its quantized DCT
+ *        coefficients, producing a smaller JPEG image, as `jpegtran -perfect` does.
+ *
+ * The transform is exact (no requantization), but it is only possible if the crop window
+ * starts at an iMCU boundary (8 or 16 pixels, depending on chroma subsampling) and, when
+ * flipping, if its width is a multiple of the iMCU width - otherwise the partial blocks at
+ * the right edge would end up on the left. Only grayscale and YCbCr images are handled.
+ *
+ * @param output        the transformed JPEG image
+ * @param decompressor  decompressor to reuse; optional
+ * @return false, if the transform is not possible for this image or an error occurred
+ */
+bool TransformLossless(const void *srcdata, int datasize, const LosslessTransform &transform,
+                       std::string *output, Decompressor *decompressor = nullptr);
+
+}  // namespace jpeg
+}  // namespace dali
+
+#endif  // DALI_IMAGE_JPEG_TRANSFORM_H_
@@ -0,0 +1,166 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+#include "dali/image/jpeg_transform.h"
+
+namespace dali {
+namespace jpeg {
+
+namespace {
+
+/**
+ * @brief Encodes a smooth, random-ish image, so that the decoding errors are small
+ */
+std::string MakeJpeg(int width, int height, int components, bool subsample) {
+  std::mt19937 rng(width * height + components);
+  std::uniform_real_distribution<float> dist(0, 1);
+  std::vector<uint8> pixels(width * height * components);
+  for (int y = 0; y < height; y++)
+    for (int x = 0; x < width; x++)
+      for (int c = 0; c < components; c++)
+        pixels[(y * width + x) * components + c] = static_cast<uint8>(
+            128 + 60 * std::sin(0.1f * x * (c + 1) + 0.07f * y) + 20 * dist(rng));
+  CompressFlags flags;
+  flags.format = components == 1 ? FORMAT_GRAYSCALE : FORMAT_RGB;
+  flags.chroma_downsampling = subsample;
+  return Compress(pixels.data(), width, height, flags);
+}
+
+std::vector<uint8> Decode(const std::string &jpeg, int components, int *width, int *height) {
+  UncompressFlags flags;
+  flags.components = components;
+  flags.color_space = components == 1 ? DALI_GRAY : DALI_RGB;
+  std::vector<uint8> out;
+  EXPECT_TRUE(Uncompress(jpeg.data(), jpeg.size(), flags, nullptr,
+    [&](int w, int h, int c) {
+      *width = w;
+      *height = h;
+      out.resize(w * h * c);
+      return out.data();
+    }));
+  return out;
+}
+
+/**
+ * @brief Compares the decoded transformed image with the crop (and flip) of the decoded original
+ *
+ * @return maximum absolute difference
+ */
+int CompareWithPixelPath(const std::string &jpeg, int components, const LosslessTransform &t) {
+  std::string transformed;
+  EXPECT_TRUE(TransformLossless(jpeg.data(), jpeg.size(), t, &transformed));
+  int W = 0, H = 0, w = 0, h = 0;
+  auto full = Decode(jpeg, components, &W, &H);
+  auto result = Decode(transformed, components, &w, &h);
+  EXPECT_EQ(w, t.crop_width);
+  EXPECT_EQ(h, t.crop_height);
+  if (w != t.crop_width || h != t.crop_height)
+    return 256;
+  int max_diff = 0;
+  for (int y = 0; y < h; y++) {
+    for (int x = 0; x < w; x++) {
+      int src_x = t.crop_x + (t.flip_horizontal ? w - 1 - x : x);
+      for (int c = 0; c < components; c++) {
+        int ref = full[((t.crop_y + y) * W + src_x) * components + c];
+        int out = result[(y * w + x) * components + c];
+        max_diff = std::max(max_diff, std::abs(ref - out));
+      }
+    }
+  }
+  return max_diff;
+}
+
+}  // namespace
+
+TEST(JpegTransformLossless, CropIsExact) {
+  for (int components : { 1, 3 }) {
+    auto jpeg = MakeJpeg(77, 53, components, false);
+    LosslessTransform t;
+    t.crop_x = 16;
+    t.crop_y = 8;
+    t.crop_width = 61;  // reaches the right edge, which is not block-aligned
+    t.crop_height = 21;
+    EXPECT_EQ(CompareWithPixelPath(jpeg, components, t), 0) << "components = " << components;
+  }
+}
+
+TEST(JpegTransformLossless, CropAndFlip) {
+  for (int components : { 1, 3 }) {
+    auto jpeg = MakeJpeg(77, 53, components, false);
+    LosslessTransform t;
+    t.crop_x = 8;
+    t.crop_y = 16;
+    t.crop_width = 48;
+    t.crop_height = 37;
+    t.flip_horizontal = true;
+    // the flipped blocks are mirrored exactly, up to the rounding in the inverse DCT
+    EXPECT_LE(CompareWithPixelPath(jpeg, components, t), 1) << "components = " << components;
+  }
+}
+
+TEST(JpegTransformLossless, Subsampled) {
+  auto jpeg = MakeJpeg(96, 64, 3, true);
+  LosslessTransform t;
+  t.crop_x = 32;
+  t.crop_y = 16;
+  t.crop_width = 48;
+  t.crop_height = 32;
+  t.flip_horizontal = true;
+  // the chroma upsampling uses the neighbors from outside of the crop window
+  EXPECT_LE(CompareWithPixelPath(jpeg, 3, t), 16);
+}
+
+TEST(JpegTransformLossless, RejectsUnalignedWindow) {
+  auto jpeg = MakeJpeg(96, 64, 3, true);  // 16x16 MCU
+  std::string out;
+  LosslessTransform t;
+  t.crop_width = 32;
+  t.crop_height = 32;
+  t.crop_x = 8;
+  EXPECT_FALSE(TransformLossless(jpeg.data(), jpeg.size(), t, &out));
+  t.crop_x = 16;
+  EXPECT_TRUE(TransformLossless(jpeg.data(), jpeg.size(), t, &out));
+  t.crop_width = 40;
+  t.flip_horizontal = true;
+  EXPECT_FALSE(TransformLossless(jpeg.data(), jpeg.size(), t, &out));
+  EXPECT_TRUE(out.empty());
+  t.crop_width = 90;
+  t.flip_horizontal = false;
+  EXPECT_FALSE(TransformLossless(jpeg.data(), jpeg.size(), t, &out));  // out of range
+}
+
+TEST(JpegTransformLossless, ReusedDecompressor) {
+  auto jpeg = MakeJpeg(64, 48, 1, false);
+  Decompressor decompressor;
+  LosslessTransform t;
+  t.crop_x = 8;
+  t.crop_width = 24;
+  t.crop_height = 40;
+  std::string ref, out;
+  ASSERT_TRUE(TransformLossless(jpeg.data(), jpeg.size(), t, &ref));
+  std::string garbage = jpeg.substr(0, jpeg.size() / 3);
+  for (int i = 0; i < 3; i++) {
+    ASSERT_TRUE(TransformLossless(jpeg.data(), jpeg.size(), t, &out, &decompressor));
+    EXPECT_EQ(out, ref);
+    EXPECT_FALSE(TransformLossless(garbage.data(), garbage.size(), t, &out, &decompressor));
+  }
+}
+
+}  // namespace jpeg
+}  // namespace dali
@@ -13,6 +13,13 @@
 // limitations under the License.
 
 #include "dali/image/png.h"
+#if LIBPNG_ENABLED
+#include <png.h>
+#include <setjmp.h>
+#endif
+#include <cstring>
+#include <memory>
+#include <utility>
 
 namespace dali {
 
@@ -23,11 +30,185 @@ int ReadIntFromPNG(const uint8 *chunk) {
 }
 
 
+#if LIBPNG_ENABLED
+namespace {
+
+struct PngSource {
+  const uint8_t *data;
+  size_t size;
+  size_t pos;
+};
+
+void ReadPngData(png_structp png, png_bytep out, png_size_t n) {
+  auto *src = static_cast<PngSource *>(png_get_io_ptr(png));
+  if (n > src->size - src->pos)
+    png_error(png, "Unexpected end of PNG data");
+  std::memcpy(out, src->data + src->pos, n);
+  src->pos += n;
+}
+
+void IgnorePngWarning(png_structp, png_const_charp) {}
+
+/**
+ * @brief Decodes PNG data with libpng, converting it to 8-bit RGB, BGR or grayscale
+ *
+ * libpng reports errors with longjmp, so the functions which call it return false
+ * on error and don't create any objects with non-trivial destructors.
+ */
+class PngDecoder {
+ public:
+  PngDecoder(const uint8_t *data, size_t size) : src_{data, size, 0} {
+    png_ = png_create_read_struct(PNG_LIBPNG_VER_STRING, nullptr, nullptr, IgnorePngWarning);
+    if (png_)
+      info_ = png_create_info_struct(png_);
+  }
+
+  ~PngDecoder() {
+    png_destroy_read_struct(&png_, &info_, nullptr);
+  }
+
+  DISABLE_COPY_MOVE_ASSIGN(PngDecoder);
+
+  /**
+   * @brief Reads the header and sets up the conversion to given color space
+   *
+   * Palette and low bit depth images are expanded, 16-bit ones are stripped to 8 bits and
+   * the alpha channel is dropped - the same as in OpenCV.
+   */
+  bool ReadHeader(DALIImageType type) {
+    if (!png_ || !info_)
+      return false;
+    if (setjmp(png_jmpbuf(png_)))
+      return false;
+    png_set_read_fn(png_, &src_, ReadPngData);
+    png_read_info(png_, info_);
+
+    png_uint_32 w = 0, h = 0;
+    int bit_depth = 0, color_type = 0;
+    png_get_IHDR(png_, info_, &w, &h, &bit_depth, &color_type, nullptr, nullptr, nullptr);
+    if (bit_depth == 16)
+      png_set_strip_16(png_);
+    if (color_type == PNG_COLOR_TYPE_PALETTE)
+      png_set_palette_to_rgb(png_);
+    if (color_type == PNG_COLOR_TYPE_GRAY && bit_depth < 8)
+      png_set_expand_gray_1_2_4_to_8(png_);
+    if (color_type & PNG_COLOR_MASK_ALPHA)
+      png_set_strip_alpha(png_);
+
+    const bool is_color = (color_type & PNG_COLOR_MASK_COLOR) != 0;
+    if (type == DALI_GRAY) {
+      if (is_color)
+        png_set_rgb_to_gray_fixed(png_, 1, 29900, 58700);
+    } else {
+      if (!is_color)
+        png_set_gray_to_rgb(png_);
+      if (type == DALI_BGR)
+        png_set_bgr(png_);
+    }
+    passes = png_set_interlace_handling(png_);
+    png_read_update_info(png_, info_);
+
+    width = w;
+    height = h;
+    channels = png_get_channels(png_, info_);
+    return true;
+  }
+
+  /**
+   * @brief Decodes the region of interest to `out`
+   *
+   * Rows outside of the region are decoded to `tmp` and discarded; decoding stops after the
+   * last row of the region.
+   *
+   * @param tmp   temporary buffer; one row for non-interlaced images, the whole image otherwise
+   */
+  bool Decode(uint8_t *out, int roi_x, int roi_y, int roi_w, int roi_h, uint8_t *tmp) {
+    if (setjmp(png_jmpbuf(png_)))
+      return false;
+    const size_t row_bytes = static_cast<size_t>(width) * channels;
+    const size_t out_row_bytes = static_cast<size_t>(roi_w) * channels;
+    const size_t roi_offset = static_cast<size_t>(roi_x) * channels;
+
+    if (passes > 1) {
+      // each pass of an interlaced image updates all the rows
+      for (int pass = 0; pass < passes; pass++) {
+        for (int y = 0; y < height; y++)
+          png_read_row(png_, tmp + y * row_bytes, nullptr);
+      }
+      for (int y = 0; y < roi_h; y++)
+        std::memcpy(out + y * out_row_bytes, tmp + (roi_y + y) * row_bytes + roi_offset,
+                    out_row_bytes);
+      return true;
+    }
+
+    for (int y = 0; y < roi_y; y++)
+      png_read_row(png_, tmp, nullptr);
+    const bool full_rows = roi_w == width;
+    for (int y = 0; y < roi_h; y++) {
+      uint8_t *out_row = out + y * out_row_bytes;
+      if (full_rows) {
+        png_read_row(png_, out_row, nullptr);
+      } else {
+        png_read_row(png_, tmp, nullptr);
+        std::memcpy(out_row, tmp + roi_offset, out_row_bytes);
+      }
+    }
+    return true;
+  }
+
+  int width = 0, height = 0, channels = 0, passes = 1;
+
+ private:
+  PngSource src_;
+  png_structp png_ = nullptr;
+  png_infop info_ = nullptr;
+};
+
+}  // namespace
+#endif  // LIBPNG_ENABLED
+
 PngImage::PngImage(const uint8_t *encoded_buffer, size_t length, DALIImageType image_type) :
         GenericImage(encoded_buffer, length, image_type) {
 }
 
 
+std::pair<std::shared_ptr<uint8_t>, Image::Shape>
+PngImage::DecodeImpl(DALIImageType image_type, const uint8_t *encoded_buffer,
+                     size_t length) const {
+  auto crop_generator = GetCropWindowGenerator();
+#if LIBPNG_ENABLED
+  if (image_type == DALI_RGB || image_type == DALI_BGR || image_type == DALI_GRAY) {
+    const int C = IsColor(image_type) ? 3 : 1;
+    PngDecoder decoder(encoded_buffer, length);
+    if (decoder.ReadHeader(image_type) && decoder.channels == C) {
+      const int H = decoder.height;
+      const int W = decoder.width;
+      int roi_x = 0, roi_y = 0, roi_h = H, roi_w = W;
+      if (crop_generator) {
+        kernels::TensorShape<> shape{H, W};
+        auto crop = crop_generator(shape);
+        DALI_ENFORCE(crop.IsInRange(shape));
+        roi_y = crop.anchor[0];
+        roi_x = crop.anchor[1];
+        roi_h = crop.shape[0];
+        roi_w = crop.shape[1];
+        // the fallback must use the same window - the generator may be random
+        crop_generator = [crop](const kernels::TensorShape<> &) { return crop; };
+      }
+
+      auto decoded_image = AllocateOutput({roi_h, roi_w, C});
+      uint8_t *tmp = GetDecoderContext().Scratch(
+        static_cast<size_t>(decoder.passes > 1 ? H : 1) * W * C);
+      if (decoder.Decode(decoded_image.get(), roi_x, roi_y, roi_w, roi_h, tmp))
+        return {decoded_image, {roi_h, roi_w, C}};
+    }
+    // Failed to decode, fallback
+  }
+#endif  // LIBPNG_ENABLED
+  return DecodeOpenCv(image_type, encoded_buffer, length, crop_generator);
+}
+
+
 Image::Shape PngImage::PeekShapeImpl(const uint8_t *encoded_buffer, size_t length) const {
   DALI_ENFORCE(encoded_buffer);
   DALI_ENFORCE(length >= 16);
@@ -15,18 +15,25 @@
 #ifndef DALI_IMAGE_PNG_H_
 #define DALI_IMAGE_PNG_H_
 
+#include <memory>
+#include <utility>
 #include "dali/image/generic_image.h"
 
 namespace dali {
 
 /**
- * PNG image decoding is performed using OpenCV, thus it's the same as Generic decoding
+ * PNG images are decoded with libpng directly into the output buffer, if available.
+ * Otherwise (and for color spaces not handled by libpng), decoding is performed using OpenCV,
+ * the same as Generic decoding.
  */
 class PngImage final : public GenericImage {
  public:
   PngImage(const uint8_t *encoded_buffer, size_t length, DALIImageType image_type);
 
  private:
+  std::pair<std::shared_ptr<uint8_t>, Shape>
+  DecodeImpl(DALIImageType image_type, const uint8_t *encoded_buffer, size_t length) const override;
+
   Shape PeekShapeImpl(const uint8_t *encoded_buffer, size_t length) const override;
 };
 
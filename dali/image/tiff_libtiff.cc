@@ -306,11 +306,7 @@ TiffImage_Libtiff::DecodeImpl(DALIImageType image_type,
   }
 
   kernels::TensorShape<3> decoded_shape = {roi_h, roi_w, out_C};
-  const size_t decoded_size = volume(decoded_shape);
-  std::shared_ptr<uint8_t> decoded_img_ptr{
-    new uint8_t[decoded_size],
-    [](uint8_t* ptr){ delete [] ptr; }
-  };
+  auto decoded_img_ptr = AllocateOutput(decoded_shape);
 
   // TODO(janton): support different types in ImageDecoder
   using InType = uint8_t;
@@ -320,14 +316,12 @@ TiffImage_Libtiff::DecodeImpl(DALIImageType image_type,
   auto row_nbytes = TIFFScanlineSize(tif_.get());
   DALI_ENFORCE(row_nbytes > 0);
 
-  std::unique_ptr<InType, void(*)(void*)> row_buf{
-    static_cast<InType *>(_TIFFmalloc(row_nbytes)), _TIFFfree};
-  DALI_ENFORCE(row_buf.get() != nullptr, "Could not allocate memory");
-  memset(row_buf.get(), 0, row_nbytes);
+  InType *row_buf = GetDecoderContext().Scratch(row_nbytes);
+  memset(row_buf, 0, row_nbytes);
 
 
   const int64_t out_row_stride = roi_w * out_C;
-  InType * const row_in  = row_buf.get();
+  InType * const row_in  = row_buf;
   OutType * const img_out = decoded_img_ptr.get();
 
   // Need to read sequentially since not all the images support random access
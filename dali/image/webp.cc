@@ -0,0 +1,114 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/image/webp.h"
+#include <webp/decode.h>
+#include <cstring>
+#include <memory>
+#include "dali/core/convert.h"
+
+namespace dali {
+
+WebpImage::WebpImage(const uint8_t *encoded_buffer,
+                     size_t length,
+                     DALIImageType image_type)
+  : GenericImage(encoded_buffer, length, image_type) {
+}
+
+std::pair<std::shared_ptr<uint8_t>, Image::Shape>
+WebpImage::DecodeImpl(DALIImageType type, const uint8_t *webp, size_t length) const {
+  if (type != DALI_RGB && type != DALI_BGR && type != DALI_GRAY)
+    return GenericImage::DecodeImpl(type, webp, length);
+
+  WebPDecoderConfig config;
+  DALI_ENFORCE(WebPInitDecoderConfig(&config), "Incompatible libwebp version");
+  DALI_ENFORCE(WebPGetFeatures(webp, length, &config.input) == VP8_STATUS_OK,
+               "Cannot read WebP header");
+  const int H = config.input.height;
+  const int W = config.input.width;
+  const int c = IsColor(type) ? 3 : 1;
+
+  int roi_x = 0, roi_y = 0, roi_h = H, roi_w = W;
+  auto crop_window_generator = GetCropWindowGenerator();
+  if (crop_window_generator) {
+    kernels::TensorShape<> shape{H, W};
+    auto crop = crop_window_generator(shape);
+    DALI_ENFORCE(crop.IsInRange(shape));
+    roi_y = crop.anchor[0];
+    roi_x = crop.anchor[1];
+    roi_h = crop.shape[0];
+    roi_w = crop.shape[1];
+  }
+
+  // libwebp rounds the origin of the crop window down to even coordinates - decode
+  // the extra row and column, if necessary, and skip them when copying the output
+  const int dx = roi_x & 1;
+  const int dy = roi_y & 1;
+  const int dec_w = roi_w + dx;
+  const int dec_h = roi_h + dy;
+  if (dec_w != W || dec_h != H) {
+    config.options.use_cropping = 1;
+    config.options.crop_left = roi_x - dx;
+    config.options.crop_top = roi_y - dy;
+    config.options.crop_width = dec_w;
+    config.options.crop_height = dec_h;
+  }
+
+  auto decoded_image = AllocateOutput({roi_h, roi_w, c});
+
+  // decode directly to the output, unless it needs to be shifted or converted to grayscale
+  const bool direct = c == 3 && dx == 0 && dy == 0;
+  uint8_t *tmp = nullptr;
+  const int dec_stride = dec_w * 3;
+  auto &out_buf = config.output;
+  out_buf.colorspace = type == DALI_BGR ? MODE_BGR : MODE_RGB;
+  out_buf.is_external_memory = 1;
+  if (direct) {
+    out_buf.u.RGBA.rgba = decoded_image.get();
+  } else {
+    tmp = GetDecoderContext().Scratch(static_cast<size_t>(dec_h) * dec_stride);
+    out_buf.u.RGBA.rgba = tmp;
+  }
+  out_buf.u.RGBA.stride = dec_stride;
+  out_buf.u.RGBA.size = static_cast<size_t>(dec_h) * dec_stride;
+
+  VP8StatusCode status = WebPDecode(webp, length, &config);
+  WebPFreeDecBuffer(&out_buf);
+  DALI_ENFORCE(status == VP8_STATUS_OK,
+               "WebP decoding failed with status " + std::to_string(status));
+
+  if (!direct) {
+    for (int y = 0; y < roi_h; y++) {
+      const uint8_t *in = tmp + (y + dy) * dec_stride + dx * 3;
+      uint8_t *out = decoded_image.get() + static_cast<ptrdiff_t>(y) * roi_w * c;
+      if (c == 3) {
+        std::memcpy(out, in, roi_w * 3);
+      } else {
+        for (int x = 0; x < roi_w; x++, in += 3)
+          out[x] = ConvertSat<uint8_t>(0.299f * in[0] + 0.587f * in[1] + 0.114f * in[2]);
+      }
+    }
+  }
+
+  return {decoded_image, {roi_h, roi_w, c}};
+}
+
+Image::Shape WebpImage::PeekShapeImpl(const uint8_t *webp, size_t length) const {
+  WebPBitstreamFeatures features;
+  DALI_ENFORCE(WebPGetFeatures(webp, length, &features) == VP8_STATUS_OK,
+               "Cannot read WebP header");
+  return {features.height, features.width, features.has_alpha ? 4 : 3};
+}
+
+}  // namespace dali
@@ -0,0 +1,98 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <webp/encode.h>
+#include <cstring>
+#include <memory>
+#include <random>
+#include <vector>
+#include "dali/image/image_factory.h"
+
+namespace dali {
+
+namespace {
+
+constexpr int kH = 29, kW = 37;
+
+}  // namespace
+
+class WebpDecodeTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    std::mt19937 rng(123);
+    std::uniform_int_distribution<int> dist(0, 255);
+    rgb_.resize(kH * kW * 3);
+    for (auto &v : rgb_)
+      v = dist(rng);
+    uint8_t *encoded = nullptr;
+    size_t size = WebPEncodeLosslessRGB(rgb_.data(), kW, kH, kW * 3, &encoded);
+    ASSERT_GT(size, 0u);
+    encoded_.assign(encoded, encoded + size);
+    WebPFree(encoded);
+  }
+
+  std::unique_ptr<Image> Decode(DALIImageType type, const CropWindow &crop = {}) {
+    auto img = ImageFactory::CreateImage(encoded_.data(), encoded_.size(), type);
+    img->SetCropWindow(crop);
+    img->Decode();
+    return img;
+  }
+
+  std::vector<uint8_t> rgb_, encoded_;
+};
+
+TEST_F(WebpDecodeTest, PeekShape) {
+  auto img = ImageFactory::CreateImage(encoded_.data(), encoded_.size(), DALI_RGB);
+  auto shape = img->PeekShape();
+  EXPECT_EQ(shape[0], kH);
+  EXPECT_EQ(shape[1], kW);
+}
+
+TEST_F(WebpDecodeTest, Lossless) {
+  auto img = Decode(DALI_RGB);
+  ASSERT_EQ(img->GetShape(), Image::Shape(kH, kW, 3));
+  EXPECT_EQ(std::memcmp(img->GetImage().get(), rgb_.data(), rgb_.size()), 0);
+}
+
+TEST_F(WebpDecodeTest, Crop) {
+  // odd anchors are not directly supported by libwebp
+  for (int y0 : { 0, 3, 4 }) {
+    for (int x0 : { 0, 5, 6 }) {
+      CropWindow crop;
+      crop.anchor = { y0, x0 };
+      crop.shape = { 11, 13 };
+      auto rgb = Decode(DALI_RGB, crop);
+      auto bgr = Decode(DALI_BGR, crop);
+      auto gray = Decode(DALI_GRAY, crop);
+      ASSERT_EQ(rgb->GetShape(), Image::Shape(11, 13, 3));
+      ASSERT_EQ(gray->GetShape(), Image::Shape(11, 13, 1));
+      for (int y = 0; y < 11; y++) {
+        for (int x = 0; x < 13; x++) {
+          const uint8_t *ref = &rgb_[((y0 + y) * kW + x0 + x) * 3];
+          const uint8_t *out_rgb = rgb->GetImage().get() + (y * 13 + x) * 3;
+          const uint8_t *out_bgr = bgr->GetImage().get() + (y * 13 + x) * 3;
+          for (int c = 0; c < 3; c++) {
+            ASSERT_EQ(out_rgb[c], ref[c]) << "at " << x << ", " << y;
+            ASSERT_EQ(out_bgr[c], ref[2 - c]) << "at " << x << ", " << y;
+          }
+          float ref_gray = 0.299f * ref[0] + 0.587f * ref[1] + 0.114f * ref[2];
+          EXPECT_NEAR(gray->GetImage().get()[y * 13 + x], ref_gray, 0.5f);
+        }
+      }
+    }
+  }
+}
+
+}  // namespace dali
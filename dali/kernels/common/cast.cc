@@ -0,0 +1,333 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dali/kernels/common/cast.h"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+#if defined(__x86_64__) && defined(__GNUC__)
+#include <immintrin.h>
+#define DALI_CAST_F16C 1
+#endif
+
+#include <algorithm>
+#include <cstring>
+
+namespace dali {
+namespace kernels {
+
+namespace {
+
+// Size of the intermediate float buffer used when a conversion is done in two steps
+constexpr int kChunk = 256;
+
+inline uint32_t FloatBits(float f) {
+  uint32_t u;
+  std::memcpy(&u, &f, sizeof(u));
+  return u;
+}
+
+inline float BitsToFloat(uint32_t u) {
+  float f;
+  std::memcpy(&f, &u, sizeof(f));
+  return f;
+}
+
+/**
+ * @brief Converts float to the bits of float16, rounding to nearest even - like F16C does.
+ */
+inline uint16_t FloatToHalfBits(float value) {
+  const uint32_t kInf = 0xffu << 23;
+  const uint32_t kHalfOverflow = (127 + 16) << 23;        // 2^16
+  const uint32_t kHalfNormalMin = (127 - 14) << 23;       // 2^-14
+  // adding 0.5 (in the units of the smallest subnormal) rounds the subnormals to nearest even
+  const uint32_t kDenormMagic = ((127 - 15) + (23 - 10) + 1) << 23;
+
+  uint32_t x = FloatBits(value);
+  uint32_t sign = x & 0x80000000u;
+  x ^= sign;
+  uint16_t h;
+  if (x >= kHalfOverflow) {
+    h = x > kInf ? 0x7e00 : 0x7c00;
+  } else if (x < kHalfNormalMin) {
+    h = FloatBits(BitsToFloat(x) + BitsToFloat(kDenormMagic)) - kDenormMagic;
+  } else {
+    uint32_t mantissa_odd = (x >> 13) & 1;
+    x += (static_cast<uint32_t>(15 - 127) << 23) + 0xfff + mantissa_odd;
+    h = x >> 13;
+  }
+  return h | (sign >> 16);
+}
+
+inline uint16_t *HalfBits(float16 *ptr) {
+  static_assert(sizeof(float16) == sizeof(uint16_t), "float16 must be 16-bit");
+  return reinterpret_cast<uint16_t *>(ptr);
+}
+
+inline const uint16_t *HalfBits(const float16 *ptr) {
+  return reinterpret_cast<const uint16_t *>(ptr);
+}
+
+#if DALI_CAST_F16C
+
+bool DetectF16C() {
+  __builtin_cpu_init();
+  return __builtin_cpu_supports("avx") && __builtin_cpu_supports("f16c");
+}
+
+__attribute__((target("avx,f16c")))
+void FloatToHalfF16C(uint16_t *out, const float *in, int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm256_cvtps_ph(_mm256_loadu_ps(in + i), _MM_FROUND_TO_NEAREST_INT);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), h);
+  }
+  for (; i < n; i++)
+    out[i] = _cvtss_sh(in[i], _MM_FROUND_TO_NEAREST_INT);
+}
+
+__attribute__((target("avx,f16c")))
+void HalfToFloatF16C(float *out, const uint16_t *in, int64_t n) {
+  int64_t i = 0;
+  for (; i + 8 <= n; i += 8) {
+    __m128i h = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+    _mm256_storeu_ps(out + i, _mm256_cvtph_ps(h));
+  }
+  for (; i < n; i++)
+    out[i] = _cvtsh_ss(in[i]);
+}
+
+#else
+
+bool DetectF16C() {
+  return false;
+}
+
+#endif  // DALI_CAST_F16C
+
+bool HasF16C() {
+  static const bool has_f16c = DetectF16C();
+  return has_f16c;
+}
+
+template <typename Out, typename In>
+struct CastImpl {
+  static void Run(Out *out, const In *in, int64_t n) {
+    for (int64_t i = 0; i < n; i++)
+      out[i] = clamp<Out>(in[i]);
+  }
+};
+
+template <>
+struct CastImpl<float16, float> {
+  static void Run(float16 *out, const float *in, int64_t n) {
+#if DALI_CAST_F16C
+    if (HasF16C())
+      return FloatToHalfF16C(HalfBits(out), in, n);
+#endif
+    uint16_t *bits = HalfBits(out);
+    for (int64_t i = 0; i < n; i++)
+      bits[i] = FloatToHalfBits(in[i]);
+  }
+};
+
+template <>
+struct CastImpl<float, float16> {
+  static void Run(float *out, const float16 *in, int64_t n) {
+#if DALI_CAST_F16C
+    if (HasF16C())
+      return HalfToFloatF16C(out, HalfBits(in), n);
+#endif
+    for (int64_t i = 0; i < n; i++)
+      out[i] = static_cast<float>(in[i]);
+  }
+};
+
+template <>
+struct CastImpl<float16, float16> {
+  static void Run(float16 *out, const float16 *in, int64_t n) {
+    std::memcpy(out, in, n * sizeof(float16));
+  }
+};
+
+/**
+ * @brief Other conversions to float16 go through float
+ */
+template <typename In>
+struct CastImpl<float16, In> {
+  static void Run(float16 *out, const In *in, int64_t n) {
+    float tmp[kChunk];
+    for (int64_t start = 0; start < n; start += kChunk) {
+      int64_t count = std::min<int64_t>(kChunk, n - start);
+      CastImpl<float, In>::Run(tmp, in + start, count);
+      CastImpl<float16, float>::Run(out + start, tmp, count);
+    }
+  }
+};
+
+/**
+ * @brief Other conversions from float16 go through float - `clamp` does the same
+ */
+template <typename Out>
+struct CastImpl<Out, float16> {
+  static void Run(Out *out, const float16 *in, int64_t n) {
+    float tmp[kChunk];
+    for (int64_t start = 0; start < n; start += kChunk) {
+      int64_t count = std::min<int64_t>(kChunk, n - start);
+      CastImpl<float, float16>::Run(tmp, in + start, count);
+      CastImpl<Out, float>::Run(out + start, tmp, count);
+    }
+  }
+};
+
+#ifdef __SSE2__
+
+/**
+ * @brief Converts 4 floats to int32 with truncation and saturation
+ *
+ * Positive overflow gives 0x80000000 (like the negative one) - it's flipped to 0x7fffffff.
+ */
+inline __m128i CvtSat(__m128 v) {
+  __m128 overflow = _mm_cmpge_ps(v, _mm_set1_ps(2147483648.0f));
+  return _mm_xor_si128(_mm_cvttps_epi32(v), _mm_castps_si128(overflow));
+}
+
+template <>
+struct CastImpl<int32_t, float> {
+  static void Run(int32_t *out, const float *in, int64_t n) {
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4)
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), CvtSat(_mm_loadu_ps(in + i)));
+    for (; i < n; i++)
+      out[i] = clamp<int32_t>(in[i]);
+  }
+};
+
+template <>
+struct CastImpl<int16_t, float> {
+  static void Run(int16_t *out, const float *in, int64_t n) {
+    const __m128 lo = _mm_set1_ps(-32768.0f), hi = _mm_set1_ps(32767.0f);
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m128i a = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i), lo), hi));
+      __m128i b = _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(in + i + 4), lo), hi));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packs_epi32(a, b));
+    }
+    for (; i < n; i++)
+      out[i] = clamp<int16_t>(in[i]);
+  }
+};
+
+template <>
+struct CastImpl<uint8_t, float> {
+  static void Run(uint8_t *out, const float *in, int64_t n) {
+    const __m128 lo = _mm_setzero_ps(), hi = _mm_set1_ps(255.0f);
+    auto cvt = [&](const float *ptr) {
+      return _mm_cvttps_epi32(_mm_min_ps(_mm_max_ps(_mm_loadu_ps(ptr), lo), hi));
+    };
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m128i ab = _mm_packs_epi32(cvt(in + i), cvt(in + i + 4));
+      __m128i cd = _mm_packs_epi32(cvt(in + i + 8), cvt(in + i + 12));
+      _mm_storeu_si128(reinterpret_cast<__m128i *>(out + i), _mm_packus_epi16(ab, cd));
+    }
+    for (; i < n; i++)
+      out[i] = clamp<uint8_t>(in[i]);
+  }
+};
+
+template <>
+struct CastImpl<float, int32_t> {
+  static void Run(float *out, const int32_t *in, int64_t n) {
+    int64_t i = 0;
+    for (; i + 4 <= n; i += 4) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+      _mm_storeu_ps(out + i, _mm_cvtepi32_ps(v));
+    }
+    for (; i < n; i++)
+      out[i] = in[i];
+  }
+};
+
+template <>
+struct CastImpl<float, int16_t> {
+  static void Run(float *out, const int16_t *in, int64_t n) {
+    int64_t i = 0;
+    for (; i + 8 <= n; i += 8) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+      // sign-extend by shifting the values from the upper halves of 32-bit lanes
+      __m128i a = _mm_srai_epi32(_mm_unpacklo_epi16(v, v), 16);
+      __m128i b = _mm_srai_epi32(_mm_unpackhi_epi16(v, v), 16);
+      _mm_storeu_ps(out + i, _mm_cvtepi32_ps(a));
+      _mm_storeu_ps(out + i + 4, _mm_cvtepi32_ps(b));
+    }
+    for (; i < n; i++)
+      out[i] = in[i];
+  }
+};
+
+template <>
+struct CastImpl<float, uint8_t> {
+  static void Run(float *out, const uint8_t *in, int64_t n) {
+    const __m128i zero = _mm_setzero_si128();
+    int64_t i = 0;
+    for (; i + 16 <= n; i += 16) {
+      __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(in + i));
+      __m128i lo = _mm_unpacklo_epi8(v, zero), hi = _mm_unpackhi_epi8(v, zero);
+      _mm_storeu_ps(out + i,      _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+      _mm_storeu_ps(out + i + 4,  _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+      _mm_storeu_ps(out + i + 8,  _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+      _mm_storeu_ps(out + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+    }
+    for (; i < n; i++)
+      out[i] = in[i];
+  }
+};
+
+#endif  // __SSE2__
+
+}  // namespace
+
+template <typename Out, typename In>
+void CastBuffer(Out *out, const In *in, int64_t n) {
+  CastImpl<Out, In>::Run(out, in, n);
+}
+
+bool CastUsesF16C() {
+  return HasF16C();
+}
+
+#define DALI_INSTANTIATE_CAST_BUFFER(Out)                                            \
+  template void CastBuffer<Out, uint8_t>(Out *, const uint8_t *, int64_t);         \
+  template void CastBuffer<Out, int16_t>(Out *, const int16_t *, int64_t);         \
+  template void CastBuffer<Out, int32_t>(Out *, const int32_t *, int64_t);         \
+  template void CastBuffer<Out, int64_t>(Out *, const int64_t *, int64_t);         \
+  template void CastBuffer<Out, float16>(Out *, const float16 *, int64_t);         \
+  template void CastBuffer<Out, float>(Out *, const float *, int64_t);             \
+  template void CastBuffer<Out, double>(Out *, const double *, int64_t);           \
+  template void CastBuffer<Out, bool>(Out *, const bool *, int64_t);
+
+DALI_INSTANTIATE_CAST_BUFFER(uint8_t)
+DALI_INSTANTIATE_CAST_BUFFER(int16_t)
+DALI_INSTANTIATE_CAST_BUFFER(int32_t)
+DALI_INSTANTIATE_CAST_BUFFER(int64_t)
+DALI_INSTANTIATE_CAST_BUFFER(float16)
+DALI_INSTANTIATE_CAST_BUFFER(float)
+DALI_INSTANTIATE_CAST_BUFFER(double)
+DALI_INSTANTIATE_CAST_BUFFER(bool)
+
+}  // namespace kernels
+}  // namespace dali
@@ -0,0 +1,49 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_KERNELS_COMMON_CAST_H_
+#define DALI_KERNELS_COMMON_CAST_H_
+
+#include <cstdint>
+#include "dali/core/common.h"
+#include "dali/core/convert.h"
+#include "dali/core/float16.h"
+
+namespace dali {
+namespace kernels {
+
+/**
+ * @brief Converts `n` values from `in` to `out`, with the semantics of `clamp<Out>`:
+ * values are saturated to the range of `Out` and floating point values converted to
+ * integers are truncated towards zero.
+ *
+ * Conversions to float16 go through float and round to nearest, ties to even - like F16C
+ * and the GPU do. Common pairs of types use SIMD; F16C is used when the CPU supports it,
+ * regardless of the compilation flags.
+ *
+ * Defined for all the pairs of types of `DALI_TYPE_SWITCH_WITH_FP16`.
+ */
+template <typename Out, typename In>
+DLL_PUBLIC void CastBuffer(Out *out, const In *in, int64_t n);
+
+/**
+ * @brief Tells whether the float <-> float16 conversions are done with F16C
+ */
+DLL_PUBLIC bool CastUsesF16C();
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_COMMON_CAST_H_
@@ -0,0 +1,166 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <cstring>
+#include <limits>
+#include <memory>
+#include <random>
+#include <vector>
+#include "dali/kernels/common/cast.h"
+
+namespace dali {
+namespace kernels {
+
+namespace {
+
+template <typename Out, typename In>
+void CheckSameAsClamp(const std::vector<In> &in) {
+  // not std::vector, which is specialized for bool
+  std::unique_ptr<Out[]> out(new Out[in.size()]);
+  CastBuffer(out.get(), in.data(), in.size());
+  for (size_t i = 0; i < in.size(); i++) {
+    ASSERT_EQ(out[i], clamp<Out>(in[i])) << "at " << i << " for " << in[i];
+  }
+}
+
+// covers the whole range of the output type, and beyond
+std::vector<float> TestFloats(float lo, float hi, int n = 1000 + 7) {
+  std::mt19937 rng(1234);
+  std::uniform_real_distribution<float> dist(lo, hi);
+  std::vector<float> values(n);
+  for (auto &v : values)
+    v = dist(rng);
+  values[0] = lo;
+  values[1] = hi;
+  values[2] = -0.5f;
+  values[3] = 0.99f;
+  return values;
+}
+
+template <typename T>
+std::vector<T> TestInts(int n = 1000 + 7) {
+  std::mt19937 rng(4321);
+  std::uniform_int_distribution<int64_t> dist(min_value<T>(), max_value<T>());
+  std::vector<T> values(n);
+  for (auto &v : values)
+    v = static_cast<T>(dist(rng));
+  values[0] = min_value<T>();
+  values[1] = max_value<T>();
+  return values;
+}
+
+uint16_t Bits(float16 h) {
+  uint16_t bits;
+  std::memcpy(&bits, &h, sizeof(bits));
+  return bits;
+}
+
+float16 FromBits(uint16_t bits) {
+  float16 h;
+  std::memcpy(&h, &bits, sizeof(bits));
+  return h;
+}
+
+}  // namespace
+
+TEST(CastBuffer, FloatToInt) {
+  CheckSameAsClamp<uint8_t>(TestFloats(-300, 300));
+  CheckSameAsClamp<int16_t>(TestFloats(-40000, 40000));
+  CheckSameAsClamp<int32_t>(TestFloats(-3e9f, 3e9f));
+  CheckSameAsClamp<int64_t>(TestFloats(-1e19f, 1e19f));
+  CheckSameAsClamp<bool>(TestFloats(-2, 2));
+}
+
+TEST(CastBuffer, IntToFloat) {
+  CheckSameAsClamp<float>(TestInts<uint8_t>());
+  CheckSameAsClamp<float>(TestInts<int16_t>());
+  CheckSameAsClamp<float>(TestInts<int32_t>());
+  CheckSameAsClamp<float>(TestInts<int64_t>());
+  CheckSameAsClamp<double>(TestInts<int32_t>());
+}
+
+TEST(CastBuffer, IntToInt) {
+  CheckSameAsClamp<uint8_t>(TestInts<int16_t>());
+  CheckSameAsClamp<int16_t>(TestInts<int64_t>());
+  CheckSameAsClamp<int32_t>(TestInts<uint8_t>());
+  CheckSameAsClamp<int64_t>(TestInts<int32_t>());
+}
+
+TEST(CastBuffer, HalfRoundTrip) {
+  std::vector<float16> halves;
+  for (int bits = 0; bits < 0x10000; bits++) {
+    // skip NaNs
+    if ((bits & 0x7c00) != 0x7c00 || (bits & 0x3ff) == 0)
+      halves.push_back(FromBits(bits));
+  }
+  std::vector<float> floats(halves.size());
+  CastBuffer(floats.data(), halves.data(), halves.size());
+  std::vector<float16> back(halves.size());
+  CastBuffer(back.data(), floats.data(), floats.size());
+  for (size_t i = 0; i < halves.size(); i++) {
+    ASSERT_EQ(floats[i], static_cast<float>(halves[i]));
+    ASSERT_EQ(Bits(back[i]), Bits(halves[i])) << floats[i];
+  }
+}
+
+TEST(CastBuffer, FloatToHalfRounding) {
+  const float eps = std::ldexp(1.0f, -10);  // spacing of halves in [1, 2)
+  std::vector<float> in = {
+    1 + eps / 2,          // tie, rounds to even: 1
+    1 + 3 * eps / 2,      // tie, rounds to even: 1 + 2 eps
+    1 + eps / 2 + 1e-6f,  // above the tie
+    65504, 65519, 65520, 1e10f, -1e10f,
+    std::ldexp(1.0f, -25),  // half of the smallest subnormal - tie, rounds to 0
+    std::ldexp(3.0f, -25),  // 1.5 smallest subnormal - tie, rounds to 2
+    std::numeric_limits<float>::infinity(), std::nanf(""),
+  };
+  std::vector<float16> out(in.size());
+  CastBuffer(out.data(), in.data(), in.size());
+  std::vector<float> result(out.size());
+  CastBuffer(result.data(), out.data(), out.size());
+  EXPECT_EQ(result[0], 1.0f);
+  EXPECT_EQ(result[1], 1 + 2 * eps);
+  EXPECT_EQ(result[2], 1 + eps);
+  EXPECT_EQ(result[3], 65504.0f);
+  EXPECT_EQ(result[4], 65504.0f);
+  EXPECT_EQ(result[5], std::numeric_limits<float>::infinity());
+  EXPECT_EQ(result[6], std::numeric_limits<float>::infinity());
+  EXPECT_EQ(result[7], -std::numeric_limits<float>::infinity());
+  EXPECT_EQ(result[8], 0.0f);
+  EXPECT_EQ(result[9], std::ldexp(2.0f, -24));
+  EXPECT_EQ(result[10], std::numeric_limits<float>::infinity());
+  EXPECT_TRUE(std::isnan(result[11]));
+}
+
+TEST(CastBuffer, ThroughHalf) {
+  // integers and halves which are exactly representable in both types
+  auto ints = TestInts<uint8_t>();
+  std::vector<float16> halves(ints.size());
+  CastBuffer(halves.data(), ints.data(), ints.size());
+  for (size_t i = 0; i < ints.size(); i++)
+    ASSERT_EQ(static_cast<float>(halves[i]), ints[i]);
+
+  std::vector<float> floats = TestFloats(-300, 300);
+  std::vector<float16> in(floats.size());
+  CastBuffer(in.data(), floats.data(), floats.size());
+  CheckSameAsClamp<uint8_t>(in);
+  CheckSameAsClamp<int32_t>(in);
+  CheckSameAsClamp<double>(in);
+}
+
+}  // namespace kernels
+}  // namespace dali
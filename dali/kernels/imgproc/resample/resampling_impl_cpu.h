@@ -109,14 +109,44 @@ void ResampleHorz_Channels(
   }
 }
 
+/**
+ * @brief Calculates one output row of vertical resampling
+ *
+ * @param out_row     output row
+ * @param in_rows     pointers to the `support` input rows contributing to the output row
+ * @param coeffs      `support` filter coefficients
+ * @param flat_w      row width, in elements (width * channels)
+ */
 template <typename Out, typename In>
-void ResampleVert(
-    Surface2D<Out> out, Surface2D<In> in, const int32_t *in_rows,
-    const float *row_coeffs, int support) {
+void ResampleVertRow(Out *out_row, const In *const *in_rows, const float *coeffs,
+                     int support, int flat_w) {
   constexpr float bias = std::is_integral<Out>::value ? 0.5f : 0;
   constexpr int tile = 64;
   float tmp[tile];  // NOLINT
 
+  for (int x0 = 0; x0 < flat_w; x0 += tile) {
+    int tile_w = x0 + tile <= flat_w ? tile : flat_w - x0;
+    assert(tile_w <= tile);
+    for (int j = 0; j < tile_w; j++)
+      tmp[j] = bias;
+
+    for (int k = 0; k < support; k++) {
+      float flt = coeffs[k];
+      const In *in_row = in_rows[k];
+      for (int j = 0; j < tile_w; j++) {
+        tmp[j] += flt * in_row[x0 + j];
+      }
+    }
+
+    for (int j = 0; j < tile_w; j++)
+      out_row[x0 + j] = clamp<Out>(tmp[j]);
+  }
+}
+
+template <typename Out, typename In>
+void ResampleVert(
+    Surface2D<Out> out, Surface2D<In> in, const int32_t *in_rows,
+    const float *row_coeffs, int support) {
   int flat_w = out.width * out.channels;
 
   assert(support > 0);
@@ -132,23 +162,7 @@ void ResampleVert(
       in_row_ptrs[k] = &in(0, sy);
     }
 
-    for (int x0 = 0; x0 < flat_w; x0 += tile) {
-      int tile_w = x0 + tile <= flat_w ? tile : flat_w - x0;
-      assert(tile_w <= tile);
-      for (int j = 0; j < tile_w; j++)
-        tmp[j] = bias;
-
-      for (int k = 0; k < support; k++) {
-        float flt = row_coeffs[y * support + k];
-        const In *in_row = in_row_ptrs[k];
-        for (int j = 0; j < tile_w; j++) {
-          tmp[j] += flt * in_row[x0 + j];
-        }
-      }
-
-      for (int j = 0; j < tile_w; j++)
-        out_row[x0 + j] = clamp<Out>(tmp[j]);
-    }
+    ResampleVertRow(out_row, in_row_ptrs, row_coeffs + y * support, support, flat_w);
   }
 }
 
@@ -0,0 +1,182 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_RESAMPLE_STREAMING_CPU_H_
+#define DALI_KERNELS_IMGPROC_RESAMPLE_STREAMING_CPU_H_
+
+#include <algorithm>
+#include <cmath>
+#include "dali/core/error_handling.h"
+#include "dali/kernels/kernel.h"
+#include "dali/kernels/imgproc/resample/separable_cpu.h"
+
+namespace dali {
+namespace kernels {
+
+/**
+ * @brief Resamples an image which is delivered row by row, e.g. by a decoder
+ *
+ * The horizontal pass is applied to each input row as it arrives and only as many
+ * horizontally resampled rows as the vertical filter needs are kept, in a ring buffer.
+ * Output rows are produced as soon as all their input rows are available.
+ * Memory use is proportional to the output width and the vertical filter support,
+ * not to the input size.
+ *
+ * The results are the same as those of SeparableResampleCPU with the horizontal pass
+ * done first.
+ *
+ * Usage: Setup, Start, then PushRow for each input row, top to bottom.
+ */
+template <typename OutputElement, typename InputElement>
+class StreamingResampleCPU {
+ public:
+  KernelRequirements Setup(KernelContext &context,
+                           const TensorShape<3> &in_shape,
+                           const ResamplingParams2D &params) {
+    DALI_ENFORCE(!params[0].roi.use_roi && !params[1].roi.use_roi,
+                 "Streaming resampling does not support ROI");
+    setup_.Setup(in_shape, params);
+    auto &desc = setup_.desc;
+    in_h_ = in_shape[0];
+    in_w_ = in_shape[1];
+    channels_ = in_shape[2];
+    out_h_ = desc.out_shape()[0];
+    out_w_ = desc.out_shape()[1];
+    support_[0] = Support(0);
+    support_[1] = Support(1);
+
+    ScratchpadEstimator se;
+    se.add<int32_t>(AllocType::Host, out_h_ + out_w_);
+    se.add<float>(AllocType::Host, out_h_ * support_[0] + out_w_ * support_[1]);
+    se.add<float>(AllocType::Host, RingRows() * out_w_ * channels_);
+    se.add<const float *>(AllocType::Host, support_[0]);
+
+    KernelRequirements req;
+    req.output_shapes = { TensorListShape<>({ TensorShape<>(out_h_, out_w_, channels_) }) };
+    req.scratch_sizes = se.sizes;
+    return req;
+  }
+
+  /**
+   * @brief Prepares the filters and the ring buffer
+   *
+   * @param output  the output image; must have the shape returned by Setup and remain valid
+   *                until all the input rows are pushed
+   */
+  void Start(KernelContext &context, const OutTensorCPU<OutputElement, 3> &output) {
+    out_ = output.data;
+    auto &scratch = *context.scratchpad;
+    int32_t *indices = scratch.Allocate<int32_t>(AllocType::Host, out_h_ + out_w_);
+    float *coeffs = scratch.Allocate<float>(AllocType::Host,
+                                            out_h_ * support_[0] + out_w_ * support_[1]);
+    ring_ = scratch.Allocate<float>(AllocType::Host, RingRows() * out_w_ * channels_);
+    row_ptrs_ = scratch.Allocate<const float *>(AllocType::Host, support_[0]);
+
+    indices_[0] = indices;
+    indices_[1] = indices + out_h_;
+    coeffs_[0] = coeffs;
+    coeffs_[1] = coeffs + out_h_ * support_[0];
+    InitFilter(0);
+    InitFilter(1);
+    rows_pushed_ = 0;
+    next_out_row_ = 0;
+  }
+
+  /**
+   * @brief Passes the next input row to the resampler
+   *
+   * @param row   `width * channels` elements of the input row; can be reused by the caller
+   *              after the function returns
+   */
+  void PushRow(const InputElement *row) {
+    assert(rows_pushed_ < in_h_);
+    int r = rows_pushed_++;
+    Surface2D<float> tmp = {
+      RingRow(r), out_w_, 1, channels_, channels_, out_w_ * channels_, 1
+    };
+    Surface2D<const InputElement> in = {
+      row, in_w_, 1, channels_, channels_, in_w_ * channels_, 1
+    };
+    ResampleHorz(tmp, in, indices_[1], coeffs_[1], support_[1]);
+    EmitRows(r);
+  }
+
+  int rows_pushed() const { return rows_pushed_; }
+
+  /// Tells whether all the output rows have been calculated
+  bool Done() const { return next_out_row_ == out_h_; }
+
+ private:
+  int Support(int axis) const {
+    auto &filter = setup_.desc.filter[axis];
+    return filter.num_coeffs ? filter.support() : 1;
+  }
+
+  int RingRows() const { return support_[0]; }
+
+  float *RingRow(int r) {
+    return ring_ + (r % RingRows()) * out_w_ * channels_;
+  }
+
+  void InitFilter(int axis) {
+    auto &desc = setup_.desc;
+    int out_size = axis == 0 ? out_h_ : out_w_;
+    if (desc.filter[axis].num_coeffs) {
+      InitializeResamplingFilter(indices_[axis], coeffs_[axis], out_size,
+                                 desc.origin[axis], desc.scale[axis], desc.filter[axis]);
+    } else {
+      // nearest neighbor - a single tap filter, same source index as in ResampleNN
+      int in_size = axis == 0 ? in_h_ : in_w_;
+      for (int i = 0; i < out_size; i++) {
+        int src = std::floor(desc.origin[axis] + (i + 0.5f) * desc.scale[axis]);
+        indices_[axis][i] = std::max(0, std::min(in_size - 1, src));
+        coeffs_[axis][i] = 1;
+      }
+    }
+  }
+
+  /// Calculates all the output rows which depend only on input rows up to `last_row`
+  void EmitRows(int last_row) {
+    const int support = support_[0];
+    const int flat_w = out_w_ * channels_;
+    for (; next_out_row_ < out_h_; next_out_row_++) {
+      int y = next_out_row_;
+      int first = indices_[0][y];
+      int last = std::max(0, std::min(in_h_ - 1, first + support - 1));
+      if (last > last_row)
+        break;
+      for (int k = 0; k < support; k++) {
+        int sy = std::max(0, std::min(in_h_ - 1, first + k));
+        row_ptrs_[k] = RingRow(sy);
+      }
+      ResampleVertRow(out_ + static_cast<ptrdiff_t>(y) * flat_w, row_ptrs_,
+                      coeffs_[0] + y * support, support, flat_w);
+    }
+  }
+
+  ResamplingSetupSingleImage setup_;
+  int in_h_ = 0, in_w_ = 0, channels_ = 0, out_h_ = 0, out_w_ = 0;
+  int support_[2] = { 1, 1 };
+  int32_t *indices_[2] = { nullptr, nullptr };
+  float *coeffs_[2] = { nullptr, nullptr };
+  float *ring_ = nullptr;
+  const float **row_ptrs_ = nullptr;
+  OutputElement *out_ = nullptr;
+  int rows_pushed_ = 0, next_out_row_ = 0;
+};
+
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_RESAMPLE_STREAMING_CPU_H_
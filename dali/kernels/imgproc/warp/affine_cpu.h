@@ -0,0 +1,256 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_KERNELS_IMGPROC_WARP_AFFINE_CPU_H_
+#define DALI_KERNELS_IMGPROC_WARP_AFFINE_CPU_H_
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <utility>
+#include "dali/core/common.h"
+#include "dali/core/convert.h"
+#include "dali/core/geom/vec.h"
+#include "dali/kernels/imgproc/surface.h"
+#include "dali/kernels/imgproc/warp/affine.h"
+
+namespace dali {
+namespace kernels {
+namespace warp {
+
+/**
+ * @brief Source coordinates along one output row of a 2D affine warp
+ *
+ * The per-row part of the mapping is computed once, so that each pixel costs one
+ * multiply-add per coordinate. The result is bit-exact with `map_coords(mapping, ivec2(x, y))`.
+ */
+struct AffineRowMapping {
+  AffineRowMapping(const AffineMapping2D &mapping, int y) {
+    const auto &m = mapping.transform;
+    m00 = m(0, 0);
+    m10 = m(1, 0);
+    row_x = (y + 0.5f) * m(0, 1);
+    row_y = (y + 0.5f) * m(1, 1);
+    tx = m(0, 2);
+    ty = m(1, 2);
+  }
+
+  inline vec2 operator()(int x) const {
+    float fx = x + 0.5f;
+    return { tx + (fx * m00 + row_x), ty + (fx * m10 + row_y) };
+  }
+
+  float m00, m10, row_x, row_y, tx, ty;
+};
+
+/**
+ * @brief Tells whether all the source pixels needed to sample at `src` lie inside the image
+ */
+template <DALIInterpType interp>
+inline bool SampleInside(vec2 src, int in_w, int in_h);
+
+template <>
+inline bool SampleInside<DALI_INTERP_NN>(vec2 src, int in_w, int in_h) {
+  return src.x >= 0 && src.x < in_w && src.y >= 0 && src.y < in_h;
+}
+
+template <>
+inline bool SampleInside<DALI_INTERP_LINEAR>(vec2 src, int in_w, int in_h) {
+  // same offset as in the linear Sampler; the neighbor at x0+1, y0+1 must be inside, too
+  float x = src.x - 0.5f;
+  float y = src.y - 0.5f;
+  return x >= 0 && x < in_w - 1 && y >= 0 && y < in_h - 1;
+}
+
+/**
+ * @brief Calculates the range [begin, end) of output x coordinates in the row for which
+ *        no border handling is necessary.
+ *
+ * The source coordinates are monotonic along the row, so the pixels that sample only
+ * the inside of the image form a single span. The span is estimated analytically
+ * and then its ends are adjusted with exact checks.
+ */
+template <DALIInterpType interp>
+std::pair<int, int> InsideSpan(const AffineRowMapping &row, int out_w, int in_w, int in_h) {
+  auto inside = [&](int x) {
+    return SampleInside<interp>(row(x), in_w, in_h);
+  };
+  const float margin = interp == DALI_INTERP_LINEAR ? 0.5f : 0.0f;
+  double lo = 0, hi = out_w;
+  // restrict [lo, hi) to solutions of: min <= coord0 + x * step < max
+  auto restrict = [&](double coord0, double step, double min, double max) {
+    if (std::abs(step) < 1e-12) {
+      if (coord0 < min || coord0 >= max)
+        hi = lo;
+      return;
+    }
+    double x0 = (min - coord0) / step;
+    double x1 = (max - coord0) / step;
+    if (x0 > x1)
+      std::swap(x0, x1);
+    lo = std::max(lo, x0);
+    hi = std::min(hi, x1);
+  };
+  vec2 origin = row(0);
+  restrict(origin.x - 0.5 * row.m00, row.m00, margin, in_w - margin);
+  restrict(origin.y - 0.5 * row.m10, row.m10, margin, in_h - margin);
+  if (!(lo < hi))
+    return { 0, 0 };
+
+  int begin = std::max(0, static_cast<int>(std::ceil(lo)));
+  int end = std::min(out_w, static_cast<int>(std::floor(hi)) + 1);
+  while (begin < end && !inside(begin))
+    begin++;
+  while (begin > 0 && inside(begin - 1))
+    begin--;
+  while (end > begin && !inside(end - 1))
+    end--;
+  while (end < out_w && end > begin && inside(end))
+    end++;
+  if (begin >= end)
+    return { 0, 0 };
+  return { begin, end };
+}
+
+/**
+ * @brief Bilinear interpolation of one pixel, all the neighbors inside the image.
+ *
+ * Same arithmetic as the linear Sampler.
+ */
+template <int static_channels, typename Out, typename In>
+inline void BlendPixel(Out *out, const In *p00, int pixel_stride, int row_stride, int channels,
+                       float qx, float qy) {
+  const int C = static_channels > 0 ? static_channels : channels;
+  const In *p01 = p00 + pixel_stride;
+  const In *p10 = p00 + row_stride;
+  const In *p11 = p10 + pixel_stride;
+  float px = 1 - qx;
+  for (int c = 0; c < C; c++) {
+    float s0 = p00[c] * px + p01[c] * qx;
+    float s1 = p10[c] * px + p11[c] * qx;
+    out[c] = ConvertSat<Out>(s0 + (s1 - s0) * qy);
+  }
+}
+
+#ifdef __SSE2__
+
+template <int channels>
+inline __m128 LoadPixelPS(const uint8_t *p) {
+  static_assert(channels >= 1 && channels <= 4, "Only up to 4 channels supported");
+  uint32_t bytes = 0;
+  if (channels == 4) {
+    std::memcpy(&bytes, p, 4);
+  } else {
+    for (int c = 0; c < channels; c++)
+      bytes |= static_cast<uint32_t>(p[c]) << (8 * c);
+  }
+  __m128i zero = _mm_setzero_si128();
+  __m128i v = _mm_unpacklo_epi8(_mm_cvtsi32_si128(static_cast<int32_t>(bytes)), zero);
+  return _mm_cvtepi32_ps(_mm_unpacklo_epi16(v, zero));
+}
+
+/**
+ * @brief Bilinear interpolation of all channels of a uint8 pixel at once.
+ *
+ * The result is rounded half up, which, for non-negative values, is the same as
+ * the rounding in ConvertSat.
+ */
+template <int channels>
+inline void BlendPixelU8(uint8_t *out, const uint8_t *p00, int pixel_stride, int row_stride,
+                         float qx, float qy) {
+  const uint8_t *p10 = p00 + row_stride;
+  __m128 s00 = LoadPixelPS<channels>(p00);
+  __m128 s01 = LoadPixelPS<channels>(p00 + pixel_stride);
+  __m128 s10 = LoadPixelPS<channels>(p10);
+  __m128 s11 = LoadPixelPS<channels>(p10 + pixel_stride);
+  __m128 vqx = _mm_set1_ps(qx);
+  __m128 vpx = _mm_set1_ps(1 - qx);
+  __m128 s0 = _mm_add_ps(_mm_mul_ps(s00, vpx), _mm_mul_ps(s01, vqx));
+  __m128 s1 = _mm_add_ps(_mm_mul_ps(s10, vpx), _mm_mul_ps(s11, vqx));
+  __m128 r = _mm_add_ps(s0, _mm_mul_ps(_mm_sub_ps(s1, s0), _mm_set1_ps(qy)));
+  // adding 0.5 before truncation could round up values just below 0.5 - compare the fraction
+  __m128i i = _mm_cvttps_epi32(r);
+  __m128 frac = _mm_sub_ps(r, _mm_cvtepi32_ps(i));
+  i = _mm_sub_epi32(i, _mm_castps_si128(_mm_cmpge_ps(frac, _mm_set1_ps(0.5f))));
+  i = _mm_packs_epi32(i, i);
+  i = _mm_packus_epi16(i, i);
+  uint32_t bytes = static_cast<uint32_t>(_mm_cvtsi128_si32(i));
+  if (channels == 4) {
+    std::memcpy(out, &bytes, 4);
+  } else {
+    for (int c = 0; c < channels; c++)
+      out[c] = static_cast<uint8_t>(bytes >> (8 * c));
+  }
+}
+
+template <>
+inline void BlendPixel<3, uint8_t, uint8_t>(uint8_t *out, const uint8_t *p00, int pixel_stride,
+                                            int row_stride, int, float qx, float qy) {
+  BlendPixelU8<3>(out, p00, pixel_stride, row_stride, qx, qy);
+}
+
+template <>
+inline void BlendPixel<4, uint8_t, uint8_t>(uint8_t *out, const uint8_t *p00, int pixel_stride,
+                                            int row_stride, int, float qx, float qy) {
+  BlendPixelU8<4>(out, p00, pixel_stride, row_stride, qx, qy);
+}
+
+#endif  // __SSE2__
+
+/**
+ * @brief Warps the span [begin, end) of an output row, for which all the samples are
+ *        known to be inside the input image (see InsideSpan).
+ *
+ * The source coordinates are calculated for blocks of pixels in a vectorizable loop;
+ * then the pixels are gathered without border checks.
+ */
+template <DALIInterpType interp, int static_channels, typename Out, typename In>
+void WarpAffineSpan(Out *out_row, int out_pixel_stride, const Surface2D<const In> &in,
+                    const AffineRowMapping &row, int begin, int end) {
+  constexpr int kBlock = 16;
+  const int C = static_channels > 0 ? static_channels : in.channels;
+  const float offset = interp == DALI_INTERP_LINEAR ? 0.5f : 0.0f;
+  float src_x[kBlock], src_y[kBlock];
+  for (int block_start = begin; block_start < end; block_start += kBlock) {
+    int n = std::min(kBlock, end - block_start);
+    for (int i = 0; i < n; i++) {
+      float fx = block_start + i + 0.5f;
+      src_x[i] = row.tx + (fx * row.m00 + row.row_x) - offset;
+      src_y[i] = row.ty + (fx * row.m10 + row.row_y) - offset;
+    }
+    Out *out = out_row + block_start * out_pixel_stride;
+    for (int i = 0; i < n; i++, out += out_pixel_stride) {
+      // coordinates are non-negative, so truncation is the same as floor
+      int x0 = static_cast<int>(src_x[i]);
+      int y0 = static_cast<int>(src_y[i]);
+      const In *p00 = in.data + y0 * in.row_stride + x0 * in.pixel_stride;
+      if (interp == DALI_INTERP_LINEAR) {
+        BlendPixel<static_channels>(out, p00, in.pixel_stride, in.row_stride, C,
+                                    src_x[i] - x0, src_y[i] - y0);
+      } else {
+        for (int c = 0; c < C; c++)
+          out[c] = ConvertSat<Out>(p00[c]);
+      }
+    }
+  }
+}
+
+}  // namespace warp
+}  // namespace kernels
+}  // namespace dali
+
+#endif  // DALI_KERNELS_IMGPROC_WARP_AFFINE_CPU_H_
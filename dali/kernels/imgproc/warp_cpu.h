@@ -21,6 +21,8 @@
 #include "dali/kernels/kernel.h"
 #include "dali/kernels/imgproc/warp/mapping_traits.h"
 #include "dali/kernels/imgproc/sampler.h"
+#include "dali/kernels/imgproc/warp/affine.h"
+#include "dali/kernels/imgproc/warp/affine_cpu.h"
 #include "dali/kernels/imgproc/warp/map_coords.h"
 
 namespace dali {
@@ -32,6 +34,10 @@ namespace kernels {
  * The warping uses a mapping functor to map destination coordinates to source
  * coordinates and samples the source tensor at the resulting locations.
  *
+ * Affine mappings use a specialized implementation, which steps the source coordinates
+ * along output rows and samples the part of each row which lies entirely inside the
+ * input image without border handling.
+ *
  * @remarks
  *  * Assumes HWC layout
  *  * Output and input have same number of spatial dimenions
@@ -113,13 +119,47 @@ class WarpCPU {
 
     Sampler<static_interp, InputType> sampler(in);
 
-    for (int y = 0; y < out_h; y++) {
-      for (int x = 0; x < out_w; x++) {
+    WarpRows(out, in, sampler, mapping, border);
+  }
+
+  template <typename AnyMapping, typename SamplerType>
+  void WarpRows(
+      const Surface2D<OutputType> &out,
+      const Surface2D<const InputType> &in,
+      const SamplerType &sampler,
+      const AnyMapping &mapping,
+      const BorderType &border) {
+    for (int y = 0; y < out.height; y++) {
+      for (int x = 0; x < out.width; x++) {
         auto src = warp::map_coords(mapping, ivec2(x, y));
         sampler(&out(x, y), src, border);
       }
     }
   }
+
+  template <DALIInterpType static_interp>
+  void WarpRows(
+      const Surface2D<OutputType> &out,
+      const Surface2D<const InputType> &in,
+      const Sampler<static_interp, InputType> &sampler,
+      const AffineMapping2D &mapping,
+      const BorderType &border) {
+    for (int y = 0; y < out.height; y++) {
+      warp::AffineRowMapping row(mapping, y);
+      auto span = warp::InsideSpan<static_interp>(row, out.width, in.width, in.height);
+      for (int x = 0; x < span.first; x++)
+        sampler(&out(x, y), row(x), border);
+      OutputType *out_row = &out(0, y);
+      VALUE_SWITCH(in.channels, static_channels, (1, 2, 3, 4),
+        (warp::WarpAffineSpan<static_interp, static_channels>(
+          out_row, out.pixel_stride, in, row, span.first, span.second);),
+        (warp::WarpAffineSpan<static_interp, -1>(
+          out_row, out.pixel_stride, in, row, span.first, span.second);)
+      );  // NOLINT
+      for (int x = span.second; x < out.width; x++)
+        sampler(&out(x, y), row(x), border);
+    }
+  }
 };
 
 }  // namespace kernels
@@ -15,6 +15,12 @@
 #ifndef DALI_KERNELS_SLICE_SLICE_CPU_H_
 #define DALI_KERNELS_SLICE_SLICE_CPU_H_
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <algorithm>
+#include <cstring>
+#include <type_traits>
 #include <vector>
 #include <utility>
 #include "dali/kernels/slice/slice_kernel_utils.h"
@@ -28,31 +34,161 @@ namespace kernels {
 
 namespace detail {
 
-template <typename OutputType, typename InputType, std::size_t Dims>
-void SliceKernelImpl(OutputType *output,
-                     const InputType *input,
-                     const std::array<int64_t, Dims> &in_strides,
-                     const std::array<int64_t, Dims> &out_strides,
-                     const TensorShape<static_cast<int>(Dims)> &out_shape,
-                     std::integral_constant<size_t, 1>) {
-  for (int i = 0; i < out_shape[Dims - 1]; i++) {
-    output[i] = clamp<OutputType>(input[i]);
+/**
+ * @brief Copies a contiguous run of `n` elements, converting them to the output type
+ */
+template <typename OutputType, typename InputType>
+inline void SliceCopyRun(OutputType *output, const InputType *input, int64_t n) {
+  if (std::is_same<OutputType, InputType>::value) {
+    std::memcpy(output, input, n * sizeof(OutputType));
+  } else {
+    for (int64_t i = 0; i < n; i++)
+      output[i] = clamp<OutputType>(input[i]);
+  }
+}
+
+#ifdef __SSE2__
+
+template <>
+inline void SliceCopyRun(float *output, const uint8_t *input, int64_t n) {
+  __m128i zero = _mm_setzero_si128();
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(input + i));
+    __m128i lo = _mm_unpacklo_epi8(v, zero);
+    __m128i hi = _mm_unpackhi_epi8(v, zero);
+    _mm_storeu_ps(output + i,      _mm_cvtepi32_ps(_mm_unpacklo_epi16(lo, zero)));
+    _mm_storeu_ps(output + i + 4,  _mm_cvtepi32_ps(_mm_unpackhi_epi16(lo, zero)));
+    _mm_storeu_ps(output + i + 8,  _mm_cvtepi32_ps(_mm_unpacklo_epi16(hi, zero)));
+    _mm_storeu_ps(output + i + 12, _mm_cvtepi32_ps(_mm_unpackhi_epi16(hi, zero)));
+  }
+  for (; i < n; i++)
+    output[i] = input[i];
+}
+
+template <>
+inline void SliceCopyRun(uint8_t *output, const float *input, int64_t n) {
+  // same as clamp<uint8_t>: saturate to [0, 255], then truncate
+  __m128 lo = _mm_setzero_ps();
+  __m128 hi = _mm_set1_ps(255.0f);
+  auto convert4 = [&](const float *in) {
+    return _mm_cvttps_epi32(_mm_max_ps(_mm_min_ps(_mm_loadu_ps(in), hi), lo));
+  };
+  int64_t i = 0;
+  for (; i + 16 <= n; i += 16) {
+    __m128i a = _mm_packs_epi32(convert4(input + i), convert4(input + i + 4));
+    __m128i b = _mm_packs_epi32(convert4(input + i + 8), convert4(input + i + 12));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(output + i), _mm_packus_epi16(a, b));
+  }
+  for (; i < n; i++)
+    output[i] = clamp<uint8_t>(input[i]);
+}
+
+#endif  // __SSE2__
+
+/**
+ * @brief Slice with the dimensions collapsed as much as possible
+ *
+ * Adjacent dimensions are merged when the slice spans the whole extent of the inner one
+ * (so that they are contiguous in both input and output) and the dimensions of extent 1
+ * are dropped. The innermost dimension is a contiguous run in both input and output.
+ */
+template <size_t Dims>
+struct CollapsedSlice {
+  int ndim = 0;
+  /// offset of the first sliced element in the input
+  int64_t in_offset = 0;
+  std::array<int64_t, Dims> shape, in_strides, out_strides;
+
+  int64_t run_length() const {
+    return ndim > 0 ? shape[ndim - 1] : 1;
+  }
+
+  /// number of contiguous runs
+  int64_t num_runs() const {
+    int64_t n = 1;
+    for (int d = 0; d < ndim - 1; d++)
+      n *= shape[d];
+    return n;
   }
+};
+
+template <size_t Dims>
+CollapsedSlice<Dims> CollapseSlice(const TensorShape<static_cast<int>(Dims)> &in_shape,
+                                   const std::array<int64_t, Dims> &anchor,
+                                   const TensorShape<static_cast<int>(Dims)> &out_shape) {
+  auto in_strides = GetStrides<Dims>(in_shape);
+  auto out_strides = GetStrides<Dims>(out_shape);
+  CollapsedSlice<Dims> slice;
+  for (size_t d = 0; d < Dims; d++)
+    slice.in_offset += anchor[d] * in_strides[d];
+
+  // going from the innermost dimension; the collapsed dims are stored in reverse order
+  bool mergeable = false;
+  for (int d = Dims - 1; d >= 0; d--) {
+    int64_t extent = out_shape[d];
+    if (extent == 1) {
+      mergeable = mergeable && in_shape[d] == 1;
+      continue;
+    }
+    if (mergeable) {
+      slice.shape[slice.ndim - 1] *= extent;
+    } else {
+      if (slice.ndim == 0 && in_strides[d] != 1) {
+        // the innermost run must be contiguous in the input
+        slice.shape[0] = slice.in_strides[0] = slice.out_strides[0] = 1;
+        slice.ndim = 1;
+      }
+      slice.shape[slice.ndim] = extent;
+      slice.in_strides[slice.ndim] = in_strides[d];
+      slice.out_strides[slice.ndim] = out_strides[d];
+      slice.ndim++;
+    }
+    // the next (outer) dimension can be merged if this one is not cropped
+    mergeable = extent == in_shape[d];
+  }
+  std::reverse(slice.shape.begin(), slice.shape.begin() + slice.ndim);
+  std::reverse(slice.in_strides.begin(), slice.in_strides.begin() + slice.ndim);
+  std::reverse(slice.out_strides.begin(), slice.out_strides.begin() + slice.ndim);
+  return slice;
 }
 
-template <typename OutputType, typename InputType, std::size_t Dims, std::size_t DimsLeft>
-void SliceKernelImpl(OutputType *output,
-                     const InputType *input,
-                     const std::array<int64_t, Dims> &in_strides,
-                     const std::array<int64_t, Dims> &out_strides,
-                     const TensorShape<static_cast<int>(Dims)> &out_shape,
-                     std::integral_constant<size_t, DimsLeft>) {
-  constexpr auto d = Dims - DimsLeft;  // NOLINT
-  for (int i = 0; i < out_shape[d]; i++) {
-    SliceKernelImpl(output, input, in_strides, out_strides, out_shape,
-                    std::integral_constant<size_t, DimsLeft - 1>());
-    input += in_strides[d];
-    output += out_strides[d];
+/**
+ * @brief Copies the runs [run_begin, run_end) of a collapsed slice
+ */
+template <typename OutputType, typename InputType, size_t Dims>
+void SliceRuns(OutputType *output, const InputType *input, const CollapsedSlice<Dims> &slice,
+               int64_t run_begin, int64_t run_end) {
+  const int outer = slice.ndim - 1;
+  const int64_t run = slice.run_length();
+  if (outer <= 0) {
+    if (run_begin < run_end)
+      SliceCopyRun(output, input + slice.in_offset, run);
+    return;
+  }
+
+  // position of run_begin in the outer dimensions
+  std::array<int64_t, Dims> idx;
+  int64_t in_pos = slice.in_offset, out_pos = 0;
+  int64_t r = run_begin;
+  for (int d = outer - 1; d >= 0; d--) {
+    idx[d] = r % slice.shape[d];
+    r /= slice.shape[d];
+    in_pos += idx[d] * slice.in_strides[d];
+    out_pos += idx[d] * slice.out_strides[d];
+  }
+
+  for (int64_t i = run_begin; i < run_end; i++) {
+    SliceCopyRun(output + out_pos, input + in_pos, run);
+    for (int d = outer - 1; d >= 0; d--) {
+      in_pos += slice.in_strides[d];
+      out_pos += slice.out_strides[d];
+      if (++idx[d] < slice.shape[d])
+        break;
+      in_pos -= slice.shape[d] * slice.in_strides[d];
+      out_pos -= slice.shape[d] * slice.out_strides[d];
+      idx[d] = 0;
+    }
   }
 }
 
@@ -61,20 +197,21 @@ void SliceKernelImpl(OutputType *output,
 template <typename OutputType, typename InputType, std::size_t Dims>
 void SliceKernel(OutputType *output,
                  const InputType *input,
-                 const std::array<int64_t, Dims> &in_strides,
-                 const std::array<int64_t, Dims> &out_strides,
+                 const TensorShape<static_cast<int>(Dims)> &in_shape,
                  const std::array<int64_t, Dims> &anchor,
                  const TensorShape<static_cast<int>(Dims)> &out_shape) {
-  for (size_t d = 0; d < Dims; d++) {
-    input += in_strides[d] * anchor[d];
-  }
-  detail::SliceKernelImpl(output, input, in_strides, out_strides, out_shape,
-                          std::integral_constant<size_t, Dims>());
+  if (volume(out_shape) == 0)
+    return;
+  auto slice = detail::CollapseSlice<Dims>(in_shape, anchor, out_shape);
+  detail::SliceRuns(output, input, slice, 0, slice.num_runs());
 }
 
 template <typename OutputType, typename InputType, std::size_t Dims>
 class SliceCPU {
  public:
+  /// Slices smaller than this (in elements) are not split in Schedule
+  static constexpr int64_t kMinBlockSize = 1 << 18;
+
   KernelRequirements Setup(KernelContext &context,
                            const InTensorCPU<InputType, Dims> &in,
                            const SliceArgs<Dims> &slice_args) {
@@ -88,15 +225,45 @@ class SliceCPU {
            OutTensorCPU<OutputType, Dims> &out,
            const InTensorCPU<InputType, Dims> &in,
            const SliceArgs<Dims> &slice_args) {
-    const auto &in_shape = in.shape;
-    const auto &out_shape = out.shape;
-    const auto &anchor = slice_args.anchor;
-    auto in_strides = GetStrides<Dims>(in_shape);
-    auto out_strides = GetStrides<Dims>(out_shape);
-    const InputType *in_ptr = in.data;
-    OutputType *out_ptr = out.data;
+    SliceKernel(out.data, in.data, in.shape, slice_args.anchor, out.shape);
+  }
 
-    SliceKernel(out_ptr, in_ptr, in_strides, out_strides, anchor, out_shape);
+  /**
+   * @brief Splits the slice into blocks of whole contiguous runs and submits them
+   *        to the execution engine.
+   *
+   * The engine must provide `DoWorkWithID(std::function<void(int)>)`, as ThreadPool does.
+   * The caller is responsible for waiting for the work to complete; the tensors must
+   * stay valid until then.
+   *
+   * @param num_blocks      the maximum number of blocks; usually the number of threads
+   * @param min_block_size  the minimum number of elements in a block
+   */
+  template <typename ExecutionEngine>
+  void Schedule(KernelContext &context,
+                OutTensorCPU<OutputType, Dims> &out,
+                const InTensorCPU<InputType, Dims> &in,
+                const SliceArgs<Dims> &slice_args,
+                ExecutionEngine &engine,
+                int num_blocks,
+                int64_t min_block_size = kMinBlockSize) {
+    int64_t total = volume(out.shape);
+    if (total == 0)
+      return;
+    auto slice = detail::CollapseSlice<Dims>(in.shape, slice_args.anchor, out.shape);
+    int64_t runs = slice.num_runs();
+    int64_t max_blocks = std::max<int64_t>(1, total / std::max<int64_t>(min_block_size, 1));
+    int64_t blocks = std::min<int64_t>(std::min<int64_t>(num_blocks, max_blocks), runs);
+    blocks = std::max<int64_t>(blocks, 1);
+    OutputType *out_ptr = out.data;
+    const InputType *in_ptr = in.data;
+    for (int64_t b = 0; b < blocks; b++) {
+      int64_t begin = runs * b / blocks;
+      int64_t end = runs * (b + 1) / blocks;
+      engine.DoWorkWithID([=](int) {
+        detail::SliceRuns(out_ptr, in_ptr, slice, begin, end);
+      });
+    }
   }
 };
 
@@ -13,6 +13,9 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <functional>
+#include <random>
+#include <vector>
 #include "dali/kernels/slice/slice_kernel_test.h"
 #include "dali/kernels/slice/slice_cpu.h"
 
@@ -80,5 +83,134 @@ TYPED_TEST(SliceCPUTest_CPUOnlyTests, All) {
   this->Run();
 }
 
+namespace {
+
+/**
+ * @brief Collects the work and runs it in reverse order, to detect dependencies between blocks
+ */
+struct TestExecutionEngine {
+  void DoWorkWithID(std::function<void(int)> work) {
+    tasks.push_back(std::move(work));
+  }
+
+  void Wait() {
+    for (int i = tasks.size() - 1; i >= 0; i--)
+      tasks[i](i);
+    tasks.clear();
+  }
+
+  std::vector<std::function<void(int)>> tasks;
+};
+
+template <typename OutputType, typename InputType, size_t Dims>
+void RefSlice(std::vector<OutputType> &out, const std::vector<InputType> &in,
+              const TensorShape<static_cast<int>(Dims)> &in_shape, const SliceArgs<Dims> &args) {
+  TensorShape<static_cast<int>(Dims)> out_shape(args.shape);
+  auto in_strides = GetStrides<Dims>(in_shape);
+  auto out_strides = GetStrides<Dims>(out_shape);
+  out.resize(volume(out_shape));
+  for (int64_t out_idx = 0; out_idx < volume(out_shape); out_idx++) {
+    int64_t idx = out_idx, in_idx = 0;
+    for (size_t d = 0; d < Dims; d++) {
+      in_idx += (args.anchor[d] + idx / out_strides[d]) * in_strides[d];
+      idx %= out_strides[d];
+    }
+    out[out_idx] = clamp<OutputType>(in[in_idx]);
+  }
+}
+
+template <typename OutputType, typename InputType, size_t Dims>
+void TestSlice(const TensorShape<static_cast<int>(Dims)> &in_shape, const SliceArgs<Dims> &args,
+               int num_blocks = 0) {
+  std::mt19937_64 rng(1234);
+  std::vector<InputType> in_data(volume(in_shape));
+  // out of range of uint8 where possible, to test saturation
+  double lo = std::is_unsigned<InputType>::value ? 0 : -20;
+  double hi = sizeof(InputType) == 1 ? 255 : 300;
+  UniformRandomFill(in_data, rng, lo, hi);
+  auto in = make_tensor_cpu<Dims>(static_cast<const InputType *>(in_data.data()), in_shape);
+
+  std::vector<OutputType> ref;
+  RefSlice(ref, in_data, in_shape, args);
+
+  KernelContext ctx;
+  SliceCPU<OutputType, InputType, Dims> kernel;
+  auto req = kernel.Setup(ctx, in, args);
+  auto out_shape = req.output_shapes[0][0].template to_static<Dims>();
+  std::vector<OutputType> out_data(volume(out_shape));
+  auto out = make_tensor_cpu<Dims>(out_data.data(), out_shape);
+  if (num_blocks > 0) {
+    TestExecutionEngine engine;
+    kernel.Schedule(ctx, out, in, args, engine, num_blocks, 1);
+    EXPECT_GE(engine.tasks.size(), 1u);
+    EXPECT_LE(engine.tasks.size(), static_cast<size_t>(num_blocks));
+    engine.Wait();
+  } else {
+    kernel.Run(ctx, out, in, args);
+  }
+  ASSERT_EQ(out_data.size(), ref.size());
+  for (size_t i = 0; i < ref.size(); i++)
+    ASSERT_EQ(out_data[i], ref[i]) << "at offset " << i;
+}
+
+template <typename OutputType, typename InputType>
+void TestSliceShapes(int num_blocks = 0) {
+  // whole tensor - a single run
+  TestSlice<OutputType, InputType, 3>({ 7, 9, 3 }, { { 0, 0, 0 }, { 7, 9, 3 } }, num_blocks);
+  // rows cropped; pixels and channels collapsed
+  TestSlice<OutputType, InputType, 3>({ 7, 9, 3 }, { { 1, 2, 0 }, { 5, 6, 3 } }, num_blocks);
+  // single channel extracted - runs of length 1
+  TestSlice<OutputType, InputType, 3>({ 7, 9, 3 }, { { 1, 2, 1 }, { 5, 6, 1 } }, num_blocks);
+  // unit dimensions in the middle
+  TestSlice<OutputType, InputType, 4>({ 5, 4, 6, 3 }, { { 1, 2, 0, 0 }, { 3, 1, 6, 3 } },
+                                      num_blocks);
+  TestSlice<OutputType, InputType, 4>({ 5, 1, 6, 3 }, { { 1, 0, 0, 0 }, { 3, 1, 6, 3 } },
+                                      num_blocks);
+  // long runs for the vectorized conversions
+  TestSlice<OutputType, InputType, 3>({ 4, 37, 3 }, { { 1, 1, 0 }, { 2, 35, 3 } }, num_blocks);
+  TestSlice<OutputType, InputType, 4>({ 3, 5, 7, 2 }, { { 0, 1, 2, 1 }, { 3, 4, 5, 1 } },
+                                      num_blocks);
+}
+
+}  // namespace
+
+TEST(SliceCPU, CollapsedDims) {
+  TestSliceShapes<uint8_t, uint8_t>();
+  TestSliceShapes<float, float>();
+  TestSliceShapes<int16_t, int16_t>();
+}
+
+TEST(SliceCPU, Conversions) {
+  TestSliceShapes<float, uint8_t>();
+  TestSliceShapes<uint8_t, float>();
+  TestSliceShapes<uint8_t, int16_t>();
+  TestSliceShapes<int16_t, float>();
+}
+
+TEST(SliceCPU, Schedule) {
+  for (int num_blocks : { 1, 3, 16 }) {
+    TestSliceShapes<uint8_t, uint8_t>(num_blocks);
+    TestSliceShapes<float, uint8_t>(num_blocks);
+  }
+}
+
+TEST(SliceCPU, ScheduleMinBlockSize) {
+  TensorShape<3> in_shape = { 64, 64, 3 }, out_shape = { 64, 62, 3 };
+  std::vector<uint8_t> in_data(volume(in_shape)), out_data(volume(out_shape));
+  auto in = make_tensor_cpu<3>(static_cast<const uint8_t *>(in_data.data()), in_shape);
+  auto out = make_tensor_cpu<3>(out_data.data(), out_shape);
+  SliceArgs<3> args = { { 0, 1, 0 }, { 64, 62, 3 } };
+  KernelContext ctx;
+  SliceCPU<uint8_t, uint8_t, 3> kernel;
+  TestExecutionEngine engine;
+  kernel.Schedule(ctx, out, in, args, engine, 8, volume(out_shape) / 2);
+  EXPECT_EQ(engine.tasks.size(), 2u);
+  engine.Wait();
+  // too small to split with the default block size
+  kernel.Schedule(ctx, out, in, args, engine, 8);
+  EXPECT_EQ(engine.tasks.size(), 1u);
+  engine.Wait();
+}
+
 }  // namespace kernels
 }  // namespace dali
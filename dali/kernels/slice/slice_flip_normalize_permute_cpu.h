@@ -15,12 +15,14 @@
 #ifndef DALI_KERNELS_SLICE_SLICE_FLIP_NORMALIZE_PERMUTE_CPU_H_
 #define DALI_KERNELS_SLICE_SLICE_FLIP_NORMALIZE_PERMUTE_CPU_H_
 
+#include <algorithm>
 #include <utility>
 #include <vector>
 #include "dali/core/common.h"
 #include "dali/core/convert.h"
 #include "dali/core/error_handling.h"
 #include "dali/kernels/kernel.h"
+#include "dali/kernels/common/cast.h"
 #include "dali/kernels/slice/slice_flip_normalize_permute_common.h"
 #include "dali/kernels/slice/slice_kernel_utils.h"
 #include "dali/util/half.hpp"
@@ -57,6 +59,46 @@ struct NormalizePolicy {
   }
 };
 
+template <typename Policy, bool IsNormalizationDim, typename OutputType, typename InputType>
+inline void FillRow(OutputType *output, const InputType *input,
+                    int64_t in_stride, int64_t out_stride, int64_t n,
+                    const float *mean, const float *inv_stddev) {
+  for (int64_t i = 0; i < n; i++) {
+    const size_t norm_idx = IsNormalizationDim ? i : 0;
+    Policy::Fill(*output, *input, mean + norm_idx, inv_stddev + norm_idx);
+    input += in_stride;
+    output += out_stride;
+  }
+}
+
+/**
+ * @brief float16 values are computed in float and converted in chunks, with F16C if available
+ */
+template <typename Policy, bool IsNormalizationDim, typename InputType>
+inline void FillRow(float16 *output, const InputType *input,
+                    int64_t in_stride, int64_t out_stride, int64_t n,
+                    const float *mean, const float *inv_stddev) {
+  constexpr int64_t kChunk = 256;
+  float tmp[kChunk];
+  float16 converted[kChunk];
+  for (int64_t start = 0; start < n; start += kChunk) {
+    int64_t count = std::min(kChunk, n - start);
+    for (int64_t j = 0; j < count; j++) {
+      const size_t norm_idx = IsNormalizationDim ? start + j : 0;
+      Policy::Fill(tmp[j], *input, mean + norm_idx, inv_stddev + norm_idx);
+      input += in_stride;
+    }
+    if (out_stride == 1) {
+      CastBuffer(output, tmp, count);
+      output += count;
+    } else {
+      CastBuffer(converted, tmp, count);
+      for (int64_t j = 0; j < count; j++, output += out_stride)
+        *output = converted[j];
+    }
+  }
+}
+
 template <typename OutputType, size_t Dims>
 inline void ZeroPad(OutputType *output,
                     std::array<int64_t, Dims> out_strides,
@@ -95,13 +137,10 @@ inline void SliceFlipNormalizePermuteImpl(OutputType *output, const InputType *i
                                           size_t normalization_dim,
                                           std::integral_constant<size_t, 1>) {
   constexpr auto d = Dims - 1;
-  int64_t i = 0;
-  for (; i < out_shape[d]; i++) {
-    const size_t norm_idx = IsNormalizationDim ? i : 0;
-    Policy::Fill(*output, *input, mean + norm_idx, inv_stddev + norm_idx);
-    input += in_strides[d];
-    output += out_strides[d];
-  }
+  FillRow<Policy, IsNormalizationDim>(output, input, in_strides[d], out_strides[d], out_shape[d],
+                                      mean, inv_stddev);
+  int64_t i = out_shape[d];
+  output += i * out_strides[d];
 
   // zero pad
   for (; i < padded_out_shape[d]; i++) {
@@ -0,0 +1,116 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "dali/kernels/test/tensor_test_utils.h"
+#include "dali/kernels/test/resampling_test/resampling_test_params.h"
+#include "dali/kernels/imgproc/resample/separable_cpu.h"
+#include "dali/kernels/imgproc/resample/streaming_cpu.h"
+#include "dali/kernels/scratch.h"
+
+namespace dali {
+namespace kernels {
+namespace resample_test {
+
+namespace {
+
+ResamplingParams2D Params(int out_w, int out_h, FilterDesc fx, FilterDesc fy) {
+  ResamplingParams2D params;
+  params[0].output_size = out_h;
+  params[1].output_size = out_w;
+  params[0].mag_filter = params[0].min_filter = fy;
+  params[1].mag_filter = params[1].min_filter = fx;
+  return params;
+}
+
+/**
+ * @brief Pushes the image to StreamingResampleCPU row by row and compares the result with
+ *        SeparableResampleCPU
+ */
+void TestStreaming(TensorShape<3> in_shape, const ResamplingParams2D &params) {
+  std::mt19937_64 rng(1234);
+  std::vector<uint8_t> in_data(volume(in_shape));
+  UniformRandomFill(in_data, rng, 0, 255);
+  auto in = make_tensor_cpu<3>(static_cast<const uint8_t *>(in_data.data()), in_shape);
+
+  KernelContext ctx;
+  ScratchpadAllocator ref_alloc;
+  SeparableResampleCPU<uint8_t, uint8_t> ref_kernel;
+  auto ref_req = ref_kernel.Setup(ctx, in, params);
+  ref_alloc.Reserve(ref_req.scratch_sizes);
+  auto ref_scratchpad = ref_alloc.GetScratchpad();
+  ctx.scratchpad = &ref_scratchpad;
+  auto out_shape = ref_req.output_shapes[0].tensor_shape<3>(0);
+  std::vector<uint8_t> ref_data(volume(out_shape)), out_data(volume(out_shape));
+  auto ref = make_tensor_cpu<3>(ref_data.data(), out_shape);
+  ref_kernel.Run(ctx, ref, in, params);
+  bool exact = ref_kernel.setup.desc.order == ResamplingSetupCPU::HorzVert;
+
+  ScratchpadAllocator alloc;
+  StreamingResampleCPU<uint8_t, uint8_t> kernel;
+  auto req = kernel.Setup(ctx, in_shape, params);
+  ASSERT_EQ(req.output_shapes[0].tensor_shape<3>(0), out_shape);
+  alloc.Reserve(req.scratch_sizes);
+  auto scratchpad = alloc.GetScratchpad();
+  ctx.scratchpad = &scratchpad;
+  auto out = make_tensor_cpu<3>(out_data.data(), out_shape);
+  kernel.Start(ctx, out);
+  std::vector<uint8_t> row(in_shape[1] * in_shape[2]);
+  for (int y = 0; y < in_shape[0]; y++) {
+    // the row buffer is reused, as it would be by a decoder
+    auto *src = in_data.data() + y * row.size();
+    std::copy(src, src + row.size(), row.begin());
+    kernel.PushRow(row.data());
+  }
+  EXPECT_TRUE(kernel.Done());
+  if (exact)
+    Check(out, ref);
+  else
+    Check(out, ref, EqualEps(1));
+}
+
+}  // namespace
+
+TEST(StreamingResampleCPU, Downscale) {
+  TestStreaming({ 300, 400, 3 }, Params(224, 224, tri(), tri()));
+  TestStreaming({ 480, 200, 3 }, Params(150, 160, lin(), lin()));
+  TestStreaming({ 101, 97, 1 }, Params(31, 23, lanczos(), cubic()));
+}
+
+TEST(StreamingResampleCPU, Upscale) {
+  TestStreaming({ 64, 48, 3 }, Params(224, 224, lin(), lin()));
+  TestStreaming({ 17, 33, 4 }, Params(50, 80, cubic(), lanczos()));
+}
+
+TEST(StreamingResampleCPU, Nearest) {
+  TestStreaming({ 120, 80, 3 }, Params(200, 40, lin(), nearest()));
+  TestStreaming({ 120, 80, 3 }, Params(40, 200, nearest(), tri()));
+}
+
+TEST(StreamingResampleCPU, RingSize) {
+  // the ring buffer holds as many rows as the vertical filter support, not the whole input
+  KernelContext ctx;
+  StreamingResampleCPU<uint8_t, uint8_t> kernel;
+  auto req = kernel.Setup(ctx, { 2000, 1000, 3 }, Params(100, 100, lin(), lin()));
+  size_t total = 0;
+  for (auto size : req.scratch_sizes)
+    total += size;
+  EXPECT_LT(total, 2000u * 100 * 3 * sizeof(float) / 4);
+}
+
+}  // namespace resample_test
+}  // namespace kernels
+}  // namespace dali
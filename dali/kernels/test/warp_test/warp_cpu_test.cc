@@ -15,6 +15,7 @@
 #include <gtest/gtest.h>
 #include <opencv2/imgcodecs.hpp>
 #include <opencv2/imgproc.hpp>
+#include <random>
 #include <string>
 #include <vector>
 #include "dali/kernels/imgproc/warp_cpu.h"
@@ -147,5 +148,71 @@ TEST(WarpCPU, Affine_RotateScale) {
   }
 }
 
+namespace {
+
+/**
+ * @brief Compares WarpCPU with a per-pixel reference, which uses map_coords and Sampler
+ *        directly for every pixel (i.e. without the affine fast path).
+ */
+template <typename Out, typename In, typename Border>
+void TestAffineFastPath(const AffineMapping2D &mapping, int channels, DALIInterpType interp,
+                        Border border) {
+  std::mt19937_64 rng(1234);
+  int in_h = 37, in_w = 53;
+  int out_h = 41, out_w = 67;
+  std::vector<In> in_data(in_h * in_w * channels);
+  UniformRandomFill(in_data, rng, 0, 255);
+  auto in = make_tensor_cpu<3>(in_data.data(), { in_h, in_w, channels });
+
+  std::vector<Out> out_data(out_h * out_w * channels), ref_data(out_data.size());
+  auto out = make_tensor_cpu<3>(out_data.data(), { out_h, out_w, channels });
+  auto ref = make_tensor_cpu<3>(ref_data.data(), { out_h, out_w, channels });
+
+  WarpCPU<AffineMapping2D, 2, Out, In, Border> warp;
+  KernelContext ctx = {};
+  TensorShape<2> out_shape = { out_h, out_w };
+  warp.Setup(ctx, in, mapping, out_shape, interp, border);
+  warp.Run(ctx, out, in, mapping, out_shape, interp, border);
+
+  Surface2D<const In> in_surf = { in.data, in_w, in_h, channels, channels, in_w * channels, 1 };
+  Surface2D<Out> ref_surf = {
+    ref.data, out_w, out_h, channels, channels, out_w * channels, 1
+  };
+  VALUE_SWITCH(interp, static_interp, (DALI_INTERP_NN, DALI_INTERP_LINEAR), (
+    Sampler<static_interp, In> sampler(in_surf);
+    for (int y = 0; y < out_h; y++)
+      for (int x = 0; x < out_w; x++)
+        sampler(&ref_surf(x, y), warp::map_coords(mapping, ivec2(x, y)), border);
+  ), (FAIL() << "Unsupported interpolation type"));  // NOLINT
+  Check(out, ref);
+}
+
+}  // namespace
+
+TEST(WarpCPU, Affine_FastPathMatchesSampler) {
+  vec2 center(26.5f, 18.5f);
+  const mat3 transforms[] = {
+    translation(vec2(3.25f, -2.5f)),
+    scaling(vec2(0.5f, 0.5f)),
+    scaling(vec2(-1.3f, 0.7f)) * translation(-center),
+    translation(center) * rotation2D(0.3f) * translation(-center),
+    translation(center) * rotation2D(-2.0f) * scaling(vec2(0.8f, 1.1f)) * translation(-center),
+    mat3{{{ 1, 0.4f, -5 }, { 0.2f, 1, 1 }, { 0, 0, 1 }}},
+  };
+  for (auto &tr : transforms) {
+    AffineMapping2D mapping = sub<2, 3>(tr, 0, 0);
+    for (auto interp : { DALI_INTERP_NN, DALI_INTERP_LINEAR }) {
+      for (int channels : { 1, 3, 4, 5 }) {
+        TestAffineFastPath<uint8_t, uint8_t>(mapping, channels, interp, uint8_t(77));
+        TestAffineFastPath<float, uint8_t>(mapping, channels, interp, 0.5f);
+        TestAffineFastPath<uint8_t, uint8_t>(mapping, channels, interp, BorderClamp());
+        TestAffineFastPath<float, float>(mapping, channels, interp, BorderClamp());
+        if (HasFailure())
+          FAIL() << "channels = " << channels << " interp = " << interp;
+      }
+    }
+  }
+}
+
 }  // namespace kernels
 }  // namespace dali
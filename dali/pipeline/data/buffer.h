@@ -21,12 +21,14 @@
 #include <numeric>
 #include <string>
 #include <type_traits>
+#include <utility>
 #include <vector>
 
 #include "dali/core/common.h"
 #include "dali/core/device_guard.h"
 #include "dali/core/error_handling.h"
 #include "dali/core/util.h"
+#include "dali/pipeline/data/memory_account.h"
 #include "dali/pipeline/data/types.h"
 
 namespace dali {
@@ -245,8 +247,17 @@ class Buffer {
                  "Cannot reallocate Buffer if it is sharing data. "
                  "Clear the status by `Reset()` first.");
     data_.reset();
-    data_.reset(Backend::New(new_num_bytes, pinned_),
-                std::bind(FreeMemory, std::placeholders::_1, new_num_bytes, device_, pinned_));
+    // charged to the pipeline and operator current for this thread, if any
+    MemoryCharge charge = MemoryAccount::ChargeCurrent(memory_kind(), new_num_bytes);
+    void *ptr = nullptr;
+    try {
+      ptr = Backend::New(new_num_bytes, pinned_);
+    } catch (...) {
+      charge.Release();
+      throw;
+    }
+    data_.reset(ptr, std::bind(FreeMemory, std::placeholders::_1, new_num_bytes, device_,
+                               pinned_, std::move(charge)));
 
     num_bytes_ = new_num_bytes;
   }
@@ -271,10 +282,18 @@ class Buffer {
   DISABLE_COPY_MOVE_ASSIGN(Buffer);
 
  protected:
-  static void FreeMemory(void* ptr, size_t bytes, int device, bool pinned) {
+  static void FreeMemory(void* ptr, size_t bytes, int device, bool pinned,
+                         const MemoryCharge &charge) {
     // for device == -1 it is noop
     DeviceGuard g(device);
     Backend::Delete(ptr, bytes, pinned);
+    charge.Release();
+  }
+
+  inline MemoryKind memory_kind() const {
+    if (std::is_same<Backend, GPUBackend>::value)
+      return MemoryKind::GPU;
+    return pinned_ ? MemoryKind::Pinned : MemoryKind::Host;
   }
 
   // Helper to resize the underlying allocation
@@ -0,0 +1,196 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/data/memory_account.h"
+#include <sstream>
+#include <utility>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+namespace {
+
+thread_local MemoryAccount *current_account = nullptr;
+thread_local int current_tag = -1;
+thread_local bool reclaiming = false;
+
+const char *kMemoryKindNames[kNumMemoryKinds] = { "host", "pinned", "gpu" };
+
+void PrintStats(std::ostream &os, const MemoryStats &stats) {
+  for (int k = 0; k < kNumMemoryKinds; k++) {
+    os << " " << kMemoryKindNames[k] << " " << stats.current[k]
+       << " (peak " << stats.peak[k] << ")";
+  }
+}
+
+}  // namespace
+
+void MemoryCharge::Release() const {
+  if (account)
+    account->Release(tag, kind, bytes);
+}
+
+void MemoryAccount::SetBudget(size_t host_bytes, size_t gpu_bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  host_budget_ = host_bytes;
+  gpu_budget_ = gpu_bytes;
+}
+
+int MemoryAccount::TagId(const std::string &tag) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto it = tag_ids_.find(tag);
+  if (it != tag_ids_.end())
+    return it->second;
+  int id = tag_names_.size();
+  tag_ids_.emplace(tag, id);
+  tag_names_.push_back(tag);
+  tag_stats_.emplace_back();
+  return id;
+}
+
+bool MemoryAccount::OverBudget(MemoryKind kind, size_t bytes) const {
+  int64_t host = total_.Current(MemoryKind::Host) + total_.Current(MemoryKind::Pinned);
+  int64_t gpu = total_.Current(MemoryKind::GPU);
+  (kind == MemoryKind::GPU ? gpu : host) += bytes;
+  return (host_budget_ && host > static_cast<int64_t>(host_budget_)) ||
+         (gpu_budget_ && gpu > static_cast<int64_t>(gpu_budget_));
+}
+
+MemoryCharge MemoryAccount::Charge(int tag, MemoryKind kind, size_t bytes) {
+  DALI_ENFORCE(tag >= 0, "Invalid memory account tag");
+  std::unique_lock<std::mutex> lock(mutex_);
+  if (OverBudget(kind, bytes)) {
+    lock.unlock();
+    Reclaim(kind, bytes);
+    lock.lock();
+    if (OverBudget(kind, bytes)) {
+      DALI_FAIL("Pipeline memory budget exceeded when allocating " + to_string(bytes) +
+                " bytes of " + kMemoryKindNames[static_cast<int>(kind)] + " memory for \"" +
+                tag_names_[tag] + "\". Current usage:\n" + ReportLocked());
+    }
+  }
+  total_.Add(kind, bytes);
+  tag_stats_[tag].Add(kind, bytes);
+  return MemoryCharge{shared_from_this(), tag, kind, bytes};
+}
+
+void MemoryAccount::Release(int tag, MemoryKind kind, size_t bytes) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  total_.current[static_cast<int>(kind)] -= bytes;
+  tag_stats_[tag].current[static_cast<int>(kind)] -= bytes;
+}
+
+void MemoryAccount::Reclaim(MemoryKind kind, size_t bytes) {
+  // A reclaimer should not allocate, but if it does, do not recurse
+  if (reclaiming)
+    return;
+  std::lock_guard<std::mutex> lock(reclaim_mutex_);
+  reclaiming = true;
+  for (auto &reclaimer : reclaimers_) {
+    try {
+      reclaimer.second();
+    } catch (...) {
+      reclaiming = false;
+      throw;
+    }
+    std::lock_guard<std::mutex> stats_lock(mutex_);
+    if (!OverBudget(kind, bytes))
+      break;
+  }
+  reclaiming = false;
+}
+
+MemoryStats MemoryAccount::Total() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return total_;
+}
+
+bool MemoryAccount::WithinBudget(double fraction) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t host = total_.Current(MemoryKind::Host) + total_.Current(MemoryKind::Pinned);
+  int64_t gpu = total_.Current(MemoryKind::GPU);
+  return (!host_budget_ || host <= fraction * host_budget_) &&
+         (!gpu_budget_ || gpu <= fraction * gpu_budget_);
+}
+
+std::map<std::string, MemoryStats> MemoryAccount::ByTag() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  std::map<std::string, MemoryStats> result;
+  for (size_t i = 0; i < tag_names_.size(); i++) {
+    bool used = false;
+    for (auto peak : tag_stats_[i].peak)
+      used |= peak > 0;
+    if (used)
+      result[tag_names_[i]] = tag_stats_[i];
+  }
+  return result;
+}
+
+std::string MemoryAccount::Report() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return ReportLocked();
+}
+
+std::string MemoryAccount::ReportLocked() const {
+  std::stringstream ss;
+  ss << "total:";
+  PrintStats(ss, total_);
+  for (size_t i = 0; i < tag_names_.size(); i++) {
+    ss << "\n" << tag_names_[i] << ":";
+    PrintStats(ss, tag_stats_[i]);
+  }
+  return ss.str();
+}
+
+int MemoryAccount::AddReclaimer(Reclaimer reclaimer) {
+  std::lock_guard<std::mutex> lock(reclaim_mutex_);
+  int id = next_reclaimer_id_++;
+  reclaimers_.emplace(id, std::move(reclaimer));
+  return id;
+}
+
+void MemoryAccount::RemoveReclaimer(int id) {
+  std::lock_guard<std::mutex> lock(reclaim_mutex_);
+  reclaimers_.erase(id);
+}
+
+MemoryCharge MemoryAccount::ChargeCurrent(MemoryKind kind, size_t bytes) {
+  if (!current_account)
+    return {};
+  return current_account->Charge(current_tag, kind, bytes);
+}
+
+MemoryAccount *MemoryAccount::Current() {
+  return current_account;
+}
+
+int MemoryAccount::CurrentTag() {
+  return current_tag;
+}
+
+MemoryAccountScope::MemoryAccountScope(MemoryAccount *account, const std::string &tag)
+    : MemoryAccountScope(account, account ? account->TagId(tag) : -1) {}
+
+MemoryAccountScope::MemoryAccountScope(MemoryAccount *account, int tag)
+    : prev_account_(current_account), prev_tag_(current_tag) {
+  current_account = account;
+  current_tag = tag;
+}
+
+MemoryAccountScope::~MemoryAccountScope() {
+  current_account = prev_account_;
+  current_tag = prev_tag_;
+}
+
+}  // namespace dali
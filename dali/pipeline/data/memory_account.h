@@ -0,0 +1,186 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_DATA_MEMORY_ACCOUNT_H_
+#define DALI_PIPELINE_DATA_MEMORY_ACCOUNT_H_
+
+#include <array>
+#include <functional>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+#include "dali/core/common.h"
+
+namespace dali {
+
+enum class MemoryKind : int {
+  Host = 0,
+  Pinned = 1,
+  GPU = 2,
+  Count = 3
+};
+
+constexpr int kNumMemoryKinds = static_cast<int>(MemoryKind::Count);
+
+/**
+ * @brief Current and peak number of bytes, per memory kind
+ */
+struct MemoryStats {
+  std::array<int64_t, kNumMemoryKinds> current{};
+  std::array<int64_t, kNumMemoryKinds> peak{};
+
+  int64_t Current(MemoryKind kind) const { return current[static_cast<int>(kind)]; }
+  int64_t Peak(MemoryKind kind) const { return peak[static_cast<int>(kind)]; }
+
+  void Add(MemoryKind kind, int64_t bytes) {
+    auto &cur = current[static_cast<int>(kind)];
+    auto &max = peak[static_cast<int>(kind)];
+    cur += bytes;
+    if (cur > max)
+      max = cur;
+  }
+};
+
+class MemoryAccount;
+
+/**
+ * @brief Bytes charged to a MemoryAccount, released when the memory is freed.
+ *
+ * An empty charge (no account) is a no-op.
+ */
+struct DLL_PUBLIC MemoryCharge {
+  std::shared_ptr<MemoryAccount> account;
+  int tag = -1;
+  MemoryKind kind = MemoryKind::Host;
+  size_t bytes = 0;
+
+  DLL_PUBLIC void Release() const;
+};
+
+/**
+ * @brief Tracks the memory allocated on behalf of a pipeline, tagged by operator.
+ *
+ * Allocations are charged to the account and tag made current for the calling thread with
+ * MemoryAccountScope. The executor sets the scope for each operator and it is propagated
+ * to the ThreadPool tasks and reader prefetch threads.
+ *
+ * When a budget is set and an allocation would exceed it, the registered reclaimers
+ * are called (in the order of registration) to shrink prefetching and caches.
+ * If that does not help, the allocation fails with an error describing the usage.
+ */
+class DLL_PUBLIC MemoryAccount : public std::enable_shared_from_this<MemoryAccount> {
+ public:
+  using Reclaimer = std::function<void()>;
+
+  DLL_PUBLIC MemoryAccount() = default;
+
+  /**
+   * @brief Sets the budget for host (including pinned) and GPU memory, 0 means unlimited
+   */
+  DLL_PUBLIC void SetBudget(size_t host_bytes, size_t gpu_bytes);
+
+  /**
+   * @brief Returns the id of the tag, registering it if necessary
+   */
+  DLL_PUBLIC int TagId(const std::string &tag);
+
+  /**
+   * @brief Charges `bytes` of `kind` memory to `tag`, enforcing the budget
+   *
+   * The account must be owned by a shared_ptr, which is kept by the returned charge.
+   */
+  DLL_PUBLIC MemoryCharge Charge(int tag, MemoryKind kind, size_t bytes);
+
+  DLL_PUBLIC MemoryStats Total() const;
+
+  /**
+   * @brief Whether the usage is at most `fraction` of the budget, for each kind with a budget
+   */
+  DLL_PUBLIC bool WithinBudget(double fraction) const;
+
+  /**
+   * @brief Returns the stats of each tag that had any memory charged to it
+   */
+  DLL_PUBLIC std::map<std::string, MemoryStats> ByTag() const;
+
+  /**
+   * @brief Human-readable usage, per tag
+   */
+  DLL_PUBLIC std::string Report() const;
+
+  /**
+   * @brief Registers a function called when the budget is exceeded.
+   *
+   * Reclaimers must not allocate memory and must not block on locks that may be held
+   * by a thread which allocates.
+   * @return id to be passed to RemoveReclaimer
+   */
+  DLL_PUBLIC int AddReclaimer(Reclaimer reclaimer);
+
+  DLL_PUBLIC void RemoveReclaimer(int id);
+
+  /**
+   * @brief Charges the account and tag current for the calling thread, if any
+   */
+  DLL_PUBLIC static MemoryCharge ChargeCurrent(MemoryKind kind, size_t bytes);
+
+  DLL_PUBLIC static MemoryAccount *Current();
+  DLL_PUBLIC static int CurrentTag();
+
+  DISABLE_COPY_MOVE_ASSIGN(MemoryAccount);
+
+ private:
+  friend struct MemoryCharge;
+
+  void Release(int tag, MemoryKind kind, size_t bytes);
+  // Whether the budget would be exceeded after allocating `bytes` more of `kind` memory
+  bool OverBudget(MemoryKind kind, size_t bytes) const;
+  void Reclaim(MemoryKind kind, size_t bytes);
+  std::string ReportLocked() const;
+
+  mutable std::mutex mutex_;
+  size_t host_budget_ = 0, gpu_budget_ = 0;
+  MemoryStats total_;
+  std::unordered_map<std::string, int> tag_ids_;
+  std::vector<std::string> tag_names_;
+  std::vector<MemoryStats> tag_stats_;
+
+  std::mutex reclaim_mutex_;
+  int next_reclaimer_id_ = 0;
+  std::map<int, Reclaimer> reclaimers_;
+};
+
+/**
+ * @brief Makes `account` and `tag` current for the calling thread, restores the previous
+ * ones on destruction. A null account disables the accounting within the scope.
+ */
+class DLL_PUBLIC MemoryAccountScope {
+ public:
+  DLL_PUBLIC MemoryAccountScope(MemoryAccount *account, const std::string &tag);
+  DLL_PUBLIC MemoryAccountScope(MemoryAccount *account, int tag);
+  DLL_PUBLIC ~MemoryAccountScope();
+
+  DISABLE_COPY_MOVE_ASSIGN(MemoryAccountScope);
+
+ private:
+  MemoryAccount *prev_account_;
+  int prev_tag_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_DATA_MEMORY_ACCOUNT_H_
@@ -0,0 +1,135 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/data/memory_account.h"
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <vector>
+
+#include "dali/pipeline/data/backend.h"
+#include "dali/pipeline/data/tensor.h"
+
+namespace dali {
+
+TEST(MemoryAccountTest, ChargeAndRelease) {
+  auto account = std::make_shared<MemoryAccount>();
+  int a = account->TagId("a");
+  int b = account->TagId("b");
+  EXPECT_EQ(account->TagId("a"), a);
+
+  auto c1 = account->Charge(a, MemoryKind::Host, 100);
+  auto c2 = account->Charge(a, MemoryKind::GPU, 200);
+  auto c3 = account->Charge(b, MemoryKind::Pinned, 50);
+  auto total = account->Total();
+  EXPECT_EQ(total.Current(MemoryKind::Host), 100);
+  EXPECT_EQ(total.Current(MemoryKind::Pinned), 50);
+  EXPECT_EQ(total.Current(MemoryKind::GPU), 200);
+
+  c1.Release();
+  c3.Release();
+  total = account->Total();
+  EXPECT_EQ(total.Current(MemoryKind::Host), 0);
+  EXPECT_EQ(total.Peak(MemoryKind::Host), 100);
+
+  auto by_tag = account->ByTag();
+  ASSERT_EQ(by_tag.size(), 2u);
+  EXPECT_EQ(by_tag["a"].Current(MemoryKind::GPU), 200);
+  EXPECT_EQ(by_tag["b"].Current(MemoryKind::Pinned), 0);
+  EXPECT_EQ(by_tag["b"].Peak(MemoryKind::Pinned), 50);
+  c2.Release();
+}
+
+TEST(MemoryAccountTest, Scope) {
+  auto account = std::make_shared<MemoryAccount>();
+  EXPECT_EQ(MemoryAccount::Current(), nullptr);
+  EXPECT_EQ(MemoryAccount::ChargeCurrent(MemoryKind::Host, 10).account, nullptr);
+  {
+    MemoryAccountScope scope(account.get(), "op");
+    EXPECT_EQ(MemoryAccount::Current(), account.get());
+    {
+      MemoryAccountScope inner(nullptr, "disabled");
+      EXPECT_EQ(MemoryAccount::Current(), nullptr);
+    }
+    auto charge = MemoryAccount::ChargeCurrent(MemoryKind::Host, 10);
+    EXPECT_EQ(account->ByTag()["op"].Current(MemoryKind::Host), 10);
+    charge.Release();
+  }
+  EXPECT_EQ(MemoryAccount::Current(), nullptr);
+}
+
+TEST(MemoryAccountTest, BudgetWithReclaimer) {
+  auto account = std::make_shared<MemoryAccount>();
+  int tag = account->TagId("op");
+  account->SetBudget(1000, 0);
+  std::vector<MemoryCharge> charges;
+  charges.push_back(account->Charge(tag, MemoryKind::Host, 600));
+  charges.push_back(account->Charge(tag, MemoryKind::Pinned, 300));
+  // GPU is not limited
+  auto gpu = account->Charge(tag, MemoryKind::GPU, 1 << 20);
+
+  int reclaimed = 0;
+  int id = account->AddReclaimer([&]() {
+    reclaimed++;
+    charges.front().Release();
+    charges.erase(charges.begin());
+  });
+  auto c = account->Charge(tag, MemoryKind::Host, 500);
+  EXPECT_EQ(reclaimed, 1);
+  EXPECT_EQ(account->Total().Current(MemoryKind::Host), 500);
+
+  account->RemoveReclaimer(id);
+  EXPECT_THROW(account->Charge(tag, MemoryKind::Host, 500), std::runtime_error);
+  // failed charge is not accounted
+  EXPECT_EQ(account->Total().Current(MemoryKind::Host), 500);
+  EXPECT_EQ(account->Total().Peak(MemoryKind::Host), 600);
+  c.Release();
+  gpu.Release();
+  for (auto &charge : charges)
+    charge.Release();
+}
+
+TEST(MemoryAccountTest, WithinBudget) {
+  auto account = std::make_shared<MemoryAccount>();
+  int tag = account->TagId("op");
+  // no budget - no limit
+  auto gpu = account->Charge(tag, MemoryKind::GPU, 1 << 20);
+  EXPECT_TRUE(account->WithinBudget(0.5));
+  account->SetBudget(1000, 0);
+  auto host = account->Charge(tag, MemoryKind::Host, 500);
+  auto pinned = account->Charge(tag, MemoryKind::Pinned, 200);
+  EXPECT_TRUE(account->WithinBudget(0.7));
+  EXPECT_FALSE(account->WithinBudget(0.6));
+  pinned.Release();
+  EXPECT_TRUE(account->WithinBudget(0.6));
+  host.Release();
+  gpu.Release();
+}
+
+TEST(MemoryAccountTest, BufferAllocation) {
+  auto account = std::make_shared<MemoryAccount>();
+  Tensor<CPUBackend> tensor;
+  tensor.set_pinned(false);
+  {
+    MemoryAccountScope scope(account.get(), "op");
+    tensor.Resize({1000});
+    tensor.mutable_data<uint8_t>();
+  }
+  EXPECT_EQ(account->ByTag()["op"].Current(MemoryKind::Host), 1000);
+  // released to the account the memory was charged to, regardless of the current scope
+  tensor.Reset();
+  EXPECT_EQ(account->Total().Current(MemoryKind::Host), 0);
+}
+
+}  // namespace dali
@@ -15,6 +15,10 @@
 #ifndef DALI_PIPELINE_EXECUTOR_EXECUTOR_H_
 #define DALI_PIPELINE_EXECUTOR_EXECUTOR_H_
 
+#include <algorithm>
+#include <atomic>
+#include <functional>
+#include <limits>
 #include <map>
 #include <memory>
 #include <queue>
@@ -24,6 +28,8 @@
 
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
+#include "dali/pipeline/data/memory_account.h"
+#include "dali/pipeline/executor/queue_autotuner.h"
 #include "dali/pipeline/executor/queue_metadata.h"
 #include "dali/pipeline/executor/queue_policy.h"
 #include "dali/pipeline/executor/workspace_policy.h"
@@ -32,6 +38,7 @@
 #include "dali/pipeline/graph/op_graph_verifier.h"
 #include "dali/pipeline/operators/common.h"
 #include "dali/pipeline/util/event_pool.h"
+#include "dali/pipeline/util/profiler.h"
 #include "dali/pipeline/util/stream_pool.h"
 #include "dali/pipeline/util/thread_pool.h"
 #include "dali/pipeline/workspace/device_workspace.h"
@@ -63,6 +70,21 @@ class DLL_PUBLIC ExecutorBase {
   DLL_PUBLIC virtual void ShareOutputs(DeviceWorkspace *ws) = 0;
   DLL_PUBLIC virtual void ReleaseOutputs() = 0;
   DLL_PUBLIC virtual void SetCompletionCallback(ExecutorCallback cb) = 0;
+  DLL_PUBLIC virtual void SetProfiler(Profiler *profiler) = 0;
+  /**
+   * @brief Adjusts the CPU queue depth and the number of active threads while running,
+   * between the given minimums and the values the executor was created with.
+   */
+  DLL_PUBLIC virtual void EnableAutotune(int min_queue_depth, int min_threads) = 0;
+  DLL_PUBLIC virtual std::vector<AutotuneDecision> GetAutotuneLog() const = 0;
+  /**
+   * @brief Sets the account to which the memory allocated by the operators is charged
+   */
+  DLL_PUBLIC virtual void SetMemoryAccount(MemoryAccount *account) = 0;
+  /**
+   * @brief Limits the number of batches the CPU stage may prepare ahead of the consumer
+   */
+  DLL_PUBLIC virtual void LimitQueueDepth(int depth) = 0;
 
  protected:
   // virtual to allow the TestPruneWholeGraph test in gcc
@@ -109,6 +131,22 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
   DLL_PUBLIC void ShareOutputs(DeviceWorkspace *ws) override;
   DLL_PUBLIC void ReleaseOutputs() override;
   DLL_PUBLIC void SetCompletionCallback(ExecutorCallback cb) override;
+  DLL_PUBLIC void SetProfiler(Profiler *profiler) override {
+    profiler_ = profiler;
+  }
+  DLL_PUBLIC void EnableAutotune(int min_queue_depth, int min_threads) override;
+  DLL_PUBLIC std::vector<AutotuneDecision> GetAutotuneLog() const override {
+    return autotuner_ ? autotuner_->Log() : std::vector<AutotuneDecision>{};
+  }
+  DLL_PUBLIC void SetMemoryAccount(MemoryAccount *account) override {
+    memory_account_ = account;
+  }
+  DLL_PUBLIC void LimitQueueDepth(int depth) override {
+    DALI_ENFORCE(depth > 0, "Queue depth must be positive");
+    queue_depth_limit_ = depth;
+    QueuePolicy::SetActiveQueueDepth(
+        autotuner_ ? std::min(autotuner_->queue_depth(), depth) : depth);
+  }
 
   DLL_PUBLIC void ShutdownQueue() {
     QueuePolicy::SignalStop();
@@ -140,6 +178,12 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
 
   void SetupOutputQueuesForGraph();
 
+  void SetupCPUOpDependencies(const OpGraph &graph);
+
+  void RunCPUOp(QueueIdxs cpu_idxs, int cpu_op_id);
+
+  void RunCPUOpsConcurrently(QueueIdxs cpu_idxs);
+
   class EventList {
    public:
     inline EventList() {}
@@ -192,12 +236,20 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
   // we need to keep this above the stream_pool_ so we still have it when the stream_pool_
   // destructor runs and it waits for streams to finish
   ExecutorCallback callback_;
+  // Optional, owned by the Pipeline
+  Profiler *profiler_ = nullptr;
+  // Optional, created with EnableAutotune
+  std::unique_ptr<QueueAutotuner> autotuner_;
+  // Set with LimitQueueDepth, caps the depth chosen by the autotuner
+  std::atomic<int> queue_depth_limit_{std::numeric_limits<int>::max()};
+  // Optional, owned by the Pipeline
+  MemoryAccount *memory_account_ = nullptr;
   StreamPool stream_pool_;
   EventPool event_pool_;
   ThreadPool thread_pool_;
   std::vector<std::string> errors_;
   std::mutex errors_mutex_;
-  bool exec_error_;
+  std::atomic<bool> exec_error_;
   QueueSizes queue_sizes_;
   std::vector<tensor_data_store_queue_t> tensor_to_store_queue_;
   cudaStream_t mixed_op_stream_, gpu_op_stream_;
@@ -209,11 +261,21 @@ class DLL_PUBLIC Executor : public ExecutorBase, public WorkspacePolicy, public
   // in some edge cases where there are no operators
   std::vector<cudaEvent_t> mixed_callback_events_;
 
+  // Dependencies between CPU ops, indexed by partition index. Used to run
+  // independent branches of the CPU stage concurrently.
+  std::vector<std::vector<int>> cpu_op_children_;
+  std::vector<int> cpu_op_num_parents_;
+  // Threads issuing the independent CPU ops. The ops share thread_pool_ for per-sample work.
+  // Empty if the CPU ops form a single chain.
+  std::unique_ptr<ThreadPool> cpu_op_issue_pool_;
+
  private:
   template <typename Workspace>
   void RunHelper(OpNode &op_node, Workspace &ws) {
     auto &output_desc = op_node.output_desc;
     auto &op = *op_node.op;
+    ProfilerScope profiler_scope(profiler_, op_node.instance_name, profiler_category::kOp);
+    MemoryAccountScope memory_scope(memory_account_, op_node.instance_name);
     output_desc.clear();
     if (op.Setup(output_desc, ws)) {
       DALI_ENFORCE(
@@ -308,17 +370,70 @@ void Executor<WorkspacePolicy, QueuePolicy>::Build(OpGraph *graph, vector<string
 
   // Producer-consumer queues info
   SetupOutputQueuesForGraph();
+
+  SetupCPUOpDependencies(*graph_);
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::SetupCPUOpDependencies(const OpGraph &graph) {
+  int num_cpu_ops = graph.NumOp(OpType::CPU);
+  cpu_op_children_.clear();
+  cpu_op_children_.resize(num_cpu_ops);
+  cpu_op_num_parents_.assign(num_cpu_ops, 0);
+  // Ops are partitioned in topological order, so the level of each op
+  // is known when we reach it. Ops with the same level are independent.
+  std::vector<int> level(num_cpu_ops, 0);
+  std::vector<int> level_width(num_cpu_ops + 1, 0);
+  int max_width = 0;
+  for (int cpu_op_id = 0; cpu_op_id < num_cpu_ops; ++cpu_op_id) {
+    const OpNode &op_node = graph.Node(OpType::CPU, cpu_op_id);
+    for (auto parent_id : op_node.parents) {
+      if (graph.NodeType(parent_id) != OpType::CPU)
+        continue;
+      int parent_idx = graph.NodeIdx(parent_id);
+      cpu_op_children_[parent_idx].push_back(cpu_op_id);
+      cpu_op_num_parents_[cpu_op_id]++;
+      level[cpu_op_id] = std::max(level[cpu_op_id], level[parent_idx] + 1);
+    }
+    max_width = std::max(max_width, ++level_width[level[cpu_op_id]]);
+  }
+
+  cpu_op_issue_pool_.reset();
+  if (max_width > 1) {
+    cpu_op_issue_pool_ = std::make_unique<ThreadPool>(max_width, device_id_, false);
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::EnableAutotune(int min_queue_depth, int min_threads) {
+  AutotuneLimits limits;
+  limits.min_queue_depth = min_queue_depth;
+  limits.max_queue_depth = stage_queue_depths_[OpType::CPU];
+  limits.min_threads = min_threads;
+  limits.max_threads = thread_pool_.size();
+  DALI_ENFORCE(min_queue_depth <= limits.max_queue_depth,
+               "Minimum queue depth for autotuning cannot exceed the prefetch queue depth");
+  DALI_ENFORCE(min_threads <= limits.max_threads,
+               "Minimum number of threads for autotuning cannot exceed the number of threads");
+  autotuner_ = std::make_unique<QueueAutotuner>(limits);
 }
 
 template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::RunCPU() {
   TimeRange tr("[Executor] RunCPU");
+  using autotune_clock = QueueAutotuner::clock;
+  auto wait_start = autotune_clock::now();
 
+  ProfilerRange support_wait(profiler_, "support", profiler_category::kQueueWait);
   auto support_idxs = QueuePolicy::AcquireIdxs(OpType::SUPPORT);
+  support_wait.stop();
+  auto producer_wait = autotune_clock::now() - wait_start;
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(support_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::SUPPORT, support_idxs);
     return;
   }
+  ProfilerRange support_stage(profiler_, "support", profiler_category::kStage);
+  auto busy_start = autotune_clock::now();
 
   DeviceGuard g(device_id_);
 
@@ -340,33 +455,94 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunCPU() {
     HandleError();
   }
 
+  support_stage.stop();
   QueuePolicy::ReleaseIdxs(OpType::SUPPORT, support_idxs);
+  auto producer_busy = autotune_clock::now() - busy_start;
 
+  wait_start = autotune_clock::now();
+  ProfilerRange cpu_wait(profiler_, "cpu", profiler_category::kQueueWait);
   auto cpu_idxs = QueuePolicy::AcquireIdxs(OpType::CPU);
+  cpu_wait.stop();
+  producer_wait += autotune_clock::now() - wait_start;
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(cpu_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::CPU, cpu_idxs);
     return;
   }
-
-  // Run the cpu-ops in the thread
-  // Process each CPU Op in batch
-  for (int cpu_op_id = 0; cpu_op_id < graph_->NumOp(OpType::CPU); ++cpu_op_id) {
-    OpNode &op_node = graph_->Node(OpType::CPU, cpu_op_id);
-    typename WorkspacePolicy::template ws_t<OpType::CPU> ws =
-        WorkspacePolicy::template GetWorkspace<OpType::CPU>(cpu_idxs, *graph_, cpu_op_id);
-    TimeRange tr("[Executor] Run CPU op " + op_node.instance_name, TimeRange::kBlue1);
-
-    try {
-      RunHelper(op_node, ws);
-    } catch (std::exception &e) {
-      HandleError(e.what());
-    } catch (...) {
-      HandleError();
+  ProfilerRange cpu_stage(profiler_, "cpu", profiler_category::kStage);
+  busy_start = autotune_clock::now();
+
+  if (cpu_op_issue_pool_) {
+    RunCPUOpsConcurrently(cpu_idxs);
+  } else {
+    // Run the cpu-ops in the thread
+    // Process each CPU Op in batch
+    for (int cpu_op_id = 0; cpu_op_id < graph_->NumOp(OpType::CPU); ++cpu_op_id) {
+      RunCPUOp(cpu_idxs, cpu_op_id);
     }
   }
 
   // Pass the work to the mixed stage
+  cpu_stage.stop();
   QueuePolicy::ReleaseIdxs(OpType::CPU, cpu_idxs);
+  if (autotuner_) {
+    producer_busy += autotune_clock::now() - busy_start;
+    autotuner_->AddProducerTimes(producer_wait, producer_busy);
+  }
+}
+
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunCPUOp(QueueIdxs cpu_idxs, int cpu_op_id) {
+  OpNode &op_node = graph_->Node(OpType::CPU, cpu_op_id);
+  typename WorkspacePolicy::template ws_t<OpType::CPU> ws =
+      WorkspacePolicy::template GetWorkspace<OpType::CPU>(cpu_idxs, *graph_, cpu_op_id);
+  TimeRange tr("[Executor] Run CPU op " + op_node.instance_name, TimeRange::kBlue1);
+
+  try {
+    RunHelper(op_node, ws);
+  } catch (std::exception &e) {
+    HandleError(e.what());
+  } catch (...) {
+    HandleError();
+  }
+}
+
+/**
+ * @brief Runs the CPU ops as a DAG - each op is issued from `cpu_op_issue_pool_`
+ * as soon as all its CPU parents are done, so per-sample work of independent
+ * ops interleaves in `thread_pool_`. Each op tracks its work in its own ThreadPool::WorkGroup.
+ */
+template <typename WorkspacePolicy, typename QueuePolicy>
+void Executor<WorkspacePolicy, QueuePolicy>::RunCPUOpsConcurrently(QueueIdxs cpu_idxs) {
+  int num_cpu_ops = graph_->NumOp(OpType::CPU);
+  std::unique_ptr<std::atomic<int>[]> pending(new std::atomic<int>[num_cpu_ops]);
+  for (int i = 0; i < num_cpu_ops; ++i) {
+    pending[i] = cpu_op_num_parents_[i];
+  }
+
+  std::function<void(int)> run_op = [&](int cpu_op_id) {
+    {
+      // the op waits only for its own per-sample work and sees only its own errors
+      ThreadPool::WorkGroup group(&thread_pool_);
+      ThreadPool::WorkGroupScope scope(&group);
+      RunCPUOp(cpu_idxs, cpu_op_id);
+    }
+    for (int child : cpu_op_children_[cpu_op_id]) {
+      if (--pending[child] == 0) {
+        cpu_op_issue_pool_->DoWorkWithID([&run_op, child](int) { run_op(child); });
+      }
+    }
+  };
+
+  for (int cpu_op_id = 0; cpu_op_id < num_cpu_ops; ++cpu_op_id) {
+    if (cpu_op_num_parents_[cpu_op_id] == 0) {
+      cpu_op_issue_pool_->DoWorkWithID([&run_op, cpu_op_id](int) { run_op(cpu_op_id); });
+    }
+  }
+  try {
+    cpu_op_issue_pool_->WaitForWork();
+  } catch (std::exception &e) {
+    HandleError(e.what());
+  }
 }
 
 template <typename WorkspacePolicy, typename QueuePolicy>
@@ -374,11 +550,14 @@ void Executor<WorkspacePolicy, QueuePolicy>::RunMixed() {
   TimeRange tr("[Executor] RunMixed");
   DeviceGuard g(device_id_);
 
+  ProfilerRange mixed_wait(profiler_, "mixed", profiler_category::kQueueWait);
   auto mixed_idxs = QueuePolicy::AcquireIdxs(OpType::MIXED);
+  mixed_wait.stop();
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(mixed_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::MIXED, mixed_idxs);
     return;
   }
+  ProfilerRange mixed_stage(profiler_, "mixed", profiler_category::kStage);
 
   try {
     for (int i = 0; i < graph_->NumOp(OpType::MIXED); ++i) {
@@ -411,11 +590,14 @@ template <typename WorkspacePolicy, typename QueuePolicy>
 void Executor<WorkspacePolicy, QueuePolicy>::RunGPU() {
   TimeRange tr("[Executor] RunGPU");
 
+  ProfilerRange gpu_wait(profiler_, "gpu", profiler_category::kQueueWait);
   auto gpu_idxs = QueuePolicy::AcquireIdxs(OpType::GPU);
+  gpu_wait.stop();
   if (exec_error_ || QueuePolicy::IsStopSignaled() || !QueuePolicy::AreValid(gpu_idxs)) {
     QueuePolicy::ReleaseIdxs(OpType::GPU, gpu_idxs);
     return;
   }
+  ProfilerRange gpu_stage(profiler_, "gpu", profiler_category::kStage);
   DeviceGuard g(device_id_);
 
   // Enforce our assumed dependency between consecutive
@@ -517,7 +699,16 @@ void Executor<WorkspacePolicy, QueuePolicy>::ShareOutputs(DeviceWorkspace *ws) {
     throw std::runtime_error(error);
   }
 
+  auto consumer_wait_start = QueueAutotuner::clock::now();
+  ProfilerRange output_wait(profiler_, "outputs", profiler_category::kOutputWait);
   auto output_idx = QueuePolicy::UseOutputIdxs();
+  output_wait.stop();
+  if (autotuner_ &&
+      autotuner_->AddConsumerWait(QueueAutotuner::clock::now() - consumer_wait_start)) {
+    QueuePolicy::SetActiveQueueDepth(std::min(autotuner_->queue_depth(),
+                                              queue_depth_limit_.load()));
+    thread_pool_.SetNumActiveThreads(autotuner_->num_threads());
+  }
 
   if (exec_error_ || QueuePolicy::IsStopSignaled()) {
     std::lock_guard<std::mutex> errors_lock(errors_mutex_);
@@ -499,6 +499,71 @@ TYPED_TEST(ExecutorTest, TestRunBasicGraphWithCB) {
   ASSERT_TRUE(ws.OutputIsType<CPUBackend>(0));
 }
 
+TYPED_TEST(ExecutorTest, TestRunIndependentCPUOps) {
+  this->num_threads_ = 4;
+  auto exe = this->GetExecutor(this->batch_size_, this->num_threads_, 0, 1);
+  exe->Init();
+
+  // Two independent CPU branches consuming the same input
+  OpGraph graph;
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ExternalSource")
+          .AddArg("device", "cpu")
+          .AddArg("device_id", 0)
+          .AddOutput("data", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ImageDecoder")
+          .AddArg("device", "cpu")
+          .AddInput("data", "cpu")
+          .AddOutput("images1", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("ImageDecoder")
+          .AddArg("device", "cpu")
+          .AddInput("data", "cpu")
+          .AddOutput("images2", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("MakeContiguous")
+          .AddArg("device", "mixed")
+          .AddInput("images1", "cpu")
+          .AddOutput("final_images1", "cpu")), "");
+
+  graph.AddOp(this->PrepareSpec(
+          OpSpec("MakeContiguous")
+          .AddArg("device", "mixed")
+          .AddInput("images2", "cpu")
+          .AddOutput("final_images2", "cpu")), "");
+
+  vector<string> outputs = {"final_images1_cpu", "final_images2_cpu"};
+  exe->Build(&graph, outputs);
+
+  auto *src_op =
+      dynamic_cast<ExternalSource<CPUBackend> *>(graph.Node(OpType::CPU, 0).op.get());
+  ASSERT_NE(src_op, nullptr);
+  TensorList<CPUBackend> tl;
+  this->MakeJPEGBatch(&tl, this->batch_size_);
+  src_op->SetDataSource(tl);
+
+  exe->RunCPU();
+  exe->RunMixed();
+  exe->RunGPU();
+
+  DeviceWorkspace ws;
+  exe->Outputs(&ws);
+  ASSERT_EQ(ws.NumOutput(), 2);
+  for (int out = 0; out < 2; ++out) {
+    ASSERT_TRUE(ws.OutputIsType<CPUBackend>(out));
+    auto &images = ws.Output<CPUBackend>(out);
+    ASSERT_EQ(static_cast<int>(images.ntensor()), this->batch_size_);
+    for (int i = 0; i < this->batch_size_; ++i) {
+      this->VerifyDecode(images.template tensor<uint8>(i),
+                         images.tensor_shape(i)[0], images.tensor_shape(i)[1], i);
+    }
+  }
+}
+
 // This test does not work with Async Executors
 TYPED_TEST(ExecutorSyncTest, TestPrefetchedExecution) {
   int batch_size = this->batch_size_ / 2;
@@ -0,0 +1,171 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_EXECUTOR_QUEUE_AUTOTUNER_H_
+#define DALI_PIPELINE_EXECUTOR_QUEUE_AUTOTUNER_H_
+
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+/**
+ * @brief Bounds for the values chosen by the QueueAutotuner
+ *
+ * The upper bounds are the values the pipeline was built with - the buffers and threads
+ * are allocated upfront and the autotuner only changes how many of them are in use.
+ */
+struct AutotuneLimits {
+  int min_queue_depth = 1;
+  int max_queue_depth = 2;
+  int min_threads = 1;
+  int max_threads = 1;
+  // Number of iterations over which the measurements are averaged before a decision
+  int window = 16;
+};
+
+struct AutotuneDecision {
+  int64_t iteration;
+  int queue_depth;
+  int num_threads;
+  std::string reason;
+};
+
+/**
+ * @brief Chooses the CPU queue depth and the number of active worker threads based on
+ * the time the consumer waits for outputs and the time the CPU stage waits for free buffers.
+ *
+ * - If the consumer waits for the outputs, the CPU stage is the bottleneck:
+ *   more threads are activated first and then the queue gets deeper to absorb jitter.
+ * - If the CPU stage spends most of its time waiting for a free buffer, the consumer
+ *   is the bottleneck: the queue gets shallower first and then threads are deactivated.
+ *
+ * Measurements can be added from different threads.
+ */
+class QueueAutotuner {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  // Fraction of the CPU stage time the consumer may wait before the CPU stage is scaled up
+  static constexpr double kConsumerWaitThreshold = 0.05;
+  // Fraction of the CPU stage time the CPU stage may wait before it is scaled down
+  static constexpr double kProducerWaitThreshold = 0.5;
+
+  explicit QueueAutotuner(const AutotuneLimits &limits)
+      : limits_(limits), queue_depth_(limits.max_queue_depth), num_threads_(limits.max_threads) {
+    DALI_ENFORCE(limits.min_queue_depth >= 1 && limits.min_queue_depth <= limits.max_queue_depth,
+                 "Invalid queue depth limits for autotuning");
+    DALI_ENFORCE(limits.min_threads >= 1 && limits.min_threads <= limits.max_threads,
+                 "Invalid thread count limits for autotuning");
+    DALI_ENFORCE(limits.window > 0, "Autotuning window must be positive");
+  }
+
+  /**
+   * @brief Time the CPU stage spent waiting for a free buffer and running, for one iteration
+   */
+  void AddProducerTimes(clock::duration wait, clock::duration busy) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    producer_wait_ += wait;
+    producer_busy_ += busy;
+    producer_iters_++;
+  }
+
+  /**
+   * @brief Time the consumer spent waiting for one output
+   *
+   * @return true, if a new decision was made - see queue_depth() and num_threads()
+   */
+  bool AddConsumerWait(clock::duration wait) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    consumer_wait_ += wait;
+    iteration_++;
+    if (++consumer_iters_ < limits_.window || producer_iters_ == 0)
+      return false;
+    bool changed = Decide();
+    consumer_wait_ = producer_wait_ = producer_busy_ = clock::duration::zero();
+    consumer_iters_ = producer_iters_ = 0;
+    return changed;
+  }
+
+  int queue_depth() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return queue_depth_;
+  }
+
+  int num_threads() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return num_threads_;
+  }
+
+  std::vector<AutotuneDecision> Log() const {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return log_;
+  }
+
+ private:
+  bool Decide() {
+    using ms = std::chrono::duration<double, std::milli>;
+    double consumer_wait = ms(consumer_wait_).count() / consumer_iters_;
+    double producer_wait = ms(producer_wait_).count() / producer_iters_;
+    double producer_busy = ms(producer_busy_).count() / producer_iters_;
+    auto stats = " (consumer wait " + to_string(consumer_wait) + " ms, CPU stage wait " +
+                 to_string(producer_wait) + " ms, CPU stage busy " +
+                 to_string(producer_busy) + " ms per iteration)";
+
+    if (consumer_wait > kConsumerWaitThreshold * producer_busy) {
+      if (num_threads_ < limits_.max_threads) {
+        num_threads_++;
+        return Commit("consumer starved, adding a worker thread" + stats);
+      }
+      if (queue_depth_ < limits_.max_queue_depth) {
+        queue_depth_++;
+        return Commit("consumer starved, increasing CPU queue depth" + stats);
+      }
+    } else if (producer_wait > kProducerWaitThreshold * producer_busy) {
+      if (queue_depth_ > limits_.min_queue_depth) {
+        queue_depth_--;
+        return Commit("CPU stage ahead of consumer, decreasing CPU queue depth" + stats);
+      }
+      if (num_threads_ > limits_.min_threads) {
+        num_threads_--;
+        return Commit("CPU stage ahead of consumer, removing a worker thread" + stats);
+      }
+    }
+    return false;
+  }
+
+  bool Commit(const std::string &reason) {
+    log_.push_back({iteration_, queue_depth_, num_threads_, reason});
+    return true;
+  }
+
+  AutotuneLimits limits_;
+  int queue_depth_, num_threads_;
+  int64_t iteration_ = 0;
+  int consumer_iters_ = 0, producer_iters_ = 0;
+  clock::duration consumer_wait_ = clock::duration::zero();
+  clock::duration producer_wait_ = clock::duration::zero();
+  clock::duration producer_busy_ = clock::duration::zero();
+  std::vector<AutotuneDecision> log_;
+  mutable std::mutex mutex_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_EXECUTOR_QUEUE_AUTOTUNER_H_
@@ -0,0 +1,132 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <atomic>
+#include <chrono>
+#include <thread>
+#include "dali/pipeline/executor/queue_autotuner.h"
+#include "dali/pipeline/util/thread_pool.h"
+
+namespace dali {
+
+namespace {
+
+using ms = std::chrono::milliseconds;
+
+AutotuneLimits TestLimits() {
+  AutotuneLimits limits;
+  limits.min_queue_depth = 1;
+  limits.max_queue_depth = 3;
+  limits.min_threads = 1;
+  limits.max_threads = 2;
+  limits.window = 4;
+  return limits;
+}
+
+// Feeds one window of measurements, returns the result of the last AddConsumerWait
+bool RunWindow(QueueAutotuner &tuner, int window, ms consumer_wait, ms producer_wait,
+               ms producer_busy) {
+  bool changed = false;
+  for (int i = 0; i < window; i++) {
+    tuner.AddProducerTimes(producer_wait, producer_busy);
+    changed = tuner.AddConsumerWait(consumer_wait);
+  }
+  return changed;
+}
+
+}  // namespace
+
+TEST(QueueAutotunerTest, StartsAtMaximum) {
+  QueueAutotuner tuner(TestLimits());
+  EXPECT_EQ(tuner.queue_depth(), 3);
+  EXPECT_EQ(tuner.num_threads(), 2);
+  EXPECT_TRUE(tuner.Log().empty());
+}
+
+TEST(QueueAutotunerTest, InvalidLimits) {
+  auto limits = TestLimits();
+  limits.min_queue_depth = 4;
+  EXPECT_THROW(QueueAutotuner{limits}, std::runtime_error);
+  limits = TestLimits();
+  limits.min_threads = 0;
+  EXPECT_THROW(QueueAutotuner{limits}, std::runtime_error);
+}
+
+TEST(QueueAutotunerTest, DecidesOncePerWindow) {
+  QueueAutotuner tuner(TestLimits());
+  for (int i = 0; i < 3; i++) {
+    tuner.AddProducerTimes(ms(10), ms(10));
+    EXPECT_FALSE(tuner.AddConsumerWait(ms(0)));
+  }
+  tuner.AddProducerTimes(ms(10), ms(10));
+  EXPECT_TRUE(tuner.AddConsumerWait(ms(0)));
+  EXPECT_EQ(tuner.queue_depth(), 2);
+}
+
+TEST(QueueAutotunerTest, ShrinksWhenConsumerIsSlow) {
+  QueueAutotuner tuner(TestLimits());
+  // The CPU stage waits for free buffers: first the queue is shortened, then threads removed
+  EXPECT_TRUE(RunWindow(tuner, 4, ms(0), ms(10), ms(10)));
+  EXPECT_EQ(tuner.queue_depth(), 2);
+  EXPECT_TRUE(RunWindow(tuner, 4, ms(0), ms(10), ms(10)));
+  EXPECT_EQ(tuner.queue_depth(), 1);
+  EXPECT_EQ(tuner.num_threads(), 2);
+  EXPECT_TRUE(RunWindow(tuner, 4, ms(0), ms(10), ms(10)));
+  EXPECT_EQ(tuner.num_threads(), 1);
+  // Already at the minimum
+  EXPECT_FALSE(RunWindow(tuner, 4, ms(0), ms(10), ms(10)));
+  EXPECT_EQ(tuner.Log().size(), 3u);
+}
+
+TEST(QueueAutotunerTest, GrowsWhenConsumerIsStarved) {
+  QueueAutotuner tuner(TestLimits());
+  RunWindow(tuner, 4, ms(0), ms(10), ms(10));
+  RunWindow(tuner, 4, ms(0), ms(10), ms(10));
+  RunWindow(tuner, 4, ms(0), ms(10), ms(10));
+  ASSERT_EQ(tuner.queue_depth(), 1);
+  ASSERT_EQ(tuner.num_threads(), 1);
+  // The consumer waits: first threads are added, then the queue gets deeper
+  EXPECT_TRUE(RunWindow(tuner, 4, ms(5), ms(0), ms(10)));
+  EXPECT_EQ(tuner.num_threads(), 2);
+  EXPECT_EQ(tuner.queue_depth(), 1);
+  EXPECT_TRUE(RunWindow(tuner, 4, ms(5), ms(0), ms(10)));
+  EXPECT_EQ(tuner.queue_depth(), 2);
+  // Balanced - no change
+  EXPECT_FALSE(RunWindow(tuner, 4, ms(0), ms(1), ms(10)));
+  EXPECT_EQ(tuner.queue_depth(), 2);
+  EXPECT_EQ(tuner.num_threads(), 2);
+}
+
+TEST(ThreadPoolTest, NumActiveThreads) {
+  ThreadPool pool(4, 0, false);
+  EXPECT_EQ(pool.NumActiveThreads(), 4);
+  pool.SetNumActiveThreads(2);
+  std::atomic<int> max_id{-1};
+  std::atomic<int> done{0};
+  for (int i = 0; i < 64; i++) {
+    pool.DoWorkWithID([&](int thread_id) {
+      int prev = max_id.load();
+      while (prev < thread_id && !max_id.compare_exchange_weak(prev, thread_id)) {}
+      std::this_thread::sleep_for(std::chrono::microseconds(100));
+      done++;
+    });
+  }
+  pool.WaitForWork();
+  EXPECT_EQ(done, 64);
+  EXPECT_LT(max_id, 2);
+  EXPECT_THROW(pool.SetNumActiveThreads(5), std::runtime_error);
+}
+
+}  // namespace dali
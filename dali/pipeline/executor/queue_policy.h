@@ -18,6 +18,7 @@
 #include <cuda_runtime_api.h>
 #include <atomic>
 #include <condition_variable>
+#include <limits>
 #include <mutex>
 #include <queue>
 #include <vector>
@@ -48,6 +49,8 @@ namespace dali {
 //   void SignalStop();
 //   // Returns true if we signaled stop previously
 //   bool IsStopSignaled();
+//   // Limit the number of buffers the CPU stage can fill ahead of the consumer
+//   void SetActiveQueueDepth(int depth);
 // };
 
 
@@ -78,13 +81,15 @@ struct UniformQueuePolicy {
       // Block until there is a free buffer to use
       std::unique_lock<std::mutex> lock(free_mutex_);
       free_cond_.wait(lock, [stage, this]() {
-        return !free_queue_.empty() || stage_work_stop_[static_cast<int>(stage)];
+        return (!free_queue_.empty() && in_flight_ < active_depth_) ||
+               stage_work_stop_[static_cast<int>(stage)];
       });
       if (stage_work_stop_[static_cast<int>(stage)]) {
         return QueueIdxs{kInvalidIdx};  // We return anything due to exec error
       }
       int queue_idx = free_queue_.front();
       free_queue_.pop();
+      in_flight_++;
       return QueueIdxs{queue_idx};
     }
 
@@ -149,11 +154,20 @@ struct UniformQueuePolicy {
         std::lock_guard<std::mutex> lock(free_mutex_);
         free_queue_.push(in_use_queue_.front());
         in_use_queue_.pop();
+        in_flight_--;
       }
       free_cond_.notify_one();
     }
   }
 
+  void SetActiveQueueDepth(int depth) {
+    {
+      std::lock_guard<std::mutex> lock(free_mutex_);
+      active_depth_ = depth;
+    }
+    free_cond_.notify_all();
+  }
+
   void NotifyAll() {
     ready_cond_.notify_all();
     free_cond_.notify_all();
@@ -181,6 +195,9 @@ struct UniformQueuePolicy {
   std::queue<int> ready_queue_, free_queue_, in_use_queue_;
   std::mutex ready_mutex_, free_mutex_;
   std::condition_variable ready_cond_, free_cond_;
+  // Number of buffers taken from the free queue and its limit, guarded by free_mutex_
+  int in_flight_ = 0;
+  int active_depth_ = std::numeric_limits<int>::max();
 
   static const int kOpCount = static_cast<int>(OpType::COUNT);
   std::array<std::queue<int>, kOpCount> stage_work_queue_;
@@ -256,8 +273,10 @@ struct SeparateQueuePolicy {
     // There always is a current stage
     {
       std::unique_lock<std::mutex> free_current_lock(stage_free_mutex_[current_stage]);
-      stage_free_cv_[current_stage].wait(free_current_lock, [current_stage, this]() {
-        return !stage_free_[current_stage].empty() || stage_free_stop_[current_stage];
+      stage_free_cv_[current_stage].wait(free_current_lock, [stage, current_stage, this]() {
+        return (!stage_free_[current_stage].empty() &&
+                (stage != OpType::CPU || cpu_in_flight_ < active_cpu_depth_)) ||
+               stage_free_stop_[current_stage];
       });
       if (stage_free_stop_[current_stage]) {
         return QueueIdxs{kInvalidIdx};
@@ -265,6 +284,9 @@ struct SeparateQueuePolicy {
       // We add info about current stage
       result[stage] = stage_free_[current_stage].front();
       stage_free_[current_stage].pop();
+      if (stage == OpType::CPU) {
+        cpu_in_flight_++;
+      }
     }
     return result;
   }
@@ -372,6 +394,15 @@ struct SeparateQueuePolicy {
     return ready_stop_;
   }
 
+  void SetActiveQueueDepth(int depth) {
+    int cpu_stage = static_cast<int>(OpType::CPU);
+    {
+      std::lock_guard<std::mutex> free_lock(stage_free_mutex_[cpu_stage]);
+      active_cpu_depth_ = depth;
+    }
+    stage_free_cv_[cpu_stage].notify_all();
+  }
+
  private:
   friend void detail::release_callback(cudaStream_t stream, cudaError_t status, void *userData);
 
@@ -381,6 +412,9 @@ struct SeparateQueuePolicy {
     {
       std::lock_guard<std::mutex> free_lock(stage_free_mutex_[released_stage]);
       stage_free_[released_stage].push(idx);
+      if (stage == OpType::CPU) {
+        cpu_in_flight_--;
+      }
     }
     // We freed buffer, so we notfiy the released stage it can continue it's work
     stage_free_cv_[released_stage].notify_one();
@@ -413,6 +447,10 @@ struct SeparateQueuePolicy {
   // next time Ouputs() is called.
   std::array<std::queue<int>, kOpCount> stage_free_;
   std::array<std::queue<QueueIdxs>, kOpCount> stage_ready_;
+  // Number of CPU buffers taken from the free queue and its limit,
+  // guarded by the CPU stage_free_mutex_
+  int cpu_in_flight_ = 0;
+  int active_cpu_depth_ = std::numeric_limits<int>::max();
 
   std::condition_variable ready_output_cv_, free_cond_;
   // Output ready and in_use mutexes and queues
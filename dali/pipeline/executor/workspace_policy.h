@@ -118,6 +118,20 @@ inline void SetupThreadPool<OpType::CPU>(op_type_to_workspace_t<OpType::CPU> &ws
   ws.SetThreadPool(thread_pool);
 }
 
+template <OpType op_type>
+inline void PrepareSampleWorkspaces(op_type_to_workspace_t<op_type> &ws, const OpNode &) {
+  /* No-op if we are not CPU */
+}
+
+/**
+ * @brief Builds the per-sample views of a CPU workspace that is kept across iterations,
+ * so that running the op doesn't have to assemble them for every sample.
+ */
+template <>
+inline void PrepareSampleWorkspaces<OpType::CPU>(HostWorkspace &ws, const OpNode &node) {
+  ws.PrepareSamples(node.spec.GetArgument<int>("batch_size"));
+}
+
 template <OpType op_type>
 void SetupStreamsAndEvents(op_type_to_workspace_t<op_type> &ws,
                            const OpGraph &graph, const OpNode &node,
@@ -420,11 +434,12 @@ struct AOT_WS_Policy<SeparateQueuePolicy> {
     workspaces[sequential_ws_idx].resize(graph.NumOp(op_type));
     for (OpPartitionId partition_idx = 0; partition_idx < graph.NumOp(op_type); partition_idx++) {
       auto &node = graph.Node(op_type, partition_idx);
-      workspaces[sequential_ws_idx][partition_idx] =
-          CreateWorkspace<op_type>(graph, node,
-                                   tensor_to_store_queue, thread_pool,
-                                   mixed_op_stream, gpu_op_stream,
-                                   mixed_op_events, idxs);
+      auto &ws = workspaces[sequential_ws_idx][partition_idx];
+      ws = CreateWorkspace<op_type>(graph, node,
+                                    tensor_to_store_queue, thread_pool,
+                                    mixed_op_stream, gpu_op_stream,
+                                    mixed_op_events, idxs);
+      PrepareSampleWorkspaces<op_type>(ws, node);
     }
   }
 };
@@ -513,6 +528,7 @@ struct AOT_WS_Policy<UniformQueuePolicy> {
                                              tensor_to_store_queue, thread_pool,
                                              mixed_op_stream, gpu_op_stream,
                                              mixed_op_events, QueueIdxs{queue_idx});
+        PrepareSampleWorkspaces<op_type_static>(ws, node);
       ), DALI_FAIL("Invalid op type"));  // NOLINT(whitespace/parens)
     }
   }
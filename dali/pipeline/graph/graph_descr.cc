@@ -15,6 +15,7 @@
 #include <algorithm>
 
 #include "dali/pipeline/graph/op_graph.h"
+#include "dali/pipeline/data/memory_account.h"
 
 #include "dali/pipeline/operators/op_schema.h"
 
@@ -210,7 +211,10 @@ void OpGraph::InstantiateOperators() {
 
   for (auto op_type : order) {
     for (auto op_id : op_partitions_[static_cast<int>(op_type)]) {
-      op_nodes_[op_id].InstantiateOperator();
+      auto &node = op_nodes_[op_id];
+      // memory allocated by the operator constructor (e.g. a cache) is charged to it
+      MemoryAccountScope memory_scope(MemoryAccount::Current(), node.instance_name);
+      node.InstantiateOperator();
     }
   }
 }
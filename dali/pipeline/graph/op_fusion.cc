@@ -0,0 +1,410 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dali/pipeline/graph/op_fusion.h"
+
+#include <algorithm>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/pipeline/operators/op_schema.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief A chain of operators matched by a pattern and the spec of the operator replacing it
+ */
+struct Chain {
+  std::vector<int> ops;
+  OpSpec fused;
+};
+
+class Matcher {
+ public:
+  Matcher(const std::vector<OpDefinition> &ops, const std::set<std::string> &outputs,
+          const OpAvailableFn &is_available)
+  : ops_(ops), outputs_(outputs), is_available_(is_available) {}
+
+  const OpSpec &Spec(int op) const {
+    return ops_[op].spec;
+  }
+
+  std::string Device(int op) const {
+    return Spec(op).GetArgument<std::string>("device");
+  }
+
+  bool Is(int op, const char *name) const {
+    return op >= 0 && Spec(op).name() == name;
+  }
+
+  bool Available(const std::string &op_name, const std::string &device) const {
+    return is_available_(op_name, device);
+  }
+
+  /**
+   * @brief Returns the index of the only operator consuming the output of `producer`,
+   * or -1 if the output is used by more than one operator, not as the first regular input,
+   * or is an output of the pipeline.
+   */
+  int Next(int producer) const {
+    const OpSpec &spec = Spec(producer);
+    if (spec.NumOutput() != 1 || outputs_.count(spec.OutputName(0)))
+      return -1;
+    const std::string &name = spec.OutputName(0);
+    int consumer = -1;
+    for (int i = 0; i < static_cast<int>(ops_.size()); i++) {
+      const OpSpec &other = Spec(i);
+      for (int j = 0; j < other.NumInput(); j++) {
+        if (other.InputName(j) != name)
+          continue;
+        if (consumer >= 0 || j != 0 || other.IsArgumentInput(j))
+          return -1;
+        consumer = i;
+      }
+    }
+    return consumer;
+  }
+
+ private:
+  const std::vector<OpDefinition> &ops_;
+  const std::set<std::string> &outputs_;
+  const OpAvailableFn &is_available_;
+};
+
+// Populated by the pipeline, rather than by the user
+const char *const kPipelineArgs[] = {
+  "device", "batch_size", "num_threads", "device_id", "cpu_prefetch_queue_depth",
+  "gpu_prefetch_queue_depth", "seed", "bytes_per_sample_hint", "preserve"
+};
+
+// Pipeline arguments which describe the output or the randomness - taken from the last op
+const char *const kPipelineArgsOfTail[] = {
+  "seed", "bytes_per_sample_hint", "preserve"
+};
+
+template <size_t N>
+bool Contains(const char *const (&names)[N], const std::string &name) {
+  return std::find(names, names + N, name) != names + N;
+}
+
+/**
+ * @brief Creates the spec of the fused operator, running on the device of `head`
+ * and producing the output of `tail`.
+ */
+OpSpec StartFused(const std::string &name, const OpSpec &head, const OpSpec &tail) {
+  OpSpec fused(name);
+  for (const char *arg : kPipelineArgs) {
+    const OpSpec &source = Contains(kPipelineArgsOfTail, arg) ? tail : head;
+    if (source.HasArgument(arg))
+      fused.ShareArgument(source, arg);
+  }
+  fused.AddOutput(tail.OutputName(0), tail.OutputDevice(0));
+  return fused;
+}
+
+bool SameValue(const OpSpec &a, const OpSpec &b, const std::string &name) {
+  bool a_tensor = a.HasTensorArgument(name), b_tensor = b.HasTensorArgument(name);
+  if (a_tensor || b_tensor) {
+    return a_tensor && b_tensor &&
+           a.InputName(a.ArgumentInputs().at(name)) == b.InputName(b.ArgumentInputs().at(name));
+  }
+  return a.Arguments().at(name)->ToString() == b.Arguments().at(name)->ToString();
+}
+
+/**
+ * @brief Gives `to` all the arguments specified for `from`, except for the pipeline ones
+ * and `skip`.
+ *
+ * Fails if the fused operator doesn't have the argument or if it has already been given
+ * a different value by another operator of the chain.
+ */
+bool CopyArguments(const OpSpec &from, OpSpec &to, const std::set<std::string> &skip = {}) {
+  const OpSchema &schema = SchemaRegistry::GetSchema(to.name());
+  for (const auto &name : from.ListArguments()) {
+    if (Contains(kPipelineArgs, name) || skip.count(name))
+      continue;
+    if (!schema.HasArgument(name))
+      return false;
+    if (to.ArgumentDefined(name)) {
+      if (!SameValue(from, to, name))
+        return false;
+      continue;
+    }
+    to.ShareArgument(from, name);
+  }
+  return true;
+}
+
+/**
+ * @brief Flip can be fused only if it flips horizontally (or not at all)
+ */
+bool IsMirror(const Matcher &m, int op) {
+  if (!m.Is(op, "Flip"))
+    return false;
+  const OpSpec &flip = m.Spec(op);
+  return !flip.HasTensorArgument("vertical") && flip.GetArgument<int>("vertical") == 0;
+}
+
+/**
+ * @brief Passes the `horizontal` argument of Flip as `name` - always explicitly,
+ * as the defaults of Flip and the fused operators differ.
+ */
+bool CopyMirror(const OpSpec &flip, OpSpec &to, const std::string &name) {
+  if (!CopyArguments(flip, to, {"horizontal", "vertical"}))
+    return false;
+  if (flip.HasTensorArgument("horizontal"))
+    to.AddArgumentInput(name, flip.InputName(flip.ArgumentInputs().at("horizontal")));
+  else
+    to.SetArg(name, flip.GetArgument<int>("horizontal"));
+  return true;
+}
+
+bool IsDecoder(const Matcher &m, int op) {
+  if (!m.Is(op, "ImageDecoder"))
+    return false;
+  auto device = m.Device(op);
+  return device == "cpu" || device == "mixed";
+}
+
+// ImageDecoder -> Crop -> Flip  =>  ImageDecoderCropFlip
+bool MatchDecoderCropFlip(const Matcher &m, int head, Chain *chain) {
+  int crop = m.Next(head);
+  int flip = crop >= 0 ? m.Next(crop) : -1;
+  if (!IsDecoder(m, head) || !m.Is(crop, "Crop") || !IsMirror(m, flip) ||
+      !m.Available("ImageDecoderCropFlip", m.Device(head)))
+    return false;
+  const OpSpec &decoder = m.Spec(head);
+  chain->ops = {head, crop, flip};
+  chain->fused = StartFused("ImageDecoderCropFlip", decoder, m.Spec(flip));
+  chain->fused.AddInput(decoder.InputName(0), decoder.InputDevice(0));
+  // the lossless DCT-domain transform may change the chroma of subsampled images
+  chain->fused.SetArg("lossless_transform", false);
+  // the color space is defined by the decoder
+  return CopyArguments(decoder, chain->fused) &&
+         CopyArguments(m.Spec(crop), chain->fused, {"image_type"}) &&
+         CopyMirror(m.Spec(flip), chain->fused, "horizontal");
+}
+
+// ImageDecoder -> Crop  =>  ImageDecoderCrop
+bool MatchDecoderCrop(const Matcher &m, int head, Chain *chain) {
+  int crop = m.Next(head);
+  if (!IsDecoder(m, head) || !m.Is(crop, "Crop") ||
+      !m.Available("ImageDecoderCrop", m.Device(head)))
+    return false;
+  const OpSpec &decoder = m.Spec(head);
+  chain->ops = {head, crop};
+  chain->fused = StartFused("ImageDecoderCrop", decoder, m.Spec(crop));
+  chain->fused.AddInput(decoder.InputName(0), decoder.InputDevice(0));
+  return CopyArguments(decoder, chain->fused) &&
+         CopyArguments(m.Spec(crop), chain->fused, {"image_type"});
+}
+
+// ImageDecoder -> Slice  =>  ImageDecoderSlice
+bool MatchDecoderSlice(const Matcher &m, int head, Chain *chain) {
+  int slice = m.Next(head);
+  if (!IsDecoder(m, head) || !m.Is(slice, "Slice") ||
+      !m.Available("ImageDecoderSlice", m.Device(head)))
+    return false;
+  const OpSpec &decoder = m.Spec(head);
+  const OpSpec &slice_spec = m.Spec(slice);
+  if (slice_spec.NumRegularInput() != 3 ||
+      slice_spec.InputDevice(1) != "cpu" || slice_spec.InputDevice(2) != "cpu")
+    return false;
+  chain->ops = {head, slice};
+  chain->fused = StartFused("ImageDecoderSlice", decoder, slice_spec);
+  chain->fused.AddInput(decoder.InputName(0), decoder.InputDevice(0))
+              .AddInput(slice_spec.InputName(1), slice_spec.InputDevice(1))
+              .AddInput(slice_spec.InputName(2), slice_spec.InputDevice(2));
+  return CopyArguments(decoder, chain->fused) &&
+         CopyArguments(slice_spec, chain->fused, {"image_type"});
+}
+
+// ImageDecoder -> RandomResizedCrop  =>  ImageDecoderRandomResizedCrop
+bool MatchDecoderRandomResizedCrop(const Matcher &m, int head, Chain *chain) {
+  int rrc = m.Next(head);
+  if (!IsDecoder(m, head) || !m.Is(rrc, "RandomResizedCrop") ||
+      !m.Available("ImageDecoderRandomResizedCrop", m.Device(head)))
+    return false;
+  const OpSpec &decoder = m.Spec(head);
+  chain->ops = {head, rrc};
+  // the seed is taken from RandomResizedCrop, so the crop windows stay the same
+  chain->fused = StartFused("ImageDecoderRandomResizedCrop", decoder, m.Spec(rrc));
+  chain->fused.AddInput(decoder.InputName(0), decoder.InputDevice(0));
+  return CopyArguments(decoder, chain->fused) &&
+         CopyArguments(m.Spec(rrc), chain->fused);
+}
+
+/**
+ * @brief Checks whether Crop always produces a `height` x `width` window
+ * (a fixed 2D crop window, not given as a tensor argument)
+ */
+bool CropsTo(const OpSpec &crop, int height, int width) {
+  int crop_h, crop_w;
+  if (crop.HasArgument("crop")) {
+    auto window = crop.GetRepeatedArgument<float>("crop");
+    if (window.empty() || window.size() > 2)
+      return false;
+    crop_h = static_cast<int>(window.front());
+    crop_w = static_cast<int>(window.back());
+  } else {
+    if (!crop.HasArgument("crop_h") || !crop.HasArgument("crop_w") ||
+        crop.ArgumentDefined("crop_d"))
+      return false;
+    crop_h = static_cast<int>(crop.GetArgument<float>("crop_h"));
+    crop_w = static_cast<int>(crop.GetArgument<float>("crop_w"));
+  }
+  return crop_h == height && crop_w == width;
+}
+
+// Crop -> [Flip] -> NormalizePermute  =>  CropMirrorNormalize
+bool MatchCropMirrorNormalize(const Matcher &m, int head, Chain *chain) {
+  int next = m.Next(head);
+  int flip = IsMirror(m, next) ? next : -1;
+  int normalize = flip >= 0 ? m.Next(flip) : next;
+  if (!m.Is(head, "Crop") || !m.Is(normalize, "NormalizePermute") ||
+      !m.Available("CropMirrorNormalize", m.Device(head)))
+    return false;
+  const OpSpec &crop = m.Spec(head);
+  const OpSpec &normalize_spec = m.Spec(normalize);
+  // NormalizePermute requires its input to be exactly height x width, CropMirrorNormalize
+  // takes the size from the crop - fuse only if they are the same
+  if (!CropsTo(crop, normalize_spec.GetArgument<int>("height"),
+               normalize_spec.GetArgument<int>("width")))
+    return false;
+  chain->ops = {head};
+  if (flip >= 0)
+    chain->ops.push_back(flip);
+  chain->ops.push_back(normalize);
+  chain->fused = StartFused("CropMirrorNormalize", crop, normalize_spec);
+  chain->fused.AddInput(crop.InputName(0), crop.InputDevice(0));
+  return CopyArguments(crop, chain->fused) &&
+         (flip < 0 || CopyMirror(m.Spec(flip), chain->fused, "mirror")) &&
+         CopyArguments(normalize_spec, chain->fused, {"height", "width"});
+}
+
+// Resize -> Crop -> [Flip]  =>  ResizeCropMirror
+bool MatchResizeCropMirror(const Matcher &m, int head, Chain *chain) {
+  int crop = m.Next(head);
+  int next = crop >= 0 ? m.Next(crop) : -1;
+  int flip = IsMirror(m, next) ? next : -1;
+  if (!m.Is(head, "Resize") || !m.Is(crop, "Crop") ||
+      !m.Available("ResizeCropMirror", m.Device(head)))
+    return false;
+  const OpSpec &resize = m.Spec(head);
+  int tail = flip >= 0 ? flip : crop;
+  chain->ops = {head, crop};
+  if (flip >= 0)
+    chain->ops.push_back(flip);
+  chain->fused = StartFused("ResizeCropMirror", resize, m.Spec(tail));
+  chain->fused.AddInput(resize.InputName(0), resize.InputDevice(0));
+  return CopyArguments(resize, chain->fused) &&
+         CopyArguments(m.Spec(crop), chain->fused) &&
+         (flip < 0 || CopyMirror(m.Spec(flip), chain->fused, "mirror"));
+}
+
+struct FusionPattern {
+  const char *name;
+  // whether the fused operator gives the same results as the chain
+  bool exact;
+  bool (*match)(const Matcher &m, int head, Chain *chain);
+};
+
+// In order of preference - longer chains first
+const FusionPattern kPatterns[] = {
+  { "decoder_crop_flip", true, MatchDecoderCropFlip },
+  { "decoder_crop", true, MatchDecoderCrop },
+  { "decoder_slice", true, MatchDecoderSlice },
+  // RandomResizedCrop may resample vertically first, the fused decoder always resamples
+  // horizontally first
+  { "decoder_random_resized_crop", false, MatchDecoderRandomResizedCrop },
+  { "crop_mirror_normalize", true, MatchCropMirrorNormalize },
+  // ResizeCropMirror resamples with OpenCV instead of the resampling filters of Resize
+  { "resize_crop_mirror", false, MatchResizeCropMirror },
+};
+
+}  // namespace
+
+std::vector<std::string> DefaultFusionPatterns() {
+  std::vector<std::string> names;
+  for (auto &pattern : kPatterns) {
+    if (pattern.exact)
+      names.push_back(pattern.name);
+  }
+  return names;
+}
+
+std::vector<std::string> AllFusionPatterns() {
+  std::vector<std::string> names;
+  for (auto &pattern : kPatterns)
+    names.push_back(pattern.name);
+  return names;
+}
+
+std::vector<FusionRecord> FuseOperators(std::vector<OpDefinition> &ops,
+                                        const std::set<std::string> &outputs,
+                                        const OpAvailableFn &is_available,
+                                        std::vector<std::string> patterns) {
+  if (patterns.empty())
+    patterns = DefaultFusionPatterns();
+  std::vector<const FusionPattern *> enabled;
+  for (auto &pattern : kPatterns) {
+    if (std::find(patterns.begin(), patterns.end(), pattern.name) != patterns.end())
+      enabled.push_back(&pattern);
+  }
+  for (auto &name : patterns) {
+    auto known = AllFusionPatterns();
+    DALI_ENFORCE(std::find(known.begin(), known.end(), name) != known.end(),
+        "Unknown operator fusion pattern: \"" + name + "\"");
+  }
+
+  std::vector<FusionRecord> log;
+  bool changed = true;
+  while (changed) {
+    changed = false;
+    Matcher matcher(ops, outputs, is_available);
+    for (int head = 0; head < static_cast<int>(ops.size()) && !changed; head++) {
+      for (auto *pattern : enabled) {
+        Chain chain;
+        if (!pattern->match(matcher, head, &chain))
+          continue;
+
+        FusionRecord record;
+        record.pattern = pattern->name;
+        record.fused_op = chain.fused.name();
+        for (int op : chain.ops)
+          record.replaced.push_back(ops[op].instance_name);
+        log.push_back(std::move(record));
+
+        // The fused operator takes the place of the last one, after all of its
+        // argument inputs are produced
+        int tail = chain.ops.back();
+        ops[tail] = { ops[tail].instance_name, std::move(chain.fused), ops[head].logical_id };
+        chain.ops.pop_back();
+        std::sort(chain.ops.rbegin(), chain.ops.rend());
+        for (int op : chain.ops)
+          ops.erase(ops.begin() + op);
+        changed = true;
+        break;
+      }
+    }
+  }
+  return log;
+}
+
+}  // namespace dali
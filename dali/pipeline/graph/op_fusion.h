@@ -0,0 +1,88 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_PIPELINE_GRAPH_OP_FUSION_H_
+#define DALI_PIPELINE_GRAPH_OP_FUSION_H_
+
+#include <functional>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/operators/op_spec.h"
+
+namespace dali {
+
+/**
+ * @brief An operator instance, as added to the pipeline
+ */
+struct OpDefinition {
+  std::string instance_name;
+  OpSpec spec;
+  int logical_id;
+};
+
+/**
+ * @brief Describes a chain of operators replaced by a fused one
+ */
+struct FusionRecord {
+  std::string pattern;
+  // instance names of the replaced operators, in the order of the chain
+  std::vector<std::string> replaced;
+  // name of the fused operator
+  std::string fused_op;
+};
+
+/**
+ * @brief Tells whether the operator `op_name` is available for given device
+ */
+using OpAvailableFn = std::function<bool(const std::string &op_name, const std::string &device)>;
+
+/**
+ * @brief Names of the patterns which produce the same results as the chains they replace.
+ *
+ * These are applied when no patterns are explicitly requested.
+ */
+DLL_PUBLIC std::vector<std::string> DefaultFusionPatterns();
+
+/**
+ * @brief Names of all the patterns, including the ones that change the results slightly
+ * (e.g. by using a different resampling method).
+ */
+DLL_PUBLIC std::vector<std::string> AllFusionPatterns();
+
+/**
+ * @brief Replaces chains of operators with their fused equivalents
+ *
+ * A chain is fused only when every intermediate result is consumed solely by the next
+ * operator of the chain, none of them is an output of the pipeline, and every argument given
+ * to the operators of the chain has a counterpart in the fused operator.
+ *
+ * @param ops operators in the order they were added to the pipeline, already populated
+ *            with pipeline arguments (batch size, seed, ...); rewritten in place
+ * @param outputs names of the tensors which are outputs of the pipeline
+ * @param is_available checks if the fused operator exists for given device
+ * @param patterns names of the patterns to apply; empty means `DefaultFusionPatterns()`
+ * @return the applied rewrites, in order
+ */
+DLL_PUBLIC std::vector<FusionRecord> FuseOperators(std::vector<OpDefinition> &ops,
+                                                   const std::set<std::string> &outputs,
+                                                   const OpAvailableFn &is_available,
+                                                   std::vector<std::string> patterns = {});
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_GRAPH_OP_FUSION_H_
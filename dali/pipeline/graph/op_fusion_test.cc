@@ -0,0 +1,239 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dali/pipeline/graph/op_fusion.h"
+
+#include <gtest/gtest.h>
+
+#include <algorithm>
+#include <set>
+#include <string>
+#include <vector>
+
+namespace dali {
+
+namespace {
+
+OpDefinition MakeOp(const std::string &instance_name, OpSpec spec, int logical_id) {
+  // arguments added by Pipeline::PrepareOpSpec
+  spec.AddArg("batch_size", 2)
+      .AddArg("num_threads", 1)
+      .AddArg("device_id", 0)
+      .AddArg("seed", static_cast<int64_t>(1000 + logical_id));
+  return { instance_name, spec, logical_id };
+}
+
+bool AllAvailable(const std::string &, const std::string &) {
+  return true;
+}
+
+std::vector<OpDefinition> DecoderCropFlip(const std::string &device, int vertical = 0) {
+  std::string out_device = device == "cpu" ? "cpu" : "gpu";
+  return {
+    MakeOp("decoder", OpSpec("ImageDecoder")
+        .AddArg("device", device)
+        .AddArg("output_type", DALI_BGR)
+        .AddInput("jpegs", "cpu")
+        .AddOutput("images", out_device), 0),
+    MakeOp("crop", OpSpec("Crop")
+        .AddArg("device", out_device)
+        .AddArg("crop", std::vector<float>{224, 224})
+        .AddArg("crop_pos_x", 0.25f)
+        .AddInput("images", out_device)
+        .AddOutput("cropped", out_device), 1),
+    MakeOp("flip", OpSpec("Flip")
+        .AddArg("device", out_device)
+        .AddArg("vertical", vertical)
+        .AddInput("cropped", out_device)
+        .AddOutput("flipped", out_device), 2),
+  };
+}
+
+}  // namespace
+
+TEST(OpFusion, DecoderCropFlip) {
+  auto ops = DecoderCropFlip("cpu");
+  auto log = FuseOperators(ops, {"flipped"}, AllAvailable);
+
+  ASSERT_EQ(ops.size(), 1u);
+  const OpSpec &spec = ops[0].spec;
+  EXPECT_EQ(ops[0].instance_name, "flip");
+  EXPECT_EQ(spec.name(), "ImageDecoderCropFlip");
+  EXPECT_EQ(spec.GetArgument<std::string>("device"), "cpu");
+  ASSERT_EQ(spec.NumInput(), 1);
+  EXPECT_EQ(spec.InputName(0), "jpegs");
+  ASSERT_EQ(spec.NumOutput(), 1);
+  EXPECT_EQ(spec.OutputName(0), "flipped");
+  EXPECT_EQ(spec.GetArgument<DALIImageType>("output_type"), DALI_BGR);
+  EXPECT_EQ(spec.GetRepeatedArgument<float>("crop"), (std::vector<float>{224, 224}));
+  EXPECT_EQ(spec.GetArgument<float>("crop_pos_x"), 0.25f);
+  // Flip's default is explicitly passed, as it differs from the fused op's one
+  EXPECT_EQ(spec.GetArgument<int>("horizontal"), 1);
+  // the lossless transform doesn't give the same result as the chain
+  EXPECT_FALSE(spec.GetArgument<bool>("lossless_transform"));
+  // the randomness and the output belong to the last operator of the chain
+  EXPECT_EQ(spec.GetArgument<int64_t>("seed"), 1002);
+
+  ASSERT_EQ(log.size(), 1u);
+  EXPECT_EQ(log[0].pattern, "decoder_crop_flip");
+  EXPECT_EQ(log[0].replaced, (std::vector<std::string>{"decoder", "crop", "flip"}));
+  EXPECT_EQ(log[0].fused_op, "ImageDecoderCropFlip");
+}
+
+TEST(OpFusion, FallsBackToShorterChain) {
+  auto ops = DecoderCropFlip("cpu", 1);
+  auto log = FuseOperators(ops, {"flipped"}, AllAvailable);
+
+  // vertical flip can't be fused
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[0].spec.name(), "ImageDecoderCrop");
+  EXPECT_EQ(ops[0].spec.OutputName(0), "cropped");
+  EXPECT_EQ(ops[1].spec.name(), "Flip");
+  ASSERT_EQ(log.size(), 1u);
+  EXPECT_EQ(log[0].pattern, "decoder_crop");
+}
+
+TEST(OpFusion, UsesAvailableOperatorsOnly) {
+  auto ops = DecoderCropFlip("mixed");
+  auto is_available = [](const std::string &name, const std::string &device) {
+    return name != "ImageDecoderCropFlip" || device == "cpu";
+  };
+  FuseOperators(ops, {"flipped"}, is_available);
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[0].spec.name(), "ImageDecoderCrop");
+  EXPECT_EQ(ops[0].spec.GetArgument<std::string>("device"), "mixed");
+
+  ops = DecoderCropFlip("cpu");
+  auto log = FuseOperators(ops, {"flipped"},
+                           [](const std::string &, const std::string &) { return false; });
+  EXPECT_EQ(ops.size(), 3u);
+  EXPECT_TRUE(log.empty());
+}
+
+TEST(OpFusion, KeepsIntermediateResultsInUse) {
+  auto ops = DecoderCropFlip("cpu");
+  FuseOperators(ops, {"cropped", "flipped"}, AllAvailable);
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[0].spec.name(), "ImageDecoderCrop");
+  EXPECT_EQ(ops[1].spec.name(), "Flip");
+
+  ops = DecoderCropFlip("cpu");
+  ops.push_back(MakeOp("other_flip", OpSpec("Flip")
+      .AddArg("device", "cpu")
+      .AddInput("images", "cpu")
+      .AddOutput("other", "cpu"), 3));
+  auto log = FuseOperators(ops, {"flipped", "other"}, AllAvailable);
+  EXPECT_EQ(ops.size(), 4u);
+  EXPECT_TRUE(log.empty());
+}
+
+TEST(OpFusion, CropMirrorNormalize) {
+  std::vector<OpDefinition> ops = {
+    MakeOp("coin", OpSpec("CoinFlip")
+        .AddArg("device", "support")
+        .AddOutput("mirror", "cpu"), 0),
+    MakeOp("crop", OpSpec("Crop")
+        .AddArg("device", "gpu")
+        .AddArg("crop", std::vector<float>{224, 224})
+        .AddInput("images", "gpu")
+        .AddOutput("cropped", "gpu"), 1),
+    MakeOp("flip", OpSpec("Flip")
+        .AddArg("device", "gpu")
+        .AddInput("cropped", "gpu")
+        .AddArgumentInput("horizontal", "mirror")
+        .AddOutput("flipped", "gpu"), 2),
+    MakeOp("normalize", OpSpec("NormalizePermute")
+        .AddArg("device", "gpu")
+        .AddArg("height", 224)
+        .AddArg("width", 224)
+        .AddArg("mean", std::vector<float>{128, 128, 128})
+        .AddArg("std", std::vector<float>{64, 64, 64})
+        .AddArg("output_dtype", DALI_FLOAT16)
+        .AddInput("flipped", "gpu")
+        .AddOutput("normalized", "gpu"), 3),
+  };
+  auto log = FuseOperators(ops, {"normalized"}, AllAvailable);
+
+  ASSERT_EQ(ops.size(), 2u);
+  EXPECT_EQ(ops[0].spec.name(), "CoinFlip");
+  const OpSpec &spec = ops[1].spec;
+  EXPECT_EQ(spec.name(), "CropMirrorNormalize");
+  EXPECT_EQ(spec.GetArgument<std::string>("device"), "gpu");
+  EXPECT_EQ(spec.NumRegularInput(), 1);
+  EXPECT_EQ(spec.InputName(0), "images");
+  ASSERT_TRUE(spec.HasTensorArgument("mirror"));
+  EXPECT_EQ(spec.InputName(spec.ArgumentInputs().at("mirror")), "mirror");
+  EXPECT_EQ(spec.GetArgument<DALIDataType>("output_dtype"), DALI_FLOAT16);
+  EXPECT_EQ(spec.GetRepeatedArgument<float>("mean"), (std::vector<float>{128, 128, 128}));
+  EXPECT_FALSE(spec.HasArgument("height"));
+  ASSERT_EQ(log.size(), 1u);
+  EXPECT_EQ(log[0].replaced, (std::vector<std::string>{"crop", "flip", "normalize"}));
+}
+
+TEST(OpFusion, CropMirrorNormalizeRequiresMatchingSize) {
+  // NormalizePermute expects 224x200 inputs
+  auto crop = []() {
+    return OpSpec("Crop")
+        .AddArg("device", "gpu")
+        .AddInput("images", "gpu")
+        .AddOutput("cropped", "gpu");
+  };
+  auto fuses = [](const OpSpec &crop) {
+    std::vector<OpDefinition> ops = {
+      MakeOp("crop", crop, 0),
+      MakeOp("normalize", OpSpec("NormalizePermute")
+          .AddArg("device", "gpu")
+          .AddArg("height", 224)
+          .AddArg("width", 200)
+          .AddArg("mean", std::vector<float>{128, 128, 128})
+          .AddArg("std", std::vector<float>{64, 64, 64})
+          .AddInput("cropped", "gpu")
+          .AddOutput("normalized", "gpu"), 1),
+    };
+    return !FuseOperators(ops, {"normalized"}, AllAvailable).empty();
+  };
+  EXPECT_TRUE(fuses(crop().AddArg("crop", std::vector<float>{224, 200})));
+  EXPECT_TRUE(fuses(crop().AddArg("crop_h", 224.f).AddArg("crop_w", 200.f)));
+  EXPECT_FALSE(fuses(crop().AddArg("crop", std::vector<float>{200, 224})));
+  EXPECT_FALSE(fuses(crop().AddArg("crop", std::vector<float>{1, 224, 200})));
+  EXPECT_FALSE(fuses(crop().AddArg("crop_h", 224.f).AddArg("crop_w", 224.f)));
+  EXPECT_FALSE(fuses(crop()
+      .AddArg("crop_h", 224.f)
+      .AddArgumentInput("crop_w", "widths")));
+  // no crop window - the whole image
+  EXPECT_FALSE(fuses(crop()));
+}
+
+TEST(OpFusion, SelectedPatterns) {
+  auto ops = DecoderCropFlip("cpu");
+  auto log = FuseOperators(ops, {"flipped"}, AllAvailable, {"crop_mirror_normalize"});
+  EXPECT_EQ(ops.size(), 3u);
+  EXPECT_TRUE(log.empty());
+
+  EXPECT_THROW(FuseOperators(ops, {"flipped"}, AllAvailable, {"no_such_pattern"}),
+               std::runtime_error);
+}
+
+TEST(OpFusion, DefaultPatternsAreExact) {
+  auto defaults = DefaultFusionPatterns();
+  auto all = AllFusionPatterns();
+  EXPECT_LT(defaults.size(), all.size());
+  for (auto &name : defaults)
+    EXPECT_NE(std::find(all.begin(), all.end(), name), all.end());
+  for (auto name : { "resize_crop_mirror", "decoder_random_resized_crop" })
+    EXPECT_EQ(std::find(defaults.begin(), defaults.end(), name), defaults.end());
+}
+
+}  // namespace dali
@@ -230,7 +230,7 @@ class RandomBBoxCrop : public Operator<Backend> {
   const int num_attempts_;
 
  private:
-  BatchRNG<std::mt19937> rngs_;
+  BatchRNG rngs_;
   USE_OPERATOR_MEMBERS();
 };
 
@@ -47,18 +47,15 @@ class RandomCropAttr {
     DALI_ENFORCE(area[0] <= area[1], "Provided empty range");
 
     int64_t seed = spec.GetArgument<int64_t>("seed");
-    std::seed_seq seq{seed};
     int batch_size = spec.GetArgument<int>("batch_size");
     DALI_ENFORCE(batch_size > 0, "batch_size should be greater than 0");
-    std::vector<int> seeds(batch_size);
-    seq.generate(seeds.begin(), seeds.end());
 
     crop_window_generators_.resize(batch_size);
 
     for (int i = 0; i < batch_size; i++) {
       std::shared_ptr<RandomCropGenerator> random_crop_generator(
         new RandomCropGenerator(
-          {aspect_ratio[0], aspect_ratio[1]}, {area[0], area[1]}, seeds[i], num_attempts));
+          {aspect_ratio[0], aspect_ratio[1]}, {area[0], area[1]}, seed, num_attempts, i));
       crop_window_generators_[i] = std::bind(
         &RandomCropGenerator::GenerateCropWindow, random_crop_generator,
         std::placeholders::_1);
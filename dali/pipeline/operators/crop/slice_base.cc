@@ -27,7 +27,8 @@ template <typename OutputType, typename InputType>
 void RunHelper(Tensor<CPUBackend> &output,
                const Tensor<CPUBackend> &input,
                const std::vector<int64_t> &slice_anchor,
-               const std::vector<int64_t> &slice_shape) {
+               const std::vector<int64_t> &slice_shape,
+               ThreadPool *thread_pool = nullptr) {
   std::size_t number_of_dims = input.shape().size();
   VALUE_SWITCH(number_of_dims, NumDims, (3, 4), (
     kernels::KernelContext ctx;
@@ -49,7 +50,10 @@ void RunHelper(Tensor<CPUBackend> &output,
     output.Resize(req.output_shapes[0][0].shape.to_vector());
 
     auto out_view = view<OutputType, NumDims>(output);
-    kernel.Run(ctx, out_view, in_view, slice_args);
+    if (thread_pool)
+      kernel.Schedule(ctx, out_view, in_view, slice_args, *thread_pool, thread_pool->size());
+    else
+      kernel.Run(ctx, out_view, in_view, slice_args);
   ), // NOLINT
   (
     DALI_FAIL("Not supported number of dimensions: " + std::to_string(number_of_dims));
@@ -65,12 +69,39 @@ DALI_SCHEMA(SliceBase)
       R"code(Output data type. By default same data type as the input will be used)code",
       DALI_NO_TYPE);
 
+template <>
+void SliceBase<CPUBackend>::Run(HostWorkspace &ws) {
+  large_samples_.clear();
+  Operator<CPUBackend>::Run(ws);
+  if (large_samples_.empty())
+    return;
+
+  // the per-sample RunImpl has set up the arguments of these samples, but didn't slice them
+  for (int data_idx : large_samples_) {
+    const auto &input = ws.Input<CPUBackend>(0, data_idx);
+    auto &output = ws.Output<CPUBackend>(0, data_idx);
+    DALI_TYPE_SWITCH_WITH_FP16(input_type_, InputType,
+      DALI_TYPE_SWITCH_WITH_FP16(output_type_, OutputType,
+        detail::RunHelper<OutputType, InputType>(
+          output, input, slice_anchors_[data_idx], slice_shapes_[data_idx], &ws.GetThreadPool());
+      )
+    )
+  }
+  ws.GetThreadPool().WaitForWork();
+}
+
 template <>
 void SliceBase<CPUBackend>::RunImpl(SampleWorkspace &ws) {
   this->DataDependentSetup(ws);
+  auto data_idx = ws.data_idx();
+  if (num_threads_ > 1 && volume(slice_shapes_[data_idx]) >= kLargeSampleSize) {
+    // a single thread would be the bottleneck of the whole batch - defer to Run
+    std::lock_guard<std::mutex> guard(large_samples_mutex_);
+    large_samples_.push_back(data_idx);
+    return;
+  }
   const auto &input = ws.Input<CPUBackend>(0);
   auto &output = ws.Output<CPUBackend>(0);
-  auto data_idx = ws.data_idx();
 
   DALI_TYPE_SWITCH_WITH_FP16(input_type_, InputType,
     DALI_TYPE_SWITCH_WITH_FP16(output_type_, OutputType,
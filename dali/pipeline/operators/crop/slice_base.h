@@ -15,6 +15,7 @@
 #ifndef DALI_PIPELINE_OPERATORS_CROP_SLICE_BASE_H_
 #define DALI_PIPELINE_OPERATORS_CROP_SLICE_BASE_H_
 
+#include <mutex>
 #include <utility>
 #include <vector>
 #include <tuple>
@@ -37,6 +38,14 @@ class SliceBase : public Operator<Backend> {
     , output_type_(spec.GetArgument<DALIDataType>("output_dtype")) {
   }
 
+  using Operator<Backend>::Run;
+
+  /**
+   * @brief On CPU, runs the slices per sample and then splits the large samples
+   *        across the whole thread pool
+   */
+  void Run(HostWorkspace &ws) override;
+
  protected:
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
     return false;
@@ -63,10 +72,24 @@ class SliceBase : public Operator<Backend> {
   std::conditional_t<std::is_same<Backend, GPUBackend>::value,
     kernels::ScratchpadAllocator, std::vector<kernels::ScratchpadAllocator>> scratch_alloc_;
 
+  /// CPU only: samples with at least this many elements are sliced by multiple threads
+  static constexpr int64_t kLargeSampleSize = 1 << 20;
+  /// CPU only: samples left by the per-sample RunImpl to be split across the threads
+  std::vector<int> large_samples_;
+  std::mutex large_samples_mutex_;
+
   USE_OPERATOR_MEMBERS();
   using Operator<Backend>::RunImpl;
 };
 
+template <typename Backend>
+void SliceBase<Backend>::Run(HostWorkspace &ws) {
+  Operator<Backend>::Run(ws);
+}
+
+template <>
+void SliceBase<CPUBackend>::Run(HostWorkspace &ws);
+
 }  // namespace dali
 
 #endif  // DALI_PIPELINE_OPERATORS_CROP_SLICE_BASE_H_
@@ -16,6 +16,7 @@
 #include "dali/pipeline/operators/decoder/cache/image_cache_factory.h"
 #include "dali/pipeline/operators/decoder/cache/image_cache_blob.h"
 #include "dali/pipeline/operators/decoder/cache/image_cache_largest.h"
+#include "dali/pipeline/data/memory_account.h"
 
 namespace dali {
 
@@ -29,13 +30,25 @@ std::shared_ptr<ImageCache> ImageCacheFactory::Get(int device_id,
   auto &instance = caches_[device_id];
   auto cache = instance.cache.lock();
   if (!cache) {
-    if (cache_policy == "threshold") {
-      cache.reset(new ImageCacheBlob(cache_size, cache_threshold, cache_debug));
-    } else if (cache_policy == "largest") {
-      cache.reset(new ImageCacheLargest(cache_size, cache_debug));
-    } else {
-      DALI_FAIL("unexpected cache policy `" + cache_policy + "`");
+    // the cache buffer is charged to the pipeline and operator which create it
+    auto charge = MemoryAccount::ChargeCurrent(MemoryKind::GPU, cache_size);
+    std::unique_ptr<ImageCache> new_cache;
+    try {
+      if (cache_policy == "threshold") {
+        new_cache.reset(new ImageCacheBlob(cache_size, cache_threshold, cache_debug));
+      } else if (cache_policy == "largest") {
+        new_cache.reset(new ImageCacheLargest(cache_size, cache_debug));
+      } else {
+        DALI_FAIL("unexpected cache policy `" + cache_policy + "`");
+      }
+    } catch (...) {
+      charge.Release();
+      throw;
     }
+    cache = std::shared_ptr<ImageCache>(new_cache.release(), [charge](ImageCache *c) {
+      delete c;
+      charge.Release();
+    });
     caches_[device_id] = {cache, params};
     return cache;
   }
@@ -0,0 +1,123 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/operators/decoder/host/fused/host_decoder_crop_flip.h"
+#include <algorithm>
+#include <memory>
+#include "dali/core/error_handling.h"
+#include "dali/image/image_factory.h"
+#include "dali/image/jpeg_transform.h"
+
+namespace dali {
+
+namespace {
+
+inline bool IsJpeg(const uint8_t *data, size_t size) {
+  return size >= 2 && data[0] == 0xFF && data[1] == 0xD8;
+}
+
+void FlipRowsInPlace(uint8_t *data, int height, int width, int channels) {
+  for (int y = 0; y < height; y++) {
+    uint8_t *left = data + static_cast<ptrdiff_t>(y) * width * channels;
+    uint8_t *right = left + (width - 1) * channels;
+    for (; left < right; left += channels, right -= channels)
+      std::swap_ranges(left, left + channels, right);
+  }
+}
+
+}  // namespace
+
+HostDecoderCropFlip::HostDecoderCropFlip(const OpSpec &spec)
+  : HostDecoderCrop(spec)
+  , lossless_transform_(spec.GetArgument<bool>("lossless_transform"))
+  , transformed_(num_threads_) {
+}
+
+bool HostDecoderCropFlip::DecodeLossless(SampleWorkspace &ws, const CropWindow &crop,
+                                         bool flip) {
+  const auto &input = ws.Input<CPUBackend>(0);
+  auto &output = ws.Output<CPUBackend>(0);
+  auto &context = GetDecoderContext(ws.thread_idx());
+  auto &transformed = transformed_[ws.thread_idx()];
+
+  jpeg::LosslessTransform transform;
+  transform.crop_y = crop.anchor[0];
+  transform.crop_x = crop.anchor[1];
+  transform.crop_height = crop.shape[0];
+  transform.crop_width = crop.shape[1];
+  transform.flip_horizontal = flip;
+  if (!jpeg::TransformLossless(input.data<uint8>(), input.size(), transform, &transformed,
+                               context.JpegDecompressor()))
+    return false;
+
+  auto img = ImageFactory::CreateImage(reinterpret_cast<const uint8_t *>(transformed.data()),
+                                       transformed.size(), output_type_);
+  img->SetUseFastIdct(use_fast_idct_);
+  img->SetDecoderContext(&context);
+  img->SetOutputAllocator([&output](const Image::Shape &shape) {
+    output.Resize(shape);
+    return output.mutable_data<uint8_t>();
+  });
+  img->Decode();
+  return true;
+}
+
+void HostDecoderCropFlip::RunImpl(SampleWorkspace &ws) {
+  const auto &input = ws.Input<CPUBackend>(0);
+  auto &output = ws.Output<CPUBackend>(0);
+  auto file_name = input.GetSourceInfo();
+
+  DALI_ENFORCE(input.ndim() == 1,
+                "Input must be 1D encoded jpeg string.");
+  DALI_ENFORCE(IsType<uint8>(input.type()),
+                "Input must be stored as uint8 data.");
+
+  const uint8_t *data = input.data<uint8>();
+  const size_t size = input.size();
+  const bool flip = spec_.GetArgument<int>("horizontal", &ws, ws.data_idx()) != 0;
+  auto &context = GetDecoderContext(ws.thread_idx());
+  samples_decoded_++;
+
+  try {
+    auto img = ImageFactory::CreateImage(data, size, output_type_);
+    img->SetDecoderContext(&context);
+    auto shape = img->PeekShape();
+    CropWindow crop = GetCropWindowGenerator(ws.data_idx())({ shape[0], shape[1] });
+
+    const bool whole_image = crop.shape[0] == shape[0] && crop.shape[1] == shape[1];
+    if (lossless_transform_ && (flip || !whole_image) && IsJpeg(data, size) &&
+        DecodeLossless(ws, crop, flip)) {
+      samples_lossless_++;
+      return;
+    }
+
+    img->SetCropWindow(crop);
+    img->SetUseFastIdct(use_fast_idct_);
+    img->SetOutputAllocator([&output](const Image::Shape &shape) {
+      output.Resize(shape);
+      return output.mutable_data<uint8_t>();
+    });
+    img->Decode();
+    if (flip) {
+      auto out_shape = img->GetShape();
+      FlipRowsInPlace(output.mutable_data<uint8_t>(), out_shape[0], out_shape[1], out_shape[2]);
+    }
+  } catch (std::exception &e) {
+    DALI_FAIL(e.what() + "File: " + file_name);
+  }
+}
+
+DALI_REGISTER_OPERATOR(ImageDecoderCropFlip, HostDecoderCropFlip, CPU);
+
+}  // namespace dali
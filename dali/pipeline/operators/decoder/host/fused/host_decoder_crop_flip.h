@@ -0,0 +1,69 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATORS_DECODER_HOST_FUSED_HOST_DECODER_CROP_FLIP_H_
+#define DALI_PIPELINE_OPERATORS_DECODER_HOST_FUSED_HOST_DECODER_CROP_FLIP_H_
+
+#include <atomic>
+#include <string>
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/pipeline/operators/decoder/host/fused/host_decoder_crop.h"
+
+namespace dali {
+
+/**
+ * @brief Decodes a crop of the image and flips it horizontally
+ *
+ * JPEG images with an MCU-aligned crop window are cropped and flipped losslessly on the DCT
+ * coefficients (see jpeg::TransformLossless) and then only the transformed image is decoded.
+ * The other images are decoded with cropping and flipped in place.
+ */
+class HostDecoderCropFlip : public HostDecoderCrop {
+ public:
+  explicit HostDecoderCropFlip(const OpSpec &spec);
+
+  ~HostDecoderCropFlip() override = default;
+  DISABLE_COPY_MOVE_ASSIGN(HostDecoderCropFlip);
+
+  /**
+   * @brief Number of images decoded so far
+   */
+  int64_t SamplesDecoded() const { return samples_decoded_; }
+
+  /**
+   * @brief Number of images cropped and flipped on the DCT coefficients
+   */
+  int64_t SamplesTransformedLosslessly() const { return samples_lossless_; }
+
+ protected:
+  void RunImpl(SampleWorkspace &ws) override;
+
+ private:
+  /**
+   * @brief Tries the lossless transform and decodes the result to the output
+   *
+   * @return false, if the transform is not possible
+   */
+  bool DecodeLossless(SampleWorkspace &ws, const CropWindow &crop, bool flip);
+
+  bool lossless_transform_;
+  std::vector<std::string> transformed_;  // per thread
+  std::atomic<int64_t> samples_decoded_{0};
+  std::atomic<int64_t> samples_lossless_{0};
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_DECODER_HOST_FUSED_HOST_DECODER_CROP_FLIP_H_
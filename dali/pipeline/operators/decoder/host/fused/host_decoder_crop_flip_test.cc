@@ -0,0 +1,88 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <algorithm>
+#include <cmath>
+#include <memory>
+#include <vector>
+#include "dali/pipeline/operators/decoder/decoder_test.h"
+
+namespace dali {
+
+template <typename ImgType>
+class ImageDecoderCropFlipTest_CPU : public DecodeTestBase<ImgType> {
+ protected:
+  OpSpec DecodingOp() const override {
+    return this->GetOpSpec("ImageDecoderCropFlip")
+      .AddArg("crop", std::vector<float>{1.0f*crop_H, 1.0f*crop_W})
+      .AddArg("crop_pos_x", crop_pos)
+      .AddArg("crop_pos_y", crop_pos)
+      .AddArg("horizontal", 1);
+  }
+
+  CropWindowGenerator GetCropWindowGenerator(int data_idx) const override {
+    return [this] (const kernels::TensorShape<>& shape) {
+      CropWindow crop_window;
+      crop_window.shape[0] = crop_H;
+      crop_window.shape[1] = crop_W;
+      crop_window.anchor[0] = std::round(crop_pos * (shape[0] - crop_window.shape[0]));
+      crop_window.anchor[1] = std::round(crop_pos * (shape[1] - crop_window.shape[1]));
+      return crop_window;
+    };
+  }
+
+  vector<std::shared_ptr<TensorList<CPUBackend>>> Reference(
+    const vector<TensorList<CPUBackend> *> &inputs,
+    DeviceWorkspace *ws) override {
+    // decode the crop, then flip it
+    auto outputs = DecodeTestBase<ImgType>::Reference(inputs, ws);
+    auto &cropped = *outputs[0];
+    const int c = this->GetNumColorComp();
+    for (size_t i = 0; i < cropped.ntensor(); i++) {
+      auto shape = cropped.tensor_shape(i);
+      uint8_t *data = cropped.template mutable_tensor<uint8_t>(i);
+      for (int y = 0; y < shape[0]; y++) {
+        uint8_t *row = data + y * shape[1] * c;
+        for (int x = 0; x < shape[1] / 2; x++)
+          std::swap_ranges(row + x * c, row + (x + 1) * c, row + (shape[1] - 1 - x) * c);
+      }
+    }
+    return outputs;
+  }
+
+  // the anchor at the origin is aligned to MCU boundaries - JPEG images are transformed
+  // losslessly, unless the width is not a multiple of the MCU width
+  float crop_pos = 0.0f;
+  int crop_H = 224, crop_W = 192;
+};
+
+typedef ::testing::Types<RGB, BGR, Gray> Types;
+TYPED_TEST_SUITE(ImageDecoderCropFlipTest_CPU, Types);
+
+TYPED_TEST(ImageDecoderCropFlipTest_CPU, JpegLossless) {
+  this->Run(t_jpegImgType);
+}
+
+TYPED_TEST(ImageDecoderCropFlipTest_CPU, JpegUnaligned) {
+  this->crop_pos = 0.5f;
+  this->crop_W = 201;
+  this->Run(t_jpegImgType);
+}
+
+TYPED_TEST(ImageDecoderCropFlipTest_CPU, PngDecode) {
+  this->crop_pos = 0.5f;
+  this->Run(t_pngImgType);
+}
+
+}  // namespace dali
@@ -0,0 +1,136 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <vector>
+#include "dali/core/error_handling.h"
+#include "dali/image/image_factory.h"
+#include "dali/image/jpeg_mem.h"
+#include "dali/pipeline/operators/decoder/host/fused/host_decoder_random_resized_crop.h"
+#include "dali/pipeline/operators/common.h"
+
+namespace dali {
+
+namespace {
+
+inline bool IsJpeg(const uint8_t *data, size_t size) {
+  return size >= 2 && data[0] == 0xFF && data[1] == 0xD8;
+}
+
+}  // namespace
+
+HostDecoderRandomResizedCrop::HostDecoderRandomResizedCrop(const OpSpec &spec)
+    : HostDecoder(spec)
+    , ResamplingFilterAttr(spec)
+    , RandomCropAttr(spec) {
+  GetSingleOrRepeatedArg(spec, size_, "size", 2);
+  DALI_ENFORCE(size_[0] > 0 && size_[1] > 0, "Output size must be positive");
+  params_[0].output_size = size_[0];
+  params_[1].output_size = size_[1];
+  params_[0].min_filter = params_[1].min_filter = min_filter_;
+  params_[0].mag_filter = params_[1].mag_filter = mag_filter_;
+  thread_state_.resize(num_threads_);
+}
+
+void HostDecoderRandomResizedCrop::StartResampling(
+    ResampleState &state, const kernels::TensorShape<3> &in_shape,
+    const kernels::OutTensorCPU<uint8_t, 3> &out) {
+  auto req = state.kernel.Setup(state.context, in_shape, params_);
+  DALI_ENFORCE(req.output_shapes[0].tensor_shape<3>(0) == out.shape,
+               "Unexpected output shape of the resampling kernel");
+  state.scratch_alloc.Reserve(req.scratch_sizes);
+  state.scratchpad = state.scratch_alloc.GetScratchpad();
+  state.context.scratchpad = &state.scratchpad;
+  state.kernel.Start(state.context, out);
+}
+
+bool HostDecoderRandomResizedCrop::DecodeJpegStreaming(
+    ResampleState &state, DecoderContext &context, const kernels::OutTensorCPU<uint8_t, 3> &out,
+    const uint8_t *data, size_t size, const CropWindow &crop) {
+#ifdef DALI_USE_JPEG_TURBO
+  // same settings as in JpegImage
+  if (output_type_ == DALI_YCbCr)
+    return false;
+  jpeg::UncompressFlags flags;
+  if (use_fast_idct_)
+    flags.dct_method = JDCT_FASTEST;
+  flags.components = c_;
+  flags.color_space = output_type_;
+  flags.crop = true;
+  flags.crop_y = crop.anchor[0];
+  flags.crop_x = crop.anchor[1];
+  flags.crop_height = crop.shape[0];
+  flags.crop_width = crop.shape[1];
+
+  bool ok = jpeg::UncompressRows(
+    data, size, flags, nullptr /* nwarn */,
+    [&](int width, int height, int channels) {
+      StartResampling(state, { height, width, channels }, out);
+    },
+    [&](const uint8 *row) {
+      state.kernel.PushRow(row);
+    },
+    context.JpegDecompressor());
+  return ok && state.kernel.Done();
+#else
+  return false;
+#endif
+}
+
+void HostDecoderRandomResizedCrop::RunImpl(SampleWorkspace &ws) {
+  const auto &input = ws.Input<CPUBackend>(0);
+  auto &output = ws.Output<CPUBackend>(0);
+  auto file_name = input.GetSourceInfo();
+
+  DALI_ENFORCE(input.ndim() == 1,
+                "Input must be 1D encoded jpeg string.");
+  DALI_ENFORCE(IsType<uint8>(input.type()),
+                "Input must be stored as uint8 data.");
+
+  const uint8_t *data = input.data<uint8>();
+  const size_t size = input.size();
+  auto &state = thread_state_[ws.thread_idx()];
+  auto &context = GetDecoderContext(ws.thread_idx());
+
+  output.Resize({ size_[0], size_[1], c_ });
+  auto out = kernels::make_tensor_cpu<3>(output.mutable_data<uint8_t>(),
+                                         { size_[0], size_[1], c_ });
+
+  try {
+    auto img = ImageFactory::CreateImage(data, size, output_type_);
+    img->SetDecoderContext(&context);
+    auto shape = img->PeekShape();
+    // the generator is random - it must be called exactly once per sample
+    CropWindow crop = GetCropWindowGenerator(ws.data_idx())({ shape[0], shape[1] });
+
+    if (IsJpeg(data, size) && DecodeJpegStreaming(state, context, out, data, size, crop))
+      return;
+
+    img->SetCropWindow(crop);
+    img->SetUseFastIdct(use_fast_idct_);
+    img->Decode();
+    const auto decoded = img->GetImage();
+    const auto decoded_shape = img->GetShape();
+    StartResampling(state, decoded_shape, out);
+    const int row_size = decoded_shape[1] * decoded_shape[2];
+    for (int y = 0; y < decoded_shape[0]; y++)
+      state.kernel.PushRow(decoded.get() + static_cast<ptrdiff_t>(y) * row_size);
+  } catch (std::exception &e) {
+    DALI_FAIL(e.what() + "File: " + file_name);
+  }
+}
+
+DALI_REGISTER_OPERATOR(ImageDecoderRandomResizedCrop, HostDecoderRandomResizedCrop, CPU);
+
+}  // namespace dali
@@ -0,0 +1,82 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_OPERATORS_DECODER_HOST_FUSED_HOST_DECODER_RANDOM_RESIZED_CROP_H_
+#define DALI_PIPELINE_OPERATORS_DECODER_HOST_FUSED_HOST_DECODER_RANDOM_RESIZED_CROP_H_
+
+#include <vector>
+#include "dali/core/common.h"
+#include "dali/kernels/imgproc/resample/streaming_cpu.h"
+#include "dali/kernels/scratch.h"
+#include "dali/pipeline/operators/decoder/host/host_decoder.h"
+#include "dali/pipeline/operators/crop/random_crop_attr.h"
+#include "dali/pipeline/operators/resize/resize_base.h"
+
+namespace dali {
+
+/**
+ * @brief Decodes a random crop of the image and resizes it, without storing the decoded crop
+ *
+ * For JPEG images, the scanlines of the crop window are passed from the decoder directly
+ * to a streaming resampler, which keeps only as many rows as the vertical filter needs.
+ * Other formats are decoded (with cropping) first and then resampled.
+ * The result is the same as that of decoding the crop and resizing it.
+ */
+class HostDecoderRandomResizedCrop : public HostDecoder
+                                   , protected ResamplingFilterAttr
+                                   , protected RandomCropAttr {
+ public:
+  explicit HostDecoderRandomResizedCrop(const OpSpec &spec);
+
+  inline ~HostDecoderRandomResizedCrop() override = default;
+  DISABLE_COPY_MOVE_ASSIGN(HostDecoderRandomResizedCrop);
+
+ protected:
+  void RunImpl(SampleWorkspace &ws) override;
+
+  inline CropWindowGenerator GetCropWindowGenerator(int data_idx) const override {
+    return RandomCropAttr::GetCropWindowGenerator(data_idx);
+  }
+
+ private:
+  struct ResampleState {
+    kernels::StreamingResampleCPU<uint8_t, uint8_t> kernel;
+    kernels::ScratchpadAllocator scratch_alloc;
+    kernels::PreallocatedScratchpad scratchpad;
+    kernels::KernelContext context;
+  };
+
+  /**
+   * @brief Sets up the resampler for an input of given shape and the output tensor
+   */
+  void StartResampling(ResampleState &state, const kernels::TensorShape<3> &in_shape,
+                       const kernels::OutTensorCPU<uint8_t, 3> &out);
+
+  /**
+   * @brief Decodes the crop window of a JPEG image, resampling the rows as they are decoded
+   *
+   * @return false, if the image cannot be decoded this way
+   */
+  bool DecodeJpegStreaming(ResampleState &state, DecoderContext &context,
+                           const kernels::OutTensorCPU<uint8_t, 3> &out,
+                           const uint8_t *data, size_t size, const CropWindow &crop);
+
+  std::vector<int> size_;
+  kernels::ResamplingParams2D params_;
+  std::vector<ResampleState> thread_state_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_DECODER_HOST_FUSED_HOST_DECODER_RANDOM_RESIZED_CROP_H_
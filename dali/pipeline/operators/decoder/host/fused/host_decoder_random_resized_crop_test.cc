@@ -0,0 +1,100 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <memory>
+#include <vector>
+#include "dali/pipeline/operators/decoder/decoder_test.h"
+#include "dali/pipeline/operators/crop/random_crop_attr.h"
+#include "dali/kernels/imgproc/resample/separable_cpu.h"
+#include "dali/kernels/scratch.h"
+
+namespace dali {
+
+static constexpr int64_t kSeed = 1212334;
+static constexpr int kOutH = 97, kOutW = 123;
+
+template <typename ImgType>
+class ImageDecoderRandomResizedCropTest_CPU : public DecodeTestBase<ImgType> {
+ public:
+  ImageDecoderRandomResizedCropTest_CPU()
+    : random_crop_attr(
+      OpSpec("RandomCropAttr")
+        .AddArg("batch_size", this->batch_size_)
+        .AddArg("seed", kSeed)) {}
+
+ protected:
+  OpSpec DecodingOp() const override {
+    return this->GetOpSpec("ImageDecoderRandomResizedCrop")
+      .AddArg("seed", kSeed)
+      .AddArg("size", std::vector<int>{ kOutH, kOutW });
+  }
+
+  CropWindowGenerator GetCropWindowGenerator(int data_idx) const override {
+    return random_crop_attr.GetCropWindowGenerator(data_idx);
+  }
+
+  vector<std::shared_ptr<TensorList<CPUBackend>>> Reference(
+    const vector<TensorList<CPUBackend> *> &inputs,
+    DeviceWorkspace *ws) override {
+    // decode the crop, then resize it
+    auto cropped = DecodeTestBase<ImgType>::Reference(inputs, ws)[0];
+    const int n = cropped->ntensor();
+    const int c = this->GetNumColorComp();
+    kernels::ResamplingParams2D params;
+    params[0].output_size = kOutH;
+    params[1].output_size = kOutW;
+    params[0].min_filter = params[1].min_filter = { kernels::ResamplingFilterType::Linear, 0 };
+    params[0].mag_filter = params[1].mag_filter = { kernels::ResamplingFilterType::Linear, 0 };
+
+    vector<Tensor<CPUBackend>> out(n);
+    for (int i = 0; i < n; i++) {
+      auto in_shape = cropped->tensor_shape(i);
+      auto in = kernels::make_tensor_cpu<3>(
+        cropped->template tensor<uint8_t>(i),
+        { static_cast<int>(in_shape[0]), static_cast<int>(in_shape[1]), c });
+      out[i].Resize({ kOutH, kOutW, c });
+      auto out_view = kernels::make_tensor_cpu<3>(
+        out[i].template mutable_data<uint8_t>(), { kOutH, kOutW, c });
+
+      kernels::SeparableResampleCPU<uint8_t, uint8_t> resample;
+      kernels::KernelContext context;
+      kernels::ScratchpadAllocator scratch_alloc;
+      auto req = resample.Setup(context, in, params);
+      scratch_alloc.Reserve(req.scratch_sizes);
+      auto scratchpad = scratch_alloc.GetScratchpad();
+      context.scratchpad = &scratchpad;
+      resample.Run(context, out_view, in, params);
+    }
+
+    vector<std::shared_ptr<TensorList<CPUBackend>>> outputs;
+    outputs.push_back(std::make_shared<TensorList<CPUBackend>>());
+    outputs[0]->Copy(out, 0);
+    return outputs;
+  }
+
+  RandomCropAttr random_crop_attr;
+};
+
+typedef ::testing::Types<RGB, BGR, Gray> Types;
+TYPED_TEST_SUITE(ImageDecoderRandomResizedCropTest_CPU, Types);
+
+TYPED_TEST(ImageDecoderRandomResizedCropTest_CPU, JpegDecode) {
+  this->Run(t_jpegImgType);
+}
+
+TYPED_TEST(ImageDecoderRandomResizedCropTest_CPU, PngDecode) {
+  this->Run(t_pngImgType);
+}
+
+}  // namespace dali
@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <opencv2/opencv.hpp>
+#include <algorithm>
+#include <numeric>
 #include <tuple>
 #include <memory>
 #include "dali/image/image_factory.h"
@@ -20,6 +22,27 @@
 
 namespace dali {
 
+void HostDecoder::DecodeBatch(HostWorkspace &ws) {
+  encoded_size_.resize(batch_size_);
+  sample_order_.resize(batch_size_);
+  for (int data_idx = 0; data_idx < batch_size_; data_idx++)
+    encoded_size_[data_idx] = ws.Input<CPUBackend>(0, data_idx).size();
+  std::iota(sample_order_.begin(), sample_order_.end(), 0);
+  std::stable_sort(sample_order_.begin(), sample_order_.end(), [this](int a, int b) {
+    return encoded_size_[a] > encoded_size_[b];
+  });
+
+  ws.PrepareSamples(batch_size_);
+  auto &thread_pool = ws.GetThreadPool();
+  for (int data_idx : sample_order_) {
+    thread_pool.DoWorkWithID([this, &ws, data_idx](int tid) {
+      SampleWorkspace &sample = ws.GetSample(data_idx, tid);
+      this->SetupSharedSampleParams(sample);
+      this->RunImpl(sample);
+    });
+  }
+}
+
 void HostDecoder::RunImpl(SampleWorkspace &ws) {
   const auto &input = ws.Input<CPUBackend>(0);
   auto &output = ws.Output<CPUBackend>(0);
@@ -36,15 +59,16 @@ void HostDecoder::RunImpl(SampleWorkspace &ws) {
     img = ImageFactory::CreateImage(input.data<uint8>(), input.size(), output_type_);
     img->SetCropWindowGenerator(GetCropWindowGenerator(ws.data_idx()));
     img->SetUseFastIdct(use_fast_idct_);
+    img->SetDecoderContext(&GetDecoderContext(ws.thread_idx()));
+    // decode straight to the output; its memory is reused between iterations
+    img->SetOutputAllocator([&output](const Image::Shape &shape) {
+      output.Resize(shape);
+      return output.mutable_data<uint8_t>();
+    });
     img->Decode();
   } catch (std::exception &e) {
     DALI_FAIL(e.what() + "File: " + file_name);
   }
-  const auto decoded = img->GetImage();
-  const auto shape = img->GetShape();
-  output.Resize(shape);
-  unsigned char *out_data = output.mutable_data<unsigned char>();
-  std::memcpy(out_data, decoded.get(), volume(shape));
 }
 
 DALI_SCHEMA(HostDecoder)
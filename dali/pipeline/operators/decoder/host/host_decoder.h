@@ -19,6 +19,7 @@
 
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
+#include "dali/image/decoder_context.h"
 #include "dali/pipeline/operators/operator.h"
 #include "dali/util/crop_window.h"
 
@@ -30,7 +31,8 @@ class HostDecoder : public Operator<CPUBackend> {
       Operator<CPUBackend>(spec),
       output_type_(spec.GetArgument<DALIImageType>("output_type")),
       c_(IsColor(output_type_) ? 3 : 1),
-      use_fast_idct_(spec.GetArgument<bool>("use_fast_idct"))
+      use_fast_idct_(spec.GetArgument<bool>("use_fast_idct")),
+      decoder_context_(num_threads_)
   {}
 
   inline ~HostDecoder() override = default;
@@ -41,8 +43,31 @@ class HostDecoder : public Operator<CPUBackend> {
     return false;
   }
 
+  /**
+   * @brief Decodes the batch with DecodeBatch
+   */
+  void RunImpl(HostWorkspace &ws) override {
+    DecodeBatch(ws);
+  }
+
+  /**
+   * @brief Decodes all the samples in the thread pool, the largest encoded images first
+   *
+   * Scheduling the long tasks first evens out the load of the threads at the end
+   * of the batch. Each sample is decoded by RunImpl(SampleWorkspace&).
+   */
+  void DecodeBatch(HostWorkspace &ws);
+
   void RunImpl(SampleWorkspace &ws) override;
 
+  /**
+   * @brief Decoder state (e.g. libjpeg decompressor, temporary buffers) kept between
+   *        the images decoded by a thread
+   */
+  inline DecoderContext &GetDecoderContext(int thread_idx) {
+    return decoder_context_[thread_idx];
+  }
+
   virtual CropWindowGenerator GetCropWindowGenerator(int data_idx) const {
     return {};
   }
@@ -50,6 +75,11 @@ class HostDecoder : public Operator<CPUBackend> {
   DALIImageType output_type_;
   int c_;
   bool use_fast_idct_ = false;
+
+ private:
+  std::vector<DecoderContext> decoder_context_;
+  std::vector<int> sample_order_;
+  std::vector<Index> encoded_size_;
 };
 
 }  // namespace dali
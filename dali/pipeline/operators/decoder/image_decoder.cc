@@ -73,6 +73,26 @@ Output of the decoder is in `HWC` ordering.)code")
   .AddParent("ImageDecoder")
   .AddParent("CropAttr");
 
+DALI_SCHEMA(ImageDecoderCropFlip)
+  .DocStr(R"code(Decode images with a fixed cropping window size and variable anchor
+and optionally flip them horizontally.
+For JPEG images, if the cropping window starts at an MCU boundary (and, when flipping,
+its width is a multiple of the MCU width), the crop and flip are done losslessly on the DCT
+coefficients, so that only the resulting, smaller image is decoded. Otherwise, the decoded crop
+is flipped. Output of the decoder is in `HWC` ordering.
+With `lossless_transform` disabled, the result is the same as that of `ImageDecoderCrop`
+followed by `Flip`. The lossless transform may change the pixels of chroma-subsampled images
+(by up to 16 levels), as the chroma upsampling of the decoded crop doesn't use the pixels
+outside of it.)code")
+  .NumInput(1)
+  .NumOutput(1)
+  .AddOptionalArg("horizontal",
+      R"code(Perform a horizontal flip.)code", 0, true)
+  .AddOptionalArg("lossless_transform",
+      R"code(Crop and flip JPEG images on the DCT coefficients, when possible. The result
+may differ slightly from that of `ImageDecoderCrop` followed by `Flip`.)code", true)
+  .AddParent("ImageDecoderCrop");
+
 DALI_SCHEMA(ImageDecoderRandomCrop)
   .DocStr(R"code(Decode images with a random cropping anchor/window.
 When possible, will make use of partial decoding (e.g. libjpeg-turbo, nvJPEG).
@@ -83,6 +103,20 @@ Output of the decoder is in `HWC` ordering.)code")
   .AddParent("ImageDecoder")
   .AddParent("RandomCropAttr");
 
+DALI_SCHEMA(ImageDecoderRandomResizedCrop)
+  .DocStr(R"code(Decode images with a random cropping anchor/window and resize the crop
+to given size. The result is the same as that of `ImageDecoderRandomCrop` followed by `Resize`,
+but the decoded crop is not stored: when possible (libjpeg-turbo), the decoded rows are resized
+as soon as they are produced by the decoder.
+Output of the decoder is in `HWC` ordering.)code")
+  .NumInput(1)
+  .NumOutput(1)
+  .AddArg("size",
+      R"code(Size of resized image.)code",
+      DALI_INT_VEC)
+  .AddParent("ImageDecoder")
+  .AddParent("RandomCropAttr")
+  .AddParent("ResamplingFilterAttr");
 
 DALI_SCHEMA(ImageDecoderSlice)
   .DocStr(R"code(Decode images on the host with a cropping window of given size and anchor.
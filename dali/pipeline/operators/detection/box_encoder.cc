@@ -12,68 +12,164 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include <algorithm>
 #include <cmath>
 
 #include "dali/pipeline/operators/detection/box_encoder.h"
 
 namespace dali {
-void BoxEncoder<CPUBackend>::CalculateIousForBox(float *ious, const BoundingBox &box) const {
-  ious[0] = box.IntersectionOverUnion(anchors_[0]);
-  unsigned best_idx = 0;
-  float best_iou = ious[0];
 
-  for (unsigned anchor_idx = 1; anchor_idx < anchors_.size(); ++anchor_idx) {
-    ious[anchor_idx] = box.IntersectionOverUnion(anchors_[anchor_idx]);
-
-    if (ious[anchor_idx] >= best_iou) {
-      best_iou = ious[anchor_idx];
-      best_idx = anchor_idx;
-    }
+namespace detail {
+
+void AnchorsSoA::Init(const vector<BoundingBox> &anchors) {
+  auto n = anchors.size();
+  left.resize(n);
+  top.resize(n);
+  right.resize(n);
+  bottom.resize(n);
+  area.resize(n);
+  for (size_t i = 0; i < n; i++) {
+    auto ltrb = anchors[i].AsLtrb();
+    left[i] = ltrb[0];
+    top[i] = ltrb[1];
+    right[i] = ltrb[2];
+    bottom[i] = ltrb[3];
+    area[i] = anchors[i].Area();
   }
-
-  // For best default box matched with current object let iou = 2, to make sure there is a match,
-  // as this object will be the best (highest IOU), for this default box
-  ious[best_idx] = 2.;
 }
 
-vector<float> BoxEncoder<CPUBackend>::CalculateIous(const vector<BoundingBox> &boxes) const {
-  vector<float> ious(boxes.size() * anchors_.size());
+namespace {
 
-  for (unsigned bbox_idx = 0; bbox_idx < boxes.size(); ++bbox_idx) {
-    auto ious_row = ious.data() + bbox_idx * anchors_.size();
-    CalculateIousForBox(ious_row, boxes[bbox_idx]);
+// Same arithmetic as BoundingBox::IntersectionOverUnion
+inline float Iou(float l, float t, float r, float b, float box_area,
+                 const AnchorsSoA &anchors, int i) {
+  if (l < anchors.right[i] && r > anchors.left[i] && t < anchors.bottom[i] && b > anchors.top[i]) {
+    float inter = (std::min(anchors.right[i], r) - std::max(anchors.left[i], l)) *
+                  (std::min(anchors.bottom[i], b) - std::max(anchors.top[i], t));
+    return inter / (box_area + anchors.area[i] - inter);
   }
-
-  return ious;
+  return 0.0f;
 }
 
-unsigned BoxEncoder<CPUBackend>::FindBestBoxForAnchor(
-  unsigned anchor_idx, const vector<float> &ious, unsigned num_boxes) const {
-  unsigned best_idx = 0;
-  float best_iou = ious[anchor_idx];
-
-  for (unsigned bbox_idx = 1; bbox_idx < num_boxes; ++bbox_idx) {
-    if (ious[bbox_idx * anchors_.size() + anchor_idx] >= best_iou) {
-      best_iou = ious[bbox_idx * anchors_.size() + anchor_idx];
-      best_idx = bbox_idx;
+}  // namespace
+
+int CalculateIousForBox(float *ious, const BoundingBox &box, const AnchorsSoA &anchors) {
+  const int n = anchors.size();
+  const auto ltrb = box.AsLtrb();
+  const float l = ltrb[0], t = ltrb[1], r = ltrb[2], b = ltrb[3];
+  const float box_area = box.Area();
+  int i = 0;
+  float best_iou = -1;
+  int best_idx = 0;
+#ifdef __SSE2__
+  if (n >= 4) {
+    const __m128 vl = _mm_set1_ps(l), vt = _mm_set1_ps(t);
+    const __m128 vr = _mm_set1_ps(r), vb = _mm_set1_ps(b);
+    const __m128 varea = _mm_set1_ps(box_area);
+    __m128 lane_best = _mm_set1_ps(-1);
+    __m128i lane_idx = _mm_setzero_si128();
+    __m128i idx = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i four = _mm_set1_epi32(4);
+    for (; i + 4 <= n; i += 4, idx = _mm_add_epi32(idx, four)) {
+      __m128 al = _mm_loadu_ps(&anchors.left[i]);
+      __m128 at = _mm_loadu_ps(&anchors.top[i]);
+      __m128 ar = _mm_loadu_ps(&anchors.right[i]);
+      __m128 ab = _mm_loadu_ps(&anchors.bottom[i]);
+      __m128 overlap = _mm_and_ps(_mm_and_ps(_mm_cmplt_ps(vl, ar), _mm_cmpgt_ps(vr, al)),
+                                  _mm_and_ps(_mm_cmplt_ps(vt, ab), _mm_cmpgt_ps(vb, at)));
+      __m128 w = _mm_sub_ps(_mm_min_ps(ar, vr), _mm_max_ps(al, vl));
+      __m128 h = _mm_sub_ps(_mm_min_ps(ab, vb), _mm_max_ps(at, vt));
+      __m128 inter = _mm_mul_ps(w, h);
+      __m128 uni = _mm_sub_ps(_mm_add_ps(varea, _mm_loadu_ps(&anchors.area[i])), inter);
+      __m128 iou = _mm_and_ps(overlap, _mm_div_ps(inter, uni));
+      _mm_storeu_ps(ious + i, iou);
+      __m128 ge = _mm_cmpge_ps(iou, lane_best);
+      lane_best = _mm_or_ps(_mm_and_ps(ge, iou), _mm_andnot_ps(ge, lane_best));
+      __m128i gei = _mm_castps_si128(ge);
+      lane_idx = _mm_or_si128(_mm_and_si128(gei, idx), _mm_andnot_si128(gei, lane_idx));
+    }
+    float lane_best_v[4];
+    int lane_idx_v[4];
+    _mm_storeu_ps(lane_best_v, lane_best);
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(lane_idx_v), lane_idx);
+    for (int k = 0; k < 4; k++) {
+      if (lane_best_v[k] > best_iou ||
+          (lane_best_v[k] == best_iou && lane_idx_v[k] > best_idx)) {
+        best_iou = lane_best_v[k];
+        best_idx = lane_idx_v[k];
+      }
+    }
+  }
+#endif
+  for (; i < n; i++) {
+    ious[i] = Iou(l, t, r, b, box_area, anchors, i);
+    if (ious[i] >= best_iou) {
+      best_iou = ious[i];
+      best_idx = i;
     }
   }
-
   return best_idx;
 }
 
-vector<std::pair<unsigned, unsigned>> BoxEncoder<CPUBackend>::MatchBoxesWithAnchors(
-  const vector<BoundingBox> &boxes) const {
-  const auto ious = CalculateIous(boxes);
-  vector<std::pair<unsigned, unsigned>> matches;
+void UpdateBestBoxes(float *best_iou, int *best_box, const float *ious, int box_idx, int n) {
+  int i = 0;
+#ifdef __SSE2__
+  const __m128i vbox = _mm_set1_epi32(box_idx);
+  for (; i + 4 <= n; i += 4) {
+    __m128 iou = _mm_loadu_ps(ious + i);
+    __m128 best = _mm_loadu_ps(best_iou + i);
+    __m128i idx = _mm_loadu_si128(reinterpret_cast<const __m128i *>(best_box + i));
+    __m128 ge = _mm_cmpge_ps(iou, best);
+    __m128i gei = _mm_castps_si128(ge);
+    _mm_storeu_ps(best_iou + i, _mm_or_ps(_mm_and_ps(ge, iou), _mm_andnot_ps(ge, best)));
+    _mm_storeu_si128(reinterpret_cast<__m128i *>(best_box + i),
+                     _mm_or_si128(_mm_and_si128(gei, vbox), _mm_andnot_si128(gei, idx)));
+  }
+#endif
+  for (; i < n; i++) {
+    if (ious[i] >= best_iou[i]) {
+      best_iou[i] = ious[i];
+      best_box[i] = box_idx;
+    }
+  }
+}
 
-  for (unsigned anchor_idx = 0; anchor_idx < anchors_.size(); ++anchor_idx) {
-    const auto best_idx = FindBestBoxForAnchor(anchor_idx, ious, boxes.size());
+}  // namespace detail
 
+vector<std::pair<unsigned, unsigned>> BoxEncoder<CPUBackend>::MatchBoxesWithAnchors(
+  const vector<BoundingBox> &boxes, MatchScratch &scratch) const {
+  const int num_anchors = anchors_soa_.size();
+  scratch.ious.resize(num_anchors);
+  scratch.best_iou.resize(num_anchors);
+  scratch.best_box.resize(num_anchors);
+  float *ious = scratch.ious.data();
+  float *best_iou = scratch.best_iou.data();
+  int *best_box = scratch.best_box.data();
+
+  // The boxes are processed one by one, keeping the best box for each anchor, instead of
+  // storing the whole boxes x anchors IoU matrix
+  for (unsigned bbox_idx = 0; bbox_idx < boxes.size(); ++bbox_idx) {
+    int best_anchor = detail::CalculateIousForBox(ious, boxes[bbox_idx], anchors_soa_);
+    // For best default box matched with current object let iou = 2, to make sure there is a
+    // match, as this object will be the best (highest IOU), for this default box
+    ious[best_anchor] = 2.;
+    if (bbox_idx == 0) {
+      std::copy(ious, ious + num_anchors, best_iou);
+      std::fill(best_box, best_box + num_anchors, 0);
+    } else {
+      detail::UpdateBestBoxes(best_iou, best_box, ious, bbox_idx, num_anchors);
+    }
+  }
+
+  vector<std::pair<unsigned, unsigned>> matches;
+  for (int anchor_idx = 0; anchor_idx < num_anchors; ++anchor_idx) {
     // Filter matches by criteria
-    if (ious[best_idx * anchors_.size() + anchor_idx] > criteria_) {
-      matches.push_back({best_idx, anchor_idx});
+    if (best_iou[anchor_idx] > criteria_) {
+      matches.push_back({static_cast<unsigned>(best_box[anchor_idx]),
+                         static_cast<unsigned>(anchor_idx)});
     }
   }
 
@@ -177,7 +273,7 @@ void BoxEncoder<CPUBackend>::RunImpl(SampleWorkspace &ws) {
   if (num_boxes == 0)
     return;
 
-  const auto matches = MatchBoxesWithAnchors(boxes);
+  const auto matches = MatchBoxesWithAnchors(boxes, scratch_[ws.thread_idx()]);
   WriteMatchesToOutput(matches, boxes, labels, out_boxes, out_labels);
 }
 
@@ -26,6 +26,36 @@
 
 namespace dali {
 
+namespace detail {
+
+/**
+ * @brief Anchors stored as a structure of arrays, for vectorized IoU calculation
+ */
+struct AnchorsSoA {
+  void Init(const vector<BoundingBox> &anchors);
+
+  int size() const { return static_cast<int>(area.size()); }
+
+  vector<float> left, top, right, bottom, area;
+};
+
+/**
+ * @brief Calculates IoU of `box` with all the anchors.
+ *
+ * The results are the same as those of `box.IntersectionOverUnion(anchor)`.
+ *
+ * @return index of the anchor with the highest IoU; the last one, if there are many
+ */
+int CalculateIousForBox(float *ious, const BoundingBox &box, const AnchorsSoA &anchors);
+
+/**
+ * @brief Updates the best box (highest IoU, the last one for ties) for each anchor
+ *        with the IoUs of box `box_idx`.
+ */
+void UpdateBestBoxes(float *best_iou, int *best_box, const float *ious, int box_idx, int n);
+
+}  // namespace detail
+
 template<typename Backend>
 class BoxEncoder;
 
@@ -50,6 +80,8 @@ class BoxEncoder<CPUBackend>: public Operator<CPUBackend> {
       "Anchors size must be divisible by 4, actual value = " + std::to_string(anchors.size()));
 
     anchors_ = ReadBoxesFromInput(anchors.data(), anchors.size() / BoundingBox::kSize);
+    anchors_soa_.Init(anchors_);
+    scratch_.resize(num_threads_);
 
     means_ = spec.GetArgument<vector<float>>("means");
     DALI_ENFORCE(means_.size() == 4,
@@ -83,9 +115,17 @@ class BoxEncoder<CPUBackend>: public Operator<CPUBackend> {
   vector<float> stds_;
   float scale_;
 
-  vector<float> CalculateIous(const vector<BoundingBox> &boxes) const;
+  detail::AnchorsSoA anchors_soa_;
 
-  void CalculateIousForBox(float *ious, const BoundingBox &box) const;
+  /**
+   * @brief Per-thread buffers for matching: the IoUs of the current box and the best box
+   *        found so far for each anchor
+   */
+  struct MatchScratch {
+    vector<float> ious, best_iou;
+    vector<int> best_box;
+  };
+  vector<MatchScratch> scratch_;
 
   vector<BoundingBox> ReadBoxesFromInput(const float *in_boxes, unsigned num_boxes) const;
 
@@ -98,10 +138,7 @@ class BoxEncoder<CPUBackend>: public Operator<CPUBackend> {
     const vector<BoundingBox> &boxes, const int *labels, float *out_boxes, int *out_labels) const;
 
   vector<std::pair<unsigned, unsigned>> MatchBoxesWithAnchors(
-    const vector<BoundingBox> &boxes) const;
-
-  unsigned FindBestBoxForAnchor(
-    unsigned anchor_idx, const vector<float> &ious, unsigned num_boxes) const;
+    const vector<BoundingBox> &boxes, MatchScratch &scratch) const;
 
   static const int kBoxesInId = 0;
   static const int kLabelsInId = 1;
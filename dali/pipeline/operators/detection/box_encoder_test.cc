@@ -12,7 +12,9 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <random>
 #include "dali/test/dali_test_bboxes.h"
+#include "dali/pipeline/operators/detection/box_encoder.h"
 #include "dali/pipeline/util/bounding_box.h"
 
 namespace dali {
@@ -1132,4 +1134,63 @@ TYPED_TEST(BoxEncoderTest, TestInvalidAnchors) {
   EXPECT_THROW(this->RunForCocoCpu(invalid_anchors, 0.5f), std::runtime_error);
 }
 
+namespace {
+
+vector<BoundingBox> RandomBoxes(std::mt19937 &rng, int n) {
+  // coarse coordinates, so that there are many identical IoUs
+  std::uniform_int_distribution<int> coord(0, 7);
+  vector<BoundingBox> boxes;
+  for (int i = 0; i < n; i++) {
+    int x0 = coord(rng), y0 = coord(rng);
+    int x1 = std::uniform_int_distribution<int>(x0 + 1, 8)(rng);
+    int y1 = std::uniform_int_distribution<int>(y0 + 1, 8)(rng);
+    boxes.push_back(BoundingBox::FromLtrb(x0 * 0.125f, y0 * 0.125f, x1 * 0.125f, y1 * 0.125f));
+  }
+  return boxes;
+}
+
+}  // namespace
+
+TEST(BoxEncoderCpuMatching, IousForBox) {
+  std::mt19937 rng(123);
+  for (int num_anchors : { 1, 3, 4, 17, 100 }) {
+    auto anchors = RandomBoxes(rng, num_anchors);
+    detail::AnchorsSoA soa;
+    soa.Init(anchors);
+    vector<float> ious(num_anchors);
+    for (auto &box : RandomBoxes(rng, 20)) {
+      int best = detail::CalculateIousForBox(ious.data(), box, soa);
+      int ref_best = 0;
+      for (int i = 0; i < num_anchors; i++) {
+        float ref = box.IntersectionOverUnion(anchors[i]);
+        ASSERT_EQ(ious[i], ref) << "anchor " << i;
+        if (ref >= ious[ref_best])
+          ref_best = i;
+      }
+      EXPECT_EQ(best, ref_best);
+    }
+  }
+}
+
+TEST(BoxEncoderCpuMatching, UpdateBestBoxes) {
+  std::mt19937 rng(321);
+  std::uniform_int_distribution<int> dist(0, 4);
+  const int n = 23;
+  vector<float> best_iou(n, 0), ious(n), ref_iou(n, 0);
+  vector<int> best_box(n, 0), ref_box(n, 0);
+  for (int box = 1; box < 10; box++) {
+    for (auto &iou : ious)
+      iou = dist(rng) * 0.25f;
+    detail::UpdateBestBoxes(best_iou.data(), best_box.data(), ious.data(), box, n);
+    for (int i = 0; i < n; i++) {
+      if (ious[i] >= ref_iou[i]) {
+        ref_iou[i] = ious[i];
+        ref_box[i] = box;
+      }
+    }
+    EXPECT_EQ(best_iou, ref_iou);
+    EXPECT_EQ(best_box, ref_box);
+  }
+}
+
 }  // namespace dali
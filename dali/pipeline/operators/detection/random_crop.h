@@ -88,7 +88,7 @@ class SSDRandomCrop : public Operator<Backend> {
   int num_attempts_;
 
   // RNG stuff
-  BatchRNG<std::mt19937> rngs_;
+  BatchRNG rngs_;
   std::uniform_int_distribution<> int_dis_;
   std::uniform_real_distribution<float> float_dis_;
 };
@@ -15,6 +15,8 @@
 #ifndef DALI_PIPELINE_OPERATORS_DISPLACEMENT_DISPLACEMENT_FILTER_H_
 #define DALI_PIPELINE_OPERATORS_DISPLACEMENT_DISPLACEMENT_FILTER_H_
 
+#include <type_traits>
+#include <utility>
 #include "dali/core/common.h"
 #include "dali/core/host_dev.h"
 #include "dali/pipeline/operators/operator.h"
@@ -32,6 +34,46 @@ struct HasParam : std::false_type { };
 template <typename T>
 struct HasParam <T, decltype((void) (typename T::Param()), 0)> : std::true_type {};
 
+/**
+ * @brief Detects the optional, batched interface of a displacement (used on CPU):
+ *
+ * ```
+ * void DisplaceRow(Coord *x, Coord *y, int h, int out_w, int H, int W, int C);
+ * ```
+ * which calculates the source coordinates of `out_w` pixels of the output row `h`,
+ * where Coord is the coordinate type of the per-pixel `operator()`. The results must be
+ * the same as calling `operator()` for each pixel.
+ */
+template <typename T, typename Coord, typename = int>
+struct HasDisplaceRow : std::false_type {};
+
+template <typename T, typename Coord>
+struct HasDisplaceRow<T, Coord, decltype((void) std::declval<T&>().DisplaceRow(
+    std::declval<Coord*>(), std::declval<Coord*>(), 0, 0, 0, 0, 0), 0)> : std::true_type {};
+
+/**
+ * @brief Detects the optional `void PrepareRows(float *buffer, int out_w)` method, called once
+ *        per image before DisplaceRow. `buffer` holds `out_w` floats which are not modified
+ *        until the whole image is processed - it can be used to store per-column terms.
+ */
+template <typename T, typename = int>
+struct HasPrepareRows : std::false_type {};
+
+template <typename T>
+struct HasPrepareRows<T, decltype((void) std::declval<T&>().PrepareRows(
+    std::declval<float*>(), 0), 0)> : std::true_type {};
+
+/**
+ * @brief Detects the optional `void SetSample(int64_t sample_id)` method, which gives random
+ *        displacements a unique identifier of the sample being processed.
+ */
+template <typename T, typename = int>
+struct HasSetSample : std::false_type {};
+
+template <typename T>
+struct HasSetSample<T, decltype((void) std::declval<T&>().SetSample(int64_t()), 0)>
+    : std::true_type {};
+
 template <typename T>
 struct Point {
   const T x, y;
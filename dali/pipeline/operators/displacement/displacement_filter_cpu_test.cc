@@ -0,0 +1,138 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <random>
+#include <vector>
+#include "dali/pipeline/operators/displacement/displacement_filter_impl_cpu.h"
+#include "dali/pipeline/operators/displacement/jitter.h"
+#include "dali/pipeline/operators/displacement/sphere.h"
+#include "dali/pipeline/operators/displacement/water.h"
+#include "dali/kernels/test/tensor_test_utils.h"
+
+namespace dali {
+
+namespace {
+
+struct TestShear {
+  Point<float> operator()(int y, int x, int c, int H, int W, int C) {
+    return { x * 0.9f + y * 0.3f - 3.3f, y * 1.1f - x * 0.2f + 2.7f };
+  }
+};
+
+struct TestShift {
+  Point<int> operator()(int y, int x, int c, int H, int W, int C) {
+    return { x + (y % 5) - 2, y - 1 };
+  }
+};
+
+/**
+ * @brief Runs Warp and compares the result with sampling each pixel at the coordinates
+ *        returned by the per-pixel displacement.
+ */
+template <DALIInterpType interp, typename T, typename Displacement>
+void TestWarpRows(Displacement displacement, int channels) {
+  std::mt19937_64 rng(4321);
+  const int H = 29, W = 43;
+  std::vector<T> in_data(H * W * channels);
+  kernels::UniformRandomFill(in_data, rng, 0, 255);
+  auto in = kernels::make_tensor_cpu<3>(static_cast<const T *>(in_data.data()),
+                                       { H, W, channels });
+
+  std::vector<T> out_data(in_data.size()), ref_data(in_data.size());
+  auto out = kernels::make_tensor_cpu<3>(out_data.data(), { H, W, channels });
+  auto ref = kernels::make_tensor_cpu<3>(ref_data.data(), { H, W, channels });
+
+  std::vector<T> fill(channels, 42);
+  kernels::ScratchpadAllocator scratch_alloc;
+  scratch_alloc.Reserve(WarpScratch<Displacement>(W).sizes);
+  auto scratchpad = scratch_alloc.GetScratchpad();
+  kernels::KernelContext ctx;
+  ctx.scratchpad = &scratchpad;
+  Warp<interp, false>(ctx, out, in, displacement, fill.data());
+
+  kernels::Sampler<interp, T> sampler(kernels::as_surface_HWC(in));
+  for (int y = 0; y < H; y++) {
+    for (int x = 0; x < W; x++) {
+      auto p = displacement(y, x, 0, H, W, channels);
+      sampler(ref(y, x), p.x, p.y, fill.data());
+    }
+  }
+  kernels::Check(out, ref);
+}
+
+template <typename Displacement>
+void TestAllVariants(const Displacement &displacement) {
+  for (int channels : { 1, 3, 4, 5 }) {
+    TestWarpRows<DALI_INTERP_NN, uint8_t>(displacement, channels);
+    TestWarpRows<DALI_INTERP_LINEAR, uint8_t>(displacement, channels);
+    TestWarpRows<DALI_INTERP_LINEAR, float>(displacement, channels);
+    if (::testing::Test::HasFailure())
+      FAIL() << "channels = " << channels;
+  }
+}
+
+}  // namespace
+
+TEST(DisplacementFilterCPU, PerPixelDisplacement) {
+  TestAllVariants(TestShear());
+  TestAllVariants(TestShift());
+}
+
+TEST(DisplacementFilterCPU, WaterRows) {
+  OpSpec spec("Water");
+  spec.AddArg("ampl_x", 3.5f).AddArg("ampl_y", 2.0f).AddArg("phase_x", 0.2f);
+  TestAllVariants(WaterAugment(spec));
+}
+
+TEST(DisplacementFilterCPU, SphereRows) {
+  TestAllVariants(SphereAugment(OpSpec("Sphere")));
+}
+
+TEST(DisplacementFilterCPU, JitterRows) {
+  OpSpec spec("Jitter");
+  spec.AddArg("nDegree", 5).AddArg("seed", int64_t(123));
+  JitterAugment<CPUBackend> jitter(spec);
+  jitter.SetSample(7);
+  TestAllVariants(jitter);
+}
+
+TEST(DisplacementFilterCPU, JitterDeterministic) {
+  OpSpec spec("Jitter");
+  spec.AddArg("nDegree", 5).AddArg("seed", int64_t(123));
+  JitterAugment<CPUBackend> a(spec), b(spec);
+  const int W = 64;
+  std::vector<int> ax(W), ay(W), bx(W), by(W);
+  a.SetSample(3);
+  b.SetSample(3);
+  a.DisplaceRow(ax.data(), ay.data(), 10, W, 100, 100, 3);
+  b.DisplaceRow(bx.data(), by.data(), 10, W, 100, 100, 3);
+  EXPECT_EQ(ax, bx);
+  EXPECT_EQ(ay, by);
+  int moved = 0;
+  for (int x = 0; x < W; x++) {
+    EXPECT_GE(ax[x], x - 2);
+    EXPECT_LE(ax[x], x + 2);
+    EXPECT_GE(ay[x], 8);
+    EXPECT_LE(ay[x], 12);
+    moved += ax[x] != x || ay[x] != 10;
+  }
+  EXPECT_GT(moved, 0);
+
+  b.SetSample(4);
+  b.DisplaceRow(bx.data(), by.data(), 10, W, 100, 100, 3);
+  EXPECT_NE(ax, bx);
+}
+
+}  // namespace dali
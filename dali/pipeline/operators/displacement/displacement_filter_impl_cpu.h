@@ -16,6 +16,7 @@
 #define DALI_PIPELINE_OPERATORS_DISPLACEMENT_DISPLACEMENT_FILTER_IMPL_CPU_H_
 
 #include <array>
+#include <type_traits>
 #include <utility>
 #include <vector>
 
@@ -24,14 +25,139 @@
 #include "dali/pipeline/data/views.h"
 #include "dali/kernels/kernel_params.h"
 #include "dali/kernels/imgproc/sampler.h"
+#include "dali/kernels/imgproc/warp/affine_cpu.h"
+#include "dali/kernels/kernel_req.h"
+#include "dali/kernels/scratch.h"
 #include "dali/core/convert.h"
 #include "dali/core/static_switch.h"
 
 namespace dali {
 
+namespace detail {
+
+template <typename Displacement>
+using displacement_coord_t = std::remove_const_t<decltype(
+    std::declval<Displacement&>()(0, 0, 0, 0, 0, 0).x)>;
+
+template <typename Displacement, typename Coord>
+std::enable_if_t<HasDisplaceRow<Displacement, Coord>::value>
+DisplaceRow(Displacement &displacement, Coord *xs, Coord *ys,
+            int y, int out_w, int H, int W, int C) {
+  displacement.DisplaceRow(xs, ys, y, out_w, H, W, C);
+}
+
+template <typename Displacement, typename Coord>
+std::enable_if_t<!HasDisplaceRow<Displacement, Coord>::value>
+DisplaceRow(Displacement &displacement, Coord *xs, Coord *ys,
+            int y, int out_w, int H, int W, int C) {
+  for (int x = 0; x < out_w; x++) {
+    auto p = displacement(y, x, 0, H, W, C);
+    xs[x] = p.x;
+    ys[x] = p.y;
+  }
+}
+
+template <typename Displacement>
+std::enable_if_t<HasPrepareRows<Displacement>::value>
+PrepareRows(Displacement &displacement, float *buffer, int out_w) {
+  displacement.PrepareRows(buffer, out_w);
+}
+
+template <typename Displacement>
+std::enable_if_t<!HasPrepareRows<Displacement>::value>
+PrepareRows(Displacement &, float *, int) {}
+
+template <int static_channels, typename Out, typename In>
+inline void CopyPixel(Out *out, const In *in, int channels) {
+  const int C = static_channels > 0 ? static_channels : channels;
+  for (int c = 0; c < C; c++)
+    out[c] = ConvertSat<Out>(in[c]);
+}
+
+/**
+ * @brief Samples a row of output pixels at integer coordinates.
+ *
+ * Integer coordinates are indices of the source pixels, regardless of the interpolation.
+ */
+template <int static_channels, DALIInterpType interp, typename Out, typename In,
+          typename Border>
+void SampleRow(Out *out, const kernels::Sampler<interp, In> &sampler,
+               const int *xs, const int *ys, int n, Border border) {
+  const auto &in = sampler.surface;
+  const int C = static_channels > 0 ? static_channels : in.channels;
+  for (int i = 0; i < n; i++, out += C) {
+    int x = xs[i], y = ys[i];
+    if (x >= 0 && x < in.width && y >= 0 && y < in.height)
+      CopyPixel<static_channels>(out, &in(x, y), C);
+    else
+      sampler(out, x, y, border);
+  }
+}
+
+template <int static_channels, typename Out, typename In, typename Border>
+void SampleRow(Out *out, const kernels::Sampler<DALI_INTERP_NN, In> &sampler,
+               const float *xs, const float *ys, int n, Border border) {
+  const auto &in = sampler.surface;
+  const int C = static_channels > 0 ? static_channels : in.channels;
+  for (int i = 0; i < n; i++, out += C) {
+    float x = xs[i], y = ys[i];
+    if (x >= 0 && x < in.width && y >= 0 && y < in.height) {
+      // non-negative, so truncation is the same as floor
+      CopyPixel<static_channels>(out, &in(static_cast<int>(x), static_cast<int>(y)), C);
+    } else {
+      sampler(out, x, y, border);
+    }
+  }
+}
+
+template <int static_channels, typename Out, typename In, typename Border>
+void SampleRow(Out *out, const kernels::Sampler<DALI_INTERP_LINEAR, In> &sampler,
+               const float *xs, const float *ys, int n, Border border) {
+  const auto &in = sampler.surface;
+  const int C = static_channels > 0 ? static_channels : in.channels;
+  for (int i = 0; i < n; i++, out += C) {
+    // same offset as in the Sampler
+    float x = xs[i] - 0.5f;
+    float y = ys[i] - 0.5f;
+    if (x >= 0 && x < in.width - 1 && y >= 0 && y < in.height - 1) {
+      int x0 = static_cast<int>(x);
+      int y0 = static_cast<int>(y);
+      kernels::warp::BlendPixel<static_channels>(out, &in(x0, y0), in.pixel_stride,
+                                                 in.row_stride, C, x - x0, y - y0);
+    } else {
+      sampler(out, xs[i], ys[i], border);
+    }
+  }
+}
+
+}  // namespace detail
+
+/**
+ * @brief Calculates the scratch memory needed by Warp for an output of width `out_w`
+ */
+template <typename Displacement>
+kernels::ScratchpadEstimator WarpScratch(int out_w) {
+  using Coord = detail::displacement_coord_t<Displacement>;
+  kernels::ScratchpadEstimator se;
+  se.add<Coord>(kernels::AllocType::Host, out_w, 64);
+  se.add<Coord>(kernels::AllocType::Host, out_w, 64);
+  se.add<float>(kernels::AllocType::Host, out_w, 64);
+  return se;
+}
+
+/**
+ * @brief Applies the displacement to an HWC image
+ *
+ * The source coordinates are calculated a row at a time (with DisplaceRow, if the
+ * displacement provides it) into buffers taken from the context's scratchpad - see
+ * WarpScratch. The pixels which sample the inside of the input image are then gathered
+ * without border handling.
+ * Per-channel displacements are evaluated for each pixel and channel separately.
+ */
 template <DALIInterpType interp_type, bool per_channel,
           typename Out, typename In, typename Displacement, typename Border>
 void Warp(
+    kernels::KernelContext &context,
     const kernels::OutTensorCPU<Out, 3> &out,
     const kernels::InTensorCPU<In, 3> &in,
     Displacement &displacement,
@@ -45,19 +171,33 @@ void Warp(
 
   kernels::Sampler<interp_type, In> sampler(kernels::as_surface_HWC(in));
 
-  for (int y = 0; y < outH; y++) {
-    Out *out_row = out(y, 0);
-    for (int x = 0; x < outW; x++) {
-      if (per_channel) {
+  if (per_channel) {
+    for (int y = 0; y < outH; y++) {
+      Out *out_row = out(y, 0);
+      for (int x = 0; x < outW; x++) {
         for (int c = 0; c < C; c++) {
           auto p = displacement(y, x, c, inH, inW, C);
           sampler(&out_row[C*x], p.x, p.y, c, border);
         }
-      } else {
-        auto p = displacement(y, x, 0, inH, inW, C);
-        sampler(&out_row[C*x], p.x, p.y, border);
       }
     }
+    return;
+  }
+
+  using Coord = detail::displacement_coord_t<Displacement>;
+  auto &scratch = *context.scratchpad;
+  Coord *xs = scratch.Allocate<Coord>(kernels::AllocType::Host, outW, 64);
+  Coord *ys = scratch.Allocate<Coord>(kernels::AllocType::Host, outW, 64);
+  float *row_buffer = scratch.Allocate<float>(kernels::AllocType::Host, outW, 64);
+  detail::PrepareRows(displacement, row_buffer, outW);
+
+  for (int y = 0; y < outH; y++) {
+    Out *out_row = out(y, 0);
+    detail::DisplaceRow(displacement, xs, ys, y, outW, inH, inW, C);
+    VALUE_SWITCH(C, static_channels, (1, 3, 4),
+      (detail::SampleRow<static_channels>(out_row, sampler, xs, ys, outW, border);),
+      (detail::SampleRow<-1>(out_row, sampler, xs, ys, outW, border);)
+    );  // NOLINT
   }
 }
 
@@ -68,6 +208,8 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
   explicit DisplacementFilter(const OpSpec &spec)
       : Operator(spec),
         displace_(num_threads_, Displacement(spec)),
+        scratch_alloc_(num_threads_),
+        sample_iteration_(batch_size_, 0),
         interp_type_(spec.GetArgument<DALIInterpType>("interp_type")) {
     has_mask_ = spec.HasTensorArgument("mask");
     DALI_ENFORCE(
@@ -103,7 +245,12 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
       fill[i] = fill_value_;
     }
 
-    Warp<interp, per_channel_transform>(out, in, displace, fill);
+    auto &scratch_alloc = scratch_alloc_[ws.thread_idx()];
+    scratch_alloc.Reserve(WarpScratch<Displacement>(out.shape[1]).sizes);
+    auto scratchpad = scratch_alloc.GetScratchpad();
+    kernels::KernelContext ctx;
+    ctx.scratchpad = &scratchpad;
+    Warp<interp, per_channel_transform>(ctx, out, in, displace, fill);
   }
 
   bool SetupImpl(std::vector<OutputDesc> &output_desc, const HostWorkspace &ws) override {
@@ -112,6 +259,10 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
 
   void RunImpl(SampleWorkspace &ws) override {
     DataDependentSetup(ws);
+    // Each sample index is processed by exactly one thread in an iteration, so the
+    // identifier doesn't depend on the number of threads or scheduling.
+    int64_t sample_id = sample_iteration_[ws.data_idx()]++ * batch_size_ + ws.data_idx();
+    SetDisplacementSample(displace_[ws.thread_idx()], sample_id);
 
     auto &input = ws.Input<CPUBackend>(0);
 
@@ -157,6 +308,15 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
   std::enable_if_t<!HasParam<U>::value> PrepareDisplacement(
       SampleWorkspace *) {}
 
+  template <typename U = Displacement>
+  std::enable_if_t<HasSetSample<U>::value> SetDisplacementSample(
+      U &displace, int64_t sample_id) {
+    displace.SetSample(sample_id);
+  }
+
+  template <typename U = Displacement>
+  std::enable_if_t<!HasSetSample<U>::value> SetDisplacementSample(U &, int64_t) {}
+
   /**
    * @brief Do basic input checking and output setup
    * assuming output_shape = input_shape
@@ -179,6 +339,8 @@ class DisplacementFilter<CPUBackend, Displacement, per_channel_transform>
 
  private:
   std::vector<Displacement> displace_;
+  std::vector<kernels::ScratchpadAllocator> scratch_alloc_;
+  std::vector<int64_t> sample_iteration_;
   DALIInterpType interp_type_;
   float fill_value_;
 
@@ -14,13 +14,11 @@
 
 
 #include "dali/pipeline/operators/displacement/jitter.h"
-#include "dali/pipeline/operators/util/randomizer_impl_cpu.h"
 #include "dali/pipeline/operators/displacement/displacement_filter_impl_cpu.h"
 
 namespace dali {
 
-// TODO(ptredak): re-enable it once RNG is changed on the CPU to be deterministic
-// DALI_REGISTER_OPERATOR(Jitter, Jitter<CPUBackend>, CPU);
+DALI_REGISTER_OPERATOR(Jitter, Jitter<CPUBackend>, CPU);
 
 DALI_SCHEMA(Jitter)
     .DocStr(R"code(Perform a random Jitter augmentation.
@@ -16,9 +16,11 @@
 #ifndef DALI_PIPELINE_OPERATORS_DISPLACEMENT_JITTER_H_
 #define DALI_PIPELINE_OPERATORS_DISPLACEMENT_JITTER_H_
 
+#include <algorithm>
 #include <ctgmath>
 #include <vector>
 #include "dali/core/host_dev.h"
+#include "dali/core/philox.h"
 #include "dali/pipeline/operators/operator.h"
 #include "dali/pipeline/operators/displacement/displacement_filter.h"
 #include "dali/pipeline/operators/util/randomizer.h"
@@ -60,6 +62,67 @@ class JitterAugment {
   Randomizer<Backend> rnd_;
 };
 
+/**
+ * @brief Jitter displacement on CPU
+ *
+ * Uses a counter-based generator keyed by the seed, so that the displacement of a pixel
+ * depends only on the seed, the sample and the pixel's position. The results don't depend
+ * on the number of threads and random numbers can be generated for a whole row at once.
+ */
+template <>
+class JitterAugment<CPUBackend> {
+ public:
+  explicit JitterAugment(const OpSpec& spec) :
+        nDegree_(spec.GetArgument<int>("nDegree")),
+        seed_(spec.GetArgument<int64_t>("seed")) {
+    DALI_ENFORCE(nDegree_ > 0, "nDegree must be positive");
+  }
+
+  void SetSample(int64_t sample_id) {
+    sample_id_ = sample_id;
+  }
+
+  Point<int> operator()(int y, int x, int c, int H, int W, int C) {
+    // each block of random numbers is used by two adjacent pixels
+    auto r = Philox4x32_10::Generate(seed_, sample_id_, Counter(y, x));
+    int k = (x & 1) * 2;
+    return Displace(r[k], r[k + 1], y, x, H, W);
+  }
+
+  void DisplaceRow(int *xs, int *ys, int y, int out_w, int H, int W, int C) {
+    for (int x = 0; x < out_w; x += 2) {
+      auto r = Philox4x32_10::Generate(seed_, sample_id_, Counter(y, x));
+      auto p0 = Displace(r[0], r[1], y, x, H, W);
+      xs[x] = p0.x;
+      ys[x] = p0.y;
+      if (x + 1 < out_w) {
+        auto p1 = Displace(r[2], r[3], y, x + 1, H, W);
+        xs[x + 1] = p1.x;
+        ys[x + 1] = p1.y;
+      }
+    }
+  }
+
+  void Cleanup() {}
+
+ private:
+  static inline uint64_t Counter(int y, int x) {
+    return (static_cast<uint64_t>(y) << 32) | static_cast<uint32_t>(x >> 1);
+  }
+
+  inline Point<int> Displace(uint32_t rx, uint32_t ry, int y, int x, int H, int W) const {
+    const int degr = nDegree_;
+    const int nHalf = degr/2;
+    const int newX = static_cast<int>(rx % degr) - nHalf + x;
+    const int newY = static_cast<int>(ry % degr) - nHalf + y;
+    return { std::min(std::max(0, newX), W), std::min(std::max(0, newY), H) };
+  }
+
+  const int nDegree_;
+  const uint64_t seed_;
+  int64_t sample_id_ = 0;
+};
+
 template <typename Backend>
 class Jitter : public DisplacementFilter<Backend, JitterAugment<Backend>> {
  public:
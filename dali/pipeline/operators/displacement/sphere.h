@@ -16,6 +16,9 @@
 #ifndef DALI_PIPELINE_OPERATORS_DISPLACEMENT_SPHERE_H_
 #define DALI_PIPELINE_OPERATORS_DISPLACEMENT_SPHERE_H_
 
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
 #include <ctgmath>
 #include <vector>
 #include "dali/pipeline/operators/operator.h"
@@ -42,6 +45,41 @@ class SphereAugment {
     return { mid_x + rad * trueX, mid_y + rad * trueY };
   }
 
+  /**
+   * @brief Calculates the source coordinates for a row of pixels, 4 pixels at a time
+   *        where SSE2 is available
+   */
+  void DisplaceRow(float *xs, float *ys, int h, int out_w, int H, int W, int C) {
+    const float mid_x = W * 0.5f;
+    const float mid_y = H * 0.5f;
+    const int d = mid_x > mid_y ? mid_x : mid_y;
+    const float trueY = h + 0.5f - mid_y;
+
+    int w = 0;
+#ifdef __SSE2__
+    const __m128 vmid_x = _mm_set1_ps(mid_x);
+    const __m128 vmid_y = _mm_set1_ps(mid_y);
+    const __m128 vtrue_y = _mm_set1_ps(trueY);
+    const __m128 vy2 = _mm_mul_ps(vtrue_y, vtrue_y);
+    const __m128 vd = _mm_set1_ps(d);
+    const __m128 half = _mm_set1_ps(0.5f);
+    __m128i vw = _mm_setr_epi32(0, 1, 2, 3);
+    const __m128i four = _mm_set1_epi32(4);
+    for (; w + 4 <= out_w; w += 4, vw = _mm_add_epi32(vw, four)) {
+      __m128 true_x = _mm_sub_ps(_mm_add_ps(_mm_cvtepi32_ps(vw), half), vmid_x);
+      __m128 rad = _mm_div_ps(_mm_sqrt_ps(_mm_add_ps(_mm_mul_ps(true_x, true_x), vy2)), vd);
+      _mm_storeu_ps(xs + w, _mm_add_ps(vmid_x, _mm_mul_ps(rad, true_x)));
+      _mm_storeu_ps(ys + w, _mm_add_ps(vmid_y, _mm_mul_ps(rad, vtrue_y)));
+    }
+#endif
+    for (; w < out_w; w++) {
+      const float trueX = w + 0.5f - mid_x;
+      const float rad = sqrtf(trueX * trueX + trueY * trueY) / d;
+      xs[w] = mid_x + rad * trueX;
+      ys[w] = mid_y + rad * trueY;
+    }
+  }
+
   void Cleanup() {}
 };
 
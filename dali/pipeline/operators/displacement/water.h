@@ -16,6 +16,7 @@
 #ifndef DALI_PIPELINE_OPERATORS_DISPLACEMENT_WATER_H_
 #define DALI_PIPELINE_OPERATORS_DISPLACEMENT_WATER_H_
 
+#include <cassert>
 #include <ctgmath>
 #include <vector>
 #include <string>
@@ -55,8 +56,39 @@ class WaterAugment {
     };
   }
 
+  /**
+   * @brief Calculates the vertical displacement, which depends only on the column
+   */
+  void PrepareRows(float *buffer, int out_w) {
+    const WaveDescr &wY = y_desc_;
+    for (int x = 0; x < out_w; x++) {
+      float w = x;
+      buffer[x] = wY.ampl * cosf(wY.freq * w + wY.phase);
+    }
+    column_displacement_ = buffer;
+  }
+
+  /**
+   * @brief Calculates the source coordinates for a row of pixels
+   *
+   * The horizontal displacement is constant in a row and the vertical one is taken from
+   * the table calculated by PrepareRows.
+   */
+  void DisplaceRow(float *xs, float *ys, int y, int out_w, int H, int W, int C) {
+    assert(column_displacement_);
+    const WaveDescr &wX = x_desc_;
+    float h = y;
+    float dx = wX.ampl * sinf(wX.freq * h + wX.phase);
+    for (int x = 0; x < out_w; x++) {
+      float w = x;
+      xs[x] = w + dx;
+      ys[x] = h + column_displacement_[x];
+    }
+  }
+
  private:
   WaveDescr x_desc_, y_desc_;
+  const float *column_displacement_ = nullptr;
 };
 
 template <typename Backend>
@@ -0,0 +1,74 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dali/pipeline/operators/expressions/arithmetic_expression.h"
+
+namespace dali {
+
+template<>
+void ArithmeticExpression<CPUBackend>::RunImpl(SampleWorkspace &ws) {
+  // single-element inputs are broadcast; the others determine the shape of the output
+  const Tensor<CPUBackend> *shape_source = &ws.Input<CPUBackend>(0);
+  for (int i = 0; i < ws.NumInput(); i++) {
+    const auto &input = ws.Input<CPUBackend>(i);
+    if (input.size() != 1) {
+      shape_source = &input;
+      break;
+    }
+  }
+
+  std::vector<expr::ExprInput> inputs;
+  for (int i = 0; i < ws.NumInput(); i++) {
+    const auto &input = ws.Input<CPUBackend>(i);
+    bool scalar = input.size() == 1 && shape_source->size() != 1;
+    DALI_ENFORCE(scalar || input.shape() == shape_source->shape(),
+        "Inputs of ArithmeticExpression must have the same shape or a single element");
+    inputs.push_back({ input.raw_data(), input.type().id(), scalar });
+  }
+
+  auto &output = ws.Output<CPUBackend>(0);
+  DALI_TYPE_SWITCH_WITH_FP16(output_type_, OType,
+    output.mutable_data<OType>();
+  );  // NOLINT
+  output.Resize(shape_source->shape());
+  output.SetLayout(shape_source->GetLayout());
+  expression_.Evaluate(output.raw_mutable_data(), output_type_, inputs, output.size());
+}
+
+DALI_REGISTER_OPERATOR(ArithmeticExpression, ArithmeticExpression<CPUBackend>, CPU);
+
+DALI_SCHEMA(ArithmeticExpression)
+  .DocStr(R"code(Evaluates an element-wise arithmetic expression over the inputs in a single
+pass, e.g. ``clamp((x0 * 1.5 + x1) / 2, 0, 255)``.
+
+The expression uses the usual infix notation with ``+``, ``-``, ``*``, ``/`` and parentheses.
+Inputs are referred to as ``x0``, ``x1``, ... (``x`` is the same as ``x0``). Available
+functions are ``min(a, b)``, ``max(a, b)``, ``clamp(a, lo, hi)``, ``abs``, ``sqrt``, ``round``,
+``floor``, ``ceil`` and the saturating casts ``uint8``, ``int16``, ``int32``, ``float16``
+and ``float``.
+
+Inputs must have the same shape, except for single-element inputs (e.g. random parameters),
+which are broadcast. The computation is done in float, in tiles small enough to stay in cache;
+the result is saturated to `output_dtype`, truncating fractions (use ``round`` to round).)code")
+  .NumInput(1, 8)
+  .NumOutput(1)
+  .AddArg("expression",
+      R"code(The expression to evaluate.)code",
+      DALI_STRING)
+  .AddOptionalArg("output_dtype",
+      R"code(Output data type.)code",
+      DALI_FLOAT);
+
+}  // namespace dali
@@ -0,0 +1,60 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_PIPELINE_OPERATORS_EXPRESSIONS_ARITHMETIC_EXPRESSION_H_
+#define DALI_PIPELINE_OPERATORS_EXPRESSIONS_ARITHMETIC_EXPRESSION_H_
+
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/operators/operator.h"
+#include "dali/pipeline/operators/expressions/expression.h"
+
+namespace dali {
+
+template <typename Backend>
+class ArithmeticExpression : public Operator<Backend> {
+ public:
+  explicit inline ArithmeticExpression(const OpSpec &spec) :
+    Operator<Backend>(spec),
+    expression_(spec.GetArgument<std::string>("expression")),
+    output_type_(spec.GetArgument<DALIDataType>("output_dtype")) {
+    DALI_ENFORCE(expression_.NumInputs() <= spec.NumRegularInput(),
+        "The expression refers to " + std::to_string(expression_.NumInputs()) +
+        " inputs, but the operator has " + std::to_string(spec.NumRegularInput()));
+  }
+
+  inline ~ArithmeticExpression() override = default;
+
+  DISABLE_COPY_MOVE_ASSIGN(ArithmeticExpression);
+
+ protected:
+  bool SetupImpl(std::vector<OutputDesc> &output_desc, const workspace_t<Backend> &ws) override {
+    return false;
+  }
+
+  void RunImpl(Workspace<Backend> &ws) override;
+
+ private:
+  expr::Expression expression_;
+  DALIDataType output_type_;
+
+  USE_OPERATOR_MEMBERS();
+  using Operator<Backend>::RunImpl;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_EXPRESSIONS_ARITHMETIC_EXPRESSION_H_
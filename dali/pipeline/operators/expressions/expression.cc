@@ -0,0 +1,530 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dali/pipeline/operators/expressions/expression.h"
+
+#include <algorithm>
+#include <cctype>
+#include <cmath>
+#include <cstdlib>
+#include <functional>
+#include <memory>
+#include <utility>
+
+#include "dali/core/convert.h"
+#include "dali/core/error_handling.h"
+#include "dali/kernels/common/cast.h"
+
+namespace dali {
+namespace expr {
+
+namespace {
+
+struct Node {
+  bool is_op = false;
+  OpCode op = OpCode::Add;
+  Operand leaf;
+  std::vector<std::unique_ptr<Node>> args;
+};
+
+using NodePtr = std::unique_ptr<Node>;
+
+int Arity(OpCode op) {
+  switch (op) {
+    case OpCode::Add: case OpCode::Sub: case OpCode::Mul: case OpCode::Div:
+    case OpCode::Min: case OpCode::Max:
+      return 2;
+    case OpCode::MulAdd: case OpCode::Clamp:
+      return 3;
+    default:
+      return 1;
+  }
+}
+
+float ToFloat16(float value) {
+  float16 h;
+  float result;
+  kernels::CastBuffer(&h, &value, 1);
+  kernels::CastBuffer(&result, &h, 1);
+  return result;
+}
+
+/**
+ * @brief Scalar semantics of the operations - used for constant folding
+ */
+float Apply(OpCode op, float a, float b = 0, float c = 0) {
+  switch (op) {
+    case OpCode::Add:         return a + b;
+    case OpCode::Sub:         return a - b;
+    case OpCode::Mul:         return a * b;
+    case OpCode::Div:         return a / b;
+    case OpCode::MulAdd:      return a * b + c;
+    case OpCode::Min:         return std::min(a, b);
+    case OpCode::Max:         return std::max(a, b);
+    case OpCode::Clamp:       return std::min(std::max(a, b), c);
+    case OpCode::Neg:         return -a;
+    case OpCode::Abs:         return std::fabs(a);
+    case OpCode::Sqrt:        return std::sqrt(a);
+    case OpCode::Round:       return std::round(a);
+    case OpCode::Floor:       return std::floor(a);
+    case OpCode::Ceil:        return std::ceil(a);
+    case OpCode::CastUint8:   return clamp<uint8_t>(a);
+    case OpCode::CastInt16:   return clamp<int16_t>(a);
+    case OpCode::CastInt32:   return clamp<int32_t>(a);
+    case OpCode::CastFloat16: return ToFloat16(a);
+  }
+  DALI_FAIL("Unknown operation");
+}
+
+NodePtr Leaf(Operand operand) {
+  NodePtr node(new Node());
+  node->leaf = operand;
+  return node;
+}
+
+NodePtr Constant(float value) {
+  Operand operand;
+  operand.kind = Operand::Constant;
+  operand.value = value;
+  return Leaf(operand);
+}
+
+bool IsConstant(const Node &node) {
+  return !node.is_op && node.leaf.kind == Operand::Constant;
+}
+
+NodePtr MakeOp(OpCode op, NodePtr a, NodePtr b);
+
+/**
+ * @brief Creates an operation node, folding constants and fusing `a * b + c`
+ */
+NodePtr MakeOp(OpCode op, std::vector<NodePtr> args) {
+  if (std::all_of(args.begin(), args.end(), [](const NodePtr &n) { return IsConstant(*n); })) {
+    float v[3] = {0, 0, 0};
+    for (size_t i = 0; i < args.size(); i++)
+      v[i] = args[i]->leaf.value;
+    return Constant(Apply(op, v[0], v[1], v[2]));
+  }
+  if (op == OpCode::Sub && IsConstant(*args[1])) {
+    // a * b - c  =>  a * b + (-c)
+    Node &product = *args[0];
+    if (product.is_op && product.op == OpCode::Mul)
+      return MakeOp(OpCode::Add, std::move(args[0]), Constant(-args[1]->leaf.value));
+  }
+  if (op == OpCode::Add) {
+    for (int i = 0; i < 2; i++) {
+      Node &product = *args[i];
+      if (product.is_op && product.op == OpCode::Mul) {
+        std::vector<NodePtr> fused;
+        fused.push_back(std::move(product.args[0]));
+        fused.push_back(std::move(product.args[1]));
+        fused.push_back(std::move(args[1 - i]));
+        return MakeOp(OpCode::MulAdd, std::move(fused));
+      }
+    }
+  }
+  NodePtr node(new Node());
+  node->is_op = true;
+  node->op = op;
+  node->args = std::move(args);
+  return node;
+}
+
+NodePtr MakeOp(OpCode op, NodePtr a, NodePtr b) {
+  std::vector<NodePtr> args;
+  args.push_back(std::move(a));
+  args.push_back(std::move(b));
+  return MakeOp(op, std::move(args));
+}
+
+struct FunctionDef {
+  const char *name;
+  OpCode op;
+  int arity;
+  bool identity;
+};
+
+const FunctionDef kFunctions[] = {
+  { "min",     OpCode::Min,         2, false },
+  { "max",     OpCode::Max,         2, false },
+  { "clamp",   OpCode::Clamp,       3, false },
+  { "abs",     OpCode::Abs,         1, false },
+  { "sqrt",    OpCode::Sqrt,        1, false },
+  { "round",   OpCode::Round,       1, false },
+  { "floor",   OpCode::Floor,       1, false },
+  { "ceil",    OpCode::Ceil,        1, false },
+  { "uint8",   OpCode::CastUint8,   1, false },
+  { "int16",   OpCode::CastInt16,   1, false },
+  { "int32",   OpCode::CastInt32,   1, false },
+  { "float16", OpCode::CastFloat16, 1, false },
+  { "float",   OpCode::Add,         1, true },
+};
+
+class Parser {
+ public:
+  explicit Parser(const std::string &text) : text_(text) {}
+
+  NodePtr Parse() {
+    NodePtr node = ParseSum();
+    SkipSpaces();
+    if (pos_ != text_.size())
+      Fail("unexpected character '" + std::string(1, text_[pos_]) + "'");
+    return node;
+  }
+
+  int NumInputs() const { return num_inputs_; }
+
+ private:
+  // sum := product (('+' | '-') product)*
+  NodePtr ParseSum() {
+    NodePtr node = ParseProduct();
+    while (true) {
+      if (Accept('+'))
+        node = MakeOp(OpCode::Add, std::move(node), ParseProduct());
+      else if (Accept('-'))
+        node = MakeOp(OpCode::Sub, std::move(node), ParseProduct());
+      else
+        return node;
+    }
+  }
+
+  // product := unary (('*' | '/') unary)*
+  NodePtr ParseProduct() {
+    NodePtr node = ParseUnary();
+    while (true) {
+      if (Accept('*'))
+        node = MakeOp(OpCode::Mul, std::move(node), ParseUnary());
+      else if (Accept('/'))
+        node = MakeOp(OpCode::Div, std::move(node), ParseUnary());
+      else
+        return node;
+    }
+  }
+
+  // unary := ('-' | '+') unary | primary
+  NodePtr ParseUnary() {
+    if (Accept('-')) {
+      std::vector<NodePtr> args;
+      args.push_back(ParseUnary());
+      return MakeOp(OpCode::Neg, std::move(args));
+    }
+    if (Accept('+'))
+      return ParseUnary();
+    return ParsePrimary();
+  }
+
+  // primary := number | input | function '(' sum (',' sum)* ')' | '(' sum ')'
+  NodePtr ParsePrimary() {
+    SkipSpaces();
+    if (Accept('(')) {
+      NodePtr node = ParseSum();
+      Expect(')');
+      return node;
+    }
+    if (pos_ < text_.size() && (std::isdigit(text_[pos_]) || text_[pos_] == '.')) {
+      const char *start = text_.c_str() + pos_;
+      char *end = nullptr;
+      float value = std::strtof(start, &end);
+      pos_ += end - start;
+      return Constant(value);
+    }
+    std::string name = ParseIdentifier();
+    if (name.empty())
+      Fail(pos_ < text_.size() ? "unexpected character '" + std::string(1, text_[pos_]) + "'"
+                               : "unexpected end");
+    if (name[0] == 'x' && std::all_of(name.begin() + 1, name.end(), ::isdigit))
+      return InputRef(name.size() == 1 ? 0 : std::stoi(name.substr(1)));
+
+    auto def = std::find_if(std::begin(kFunctions), std::end(kFunctions),
+                            [&](const FunctionDef &f) { return name == f.name; });
+    if (def == std::end(kFunctions))
+      Fail("unknown name \"" + name + "\"");
+    Expect('(');
+    std::vector<NodePtr> args;
+    args.push_back(ParseSum());
+    while (Accept(','))
+      args.push_back(ParseSum());
+    Expect(')');
+    if (static_cast<int>(args.size()) != def->arity)
+      Fail(std::string(def->name) + " expects " + std::to_string(def->arity) + " argument(s)");
+    if (def->identity)
+      return std::move(args[0]);
+    return MakeOp(def->op, std::move(args));
+  }
+
+  NodePtr InputRef(int index) {
+    num_inputs_ = std::max(num_inputs_, index + 1);
+    Operand operand;
+    operand.kind = Operand::Input;
+    operand.index = index;
+    return Leaf(operand);
+  }
+
+  std::string ParseIdentifier() {
+    size_t start = pos_;
+    while (pos_ < text_.size() && (std::isalnum(text_[pos_]) || text_[pos_] == '_'))
+      pos_++;
+    return text_.substr(start, pos_ - start);
+  }
+
+  void SkipSpaces() {
+    while (pos_ < text_.size() && std::isspace(text_[pos_]))
+      pos_++;
+  }
+
+  bool Accept(char c) {
+    SkipSpaces();
+    if (pos_ < text_.size() && text_[pos_] == c) {
+      pos_++;
+      return true;
+    }
+    return false;
+  }
+
+  void Expect(char c) {
+    if (!Accept(c))
+      Fail(std::string("expected '") + c + "'");
+  }
+
+  [[noreturn]] void Fail(const std::string &message) {
+    DALI_FAIL("Invalid expression \"" + text_ + "\" at position " + std::to_string(pos_) +
+              ": " + message);
+  }
+
+  const std::string &text_;
+  size_t pos_ = 0;
+  int num_inputs_ = 0;
+};
+
+/**
+ * @brief Pointers to the values of the operands for the current tile
+ */
+struct TileContext {
+  float *registers;
+  std::vector<const float *> inputs;  // nullptr for scalar inputs
+  std::vector<float> scalars;
+
+  // Returns nullptr if the operand has the same value for all the elements
+  const float *Ptr(const Operand &operand) const {
+    switch (operand.kind) {
+      case Operand::Register: return registers + operand.index * Expression::kTileSize;
+      case Operand::Input:    return inputs[operand.index];
+      default:                return nullptr;
+    }
+  }
+
+  float Value(const Operand &operand) const {
+    return operand.kind == Operand::Input ? scalars[operand.index] : operand.value;
+  }
+};
+
+template <typename F>
+void Unary(float *dst, const float *a, int n, F f) {
+  for (int i = 0; i < n; i++)
+    dst[i] = f(a[i]);
+}
+
+template <typename F>
+void Binary(float *dst, const TileContext &ctx, const Operand *args, int n, F f) {
+  const float *a = ctx.Ptr(args[0]), *b = ctx.Ptr(args[1]);
+  if (a && b) {
+    for (int i = 0; i < n; i++)
+      dst[i] = f(a[i], b[i]);
+  } else if (a) {
+    float vb = ctx.Value(args[1]);
+    for (int i = 0; i < n; i++)
+      dst[i] = f(a[i], vb);
+  } else if (b) {
+    float va = ctx.Value(args[0]);
+    for (int i = 0; i < n; i++)
+      dst[i] = f(va, b[i]);
+  } else {
+    // scalar inputs and constants, e.g. x * (1 - x1)
+    std::fill(dst, dst + n, f(ctx.Value(args[0]), ctx.Value(args[1])));
+  }
+}
+
+template <typename F>
+void Ternary(float *dst, const TileContext &ctx, const Operand *args, int n, F f) {
+  const float *a = ctx.Ptr(args[0]), *b = ctx.Ptr(args[1]), *c = ctx.Ptr(args[2]);
+  if (a && !b && !c) {
+    // the common case: x * scale + shift, clamp(x, lo, hi)
+    float vb = ctx.Value(args[1]), vc = ctx.Value(args[2]);
+    for (int i = 0; i < n; i++)
+      dst[i] = f(a[i], vb, vc);
+    return;
+  }
+  float v[3];
+  const float *ptr[3] = { a, b, c };
+  int stride[3];
+  for (int k = 0; k < 3; k++) {
+    stride[k] = ptr[k] ? 1 : 0;
+    if (!ptr[k]) {
+      v[k] = ctx.Value(args[k]);
+      ptr[k] = &v[k];
+    }
+  }
+  for (int i = 0; i < n; i++)
+    dst[i] = f(ptr[0][i * stride[0]], ptr[1][i * stride[1]], ptr[2][i * stride[2]]);
+}
+
+void Execute(const Instruction &instr, const TileContext &ctx, int n) {
+  float *dst = ctx.registers + instr.dst * Expression::kTileSize;
+  const Operand *args = instr.args;
+  // unary operations are never applied to constants - those are folded
+  const float *a = ctx.Ptr(args[0]);
+  float tmp[Expression::kTileSize];
+  if (Arity(instr.op) == 1 && !a) {
+    std::fill(tmp, tmp + n, ctx.Value(args[0]));
+    a = tmp;
+  }
+  switch (instr.op) {
+    case OpCode::Add:
+      return Binary(dst, ctx, args, n, [](float x, float y) { return x + y; });
+    case OpCode::Sub:
+      return Binary(dst, ctx, args, n, [](float x, float y) { return x - y; });
+    case OpCode::Mul:
+      return Binary(dst, ctx, args, n, [](float x, float y) { return x * y; });
+    case OpCode::Div:
+      return Binary(dst, ctx, args, n, [](float x, float y) { return x / y; });
+    case OpCode::Min:
+      return Binary(dst, ctx, args, n, [](float x, float y) { return std::min(x, y); });
+    case OpCode::Max:
+      return Binary(dst, ctx, args, n, [](float x, float y) { return std::max(x, y); });
+    case OpCode::MulAdd:
+      return Ternary(dst, ctx, args, n, [](float x, float y, float z) { return x * y + z; });
+    case OpCode::Clamp:
+      return Ternary(dst, ctx, args, n, [](float x, float lo, float hi) {
+        return std::min(std::max(x, lo), hi);
+      });
+    case OpCode::Neg:
+      return Unary(dst, a, n, [](float x) { return -x; });
+    case OpCode::Abs:
+      return Unary(dst, a, n, [](float x) { return std::fabs(x); });
+    case OpCode::Sqrt:
+      return Unary(dst, a, n, [](float x) { return std::sqrt(x); });
+    case OpCode::Round:
+      return Unary(dst, a, n, [](float x) { return std::round(x); });
+    case OpCode::Floor:
+      return Unary(dst, a, n, [](float x) { return std::floor(x); });
+    case OpCode::Ceil:
+      return Unary(dst, a, n, [](float x) { return std::ceil(x); });
+    case OpCode::CastUint8:
+      return Unary(dst, a, n, [](float x) { return static_cast<float>(clamp<uint8_t>(x)); });
+    case OpCode::CastInt16:
+      return Unary(dst, a, n, [](float x) { return static_cast<float>(clamp<int16_t>(x)); });
+    case OpCode::CastInt32:
+      return Unary(dst, a, n, [](float x) { return static_cast<float>(clamp<int32_t>(x)); });
+    case OpCode::CastFloat16: {
+      float16 h[Expression::kTileSize];
+      kernels::CastBuffer(h, a, n);
+      kernels::CastBuffer(dst, h, n);
+      return;
+    }
+  }
+}
+
+}  // namespace
+
+Expression::Expression(const std::string &text) {
+  Parser parser(text);
+  NodePtr root = parser.Parse();
+  num_inputs_ = parser.NumInputs();
+  input_used_.resize(num_inputs_, false);
+
+  std::vector<int> free_registers;
+  std::function<Operand(const Node &)> compile = [&](const Node &node) -> Operand {
+    if (!node.is_op) {
+      if (node.leaf.kind == Operand::Input)
+        input_used_[node.leaf.index] = true;
+      return node.leaf;
+    }
+    Instruction instr;
+    instr.op = node.op;
+    for (size_t i = 0; i < node.args.size(); i++)
+      instr.args[i] = compile(*node.args[i]);
+    // the operations are element-wise, so the result may overwrite an argument
+    for (size_t i = 0; i < node.args.size(); i++) {
+      if (instr.args[i].kind == Operand::Register)
+        free_registers.push_back(instr.args[i].index);
+    }
+    if (free_registers.empty()) {
+      instr.dst = num_registers_++;
+    } else {
+      instr.dst = free_registers.back();
+      free_registers.pop_back();
+    }
+    program_.push_back(instr);
+    Operand result;
+    result.kind = Operand::Register;
+    result.index = instr.dst;
+    return result;
+  };
+  result_ = compile(*root);
+}
+
+void Expression::Evaluate(void *out, DALIDataType out_type,
+                          const std::vector<ExprInput> &inputs, int64_t n) const {
+  DALI_ENFORCE(static_cast<int>(inputs.size()) >= num_inputs_,
+      "The expression uses " + std::to_string(num_inputs_) + " inputs, got " +
+      std::to_string(inputs.size()));
+
+  // registers, followed by the tiles of converted inputs
+  std::vector<float> scratch((num_registers_ + num_inputs_) * kTileSize);
+  TileContext ctx;
+  ctx.registers = scratch.data();
+  ctx.inputs.resize(num_inputs_, nullptr);
+  ctx.scalars.resize(num_inputs_, 0);
+  for (int k = 0; k < num_inputs_; k++) {
+    if (input_used_[k] && inputs[k].scalar) {
+      DALI_TYPE_SWITCH_WITH_FP16(inputs[k].type, InType,
+        kernels::CastBuffer(&ctx.scalars[k], static_cast<const InType *>(inputs[k].data), 1);
+      );  // NOLINT
+    }
+  }
+
+  for (int64_t start = 0; start < n; start += kTileSize) {
+    int count = std::min<int64_t>(kTileSize, n - start);
+    for (int k = 0; k < num_inputs_; k++) {
+      if (!input_used_[k] || inputs[k].scalar)
+        continue;
+      if (inputs[k].type == DALI_FLOAT) {
+        ctx.inputs[k] = static_cast<const float *>(inputs[k].data) + start;
+        continue;
+      }
+      float *tile = scratch.data() + (num_registers_ + k) * kTileSize;
+      DALI_TYPE_SWITCH_WITH_FP16(inputs[k].type, InType,
+        kernels::CastBuffer(tile, static_cast<const InType *>(inputs[k].data) + start, count);
+      );  // NOLINT
+      ctx.inputs[k] = tile;
+    }
+
+    for (auto &instr : program_)
+      Execute(instr, ctx, count);
+
+    const float *result = ctx.Ptr(result_);
+    float broadcast[kTileSize];
+    if (!result) {
+      std::fill(broadcast, broadcast + count, ctx.Value(result_));
+      result = broadcast;
+    }
+    DALI_TYPE_SWITCH_WITH_FP16(out_type, OutType,
+      kernels::CastBuffer(static_cast<OutType *>(out) + start, result, count);
+    );  // NOLINT
+  }
+}
+
+}  // namespace expr
+}  // namespace dali
@@ -0,0 +1,114 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_PIPELINE_OPERATORS_EXPRESSIONS_EXPRESSION_H_
+#define DALI_PIPELINE_OPERATORS_EXPRESSIONS_EXPRESSION_H_
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/data/types.h"
+
+namespace dali {
+namespace expr {
+
+enum class OpCode : uint8_t {
+  Add, Sub, Mul, Div, MulAdd, Min, Max, Clamp,
+  Neg, Abs, Sqrt, Round, Floor, Ceil,
+  // saturating casts, with the semantics of `clamp<T>`
+  CastUint8, CastInt16, CastInt32, CastFloat16
+};
+
+/**
+ * @brief An operand of an instruction: a register, an input or a constant
+ */
+struct Operand {
+  enum Kind : uint8_t { Register, Input, Constant };
+  Kind kind = Constant;
+  int index = 0;
+  float value = 0;
+};
+
+struct Instruction {
+  OpCode op;
+  int dst;
+  Operand args[3];
+};
+
+/**
+ * @brief An input of the expression. Scalar inputs (a single value) are broadcast.
+ */
+struct ExprInput {
+  const void *data;
+  DALIDataType type;
+  bool scalar;
+};
+
+/**
+ * @brief Element-wise arithmetic expression, compiled to a program working on tiles of values
+ *
+ * The syntax is the usual infix notation with `+`, `-`, `*`, `/`, parentheses, numbers,
+ * inputs (`x0`, `x1`, ..., `x` is the same as `x0`) and functions: `min(a, b)`, `max(a, b)`,
+ * `clamp(a, lo, hi)`, `abs`, `sqrt`, `round`, `floor`, `ceil` and the saturating casts:
+ * `uint8`, `int16`, `int32`, `float16` and `float`.
+ *
+ * The computation is done in float. Constant subexpressions are folded and multiplications
+ * followed by additions are fused.
+ */
+class DLL_PUBLIC Expression {
+ public:
+  /**
+   * @brief Parses and compiles the expression; throws on syntax errors
+   */
+  explicit Expression(const std::string &text);
+
+  /**
+   * @brief Number of inputs the expression refers to (the highest input index + 1)
+   */
+  int NumInputs() const { return num_inputs_; }
+
+  /**
+   * @brief Number of tile-sized registers used by the program
+   */
+  int NumRegisters() const { return num_registers_; }
+
+  const std::vector<Instruction> &Program() const { return program_; }
+
+  /**
+   * @brief Evaluates the expression for `n` elements and stores the results as `out_type`
+   */
+  void Evaluate(void *out, DALIDataType out_type,
+                const std::vector<ExprInput> &inputs, int64_t n) const;
+
+  /**
+   * @brief Number of elements processed at once; the registers of a tile stay in L1 cache
+   */
+  static constexpr int kTileSize = 256;
+
+ private:
+  std::vector<Instruction> program_;
+  // where the result is: a register, an input or a constant
+  Operand result_;
+  std::vector<bool> input_used_;
+  int num_inputs_ = 0;
+  int num_registers_ = 0;
+};
+
+}  // namespace expr
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_EXPRESSIONS_EXPRESSION_H_
@@ -0,0 +1,123 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <cmath>
+#include <string>
+#include <vector>
+#include "dali/pipeline/operators/expressions/expression.h"
+
+namespace dali {
+namespace expr {
+
+namespace {
+
+template <typename Out, typename In>
+std::vector<Out> Eval(const std::string &text, const std::vector<In> &x,
+                      std::vector<ExprInput> extra = {}) {
+  Expression e(text);
+  std::vector<Out> out(x.size());
+  std::vector<ExprInput> inputs = { { x.data(), TypeTable::GetTypeID<In>(), false } };
+  inputs.insert(inputs.end(), extra.begin(), extra.end());
+  e.Evaluate(out.data(), TypeTable::GetTypeID<Out>(), inputs, x.size());
+  return out;
+}
+
+std::vector<uint8_t> Ramp(int n) {
+  std::vector<uint8_t> values(n);
+  for (int i = 0; i < n; i++)
+    values[i] = i * 7;
+  return values;
+}
+
+}  // namespace
+
+TEST(Expression, Arithmetic) {
+  // more than a tile, not a multiple of it
+  auto x = Ramp(1000);
+  auto out = Eval<float>("(x * 2 + 10) / 4 - -1", x);
+  for (size_t i = 0; i < x.size(); i++)
+    ASSERT_EQ(out[i], (x[i] * 2.0f + 10) / 4 + 1) << i;
+}
+
+TEST(Expression, FoldsConstantsAndFusesMultiplyAdd) {
+  Expression e("x * (1 + 2) + 4 * 0.5");
+  ASSERT_EQ(e.Program().size(), 1u);
+  EXPECT_EQ(e.Program()[0].op, OpCode::MulAdd);
+  EXPECT_EQ(e.Program()[0].args[1].value, 3.0f);
+  EXPECT_EQ(e.Program()[0].args[2].value, 2.0f);
+  EXPECT_EQ(e.NumRegisters(), 1);
+
+  Expression constant("min(3, 2) * 2");
+  EXPECT_TRUE(constant.Program().empty());
+  std::vector<int32_t> out(5);
+  std::vector<uint8_t> x(5);
+  constant.Evaluate(out.data(), DALI_INT32, { { x.data(), DALI_UINT8, false } }, 5);
+  EXPECT_EQ(out, std::vector<int32_t>(5, 4));
+}
+
+TEST(Expression, ReusesRegisters) {
+  Expression e("abs(x0 - x1) + abs(x1 - x2) + abs(x2 - x0)");
+  EXPECT_EQ(e.NumInputs(), 3);
+  EXPECT_LE(e.NumRegisters(), 3);
+}
+
+TEST(Expression, FunctionsAndCasts) {
+  std::vector<float> x = { -300.7f, -1.5f, -0.5f, 0.4f, 2.5f, 254.9f, 1000 };
+  auto out = Eval<float>("uint8(x)", x);
+  EXPECT_EQ(out, (std::vector<float>{ 0, 0, 0, 0, 2, 254, 255 }));
+  out = Eval<float>("round(x)", x);
+  EXPECT_EQ(out, (std::vector<float>{ -301, -2, -1, 0, 3, 255, 1000 }));
+  out = Eval<float>("clamp(x, -1, 1)", x);
+  EXPECT_EQ(out, (std::vector<float>{ -1, -1, -0.5f, 0.4f, 1, 1, 1 }));
+  out = Eval<float>("max(floor(x), ceil(x) - 10) + float(sqrt(abs(x)) * 0)", x);
+  for (size_t i = 0; i < x.size(); i++)
+    EXPECT_EQ(out[i], std::max(std::floor(x[i]), std::ceil(x[i]) - 10));
+  out = Eval<float>("float16(x / 3)", x);
+  EXPECT_EQ(out[5], 84.9375f);
+
+  // the output type saturates and truncates
+  auto out_u8 = Eval<uint8_t>("x", x);
+  EXPECT_EQ(out_u8, (std::vector<uint8_t>{ 0, 0, 0, 0, 2, 254, 255 }));
+}
+
+TEST(Expression, ScalarInputs) {
+  auto x = Ramp(300);
+  float a = 0.5f;
+  int16_t b = -3;
+  auto out = Eval<float>("(x - x2) * x1", x,
+                         { { &a, DALI_FLOAT, true }, { &b, DALI_INT16, true } });
+  for (size_t i = 0; i < x.size(); i++)
+    ASSERT_EQ(out[i], (x[i] + 3) * 0.5f);
+
+  // binary operations with no per-element operand
+  out = Eval<float>("x * (1 - x1)", x, { { &a, DALI_FLOAT, true } });
+  for (size_t i = 0; i < x.size(); i++)
+    ASSERT_EQ(out[i], x[i] * 0.5f);
+  out = Eval<float>("x * (x1 + x2)", x, { { &a, DALI_FLOAT, true }, { &b, DALI_INT16, true } });
+  for (size_t i = 0; i < x.size(); i++)
+    ASSERT_EQ(out[i], x[i] * -2.5f);
+}
+
+TEST(Expression, Errors) {
+  EXPECT_THROW(Expression("x +"), std::runtime_error);
+  EXPECT_THROW(Expression("(x"), std::runtime_error);
+  EXPECT_THROW(Expression("y * 2"), std::runtime_error);
+  EXPECT_THROW(Expression("clamp(x, 1)"), std::runtime_error);
+  EXPECT_THROW(Expression("x $ 2"), std::runtime_error);
+}
+
+}  // namespace expr
+}  // namespace dali
@@ -14,6 +14,10 @@
 
 #include "dali/pipeline/operators/fused/normalize_permute.h"
 
+#include <vector>
+
+#include "dali/kernels/common/cast.h"
+
 namespace dali {
 
   template<>
@@ -36,6 +40,8 @@ namespace dali {
     output.SetLayout(DALI_NCHW);
     if (output_type_ == DALI_FLOAT) {
       CPURunHelper<float>(input, output);
+    } else if (output_type_ == DALI_FLOAT16) {
+      CPURunHelper<float16>(input, output);
     } else {
       DALI_FAIL("Unsupported output type.");
     }
@@ -50,12 +56,14 @@ void NormalizePermute<CPUBackend>::CPURunHelper(const Tensor<CPUBackend> &input,
   float *mean = mean_.template mutable_data<float>();
   float *inv_std = inv_std_.template mutable_data<float>();
 
+  // rows are normalized in float and then converted to the output type at once
+  std::vector<float> row(W_);
   for (int c = 0; c < C_; ++c) {
     for (int h = 0; h < H_; ++h) {
       for (int w = 0; w < W_; ++w) {
-        out[c*H_*W_ + h*W_ + w] = static_cast<OUT>(
-            (static_cast<float>(in[h*W_*C_ + w*C_ + c]) - mean[c]) * inv_std[c]);
+        row[w] = (static_cast<float>(in[h*W_*C_ + w*C_ + c]) - mean[c]) * inv_std[c];
       }
+      kernels::CastBuffer(out + c*H_*W_ + h*W_, row.data(), W_);
     }
   }
 }
@@ -60,4 +60,16 @@ OpSpec& OpSpec::AddArgumentInput(const string &arg_name, const string &inp_name)
   return *this;
 }
 
+OpSpec& OpSpec::ShareArgument(const OpSpec &other, const string &name) {
+  auto arg_input = other.argument_inputs_.find(name);
+  if (arg_input != other.argument_inputs_.end()) {
+    return AddArgumentInput(name, other.InputName(arg_input->second));
+  }
+  auto arg = other.arguments_.find(name);
+  DALI_ENFORCE(arg != other.arguments_.end(),
+      "Argument \"" + name + "\" is not defined in the op `" + other.name() + "`.");
+  arguments_[name] = arg->second;
+  return *this;
+}
+
 }  // namespace dali
@@ -365,6 +365,12 @@ class DLL_PUBLIC OpSpec {
     return TryGetRepeatedArgumentImpl<T, S>(result, name);
   }
 
+  /**
+   * @brief Makes this spec use the same value (or argument input) of the argument `name`
+   * as `other` does.
+   */
+  DLL_PUBLIC OpSpec& ShareArgument(const OpSpec &other, const string &name);
+
   DLL_PUBLIC OpSpec& ShareArguments(OpSpec& other) {
     this->arguments_ = other.arguments_;
     this->argument_inputs_ = other.argument_inputs_;
@@ -55,6 +55,11 @@ class OperatorRegistry {
     return registry_[name](spec);
   }
 
+  bool IsRegistered(const std::string &name) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return registry_.count(name) > 0;
+  }
+
   vector<std::string> RegisteredNames(bool internal_ops) {
     vector<std::string> names;
     for (const auto &pair : registry_) {
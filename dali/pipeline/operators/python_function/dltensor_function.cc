@@ -12,6 +12,7 @@
 // See the License for the specific language governing permissions and
 // limitations under the License.
 
+#include <vector>
 #include "dali/pipeline/operators/python_function/dltensor_function.h"
 #include "dali/pipeline/operators/python_function/util/copy_with_stride.h"
 
@@ -69,9 +70,16 @@ void CopyDLTensorOutputs<CPUBackend>(HostWorkspace &ws, py::tuple &return_tuple)
     auto &thread_pool = ws.GetThreadPool();
     const auto batch_size = dl_tensors.size();
     for (size_t i = 0; i < batch_size; ++i) {
-      thread_pool.DoWorkWithID([&, i](int) {
-        CopyDlTensor<CPUBackend>(tvec[i].raw_mutable_data(), dl_tensors[i]);
-      });
+      auto &dl_tensor = dl_tensors[i]->dl_tensor;
+      auto item_size = dl_tensor.dtype.bits / 8;
+      std::vector<Index> strides;
+      if (dl_tensor.strides) {
+        strides.resize(dl_tensor.ndim);
+        for (Index d = 0; d < dl_tensor.ndim; ++d) strides[d] = dl_tensor.strides[d] * item_size;
+      }
+      ScheduleCopyWithStride(thread_pool, tvec[i].raw_mutable_data(), dl_tensor.data,
+                             dl_tensor.strides ? strides.data() : nullptr,
+                             dl_tensor.shape, dl_tensor.ndim, item_size);
     }
     thread_pool.WaitForWork();
   }
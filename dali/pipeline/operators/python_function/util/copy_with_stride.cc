@@ -13,77 +13,190 @@
 // limitations under the License.
 
 #include "dali/pipeline/operators/python_function/util/copy_with_stride.h"
+#ifdef __AVX2__
+#include <immintrin.h>
+#endif
+#include <algorithm>
+#include <cstdlib>
 #include <cstring>
 #include <cassert>
+#include <limits>
+#include <memory>
+#include <utility>
 #include "dali/core/static_switch.h"
 #include "dali/core/util.h"
 
 namespace dali {
 
-inline void CopyVec(uint8 *output, const uint8 *input, size_t elems,
-                    size_t in_stride, size_t item_size) {
-  for (size_t i = 0; i < elems; ++i) {
-    for (size_t j = 0; j < item_size; j++)
-      *output++ = input[j];
+namespace {
+
+/**
+ * @brief Strided copy with merged dimensions.
+ *
+ * The innermost level copies `shape.back()` blocks of `block_size` bytes, spaced by
+ * `in_strides.back()` bytes in the input. If `shape` is empty, the whole copy is
+ * a single block. The output is always dense.
+ */
+struct StridedCopyDesc {
+  std::vector<Index> shape;
+  std::vector<Index> in_strides;
+  std::vector<Index> out_strides;
+  size_t block_size = 0;
+  bool empty = false;
+
+  Index num_bytes() const {
+    return empty ? 0 : volume(shape) * static_cast<Index>(block_size);
+  }
+};
+
+StridedCopyDesc SimplifyStridedCopy(const Index *in_strides, const Index *shape,
+                                    int ndim, size_t item_size) {
+  StridedCopyDesc desc;
+  desc.block_size = item_size;
+  for (int i = 0; i < ndim; ++i) {
+    if (shape[i] == 0) {
+      desc.empty = true;
+      return desc;
+    }
+    // the stride of a unit dimension is irrelevant
+    if (shape[i] == 1)
+      continue;
+    if (!desc.shape.empty() && desc.in_strides.back() == in_strides[i] * shape[i]) {
+      desc.shape.back() *= shape[i];
+      desc.in_strides.back() = in_strides[i];
+    } else {
+      desc.shape.push_back(shape[i]);
+      desc.in_strides.push_back(in_strides[i]);
+    }
+  }
+  // contiguous innermost dimension is copied as a single block
+  if (!desc.shape.empty() && desc.in_strides.back() == static_cast<Index>(item_size)) {
+    desc.block_size *= desc.shape.back();
+    desc.shape.pop_back();
+    desc.in_strides.pop_back();
+  }
+  desc.out_strides.resize(desc.shape.size());
+  Index out_stride = desc.block_size;
+  for (int i = static_cast<int>(desc.shape.size()) - 1; i >= 0; --i) {
+    desc.out_strides[i] = out_stride;
+    out_stride *= desc.shape[i];
+  }
+  return desc;
+}
+
+inline void GatherBlocks(uint8 *output, const uint8 *input, Index n,
+                         Index in_stride, size_t block_size) {
+  for (Index i = 0; i < n; ++i) {
+    std::memcpy(output, input, block_size);
+    output += block_size;
     input += in_stride;
   }
 }
 
-template <size_t item_size>
-inline void CopyVecStatic(uint8 *output, const uint8 *input, size_t elems, size_t in_stride) {
-  for (size_t i = 0; i < elems; ++i) {
-    for (size_t j = 0; j < item_size; j++)
+template <size_t block_size>
+inline void GatherBlocksStatic(uint8 *output, const uint8 *input, Index n, Index in_stride) {
+  for (Index i = 0; i < n; ++i) {
+    for (size_t j = 0; j < block_size; j++)
       output[j] = input[j];
-    output += item_size;
+    output += block_size;
     input += in_stride;
   }
 }
 
-inline void CopyWithStrideHelper(void *output, const void *input,
-                                 const Index *in_strides,
-                                 const Index *out_strides,
-                                 const Index *shape,
-                                 Index ndim,
-                                 Index dim, Index deepest_contiguous) {
-  auto out_ptr = reinterpret_cast<uint8*>(output);
-  auto in_ptr = reinterpret_cast<const uint8*>(input);
-  const auto item_size = out_strides[ndim - 1];
-  if (dim == deepest_contiguous) {
-    std::memcpy(out_ptr, in_ptr,
-        volume(shape + dim, shape + ndim)*item_size);
-    return;
+#ifdef __AVX2__
+
+template <>
+inline void GatherBlocksStatic<4>(uint8 *output, const uint8 *input, Index n, Index in_stride) {
+  Index i = 0;
+  if (std::abs(in_stride) <= std::numeric_limits<int32_t>::max() / 8) {
+    const int32_t s = in_stride;
+    const __m256i offsets = _mm256_setr_epi32(0, s, 2*s, 3*s, 4*s, 5*s, 6*s, 7*s);
+    for (; i + 8 <= n; i += 8) {
+      __m256i v = _mm256_i32gather_epi32(reinterpret_cast<const int *>(input), offsets, 1);
+      _mm256_storeu_si256(reinterpret_cast<__m256i *>(output), v);
+      output += 8 * 4;
+      input += 8 * in_stride;
+    }
+  }
+  for (; i < n; ++i) {
+    std::memcpy(output, input, 4);
+    output += 4;
+    input += in_stride;
+  }
+}
+
+template <>
+inline void GatherBlocksStatic<8>(uint8 *output, const uint8 *input, Index n, Index in_stride) {
+  const __m256i offsets = _mm256_setr_epi64x(0, in_stride, 2*in_stride, 3*in_stride);
+  Index i = 0;
+  for (; i + 4 <= n; i += 4) {
+    __m256i v = _mm256_i64gather_epi64(reinterpret_cast<const long long *>(input),  // NOLINT
+                                       offsets, 1);
+    _mm256_storeu_si256(reinterpret_cast<__m256i *>(output), v);
+    output += 4 * 8;
+    input += 4 * in_stride;
+  }
+  for (; i < n; ++i) {
+    std::memcpy(output, input, 8);
+    output += 8;
+    input += in_stride;
   }
+}
+
+#endif  // __AVX2__
+
+inline void CopyBlocks(uint8 *output, const uint8 *input, Index n,
+                       Index in_stride, size_t block_size) {
+  VALUE_SWITCH(block_size, static_size, (1, 2, 3, 4, 6, 8, 12, 16),
+               (GatherBlocksStatic<static_size>(output, input, n, in_stride)),
+               (GatherBlocks(output, input, n, in_stride, block_size)));
+}
+
+void CopyDim(uint8 *output, const uint8 *input, const StridedCopyDesc &desc,
+             int dim, Index extent) {
+  const int ndim = desc.shape.size();
   if (dim == ndim - 1) {
-    VALUE_SWITCH(item_size, elem_size, (1, 2, 3, 4, 5, 6, 7, 8, 12, 16),
-                 (CopyVecStatic<elem_size>(out_ptr, in_ptr, shape[ndim - 1], in_strides[ndim - 1])),
-                 (CopyVec(out_ptr, in_ptr, shape[ndim - 1], in_strides[ndim - 1], item_size)));
+    CopyBlocks(output, input, extent, desc.in_strides[dim], desc.block_size);
     return;
   }
-  const auto out_stride = out_strides[dim];
-  const auto in_stride = in_strides[dim];
-  const auto n = shape[dim];
-  for (Index i = 0; i < n; ++i) {
-    CopyWithStrideHelper(out_ptr, in_ptr, in_strides, out_strides,
-        shape, ndim, dim + 1, deepest_contiguous);
-    out_ptr += out_stride;
-    in_ptr += in_stride;
+  const auto out_stride = desc.out_strides[dim];
+  const auto in_stride = desc.in_strides[dim];
+  for (Index i = 0; i < extent; ++i) {
+    CopyDim(output, input, desc, dim + 1, desc.shape[dim + 1]);
+    output += out_stride;
+    input += in_stride;
   }
 }
 
-inline Index DeepestContiguous(const Index *in_strides,
-                               const Index *shape,
-                               int ndim,
-                               size_t item_size) {
-  ssize_t dim_prod = 1;
-  for (int i = ndim-1; i >= 0; --i) {
-    if (in_strides[i] != dim_prod*static_cast<Index>(item_size)) {
-      return i+1;
-    }
-    dim_prod *= shape[i];
+/**
+ * @brief Copies the range [begin, end) of the outermost dimension of `desc`
+ */
+void CopyRange(void *output, const void *input, const StridedCopyDesc &desc,
+               Index begin, Index end) {
+  auto out_ptr = reinterpret_cast<uint8*>(output);
+  auto in_ptr = reinterpret_cast<const uint8*>(input);
+  if (desc.empty)
+    return;
+  if (desc.shape.empty()) {
+    std::memcpy(out_ptr, in_ptr, desc.block_size);
+    return;
   }
-  return 0;
+  CopyDim(out_ptr + begin * desc.out_strides[0], in_ptr + begin * desc.in_strides[0],
+          desc, 0, end - begin);
 }
 
+std::vector<Index> DenseStrides(const Index *shape, int ndim, size_t item_size) {
+  std::vector<Index> strides(ndim);
+  Index stride = item_size;
+  for (int i = ndim - 1; i >= 0; --i) {
+    strides[i] = stride;
+    stride *= shape[i];
+  }
+  return strides;
+}
+
+}  // namespace
+
 template <>
 void CopyWithStride<CPUBackend>(void *output, const void *input,
                     const Index *in_strides,
@@ -95,14 +208,50 @@ void CopyWithStride<CPUBackend>(void *output, const void *input,
     std::memcpy(output, input, item_size * volume(shape, shape + ndim));
     return;
   }
-  std::vector<Index> out_strides(ndim);
-  out_strides.back() = item_size;
-  for (int i = ndim - 2; i >= 0; --i) {
-    out_strides[i] = out_strides[i + 1] * shape[i + 1];
+  auto desc = SimplifyStridedCopy(in_strides, shape, ndim, item_size);
+  CopyRange(output, input, desc, 0, desc.shape.empty() ? 1 : desc.shape[0]);
+}
+
+void ScheduleCopyWithStride(ThreadPool &thread_pool,
+                            void *output, const void *input,
+                            const Index *in_strides,
+                            const Index *shape,
+                            int ndim,
+                            size_t item_size,
+                            size_t min_chunk_bytes) {
+  assert(ndim > 0);
+  std::vector<Index> dense_strides;
+  if (!in_strides) {
+    dense_strides = DenseStrides(shape, ndim, item_size);
+    in_strides = dense_strides.data();
+  }
+  auto desc = SimplifyStridedCopy(in_strides, shape, ndim, item_size);
+  const Index num_bytes = desc.num_bytes();
+  if (num_bytes == 0)
+    return;
+
+  Index num_chunks = 1;
+  if (!desc.shape.empty() && min_chunk_bytes > 0) {
+    num_chunks = std::min<Index>(desc.shape[0], num_bytes / min_chunk_bytes);
+    num_chunks = std::min<Index>(num_chunks, thread_pool.size());
+    num_chunks = std::max<Index>(num_chunks, 1);
+  }
+  if (num_chunks == 1) {
+    thread_pool.DoWorkWithID([output, input, desc](int) {
+      CopyRange(output, input, desc, 0, desc.shape.empty() ? 1 : desc.shape[0]);
+    });
+    return;
+  }
+
+  auto shared_desc = std::make_shared<StridedCopyDesc>(std::move(desc));
+  const Index extent = shared_desc->shape[0];
+  for (Index chunk = 0; chunk < num_chunks; ++chunk) {
+    Index begin = extent * chunk / num_chunks;
+    Index end = extent * (chunk + 1) / num_chunks;
+    thread_pool.DoWorkWithID([output, input, shared_desc, begin, end](int) {
+      CopyRange(output, input, *shared_desc, begin, end);
+    });
   }
-  auto deepest_contiguous = DeepestContiguous(in_strides, shape, ndim, item_size);
-  CopyWithStrideHelper(output, input, in_strides, out_strides.data(),
-                       shape, ndim, 0, deepest_contiguous);
 }
 
 }  // namespace dali
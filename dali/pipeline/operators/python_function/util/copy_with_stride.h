@@ -18,9 +18,22 @@
 #include <vector>
 #include "dali/core/common.h"
 #include "dali/pipeline/data/backend.h"
+#include "dali/pipeline/util/thread_pool.h"
 
 namespace dali {
 
+/**
+ * @brief Minimum number of bytes copied by a single task in ScheduleCopyWithStride.
+ */
+constexpr size_t kStridedCopyMinChunk = 1 << 20;
+
+/**
+ * @brief Copies a tensor described by `in_strides` (in bytes) to a dense output.
+ *
+ * Dimensions which are contiguous in the input are merged before copying, so that
+ * the innermost loop moves the longest possible runs with a single memcpy or
+ * a fixed-size gather. If `in_strides` is null, the input is assumed to be dense.
+ */
 template <typename Backend>
 DLL_PUBLIC void CopyWithStride(void *output, const void *input,
                                const Index *in_strides,
@@ -28,6 +41,21 @@ DLL_PUBLIC void CopyWithStride(void *output, const void *input,
                                int ndim,
                                size_t item_size);
 
-}
+/**
+ * @brief Schedules a strided copy in the thread pool.
+ *
+ * Tensors larger than `min_chunk_bytes` are split along the outermost non-trivial
+ * dimension into several tasks. The copy is complete after `thread_pool.WaitForWork()`;
+ * `input` and `output` must stay valid until then. `in_strides` and `shape` are copied.
+ */
+DLL_PUBLIC void ScheduleCopyWithStride(ThreadPool &thread_pool,
+                                       void *output, const void *input,
+                                       const Index *in_strides,
+                                       const Index *shape,
+                                       int ndim,
+                                       size_t item_size,
+                                       size_t min_chunk_bytes = kStridedCopyMinChunk);
+
+}  // namespace dali
 
 #endif  // DALI_PIPELINE_OPERATORS_PYTHON_FUNCTION_UTIL_COPY_WITH_STRIDE_H_
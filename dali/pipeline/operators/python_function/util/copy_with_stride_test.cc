@@ -13,6 +13,8 @@
 // limitations under the License.
 
 #include <gtest/gtest.h>
+#include <numeric>
+#include <vector>
 #include "dali/pipeline/operators/python_function/util/copy_with_stride.h"
 
 namespace dali {
@@ -44,4 +46,65 @@ TEST(CopyWithStrideTest, SimpleCopy) {
   ASSERT_TRUE((out == std::array<uint8, 8>{1, 2, 3, 4, 5, 6, 7, 8}));
 }
 
+TEST(CopyWithStrideTest, Transposed) {
+  int data[] = {1, 2, 3, 4, 5, 6};  // 2x3 matrix, read as its 3x2 transpose
+  std::array<int, 6> out;
+  Index stride[] = {sizeof(int), 3 * sizeof(int)};
+  Index shape[] = {3, 2};
+  CopyWithStride<CPUBackend>(out.data(), data, stride, shape, 2, sizeof(int));
+  ASSERT_TRUE((out == std::array<int, 6>{1, 4, 2, 5, 3, 6}));
+}
+
+TEST(CopyWithStrideTest, NegativeStride) {
+  int16_t data[] = {1, 2, 3, 4, 5, 6};
+  std::array<int16_t, 3> out;
+  Index stride = -2 * static_cast<Index>(sizeof(int16_t));
+  Index shape = 3;
+  CopyWithStride<CPUBackend>(out.data(), data + 5, &stride, &shape, 1, sizeof(int16_t));
+  ASSERT_TRUE((out == std::array<int16_t, 3>{6, 4, 2}));
+}
+
+TEST(CopyWithStrideTest, ChannelSlice) {
+  // HWC image with 5 channels, channels 1..3 selected - copied in 3-element blocks
+  const int H = 4, W = 7, C = 5;
+  std::vector<uint8> data(H * W * C);
+  std::iota(data.begin(), data.end(), 0);
+  std::vector<uint8> out(H * W * 3);
+  Index stride[] = {W * C, C, 1};
+  Index shape[] = {H, W, 3};
+  CopyWithStride<CPUBackend>(out.data(), data.data() + 1, stride, shape, 3, 1);
+  for (int y = 0; y < H; y++)
+    for (int x = 0; x < W; x++)
+      for (int c = 0; c < 3; c++)
+        ASSERT_EQ(out[(y * W + x) * 3 + c], data[(y * W + x) * C + c + 1]);
+}
+
+TEST(CopyWithStrideTest, UnitAndEmptyDims) {
+  float data[] = {1, 2, 3, 4, 5, 6};
+  std::array<float, 3> out = {0, 0, 0};
+  Index stride[] = {100, 2 * sizeof(float), 7};
+  Index shape[] = {1, 3, 1};
+  CopyWithStride<CPUBackend>(out.data(), data, stride, shape, 3, sizeof(float));
+  ASSERT_TRUE((out == std::array<float, 3>{1, 3, 5}));
+
+  Index empty_shape[] = {1, 0, 1};
+  out = {0, 0, 0};
+  CopyWithStride<CPUBackend>(out.data(), data, stride, empty_shape, 3, sizeof(float));
+  ASSERT_TRUE((out == std::array<float, 3>{0, 0, 0}));
+}
+
+TEST(CopyWithStrideTest, ScheduledInChunks) {
+  const int N = 37, M = 11;
+  std::vector<int64_t> data(N * M * 2);
+  std::iota(data.begin(), data.end(), 0);
+  std::vector<int64_t> out(N * M);
+  Index stride[] = {M * 2 * sizeof(int64_t), 2 * sizeof(int64_t)};
+  Index shape[] = {N, M};
+  ThreadPool tp(4, 0, false);
+  ScheduleCopyWithStride(tp, out.data(), data.data(), stride, shape, 2, sizeof(int64_t), 64);
+  tp.WaitForWork();
+  for (int i = 0; i < N * M; i++)
+    ASSERT_EQ(out[i], 2 * i);
+}
+
 }  // namespace dali
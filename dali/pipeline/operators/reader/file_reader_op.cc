@@ -34,6 +34,12 @@ directories with images in them. To obtain labels `FileReader` sorts directories
       R"code(Path to the file with a list of pairs ``file label``
 (leave empty to traverse the `file_root` directory to obtain files and labels))code",
       std::string())
+  .AddOptionalArg("file_list_cache",
+      R"code(Path of a file caching the result of the `file_root` traversal
+(leave empty to traverse the directory on every start).
+The cache is created on the first run and reused, also by other processes reading the same
+`file_root`, as long as no files were added to or removed from the directories.)code",
+      std::string())
 .AddOptionalArg("shuffle_after_epoch",
       R"code(If true, reader shuffles whole dataset after each epoch. It is exclusive with
 `stick_to_shard` and `random_shuffle`.)code",
@@ -37,6 +37,9 @@ inline int safe_strcmp(const char *str1, const char (&str2)[N]) {
 using ImageIdPairs = std::vector<std::pair<std::string, int>>;
 class CocoLoader : public FileLoader {
  public:
+  // the annotations are parsed into the vectors of the reader which created the loader
+  static constexpr bool kShareable = false;
+
   explicit inline CocoLoader(
     const OpSpec& spec,
     std::vector<int> &offsets,
@@ -14,7 +14,18 @@
 
 #include <dirent.h>
 #include <errno.h>
+#include <unistd.h>
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <exception>
+#include <fstream>
+#include <iterator>
 #include <memory>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
 
 #include "dali/core/common.h"
 #include "dali/image/image.h"
@@ -23,15 +34,17 @@
 
 namespace dali {
 
+namespace {
+
 inline void assemble_file_list(const std::string& path, const std::string& curr_entry, int label,
                         std::vector<std::pair<std::string, int>> *file_label_pairs) {
   std::string curr_dir_path = path + "/" + curr_entry;
   DIR *dir = opendir(curr_dir_path.c_str());
+  DALI_ENFORCE(dir != nullptr, "Directory " + curr_dir_path + " could not be opened.");
 
   struct dirent *entry;
 
   while ((entry = readdir(dir))) {
-    std::string full_path = curr_dir_path + "/" + std::string{entry->d_name};
 #ifdef _DIRENT_HAVE_D_TYPE
     /*
      * we support only regular files and symlinks, if FS returns DT_UNKNOWN
@@ -48,9 +61,30 @@ inline void assemble_file_list(const std::string& path, const std::string& curr_
     }
   }
   closedir(dir);
+  // entries of a single directory can be sorted in parallel with the others
+  std::sort(file_label_pairs->begin(), file_label_pairs->end());
 }
 
-vector<std::pair<string, int>> filesystem::traverse_directories(const std::string& file_root) {
+bool is_directory(const std::string &parent, const struct dirent *entry) {
+#ifdef _DIRENT_HAVE_D_TYPE
+  // avoid a stat call per entry when the file system reports the type
+  if (entry->d_type == DT_DIR)
+    return true;
+  if (entry->d_type != DT_LNK && entry->d_type != DT_UNKNOWN)
+    return false;
+#endif
+  struct stat s;
+  std::string full_path = parent + "/" + entry->d_name;
+  int ret = stat(full_path.c_str(), &s);
+  DALI_ENFORCE(ret == 0,
+      "Could not access " + full_path + " during directory traversal.");
+  return S_ISDIR(s.st_mode);
+}
+
+/**
+ * @brief Sorted names of the class directories in `file_root`
+ */
+std::vector<std::string> list_class_directories(const std::string& file_root) {
   // open the root
   DIR *dir = opendir(file_root.c_str());
 
@@ -58,35 +92,270 @@ vector<std::pair<string, int>> filesystem::traverse_directories(const std::strin
       "Directory " + file_root + " could not be opened.");
 
   struct dirent *entry;
-
-  std::vector<std::pair<std::string, int>> file_label_pairs;
   std::vector<std::string> entry_name_list;
 
   while ((entry = readdir(dir))) {
-    struct stat s;
-    std::string entry_name(entry->d_name);
-    std::string full_path = file_root + "/" + entry_name;
-    int ret = stat(full_path.c_str(), &s);
-    DALI_ENFORCE(ret == 0,
-        "Could not access " + full_path + " during directory traversal.");
     if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
-    if (S_ISDIR(s.st_mode)) {
-      entry_name_list.push_back(entry_name);
+    if (is_directory(file_root, entry)) {
+      entry_name_list.push_back(entry->d_name);
     }
   }
+  closedir(dir);
   // sort directories to preserve class alphabetic order, as readdir could
   // return unordered dir list. Otherwise file reader for training and validation
   // could return directories with the same names in completely different order
   std::sort(entry_name_list.begin(), entry_name_list.end());
-  for (unsigned dir_count = 0; dir_count < entry_name_list.size(); ++dir_count) {
-      assemble_file_list(file_root, entry_name_list[dir_count], dir_count, &file_label_pairs);
+  return entry_name_list;
+}
+
+vector<std::pair<string, int>> traverse_class_directories(
+    const std::string& file_root, const std::vector<std::string> &dirs) {
+  // listing directories is dominated by the file system latency (especially on network
+  // file systems), so the class directories are read concurrently
+  std::vector<std::vector<std::pair<std::string, int>>> per_dir(dirs.size());
+  int num_threads = std::min<int>(dirs.size(),
+                                  std::max(4u, std::thread::hardware_concurrency()));
+  std::atomic<size_t> next_dir(0);
+  std::vector<std::exception_ptr> errors(num_threads);
+  auto worker = [&](int thread_idx) {
+    try {
+      for (size_t i; (i = next_dir++) < dirs.size(); ) {
+        assemble_file_list(file_root, dirs[i], i, &per_dir[i]);
+      }
+    } catch (...) {
+      errors[thread_idx] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int t = 1; t < num_threads; t++)
+    threads.emplace_back(worker, t);
+  if (num_threads > 0)
+    worker(0);
+  for (auto &t : threads)
+    t.join();
+  for (auto &error : errors) {
+    if (error)
+      std::rethrow_exception(error);
   }
-  // sort file names as well
-  std::sort(file_label_pairs.begin(), file_label_pairs.end());
-  printf("read %lu files from %lu directories\n", file_label_pairs.size(), entry_name_list.size());
 
-  closedir(dir);
+  size_t total = 0;
+  for (auto &files : per_dir)
+    total += files.size();
+  std::vector<std::pair<std::string, int>> file_label_pairs;
+  file_label_pairs.reserve(total);
+  for (auto &files : per_dir) {
+    std::move(files.begin(), files.end(), std::back_inserter(file_label_pairs));
+  }
+  // the concatenation is already sorted unless some directory name is a prefix of another
+  if (!std::is_sorted(file_label_pairs.begin(), file_label_pairs.end()))
+    std::sort(file_label_pairs.begin(), file_label_pairs.end());
+  printf("read %lu files from %lu directories\n", file_label_pairs.size(), dirs.size());
+  return file_label_pairs;
+}
+
+/**
+ * @brief Identifies the state of a directory listing - changes when entries are added or removed
+ */
+struct DirectoryStamp {
+  int64_t mtime_sec = 0;
+  int64_t mtime_nsec = 0;
+  int64_t size = 0;
+
+  bool operator==(const DirectoryStamp &other) const {
+    return mtime_sec == other.mtime_sec && mtime_nsec == other.mtime_nsec &&
+           size == other.size;
+  }
+};
+
+bool get_directory_stamp(const std::string &path, DirectoryStamp *stamp) {
+  struct stat s;
+  if (stat(path.c_str(), &s) != 0)
+    return false;
+  stamp->mtime_sec = s.st_mtim.tv_sec;
+  stamp->mtime_nsec = s.st_mtim.tv_nsec;
+  stamp->size = s.st_size;
+  return true;
+}
+
+constexpr char kFileListCacheMagic[8] = {'D', 'A', 'L', 'I', 'F', 'L', 'C', '1'};
+
+/**
+ * @brief Sequential reader of the memory-mapped cache file
+ */
+class CacheReader {
+ public:
+  explicit CacheReader(FileStream *stream) : stream_(stream) {}
+
+  template <typename T>
+  bool Read(T *value) {
+    return ReadBytes(value, sizeof(T));
+  }
+
+  bool Read(std::string *value) {
+    uint32_t length;
+    if (!Read(&length))
+      return false;
+    if (length > Remaining())
+      return false;
+    value->resize(length);
+    return length == 0 || ReadBytes(&(*value)[0], length);
+  }
+
+  /**
+   * @brief Number of bytes left in the cache file
+   */
+  size_t Remaining() const {
+    return stream_->Size() - offset_;
+  }
+
+ private:
+  bool ReadBytes(void *dst, size_t n) {
+    size_t read = stream_->Read(static_cast<uint8_t *>(dst), n);
+    offset_ += read;
+    return read == n;
+  }
+
+  FileStream *stream_;
+  size_t offset_ = 0;
+};
 
+template <typename T>
+void write_value(std::ostream &os, const T &value) {
+  os.write(reinterpret_cast<const char *>(&value), sizeof(T));
+}
+
+void write_value(std::ostream &os, const std::string &value) {
+  write_value(os, static_cast<uint32_t>(value.size()));
+  os.write(value.data(), value.size());
+}
+
+void write_value(std::ostream &os, const DirectoryStamp &stamp) {
+  write_value(os, stamp.mtime_sec);
+  write_value(os, stamp.mtime_nsec);
+  write_value(os, stamp.size);
+}
+
+bool read_stamp(CacheReader &reader, DirectoryStamp *stamp) {
+  return reader.Read(&stamp->mtime_sec) && reader.Read(&stamp->mtime_nsec) &&
+         reader.Read(&stamp->size);
+}
+
+/**
+ * @brief Loads the file list from the cache if it is still valid for `file_root`
+ */
+bool load_file_list_cache(const std::string &cache_path, const std::string &file_root,
+                          vector<std::pair<string, int>> *file_label_pairs) {
+  if (access(cache_path.c_str(), R_OK) != 0)
+    return false;
+  std::unique_ptr<FileStream> stream;
+  try {
+    stream = FileStream::Open(cache_path, false);
+  } catch (const std::exception &) {
+    return false;
+  }
+  CacheReader reader(stream.get());
+
+  char magic[sizeof(kFileListCacheMagic)];
+  std::string root;
+  DirectoryStamp stamp, current;
+  uint32_t num_dirs;
+  if (!reader.Read(&magic) ||
+      memcmp(magic, kFileListCacheMagic, sizeof(magic)) != 0 ||
+      !reader.Read(&root) || root != file_root ||
+      !read_stamp(reader, &stamp) ||
+      !get_directory_stamp(file_root, &current) || !(stamp == current) ||
+      !reader.Read(&num_dirs))
+    return false;
+
+  // a directory listing changes (and so does its modification time) when an entry is added
+  // or removed, so one stat per directory is enough to validate the whole list
+  for (uint32_t i = 0; i < num_dirs; i++) {
+    std::string dir;
+    if (!reader.Read(&dir) || !read_stamp(reader, &stamp) ||
+        !get_directory_stamp(file_root + "/" + dir, &current) || !(stamp == current))
+      return false;
+  }
+
+  uint64_t num_files;
+  // each entry takes at least a label and a name length - don't trust a corrupted count
+  const size_t kMinEntrySize = sizeof(int32_t) + sizeof(uint32_t);
+  if (!reader.Read(&num_files) || num_files > reader.Remaining() / kMinEntrySize)
+    return false;
+  vector<std::pair<string, int>> result(num_files);
+  for (auto &file_label : result) {
+    int32_t label;
+    if (!reader.Read(&label) || !reader.Read(&file_label.first))
+      return false;
+    file_label.second = label;
+  }
+  *file_label_pairs = std::move(result);
+  return true;
+}
+
+void save_file_list_cache(const std::string &cache_path, const std::string &file_root,
+                          const DirectoryStamp &root_stamp,
+                          const std::vector<std::string> &dirs,
+                          const std::vector<DirectoryStamp> &dir_stamps,
+                          const vector<std::pair<string, int>> &file_label_pairs) {
+  // write to a private file and rename it, so that concurrent readers (e.g. other ranks)
+  // never see a partially written cache
+  std::string tmp_path = cache_path + ".tmp." + std::to_string(getpid());
+  {
+    std::ofstream os(tmp_path, std::ios::binary | std::ios::trunc);
+    if (!os.is_open()) {
+      DALI_WARN("Could not write the file list cache " + cache_path);
+      return;
+    }
+    os.write(kFileListCacheMagic, sizeof(kFileListCacheMagic));
+    write_value(os, file_root);
+    write_value(os, root_stamp);
+    write_value(os, static_cast<uint32_t>(dirs.size()));
+    for (size_t i = 0; i < dirs.size(); i++) {
+      write_value(os, dirs[i]);
+      write_value(os, dir_stamps[i]);
+    }
+    write_value(os, static_cast<uint64_t>(file_label_pairs.size()));
+    for (auto &file_label : file_label_pairs) {
+      write_value(os, static_cast<int32_t>(file_label.second));
+      write_value(os, file_label.first);
+    }
+    if (!os.good()) {
+      std::remove(tmp_path.c_str());
+      return;
+    }
+  }
+  if (std::rename(tmp_path.c_str(), cache_path.c_str()) != 0)
+    std::remove(tmp_path.c_str());
+}
+
+}  // namespace
+
+vector<std::pair<string, int>> filesystem::traverse_directories(const std::string& file_root) {
+  return traverse_class_directories(file_root, list_class_directories(file_root));
+}
+
+vector<std::pair<string, int>> filesystem::traverse_directories(const std::string& file_root,
+                                                                const std::string& cache_path) {
+  if (cache_path.empty())
+    return traverse_directories(file_root);
+
+  vector<std::pair<string, int>> file_label_pairs;
+  if (load_file_list_cache(cache_path, file_root, &file_label_pairs))
+    return file_label_pairs;
+
+  // the stamps are taken before listing, so that changes made during the scan
+  // invalidate the cache
+  DirectoryStamp root_stamp;
+  DALI_ENFORCE(get_directory_stamp(file_root, &root_stamp),
+      "Directory " + file_root + " could not be opened.");
+  auto dirs = list_class_directories(file_root);
+  std::vector<DirectoryStamp> dir_stamps(dirs.size());
+  for (size_t i = 0; i < dirs.size(); i++) {
+    DALI_ENFORCE(get_directory_stamp(file_root + "/" + dirs[i], &dir_stamps[i]),
+        "Could not access " + file_root + "/" + dirs[i] + " during directory traversal.");
+  }
+  file_label_pairs = traverse_class_directories(file_root, dirs);
+  save_file_list_cache(cache_path, file_root, root_stamp, dirs, dir_stamps, file_label_pairs);
   return file_label_pairs;
 }
 
@@ -94,6 +363,10 @@ void FileLoader::PrepareEmpty(ImageLabelWrapper &image_label) {
   PrepareEmptyTensor(image_label.image);
 }
 
+void FileLoader::ReleaseEmpty(ImageLabelWrapper &image_label) {
+  ReleaseEmptyTensor(image_label.image);
+}
+
 void FileLoader::ReadSample(ImageLabelWrapper &image_label) {
   auto image_pair = image_label_pairs_[current_index_++];
 
@@ -36,6 +36,15 @@ namespace filesystem {
 
 vector<std::pair<string, int>> traverse_directories(const std::string& path);
 
+/**
+ * @brief Same as traverse_directories(path), but the result is cached in `cache_path`.
+ *
+ * The cache is reused (e.g. by other processes or ranks) as long as no entries were added to
+ * or removed from the traversed directories. An empty `cache_path` disables caching.
+ */
+vector<std::pair<string, int>> traverse_directories(const std::string& path,
+                                                    const std::string& cache_path);
+
 }  // namespace filesystem
 
 struct ImageLabelWrapper {
@@ -56,6 +65,8 @@ class FileLoader : public Loader<CPUBackend, ImageLabelWrapper> {
       shuffle_after_epoch_(shuffle_after_epoch),
       current_index_(0),
       current_epoch_(0) {
+      // not every reader based on FileLoader supports the cache
+      spec.TryGetArgument(file_list_cache_, "file_list_cache");
       /*
       * Those options are mutually exclusive as `shuffle_after_epoch` will make every shard looks differently
       * after each epoch so coexistence with `stick_to_shard` doesn't make any sense
@@ -82,6 +93,7 @@ class FileLoader : public Loader<CPUBackend, ImageLabelWrapper> {
   }
 
   void PrepareEmpty(ImageLabelWrapper &tensor) override;
+  void ReleaseEmpty(ImageLabelWrapper &tensor) override;
   void ReadSample(ImageLabelWrapper &tensor) override;
 
  protected:
@@ -90,7 +102,7 @@ class FileLoader : public Loader<CPUBackend, ImageLabelWrapper> {
   void PrepareMetadataImpl() override {
     if (image_label_pairs_.empty()) {
       if (file_list_ == "") {
-        image_label_pairs_ = filesystem::traverse_directories(file_root_);
+        image_label_pairs_ = filesystem::traverse_directories(file_root_, file_list_cache_);
       } else {
         // load (path, label) pairs from list
         std::ifstream s(file_list_);
@@ -134,7 +146,7 @@ class FileLoader : public Loader<CPUBackend, ImageLabelWrapper> {
   using Loader<CPUBackend, ImageLabelWrapper>::shard_id_;
   using Loader<CPUBackend, ImageLabelWrapper>::num_shards_;
 
-  string file_root_, file_list_;
+  string file_root_, file_list_, file_list_cache_;
   vector<std::pair<string, int>> image_label_pairs_;
   bool shuffle_after_epoch_;
   Index current_index_;
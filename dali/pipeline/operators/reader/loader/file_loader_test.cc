@@ -0,0 +1,121 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/loader/file_loader.h"
+
+namespace dali {
+
+class TraverseDirectoriesTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/dali_file_list_XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    root_ = tmpl;
+    // "a" is a prefix of "a-b", which sorts before "a/" when comparing whole paths
+    for (auto dir : { "b", "a-b", "a" })
+      MakeDir(dir);
+    for (auto file : { "a/2.jpg", "a/1.jpg", "a/notes.txt", "a-b/1.png", "b/3.jpg", "b/0.jpg" })
+      Touch(file);
+  }
+
+  void TearDown() override {
+    for (auto it = created_.rbegin(); it != created_.rend(); ++it)
+      std::remove((root_ + "/" + *it).c_str());
+    std::remove((root_ + ".cache").c_str());
+    rmdir(root_.c_str());
+  }
+
+  void MakeDir(const std::string &name) {
+    ASSERT_EQ(mkdir((root_ + "/" + name).c_str(), 0755), 0);
+    created_.push_back(name);
+  }
+
+  void Touch(const std::string &name) {
+    std::ofstream f(root_ + "/" + name);
+    created_.push_back(name);
+  }
+
+  std::string root_;
+  std::vector<std::string> created_;
+};
+
+TEST_F(TraverseDirectoriesTest, SortedWithLabels) {
+  auto files = filesystem::traverse_directories(root_);
+  std::vector<std::pair<std::string, int>> expected = {
+    { "a-b/1.png", 1 }, { "a/1.jpg", 0 }, { "a/2.jpg", 0 }, { "b/0.jpg", 2 }, { "b/3.jpg", 2 }
+  };
+  EXPECT_EQ(files, expected);
+}
+
+TEST_F(TraverseDirectoriesTest, Cache) {
+  std::string cache = root_ + ".cache";
+  auto files = filesystem::traverse_directories(root_, cache);
+  EXPECT_EQ(files, filesystem::traverse_directories(root_));
+
+  struct stat before, after;
+  ASSERT_EQ(stat(cache.c_str(), &before), 0);
+  EXPECT_EQ(filesystem::traverse_directories(root_, cache), files);
+  ASSERT_EQ(stat(cache.c_str(), &after), 0);
+  // the cache was valid, so it wasn't rewritten
+  EXPECT_EQ(before.st_ino, after.st_ino);
+
+  // adding a file invalidates the cache
+  Touch("b/4.jpg");
+  files = filesystem::traverse_directories(root_, cache);
+  EXPECT_EQ(files.size(), 6u);
+  EXPECT_EQ(files.back(), std::make_pair(std::string("b/4.jpg"), 2));
+  ASSERT_EQ(stat(cache.c_str(), &after), 0);
+  EXPECT_NE(before.st_ino, after.st_ino);
+
+  // a new class directory as well
+  MakeDir("c");
+  Touch("c/5.jpg");
+  files = filesystem::traverse_directories(root_, cache);
+  EXPECT_EQ(files.back(), std::make_pair(std::string("c/5.jpg"), 3));
+  EXPECT_EQ(filesystem::traverse_directories(root_, cache), files);
+}
+
+TEST_F(TraverseDirectoriesTest, CorruptedCache) {
+  std::string cache = root_ + ".cache";
+  auto files = filesystem::traverse_directories(root_, cache);
+
+  // the file count precedes the (label, name length, name) entries at the end of the cache
+  size_t entries_size = 0;
+  for (auto &file : files)
+    entries_size += sizeof(int32_t) + sizeof(uint32_t) + file.first.size();
+  struct stat st;
+  ASSERT_EQ(stat(cache.c_str(), &st), 0);
+  {
+    std::fstream f(cache, std::ios::in | std::ios::out | std::ios::binary);
+    f.seekp(st.st_size - entries_size - sizeof(uint64_t));
+    uint64_t num_files = uint64_t(1) << 60;
+    f.write(reinterpret_cast<const char *>(&num_files), sizeof(num_files));
+  }
+  // the count is rejected before anything is allocated and the list is built again
+  EXPECT_EQ(filesystem::traverse_directories(root_, cache), files);
+}
+
+}  // namespace dali
@@ -15,14 +15,18 @@
 #ifndef DALI_PIPELINE_OPERATORS_READER_LOADER_INDEXED_FILE_LOADER_H_
 #define DALI_PIPELINE_OPERATORS_READER_LOADER_INDEXED_FILE_LOADER_H_
 
+#include <algorithm>
 #include <vector>
 #include <string>
 #include <tuple>
 #include <fstream>
+#include <map>
 #include <memory>
+#include <utility>
 
 #include "dali/core/common.h"
 #include "dali/pipeline/operators/reader/loader/loader.h"
+#include "dali/pipeline/operators/reader/loader/read_planner.h"
 #include "dali/util/file.h"
 
 namespace dali {
@@ -34,14 +38,18 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       uris_(options.GetRepeatedArgument<std::string>("path")),
       index_uris_(options.GetRepeatedArgument<std::string>("index_path")),
       current_file_(nullptr) {
+      // not every reader based on IndexedFileLoader supports chunk shuffling
+      options.TryGetArgument(shuffle_chunk_size_, "shuffle_chunk_size");
+      DALI_ENFORCE(shuffle_chunk_size_ >= 0, "shuffle_chunk_size must not be negative");
     }
 
   void ReadSample(Tensor<CPUBackend>& tensor) override {
     MoveToNextShard(current_index_);
+    PlanReadAhead();
 
     int64 seek_pos, size;
     size_t file_index;
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+    std::tie(seek_pos, size, file_index) = indices_[RecordIndex(current_index_)];
     ++current_index_;
 
     std::string image_key = uris_[file_index] + " at index " + to_string(seek_pos);
@@ -50,9 +58,7 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     meta.SetSkipSample(false);
 
     if (file_index != current_file_index_) {
-      current_file_->Close();
-      current_file_ = FileStream::Open(uris_[file_index], read_ahead_);
-      current_file_index_ = file_index;
+      SwitchToFile(file_index);
     }
 
     // if image is cached, skip loading
@@ -66,7 +72,7 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
       return;
     }
 
-    if (should_seek_) {
+    if (should_seek_ || !record_order_.empty()) {
       current_file_->Seek(seek_pos);
       should_seek_ = false;
     }
@@ -114,6 +120,133 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
   }
 
  protected:
+  /**
+   * @brief Asks the file system to prefetch the records of the next samples in flight.
+   *
+   * The records of a window are sorted by file and offset and adjacent ones are coalesced,
+   * so that each contiguous part of a file is requested once. Samples are still read
+   * in the same order; only the I/O is scheduled ahead of it.
+   */
+  void PlanReadAhead() {
+    // mapping with read_ahead already populates the whole file
+    if (read_ahead_)
+      return;
+    const size_t window = initial_empty_size_;
+    if (planned_until_ > current_index_ + window / 2)
+      return;
+    size_t begin = std::max(planned_until_, current_index_);
+    size_t end = std::min(current_index_ + window, indices_.size());
+    if (begin >= end)
+      return;
+
+    std::vector<ReadRange> reads;
+    reads.reserve(end - begin);
+    for (size_t i = begin; i < end; i++) {
+      int64 seek_pos, size;
+      size_t file_index;
+      std::tie(seek_pos, size, file_index) = indices_[RecordIndex(i)];
+      reads.push_back({ file_index, seek_pos, size });
+    }
+    // the streams of the files in this window; the entry of the current file is empty
+    std::map<size_t, std::unique_ptr<FileStream>> window_files;
+    for (auto &range : PlanReads(std::move(reads), kReadAheadMaxGap)) {
+      if (range.file_index == current_file_index_ && current_file_) {
+        window_files[range.file_index];
+        current_file_->ReadAhead(range.offset, range.size);
+        continue;
+      }
+      // without the mapping reservation only the current file is kept mapped
+      if (!mmap_reserver.CanShareMappedData())
+        continue;
+      auto &file = window_files[range.file_index];
+      if (!file) {
+        auto it = read_ahead_files_.find(range.file_index);
+        if (it != read_ahead_files_.end() && it->second)
+          file = std::move(it->second);
+        else
+          file = FileStream::Open(uris_[range.file_index], read_ahead_);
+      }
+      file->ReadAhead(range.offset, range.size);
+    }
+    // files which are no longer in flight are closed
+    for (auto &file : read_ahead_files_) {
+      if (file.second)
+        file.second->Close();
+    }
+    read_ahead_files_ = std::move(window_files);
+    planned_until_ = end;
+  }
+
+  /**
+   * @brief Makes `file_index` the current file.
+   *
+   * A stream already opened for read-ahead is reused and rewound to the beginning of the file.
+   * The previous current stream is kept open if its file is still in the read-ahead window.
+   */
+  void SwitchToFile(size_t file_index) {
+    if (current_file_) {
+      auto prev = read_ahead_files_.find(current_file_index_);
+      if (prev != read_ahead_files_.end())
+        prev->second = std::move(current_file_);
+      else
+        current_file_->Close();
+    }
+    auto it = read_ahead_files_.find(file_index);
+    if (it != read_ahead_files_.end() && it->second) {
+      current_file_ = std::move(it->second);
+      current_file_->Seek(0);
+    } else {
+      current_file_ = FileStream::Open(uris_[file_index], read_ahead_);
+    }
+    current_file_index_ = file_index;
+  }
+
+  /**
+   * @brief Index of the record read at position `pos` of the epoch
+   */
+  size_t RecordIndex(size_t pos) const {
+    return record_order_.empty() ? pos : record_order_[pos];
+  }
+
+  /**
+   * @brief Permutes chunks of contiguous records within each shard.
+   *
+   * A chunk is a run of records from one file of at most `shuffle_chunk_size_` bytes
+   * (or a single, larger record), so each chunk is still read sequentially.
+   * Samples from different chunks are then mixed by the shuffle buffer.
+   */
+  void ShuffleChunks() {
+    record_order_.resize(indices_.size());
+    std::vector<std::pair<size_t, size_t>> chunks;
+    for (int shard = 0; shard < num_shards_; shard++) {
+      size_t shard_begin = start_index(shard, num_shards_, indices_.size());
+      size_t shard_end = start_index(shard + 1, num_shards_, indices_.size());
+      chunks.clear();
+      size_t chunk_begin = shard_begin;
+      int64 chunk_bytes = 0;
+      for (size_t i = shard_begin; i < shard_end; i++) {
+        int64 size = std::get<1>(indices_[i]);
+        if (i > chunk_begin &&
+            (chunk_bytes + size > shuffle_chunk_size_ ||
+             std::get<2>(indices_[i]) != std::get<2>(indices_[i - 1]))) {
+          chunks.emplace_back(chunk_begin, i);
+          chunk_begin = i;
+          chunk_bytes = 0;
+        }
+        chunk_bytes += size;
+      }
+      if (chunk_begin < shard_end)
+        chunks.emplace_back(chunk_begin, shard_end);
+
+      std::shuffle(chunks.begin(), chunks.end(), e_);
+      size_t pos = shard_begin;
+      for (auto &chunk : chunks) {
+        for (size_t i = chunk.first; i < chunk.second; i++)
+          record_order_[pos++] = i;
+      }
+    }
+  }
+
   Index SizeImpl() override {
     return indices_.size();
   }
@@ -137,13 +270,13 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
     } else {
       current_index_ = 0;
     }
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+    // a new pass over the data - with a new order of chunks
+    if (shuffle_chunk_size_ > 0)
+      ShuffleChunks();
+    planned_until_ = current_index_;
+    std::tie(seek_pos, size, file_index) = indices_[RecordIndex(current_index_)];
     if (file_index != current_file_index_) {
-      if (current_file_index_ != static_cast<size_t>(INVALID_INDEX)) {
-        current_file_->Close();
-      }
-      current_file_ = FileStream::Open(uris_[file_index], read_ahead_);
-      current_file_index_ = file_index;
+      SwitchToFile(file_index);
     }
     current_file_->Seek(seek_pos);
   }
@@ -157,6 +290,15 @@ class IndexedFileLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
   FileStream::FileStreamMappinReserver mmap_reserver;
   static constexpr int INVALID_INDEX = -1;
   bool should_seek_ = false;
+  int64 shuffle_chunk_size_ = 0;
+  // order of the records in the current pass, empty if the records are read in index order
+  std::vector<size_t> record_order_;
+  size_t planned_until_ = 0;
+  // streams of the other files with records in the read-ahead window, kept open until
+  // the window moves past them, so that each of them is opened once
+  std::map<size_t, std::unique_ptr<FileStream>> read_ahead_files_;
+  // records separated by less than this are prefetched with a single request
+  static constexpr int64 kReadAheadMaxGap = 1 << 16;
 };
 
 }  // namespace dali
@@ -0,0 +1,209 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <fstream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/loader/indexed_file_loader.h"
+#include "dali/util/local_file.h"
+
+namespace dali {
+
+DALI_SCHEMA(IndexedFileLoaderTestReader)
+  .DocStr("Dummy")
+  .NumInput(0)
+  .NumOutput(1)
+  .AddArg("path", "Data files", DALI_STRING_VEC)
+  .AddArg("index_path", "Index files", DALI_STRING_VEC)
+  .AddOptionalArg("shuffle_chunk_size", "Chunk size", 0)
+  .AddParent("LoaderBase");
+
+namespace {
+
+constexpr int kRecords = 30;
+constexpr int kRecordSize = 100;
+
+}  // namespace
+
+class IndexedFileLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/dali_indexed_XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    root_ = tmpl;
+    // each record is filled with its index
+    std::ofstream data(root_ + "/data", std::ios::binary);
+    std::ofstream index(root_ + "/index");
+    for (int i = 0; i < kRecords; i++) {
+      std::string record(kRecordSize, static_cast<char>(i));
+      data.write(record.data(), record.size());
+      index << i * kRecordSize << " " << kRecordSize << "\n";
+    }
+  }
+
+  void TearDown() override {
+    std::remove((root_ + "/data").c_str());
+    std::remove((root_ + "/index").c_str());
+    rmdir(root_.c_str());
+  }
+
+  std::unique_ptr<IndexedFileLoader> MakeLoader(int chunk_size, int num_shards = 1,
+                                                int shard_id = 0) {
+    std::unique_ptr<IndexedFileLoader> loader(new IndexedFileLoader(
+        OpSpec("IndexedFileLoaderTestReader")
+        .AddArg("path", std::vector<std::string>{ root_ + "/data" })
+        .AddArg("index_path", std::vector<std::string>{ root_ + "/index" })
+        .AddArg("shuffle_chunk_size", chunk_size)
+        .AddArg("num_shards", num_shards)
+        .AddArg("shard_id", shard_id)
+        .AddArg("stick_to_shard", true)
+        .AddArg("seed", 123)
+        .AddArg("batch_size", 4)
+        .AddArg("device_id", 0)));
+    loader->PrepareMetadata();
+    return loader;
+  }
+
+  std::vector<int> ReadRecords(IndexedFileLoader &loader, int n) {
+    std::vector<int> result;
+    Tensor<CPUBackend> tensor;
+    for (int i = 0; i < n; i++) {
+      loader.ReadSample(tensor);
+      EXPECT_EQ(tensor.size(), kRecordSize);
+      result.push_back(tensor.data<uint8_t>()[0]);
+    }
+    return result;
+  }
+
+  std::string root_;
+};
+
+TEST_F(IndexedFileLoaderTest, IndexOrder) {
+  auto loader = MakeLoader(0);
+  auto records = ReadRecords(*loader, kRecords);
+  for (int i = 0; i < kRecords; i++)
+    EXPECT_EQ(records[i], i);
+}
+
+TEST_F(IndexedFileLoaderTest, ChunkShuffle) {
+  const int records_per_chunk = 3;
+  auto loader = MakeLoader(records_per_chunk * kRecordSize);
+  auto epoch1 = ReadRecords(*loader, kRecords);
+  auto epoch2 = ReadRecords(*loader, kRecords);
+
+  for (auto &epoch : { epoch1, epoch2 }) {
+    std::vector<bool> seen(kRecords, false);
+    for (int i = 0; i < kRecords; i++) {
+      ASSERT_GE(epoch[i], 0);
+      ASSERT_LT(epoch[i], kRecords);
+      EXPECT_FALSE(seen[epoch[i]]);
+      seen[epoch[i]] = true;
+      // records within a chunk are read sequentially
+      if (i % records_per_chunk == 0)
+        EXPECT_EQ(epoch[i] % records_per_chunk, 0);
+      else
+        EXPECT_EQ(epoch[i], epoch[i - 1] + 1);
+    }
+  }
+  std::vector<int> identity(kRecords);
+  for (int i = 0; i < kRecords; i++)
+    identity[i] = i;
+  EXPECT_NE(epoch1, identity);
+  // a new order of chunks in every pass
+  EXPECT_NE(epoch1, epoch2);
+}
+
+TEST_F(IndexedFileLoaderTest, ChunkShuffleStaysInShard) {
+  const int num_shards = 2;
+  for (int shard = 0; shard < num_shards; shard++) {
+    auto loader = MakeLoader(2 * kRecordSize, num_shards, shard);
+    int shard_size = kRecords / num_shards;
+    auto records = ReadRecords(*loader, 2 * shard_size);
+    for (int r : records) {
+      EXPECT_GE(r, shard * shard_size);
+      EXPECT_LT(r, (shard + 1) * shard_size);
+    }
+  }
+}
+
+TEST_F(IndexedFileLoaderTest, ReadAheadOpensEachFileOnce) {
+  const int kFiles = 3;
+  const int records_per_file = kRecords / kFiles;
+  std::vector<std::string> paths, index_paths;
+  for (int f = 0; f < kFiles; f++) {
+    std::string name = root_ + "/part" + std::to_string(f);
+    std::ofstream data(name, std::ios::binary);
+    std::ofstream index(name + ".idx");
+    for (int i = 0; i < records_per_file; i++) {
+      std::string record(kRecordSize, static_cast<char>(f * records_per_file + i));
+      data.write(record.data(), record.size());
+      index << i * kRecordSize << " " << kRecordSize << "\n";
+    }
+    paths.push_back("counting://" + name);
+    index_paths.push_back(name + ".idx");
+  }
+
+  // the scheme stays registered after the test, so it doesn't refer to the test's locals
+  auto opens = std::make_shared<std::map<std::string, int>>();
+  FileStream::RegisterScheme("counting", [opens](const std::string &uri, bool read_ahead) {
+    (*opens)[uri]++;
+    return std::unique_ptr<FileStream>(
+        new LocalFileStream(uri.substr(std::string("counting://").size()), read_ahead));
+  });
+
+  {
+    // the read-ahead window (2 * batch_size) covers the whole epoch
+    IndexedFileLoader loader(
+        OpSpec("IndexedFileLoaderTestReader")
+        .AddArg("path", paths)
+        .AddArg("index_path", index_paths)
+        .AddArg("shuffle_chunk_size", 2 * kRecordSize)
+        .AddArg("stick_to_shard", true)
+        .AddArg("seed", 123)
+        .AddArg("batch_size", 16)
+        .AddArg("device_id", 0));
+    loader.PrepareMetadata();
+    for (int epoch = 0; epoch < 2; epoch++) {
+      auto records = ReadRecords(loader, kRecords);
+      std::vector<bool> seen(kRecords, false);
+      for (int r : records) {
+        ASSERT_GE(r, 0);
+        ASSERT_LT(r, kRecords);
+        EXPECT_FALSE(seen[r]);
+        seen[r] = true;
+      }
+    }
+  }
+
+  // files are switched many times, but the streams opened for read-ahead are reused
+  EXPECT_EQ(opens->size(), static_cast<size_t>(kFiles));
+  for (auto &file : *opens)
+    EXPECT_EQ(file.second, 1) << file.first;
+
+  for (int f = 0; f < kFiles; f++) {
+    std::remove(index_paths[f].c_str());
+    std::remove(paths[f].substr(std::string("counting://").size()).c_str());
+  }
+}
+
+}  // namespace dali
@@ -13,6 +13,11 @@
 // limitations under the License.
 
 
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+
 #include "dali/pipeline/operators/reader/loader/loader.h"
 
 namespace dali {
@@ -49,7 +54,34 @@ In such case the output of the loader will be empty)code", false)
 instead of in the constructor.)code", false)
   .AddOptionalArg("pad_last_batch",
       R"code(If set to true, the Loader will pad the last batch with the last image when the batch size is not aligned
-with the shard size.)code", false);
+with the shard size.)code", false)
+  .AddOptionalArg("shared_loader",
+      R"code(If not empty, readers of the same type and with the same `shared_loader` key share
+a single loader within the process, e.g. across pipelines running on different GPUs.
+The dataset is indexed, mapped and read once, with the arguments of the first reader created.
+Reading starts once all readers sharing the loader have been created.
+Not supported by VideoReader and COCOReader.)code", std::string())
+  .AddOptionalArg("shared_loader_mode",
+      R"code(How the samples of a shared loader are distributed between the readers:
+`shard` - the `i`-th sample of an epoch is given to the reader `i % N`, so that each of the `N`
+readers gets a fixed, disjoint part of ``epoch_size / N`` samples (the remaining samples are
+skipped); a reader running ahead waits for the others,
+`replicate` - each reader receives all the samples.)code", std::string("shard"));
+
+std::shared_ptr<void> GetOrCreateSharedLoader(
+    const std::string &key,
+    const std::function<std::shared_ptr<void>()> &create) {
+  static std::mutex registry_mutex;
+  static std::map<std::string, std::weak_ptr<void>> registry;
+  std::lock_guard<std::mutex> lock(registry_mutex);
+  auto &entry = registry[key];
+  auto shared = entry.lock();
+  if (!shared) {
+    shared = create();
+    entry = shared;
+  }
+  return shared;
+}
 
 size_t start_index(const size_t shard_id,
                    const size_t shard_num,
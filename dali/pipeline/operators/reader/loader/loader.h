@@ -15,6 +15,8 @@
 #ifndef DALI_PIPELINE_OPERATORS_READER_LOADER_LOADER_H_
 #define DALI_PIPELINE_OPERATORS_READER_LOADER_LOADER_H_
 
+#include <algorithm>
+#include <condition_variable>
 #include <list>
 #include <map>
 #include <memory>
@@ -25,12 +27,15 @@
 #include <utility>
 #include <vector>
 #include <deque>
+#include <functional>
+#include <typeinfo>
 
 #include "dali/core/common.h"
 #include "dali/core/error_handling.h"
 #include "dali/pipeline/operators/op_spec.h"
 #include "dali/pipeline/data/tensor.h"
 #include "dali/pipeline/operators/decoder/cache/image_cache_factory.h"
+#include "dali/pipeline/util/counter_rng.h"
 
 namespace dali {
 
@@ -49,6 +54,12 @@ class Loader {
  public:
   using LoadTargetUniquePtr = std::unique_ptr<LoadTarget>;
   using LoadTargetSharedPtr = std::shared_ptr<LoadTarget>;
+  using LoaderType = Loader<Backend, LoadTarget>;
+  using backend_type = Backend;
+  using load_target_type = LoadTarget;
+  // whether several readers can share an instance (see InitLoader); loaders which keep
+  // per-reader state, e.g. in references to members of the reader, must set it to false
+  static constexpr bool kShareable = true;
   explicit Loader(const OpSpec& options)
     : shuffle_(options.GetArgument<bool>("random_shuffle")),
       initial_buffer_fill_(shuffle_ ? options.GetArgument<int>("initial_fill") : 1),
@@ -68,10 +79,9 @@ class Loader {
       pad_last_batch_(options.GetArgument<bool>("pad_last_batch")) {
     DALI_ENFORCE(initial_empty_size_ > 0, "Batch size needs to be greater than 0");
     DALI_ENFORCE(num_shards_ > shard_id_, "num_shards needs to be greater than shard_id");
-    // initialize a random distribution -- this will be
+    // initialize a random stream -- this will be
     // used to pick from our sample buffer
-    std::seed_seq seq({seed_});
-    e_ = std::default_random_engine(seq);
+    e_ = CounterRNG(seed_, RNGDomain::Loader);
     virtual_shard_id_ = shard_id_;
   }
 
@@ -109,8 +119,36 @@ class Loader {
       "Please overload PrepareEmpty for custom LoadTarget type other than Tensor");
   }
 
+  virtual void ReleaseEmpty(LoadTarget& tensor) {
+    ReleaseEmptyTensor(tensor);
+  }
+
+  template <typename T>
+  std::enable_if_t<std::is_same<T, Tensor<CPUBackend>>::value>
+  ReleaseEmptyTensor(T& tensor) {
+    // ReadSample resizes the tensor as needed
+    tensor.Reset();
+  }
+
+  template <typename T>
+  std::enable_if_t<!std::is_same<T, Tensor<CPUBackend>>::value>
+  ReleaseEmptyTensor(T&) {}
+
+  /**
+   * @brief Frees the memory held by the tensors waiting to be filled, to reduce the memory
+   * usage of the pipeline. Does nothing if the list of empty tensors is in use.
+   */
+  virtual void ReleaseEmptyTensors() {
+    std::unique_lock<std::mutex> lock(empty_tensors_mutex_, std::try_to_lock);
+    if (!lock.owns_lock())
+      return;
+    for (auto &tensor : empty_tensors_) {
+      ReleaseEmpty(*tensor);
+    }
+  }
+
   // Get a random read sample
-  LoadTargetSharedPtr ReadOne(bool is_new_epoch) {
+  virtual LoadTargetSharedPtr ReadOne(bool is_new_epoch) {
     if (!loading_flag_) {
       PrepareMetadata();
     }
@@ -133,11 +171,18 @@ class Loader {
 
       // need some entries in the empty_tensors_ list
       TimeRange tr2("[Loader] Filling empty list", TimeRange::kOrange);
-      std::lock_guard<std::mutex> lock(empty_tensors_mutex_);
+      // allocate outside of the lock - going over the memory budget runs the reclaimer,
+      // which calls ReleaseEmptyTensors on this thread
+      std::vector<LoadTargetUniquePtr> empty_tensors;
       for (int i = 0; i < initial_empty_size_; ++i) {
         auto tensor_ptr = LoadTargetUniquePtr(new LoadTarget());
         PrepareEmpty(*tensor_ptr);
-        empty_tensors_.push_back(std::move(tensor_ptr));
+        empty_tensors.push_back(std::move(tensor_ptr));
+      }
+      {
+        std::lock_guard<std::mutex> lock(empty_tensors_mutex_);
+        for (auto &tensor_ptr : empty_tensors)
+          empty_tensors_.push_back(std::move(tensor_ptr));
       }
 
       initial_buffer_filled_ = true;
@@ -212,6 +257,23 @@ class Loader {
     return SizeImpl();
   }
 
+  /**
+   * @brief Number of tensors allocated for samples in flight, before they're first needed
+   */
+  int EmptyTensorCapacity() const {
+    return initial_empty_size_;
+  }
+
+  /**
+   * @brief Allocates `count` more tensors for samples in flight.
+   *        Must be called before the first sample is read.
+   */
+  void AddEmptyTensorCapacity(int count) {
+    DALI_ENFORCE(!initial_buffer_filled_,
+                 "Cannot change the number of samples in flight after reading has started");
+    initial_empty_size_ += count;
+  }
+
  protected:
   virtual Index SizeImpl() = 0;
 
@@ -277,12 +339,12 @@ class Loader {
   // ~1 minibatch seems reasonable
   bool shuffle_;
   const int initial_buffer_fill_;
-  const int initial_empty_size_;
+  int initial_empty_size_;
   const int tensor_init_bytes_;
   bool initial_buffer_filled_ = false;
 
   // rng
-  std::default_random_engine e_;
+  CounterRNG e_;
   Index seed_;
 
   // control return of tensors
@@ -334,11 +396,231 @@ class Loader {
   std::deque<ShardBoundaries> shards_;
 };
 
+/**
+ * @brief Returns the object registered under `key`, creating it with `create` if there is none.
+ *
+ * The registry only holds weak references - an object lives as long as its users do
+ * and the next lookup after that creates a new one.
+ */
+DLL_PUBLIC std::shared_ptr<void> GetOrCreateSharedLoader(
+    const std::string &key,
+    const std::function<std::shared_ptr<void>()> &create);
+
+/**
+ * @brief A loader shared by several readers in the process.
+ *
+ * Every reader attached to it is a consumer with its own queue of samples. The underlying
+ * loader (with its file index, file mappings and shuffle buffer) is read once and
+ * the samples are either dealt between the consumers (`shard` mode) or handed to all of them
+ * (`replicate` mode).
+ *
+ * In shard mode, the sample at position `p` of an epoch goes to consumer `p % n`, so each
+ * consumer gets a fixed, disjoint part of the dataset of Size() / n samples per epoch; the
+ * remaining Size() % n samples of every epoch are skipped. A consumer which needs a sample
+ * dealt to another consumer whose queue is full waits until that consumer catches up.
+ * In replicate mode, consumers that fall more than a bounded number of samples behind drop
+ * their oldest samples. Either way, a stalled consumer cannot exhaust the tensors of the
+ * underlying loader.
+ */
+template <typename Backend, typename LoadTarget>
+class SharedLoader {
+ public:
+  using LoaderType = Loader<Backend, LoadTarget>;
+  using LoadTargetSharedPtr = typename LoaderType::LoadTargetSharedPtr;
+
+  SharedLoader(std::unique_ptr<LoaderType> loader, bool replicate)
+    : loader_(std::move(loader)), replicate_(replicate),
+      base_capacity_(loader_->EmptyTensorCapacity()),
+      max_queued_(std::max(base_capacity_ / 2, 1)) {}
+
+  int Attach() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    DALI_ENFORCE(!started_, "Cannot attach a reader to a shared loader which is already in use");
+    // each consumer keeps its own prefetched batches in flight
+    if (!queues_.empty())
+      loader_->AddEmptyTensorCapacity(base_capacity_);
+    queues_.emplace_back();
+    attached_.push_back(true);
+    return static_cast<int>(queues_.size()) - 1;
+  }
+
+  void Detach(int consumer) {
+    std::lock_guard<std::mutex> lock(mutex_);
+    attached_[consumer] = false;
+    queues_[consumer].clear();
+    dequeued_.notify_all();
+  }
+
+  LoadTargetSharedPtr ReadOne(int consumer, bool is_new_epoch) {
+    std::unique_lock<std::mutex> lock(mutex_);
+    if (!started_) {
+      started_ = true;
+      epoch_size_ = loader_->Size();
+      DALI_ENFORCE(replicate_ || epoch_size_ >= static_cast<Index>(queues_.size()),
+                   "A shared loader in shard mode needs at least as many samples as readers");
+    }
+    auto &queue = queues_[consumer];
+    while (queue.empty()) {
+      if (replicate_) {
+        auto sample = loader_->ReadOne(is_new_epoch);
+        for (size_t i = 0; i < queues_.size(); i++) {
+          if (!attached_[i])
+            continue;
+          if (static_cast<int>(queues_[i].size()) >= max_queued_)
+            queues_[i].pop_front();
+          queues_[i].push_back(sample);
+        }
+        continue;
+      }
+      int target = ShardConsumer(position_);
+      if (target >= 0 && target != consumer && attached_[target] &&
+          static_cast<int>(queues_[target].size()) >= max_queued_) {
+        dequeued_.wait(lock);
+        continue;
+      }
+      auto sample = loader_->ReadOne(is_new_epoch);
+      position_ = (position_ + 1) % epoch_size_;
+      // samples of detached readers and the remainder of the epoch are dropped
+      if (target >= 0 && attached_[target])
+        queues_[target].push_back(std::move(sample));
+    }
+    auto sample = std::move(queue.front());
+    queue.pop_front();
+    dequeued_.notify_all();
+    return sample;
+  }
+
+  void PrepareMetadata() {
+    loader_->PrepareMetadata();
+  }
+
+  /**
+   * @brief Number of samples per epoch seen by each consumer
+   */
+  Index Size() {
+    Index size = loader_->Size();
+    if (replicate_)
+      return size;
+    std::lock_guard<std::mutex> lock(mutex_);
+    return size / static_cast<Index>(queues_.size());
+  }
+
+  void ReleaseEmptyTensors() {
+    loader_->ReleaseEmptyTensors();
+  }
+
+  int NumConsumers() const {
+    return queues_.size();
+  }
+
+ private:
+  /**
+   * @brief Consumer of the sample at `position` of the epoch, or -1 if the sample is skipped
+   */
+  int ShardConsumer(Index position) const {
+    Index n = queues_.size();
+    if (position >= epoch_size_ / n * n)
+      return -1;
+    return static_cast<int>(position % n);
+  }
+
+  // the queues hold samples of the loader, so it must outlive them
+  std::unique_ptr<LoaderType> loader_;
+  bool replicate_;
+  int base_capacity_;
+  int max_queued_;
+  std::mutex mutex_;
+  std::condition_variable dequeued_;
+  bool started_ = false;
+  Index epoch_size_ = 0;
+  Index position_ = 0;
+  std::vector<std::deque<LoadTargetSharedPtr>> queues_;
+  std::vector<bool> attached_;
+};
+
+/**
+ * @brief The view of a SharedLoader used by a single reader.
+ */
+template <typename Backend, typename LoadTarget>
+class SharedLoaderConsumer : public Loader<Backend, LoadTarget> {
+ public:
+  using LoadTargetSharedPtr = typename Loader<Backend, LoadTarget>::LoadTargetSharedPtr;
+
+  SharedLoaderConsumer(const OpSpec &spec,
+                       std::shared_ptr<SharedLoader<Backend, LoadTarget>> shared)
+    : Loader<Backend, LoadTarget>(spec), shared_(std::move(shared)) {
+    consumer_ = shared_->Attach();
+  }
+
+  ~SharedLoaderConsumer() override {
+    shared_->Detach(consumer_);
+  }
+
+  LoadTargetSharedPtr ReadOne(bool is_new_epoch) override {
+    return shared_->ReadOne(consumer_, is_new_epoch);
+  }
+
+  void ReleaseEmptyTensors() override {
+    shared_->ReleaseEmptyTensors();
+  }
+
+  void ReadSample(LoadTarget &) override {
+    DALI_FAIL("Samples of a shared loader are read by the shared instance");
+  }
+
+  int consumer_id() const {
+    return consumer_;
+  }
+
+ protected:
+  void PrepareMetadataImpl() override {
+    shared_->PrepareMetadata();
+  }
+
+  Index SizeImpl() override {
+    return shared_->Size();
+  }
+
+  void Reset(bool) override {}
+
+ private:
+  std::shared_ptr<SharedLoader<Backend, LoadTarget>> shared_;
+  int consumer_;
+};
+
+/**
+ * @brief Creates and initializes a loader of type T.
+ *
+ * If `shared_loader` is set, the readers of the process using the same key (and loader type)
+ * share a single instance of T, which is created with the arguments of the first of them.
+ */
 template<typename T, typename... Args>
-std::unique_ptr<T> InitLoader(const OpSpec& spec, Args&&... args) {
-  std::unique_ptr<T> loader (new T(spec, std::forward<Args>(args)...));
-  loader->Init();
-  return loader;
+std::unique_ptr<typename T::LoaderType> InitLoader(const OpSpec& spec, Args&&... args) {
+  using LoaderType = typename T::LoaderType;
+  using Shared = SharedLoader<typename T::backend_type, typename T::load_target_type>;
+  std::string key = spec.GetArgument<std::string>("shared_loader");
+  if (key.empty()) {
+    std::unique_ptr<T> loader(new T(spec, std::forward<Args>(args)...));
+    loader->Init();
+    return std::move(loader);
+  }
+  DALI_ENFORCE(T::kShareable, "Operator " + spec.name() + " does not support `shared_loader`");
+
+  std::string mode = spec.GetArgument<std::string>("shared_loader_mode");
+  DALI_ENFORCE(mode == "shard" || mode == "replicate",
+               "Unknown shared_loader_mode: " + mode + ". Expected `shard` or `replicate`");
+  auto shared = std::static_pointer_cast<Shared>(GetOrCreateSharedLoader(
+      key + "/" + typeid(T).name() + "/" + mode,
+      [&]() {
+        std::unique_ptr<T> loader(new T(spec, std::forward<Args>(args)...));
+        loader->Init();
+        return std::make_shared<Shared>(std::move(loader), mode == "replicate");
+      }));
+  std::unique_ptr<LoaderType> consumer(
+      new SharedLoaderConsumer<typename T::backend_type, typename T::load_target_type>(
+          spec, std::move(shared)));
+  consumer->Init();
+  return consumer;
 }
 
 };  // namespace dali
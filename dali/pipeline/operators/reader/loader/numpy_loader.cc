@@ -0,0 +1,400 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <dirent.h>
+#include <sys/stat.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/loader/numpy_loader.h"
+
+namespace dali {
+
+namespace {
+
+const char kNumpyMagic[] = "\x93NUMPY";
+constexpr size_t kNumpyMagicSize = 6;
+
+TypeInfo NumpyTypeInfo(char kind, int size, const std::string &path) {
+  switch (kind) {
+    case 'b':
+      if (size == 1) return TypeInfo::Create<bool>();
+      break;
+    case 'u':
+      switch (size) {
+        case 1: return TypeInfo::Create<uint8_t>();
+        case 2: return TypeInfo::Create<uint16_t>();
+        case 4: return TypeInfo::Create<uint32_t>();
+        case 8: return TypeInfo::Create<uint64_t>();
+      }
+      break;
+    case 'i':
+      switch (size) {
+        case 1: return TypeInfo::Create<int8_t>();
+        case 2: return TypeInfo::Create<int16_t>();
+        case 4: return TypeInfo::Create<int32_t>();
+        case 8: return TypeInfo::Create<int64_t>();
+      }
+      break;
+    case 'f':
+      switch (size) {
+        case 2: return TypeInfo::Create<float16>();
+        case 4: return TypeInfo::Create<float>();
+        case 8: return TypeInfo::Create<double>();
+      }
+      break;
+  }
+  DALI_FAIL("Unsupported numpy data type '" + std::string(1, kind) + std::to_string(size) +
+            "' in " + path);
+}
+
+/**
+ * @brief Returns the text following `'key':` in the header dictionary
+ */
+const char *FindDictValue(const std::string &header, const char *key, const std::string &path) {
+  std::string quoted = std::string("'") + key + "'";
+  auto pos = header.find(quoted);
+  DALI_ENFORCE(pos != std::string::npos,
+               "Key " + quoted + " not found in the header of " + path);
+  pos = header.find(':', pos + quoted.size());
+  DALI_ENFORCE(pos != std::string::npos, "Invalid header of " + path);
+  const char *value = header.c_str() + pos + 1;
+  while (std::isspace(*value))
+    value++;
+  return value;
+}
+
+/**
+ * @brief Calls `fn(offset_in_elements)` for every contiguous run of the region of interest
+ *        of a C-order array and returns the length of a run.
+ */
+template <typename Fn>
+int64_t ForEachRun(const std::vector<int64_t> &shape,
+                   const std::vector<int64_t> &start,
+                   const std::vector<int64_t> &extent,
+                   Fn &&fn) {
+  int ndim = shape.size();
+  if (ndim == 0) {
+    // a scalar is a single run of one element
+    fn(0);
+    return 1;
+  }
+  std::vector<int64_t> strides(ndim);
+  int64_t stride = 1;
+  for (int d = ndim - 1; d >= 0; d--) {
+    strides[d] = stride;
+    stride *= shape[d];
+  }
+  // the innermost dimensions which are read in full are merged into a single run
+  int inner = ndim - 1;
+  while (inner > 0 && extent[inner] == shape[inner])
+    inner--;
+  int64_t run = extent[inner] * strides[inner];
+  for (int d = 0; d < ndim; d++) {
+    if (extent[d] == 0)
+      return 0;
+  }
+
+  std::vector<int64_t> idx(inner, 0);
+  for (;;) {
+    int64_t offset = start[inner] * strides[inner];
+    for (int d = 0; d < inner; d++)
+      offset += (start[d] + idx[d]) * strides[d];
+    fn(offset);
+    int d = inner - 1;
+    for (; d >= 0; d--) {
+      if (++idx[d] < extent[d])
+        break;
+      idx[d] = 0;
+    }
+    if (d < 0)
+      break;
+  }
+  return run;
+}
+
+/**
+ * @brief Copies a C-order array of shape `in_shape` into `out` with the axes reversed
+ */
+template <typename T>
+void ReverseAxes(T *out, const T *in, const std::vector<int64_t> &in_shape) {
+  int ndim = in_shape.size();
+  std::vector<int64_t> in_strides(ndim);
+  int64_t stride = 1;
+  for (int d = ndim - 1; d >= 0; d--) {
+    in_strides[d] = stride;
+    stride *= in_shape[d];
+  }
+  int64_t total = stride;
+  if (total == 0)
+    return;
+  // walk the output in C order; output axis `d` is input axis `ndim - 1 - d`
+  std::vector<int64_t> idx(ndim, 0);
+  int64_t in_offset = 0;
+  for (int64_t i = 0; i < total; i++) {
+    out[i] = in[in_offset];
+    for (int d = 0; d < ndim; d++) {
+      // output axis ndim - 1 - d is the fastest moving one and maps to input axis d
+      in_offset += in_strides[d];
+      if (++idx[d] < in_shape[d])
+        break;
+      in_offset -= idx[d] * in_strides[d];
+      idx[d] = 0;
+    }
+  }
+}
+
+void ReverseAxes(void *out, const void *in, const std::vector<int64_t> &in_shape,
+                 size_t type_size) {
+  switch (type_size) {
+    case 1:
+      ReverseAxes(static_cast<uint8_t *>(out), static_cast<const uint8_t *>(in), in_shape);
+      break;
+    case 2:
+      ReverseAxes(static_cast<uint16_t *>(out), static_cast<const uint16_t *>(in), in_shape);
+      break;
+    case 4:
+      ReverseAxes(static_cast<uint32_t *>(out), static_cast<const uint32_t *>(in), in_shape);
+      break;
+    case 8:
+      ReverseAxes(static_cast<uint64_t *>(out), static_cast<const uint64_t *>(in), in_shape);
+      break;
+    default:
+      DALI_FAIL("Unsupported element size: " + std::to_string(type_size));
+  }
+}
+
+void TraverseNumpyFiles(const std::string &root, const std::string &rel_path,
+                        const std::string &filter, std::vector<std::string> *files) {
+  std::string dir_path = rel_path.empty() ? root : root + "/" + rel_path;
+  DIR *dir = opendir(dir_path.c_str());
+  DALI_ENFORCE(dir != nullptr, "Directory " + dir_path + " could not be opened.");
+
+  struct dirent *entry;
+  while ((entry = readdir(dir))) {
+    if (strcmp(entry->d_name, ".") == 0 || strcmp(entry->d_name, "..") == 0) continue;
+    std::string name(entry->d_name);
+    std::string entry_rel = rel_path.empty() ? name : rel_path + "/" + name;
+    struct stat s;
+    if (stat((root + "/" + entry_rel).c_str(), &s) != 0)
+      continue;
+    if (S_ISDIR(s.st_mode)) {
+      TraverseNumpyFiles(root, entry_rel, filter, files);
+    } else if (name.size() >= filter.size() &&
+               name.compare(name.size() - filter.size(), filter.size(), filter) == 0) {
+      files->push_back(entry_rel);
+    }
+  }
+  closedir(dir);
+}
+
+}  // namespace
+
+NumpyHeader ParseNumpyHeaderDict(const std::string &header, const std::string &path) {
+  NumpyHeader result;
+
+  const char *descr = FindDictValue(header, "descr", path);
+  DALI_ENFORCE(*descr == '\'' || *descr == '"', "Invalid 'descr' in the header of " + path);
+  char byte_order = descr[1];
+  char kind = descr[2];
+  int size = std::atoi(descr + 3);
+  DALI_ENFORCE(size > 0, "Invalid 'descr' in the header of " + path);
+  result.type = NumpyTypeInfo(kind, size, path);
+  DALI_ENFORCE(byte_order != '>' || size == 1,
+               "Big-endian arrays are not supported: " + path);
+
+  const char *fortran_order = FindDictValue(header, "fortran_order", path);
+  if (strncmp(fortran_order, "True", 4) == 0) {
+    result.fortran_order = true;
+  } else {
+    DALI_ENFORCE(strncmp(fortran_order, "False", 5) == 0,
+                 "Invalid 'fortran_order' in the header of " + path);
+  }
+
+  const char *shape = FindDictValue(header, "shape", path);
+  DALI_ENFORCE(*shape == '(', "Invalid 'shape' in the header of " + path);
+  shape++;
+  for (;;) {
+    while (std::isspace(*shape) || *shape == ',')
+      shape++;
+    if (*shape == ')')
+      break;
+    char *end;
+    int64_t extent = std::strtoll(shape, &end, 10);
+    DALI_ENFORCE(end != shape && extent >= 0, "Invalid 'shape' in the header of " + path);
+    result.shape.push_back(extent);
+    shape = end;
+    // python 2 may write long integers as e.g. 3L
+    if (*shape == 'L')
+      shape++;
+  }
+  return result;
+}
+
+NumpyHeader ParseNumpyHeader(FileStream *file, const std::string &path) {
+  uint8_t preamble[kNumpyMagicSize + 2];
+  DALI_ENFORCE(file->Read(preamble, sizeof(preamble)) == sizeof(preamble) &&
+               memcmp(preamble, kNumpyMagic, kNumpyMagicSize) == 0,
+               "Not a numpy file: " + path);
+  int major_version = preamble[kNumpyMagicSize];
+  DALI_ENFORCE(major_version >= 1 && major_version <= 3,
+               "Unsupported numpy file format version " + std::to_string(major_version) +
+               ": " + path);
+
+  // the header length is a little-endian uint16 in version 1 and uint32 since version 2
+  size_t length_size = major_version == 1 ? 2 : 4;
+  uint8_t length_bytes[4];
+  DALI_ENFORCE(file->Read(length_bytes, length_size) == length_size,
+               "Truncated numpy header: " + path);
+  size_t header_length = 0;
+  for (size_t i = length_size; i > 0; i--)
+    header_length = (header_length << 8) | length_bytes[i - 1];
+
+  std::string header(header_length, '\0');
+  DALI_ENFORCE(file->Read(reinterpret_cast<uint8_t *>(&header[0]), header_length) ==
+               header_length, "Truncated numpy header: " + path);
+
+  NumpyHeader result = ParseNumpyHeaderDict(header, path);
+  result.data_offset = sizeof(preamble) + length_size + header_length;
+  DALI_ENFORCE(result.data_offset + result.nbytes() <= file->Size(),
+               "Numpy file is smaller than its header describes: " + path);
+  return result;
+}
+
+NumpyLoader::NumpyLoader(const OpSpec& spec, bool shuffle_after_epoch)
+    : FileLoader(spec, std::vector<std::pair<string, int>>(), shuffle_after_epoch),
+      file_filter_(spec.GetArgument<string>("file_filter")) {
+  auto roi_start = spec.GetRepeatedArgument<int>("roi_start");
+  auto roi_shape = spec.GetRepeatedArgument<int>("roi_shape");
+  roi_start_.assign(roi_start.begin(), roi_start.end());
+  roi_shape_.assign(roi_shape.begin(), roi_shape.end());
+}
+
+void NumpyLoader::PrepareMetadataImpl() {
+  if (image_label_pairs_.empty() && file_list_.empty()) {
+    std::vector<std::string> files;
+    TraverseNumpyFiles(file_root_, "", file_filter_, &files);
+    std::sort(files.begin(), files.end());
+    for (size_t i = 0; i < files.size(); i++)
+      image_label_pairs_.emplace_back(files[i], static_cast<int>(i));
+  }
+  FileLoader::PrepareMetadataImpl();
+}
+
+void NumpyLoader::ReadSample(ImageLabelWrapper &sample) {
+  auto file_label = image_label_pairs_[current_index_++];
+
+  // handle wrap-around
+  MoveToNextShard(current_index_);
+
+  sample.label = file_label.second;
+  DALIMeta meta;
+  meta.SetSourceInfo(file_label.first);
+  meta.SetSkipSample(false);
+
+  std::string path = file_root_ + "/" + file_label.first;
+  auto file = FileStream::Open(path, read_ahead_);
+  NumpyHeader header = ParseNumpyHeader(file.get(), path);
+  ReadArray(file.get(), path, header, sample.image);
+  file->Close();
+
+  sample.image.SetMeta(meta);
+}
+
+void NumpyLoader::ReadArray(FileStream *file, const std::string &path,
+                            const NumpyHeader &header, Tensor<CPUBackend> &tensor) {
+  const auto &shape = header.shape;
+  int ndim = shape.size();
+  DALI_ENFORCE(static_cast<int>(roi_start_.size()) <= ndim &&
+               static_cast<int>(roi_shape_.size()) <= ndim,
+               "Region of interest has more dimensions than the array in " + path);
+
+  // region of interest in the logical (C order) array; missing dimensions are taken in full
+  std::vector<int64_t> start(ndim, 0), extent(shape);
+  for (int d = 0; d < ndim; d++) {
+    if (d < static_cast<int>(roi_start_.size()))
+      start[d] = roi_start_[d];
+    if (d < static_cast<int>(roi_shape_.size()))
+      extent[d] = roi_shape_[d];
+    else
+      extent[d] = shape[d] - start[d];
+    DALI_ENFORCE(start[d] >= 0 && extent[d] >= 0 && start[d] + extent[d] <= shape[d],
+                 "Region of interest out of bounds in dimension " + std::to_string(d) +
+                 " of " + path);
+  }
+
+  // a Fortran-order array is stored as a C-order array with the axes reversed
+  std::vector<int64_t> disk_shape(shape), disk_start(start), disk_extent(extent);
+  if (header.fortran_order) {
+    std::reverse(disk_shape.begin(), disk_shape.end());
+    std::reverse(disk_start.begin(), disk_start.end());
+    std::reverse(disk_extent.begin(), disk_extent.end());
+  }
+
+  // DALI represents scalars as 1-element tensors
+  if (ndim == 0)
+    extent = {1};
+
+  std::vector<int64_t> offsets;
+  int64_t run = ForEachRun(disk_shape, disk_start, disk_extent,
+                           [&](int64_t offset) { offsets.push_back(offset); });
+  size_t run_bytes = run * header.type.size();
+
+  // transposing a Fortran array is a no-op when at most one dimension is not degenerate
+  int nontrivial_dims = 0;
+  for (auto e : extent)
+    nontrivial_dims += e > 1;
+  bool transpose = header.fortran_order && nontrivial_dims > 1;
+
+  if (!copy_read_data_ && !transpose && offsets.size() == 1 && run_bytes > 0) {
+    // the whole region of interest is contiguous - wrap the mapped file
+    file->Seek(header.data_offset + offsets[0] * header.type.size());
+    auto p = file->Get(run_bytes);
+    DALI_ENFORCE(p != nullptr, "Failed to read " + path);
+    tensor.ShareData(p, run_bytes, extent);
+    tensor.set_type(header.type);
+    return;
+  }
+
+  if (tensor.shares_data()) {
+    tensor.Reset();
+  }
+  tensor.set_type(header.type);
+  tensor.Resize(extent);
+  if (offsets.empty() || run_bytes == 0)
+    return;
+
+  std::unique_ptr<uint8_t[]> scratch;
+  uint8_t *dst = static_cast<uint8_t *>(tensor.raw_mutable_data());
+  if (transpose) {
+    scratch.reset(new uint8_t[offsets.size() * run_bytes]);
+    dst = scratch.get();
+  }
+  for (auto offset : offsets) {
+    file->Seek(header.data_offset + offset * header.type.size());
+    DALI_ENFORCE(file->Read(dst, run_bytes) == run_bytes, "Failed to read " + path);
+    dst += run_bytes;
+  }
+  if (transpose)
+    ReverseAxes(tensor.raw_mutable_data(), scratch.get(), disk_extent, header.type.size());
+}
+
+}  // namespace dali
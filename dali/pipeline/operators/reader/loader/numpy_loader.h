@@ -0,0 +1,92 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_PIPELINE_OPERATORS_READER_LOADER_NUMPY_LOADER_H_
+#define DALI_PIPELINE_OPERATORS_READER_LOADER_NUMPY_LOADER_H_
+
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/operators/reader/loader/file_loader.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+/**
+ * @brief Description of the array stored in a .npy file
+ */
+struct NumpyHeader {
+  TypeInfo type;
+  std::vector<int64_t> shape;
+  bool fortran_order = false;
+  // offset of the array data in the file
+  size_t data_offset = 0;
+
+  int64_t size() const {
+    int64_t n = 1;
+    for (auto extent : shape)
+      n *= extent;
+    return n;
+  }
+
+  size_t nbytes() const {
+    return size() * type.size();
+  }
+};
+
+/**
+ * @brief Parses the header of a .npy file (format versions 1.0 - 3.0)
+ *
+ * Leaves the stream positioned at the beginning of the array data.
+ */
+DLL_PUBLIC NumpyHeader ParseNumpyHeader(FileStream *file, const std::string &path);
+
+/**
+ * @brief Parses the python dictionary literal of the .npy header
+ */
+DLL_PUBLIC NumpyHeader ParseNumpyHeaderDict(const std::string &header, const std::string &path);
+
+/**
+ * @brief Loads arrays from .npy files as tensors of their type and shape.
+ *
+ * The arrays are shared with the file mapping when possible. Fortran-order arrays are
+ * transposed to C order. If a region of interest is given, only that part of the array is read.
+ * Labels are the indices of the files in the list.
+ */
+class NumpyLoader : public FileLoader {
+ public:
+  explicit NumpyLoader(const OpSpec& spec, bool shuffle_after_epoch = false);
+
+  void ReadSample(ImageLabelWrapper &sample) override;
+
+ protected:
+  void PrepareMetadataImpl() override;
+
+ private:
+  /**
+   * @brief Reads the region of interest of the array into `tensor`
+   */
+  void ReadArray(FileStream *file, const std::string &path, const NumpyHeader &header,
+                 Tensor<CPUBackend> &tensor);
+
+  std::string file_filter_;
+  std::vector<int64_t> roi_start_, roi_shape_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_READER_LOADER_NUMPY_LOADER_H_
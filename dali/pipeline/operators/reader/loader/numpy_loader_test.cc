@@ -0,0 +1,204 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <stdlib.h>
+#include <unistd.h>
+
+#include <cstdio>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/operators/op_spec.h"
+#include "dali/pipeline/operators/reader/loader/numpy_loader.h"
+
+namespace dali {
+
+class NumpyLoaderTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/dali_numpy_XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    root_ = tmpl;
+  }
+
+  void TearDown() override {
+    for (auto &f : files_)
+      std::remove((root_ + "/" + f).c_str());
+    rmdir(root_.c_str());
+  }
+
+  void WriteNpy(const std::string &name, const std::string &header_dict,
+                const void *data, size_t bytes) {
+    // pad the header so that the data is 64-byte aligned, as numpy does
+    std::string header = header_dict;
+    size_t total = 10 + header.size() + 1;
+    header.append((64 - total % 64) % 64, ' ');
+    header.push_back('\n');
+    std::string preamble("\x93NUMPY\x01\x00", 8);
+    preamble.push_back(static_cast<char>(header.size() & 0xff));
+    preamble.push_back(static_cast<char>(header.size() >> 8));
+
+    FILE *f = std::fopen((root_ + "/" + name).c_str(), "wb");
+    ASSERT_NE(f, nullptr);
+    std::fwrite(preamble.data(), 1, preamble.size(), f);
+    std::fwrite(header.data(), 1, header.size(), f);
+    std::fwrite(data, 1, bytes, f);
+    std::fclose(f);
+    files_.push_back(name);
+  }
+
+  std::unique_ptr<NumpyLoader> MakeLoader(const std::vector<int> &roi_start = {},
+                                          const std::vector<int> &roi_shape = {}) {
+    std::unique_ptr<NumpyLoader> loader(new NumpyLoader(
+        OpSpec("NumpyReader")
+        .AddArg("file_root", root_)
+        .AddArg("roi_start", roi_start)
+        .AddArg("roi_shape", roi_shape)
+        .AddArg("batch_size", 1)
+        .AddArg("device_id", 0)));
+    loader->PrepareMetadata();
+    return loader;
+  }
+
+  std::string root_;
+  std::vector<std::string> files_;
+};
+
+TEST(NumpyHeaderTest, ParseDict) {
+  auto header = ParseNumpyHeaderDict(
+      "{'descr': '<f4', 'fortran_order': False, 'shape': (3, 4, 5), }", "test");
+  EXPECT_EQ(header.type.id(), DALI_FLOAT);
+  EXPECT_EQ(header.type.size(), 4u);
+  EXPECT_FALSE(header.fortran_order);
+  EXPECT_EQ(header.shape, (std::vector<int64_t>{3, 4, 5}));
+
+  header = ParseNumpyHeaderDict(
+      "{'descr': '|u1', 'fortran_order': True, 'shape': (7,), }", "test");
+  EXPECT_EQ(header.type.id(), DALI_UINT8);
+  EXPECT_TRUE(header.fortran_order);
+  EXPECT_EQ(header.shape, (std::vector<int64_t>{7}));
+
+  header = ParseNumpyHeaderDict(
+      "{'descr': '<i8', 'fortran_order': False, 'shape': (), }", "test");
+  EXPECT_EQ(header.type.id(), DALI_INT64);
+  EXPECT_TRUE(header.shape.empty());
+  EXPECT_EQ(header.size(), 1);
+
+  EXPECT_THROW(ParseNumpyHeaderDict(
+      "{'descr': '>f4', 'fortran_order': False, 'shape': (3,), }", "test"), DALIException);
+  EXPECT_THROW(ParseNumpyHeaderDict(
+      "{'descr': '<c8', 'fortran_order': False, 'shape': (3,), }", "test"), DALIException);
+}
+
+TEST_F(NumpyLoaderTest, ReadCOrder) {
+  std::vector<int16_t> data(3 * 4);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = i;
+  WriteNpy("a.npy", "{'descr': '<i2', 'fortran_order': False, 'shape': (3, 4), }",
+           data.data(), data.size() * sizeof(int16_t));
+
+  auto loader = MakeLoader();
+  auto sample = loader->ReadOne(false);
+  auto &t = sample->image;
+  EXPECT_TRUE(IsType<int16_t>(t.type()));
+  EXPECT_EQ(t.shape(), kernels::TensorShape<>(3, 4));
+  for (size_t i = 0; i < data.size(); i++)
+    EXPECT_EQ(t.data<int16_t>()[i], data[i]);
+  EXPECT_EQ(t.GetSourceInfo(), "a.npy");
+}
+
+TEST_F(NumpyLoaderTest, ReadScalar) {
+  double value = 2.5;
+  WriteNpy("s.npy", "{'descr': '<f8', 'fortran_order': False, 'shape': (), }",
+           &value, sizeof(value));
+
+  auto loader = MakeLoader();
+  auto sample = loader->ReadOne(false);
+  auto &t = sample->image;
+  EXPECT_TRUE(IsType<double>(t.type()));
+  // stored as a 1-element tensor
+  EXPECT_EQ(t.shape(), kernels::TensorShape<>(1));
+  EXPECT_EQ(t.data<double>()[0], value);
+}
+
+TEST_F(NumpyLoaderTest, ReadRoi) {
+  std::vector<float> data(4 * 5 * 6);
+  for (size_t i = 0; i < data.size(); i++)
+    data[i] = i;
+  WriteNpy("a.npy", "{'descr': '<f4', 'fortran_order': False, 'shape': (4, 5, 6), }",
+           data.data(), data.size() * sizeof(float));
+
+  // a contiguous region and a strided one
+  for (auto roi_shape : { std::vector<int>{2, 5, 6}, std::vector<int>{2, 3, 4} }) {
+    std::vector<int> roi_start = {1, roi_shape[1] == 5 ? 0 : 2, roi_shape[2] == 6 ? 0 : 1};
+    auto loader = MakeLoader(roi_start, roi_shape);
+    auto sample = loader->ReadOne(false);
+    auto &t = sample->image;
+    ASSERT_EQ(t.shape(), kernels::TensorShape<>(roi_shape[0], roi_shape[1], roi_shape[2]));
+    const float *out = t.data<float>();
+    for (int i = 0; i < roi_shape[0]; i++)
+      for (int j = 0; j < roi_shape[1]; j++)
+        for (int k = 0; k < roi_shape[2]; k++) {
+          int64_t src = ((i + roi_start[0]) * 5 + j + roi_start[1]) * 6 + k + roi_start[2];
+          EXPECT_EQ(*out++, data[src]);
+        }
+  }
+}
+
+TEST_F(NumpyLoaderTest, ReadFortranOrder) {
+  // logical array of shape (2, 3, 4), stored with the first index varying fastest
+  std::vector<int32_t> data(2 * 3 * 4);
+  for (int i = 0; i < 2; i++)
+    for (int j = 0; j < 3; j++)
+      for (int k = 0; k < 4; k++)
+        data[i + 2 * (j + 3 * k)] = 100 * i + 10 * j + k;
+  WriteNpy("f.npy", "{'descr': '<i4', 'fortran_order': True, 'shape': (2, 3, 4), }",
+           data.data(), data.size() * sizeof(int32_t));
+
+  {
+    auto loader = MakeLoader();
+    auto sample = loader->ReadOne(false);
+    auto &t = sample->image;
+    ASSERT_EQ(t.shape(), kernels::TensorShape<>(2, 3, 4));
+    const int32_t *out = t.data<int32_t>();
+    for (int i = 0; i < 2; i++)
+      for (int j = 0; j < 3; j++)
+        for (int k = 0; k < 4; k++)
+          EXPECT_EQ(*out++, 100 * i + 10 * j + k);
+  }
+  {
+    auto loader = MakeLoader({1, 1, 1}, {1, 2, 2});
+    auto sample = loader->ReadOne(false);
+    auto &t = sample->image;
+    ASSERT_EQ(t.shape(), kernels::TensorShape<>(1, 2, 2));
+    const int32_t *out = t.data<int32_t>();
+    for (int j = 1; j < 3; j++)
+      for (int k = 1; k < 3; k++)
+        EXPECT_EQ(*out++, 100 + 10 * j + k);
+  }
+}
+
+TEST_F(NumpyLoaderTest, RoiOutOfBounds) {
+  std::vector<uint8_t> data(10);
+  WriteNpy("a.npy", "{'descr': '|u1', 'fortran_order': False, 'shape': (10,), }",
+           data.data(), data.size());
+  auto loader = MakeLoader({8}, {4});
+  EXPECT_THROW(loader->ReadOne(false), DALIException);
+}
+
+}  // namespace dali
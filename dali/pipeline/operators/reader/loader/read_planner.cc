@@ -0,0 +1,44 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <algorithm>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/loader/read_planner.h"
+
+namespace dali {
+
+std::vector<ReadRange> PlanReads(std::vector<ReadRange> reads, int64 max_gap) {
+  std::sort(reads.begin(), reads.end(), [](const ReadRange &a, const ReadRange &b) {
+    return a.file_index < b.file_index ||
+           (a.file_index == b.file_index && a.offset < b.offset);
+  });
+
+  std::vector<ReadRange> plan;
+  for (auto &read : reads) {
+    if (read.size <= 0)
+      continue;
+    if (!plan.empty() && plan.back().file_index == read.file_index &&
+        read.offset <= plan.back().end() + max_gap) {
+      auto &last = plan.back();
+      last.size = std::max(last.end(), read.end()) - last.offset;
+    } else {
+      plan.push_back(read);
+    }
+  }
+  return plan;
+}
+
+}  // namespace dali
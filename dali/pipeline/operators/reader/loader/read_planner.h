@@ -0,0 +1,49 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_PIPELINE_OPERATORS_READER_LOADER_READ_PLANNER_H_
+#define DALI_PIPELINE_OPERATORS_READER_LOADER_READ_PLANNER_H_
+
+#include <vector>
+
+#include "dali/core/common.h"
+
+namespace dali {
+
+/**
+ * @brief A range of bytes in one of the files of a dataset
+ */
+struct ReadRange {
+  size_t file_index;
+  int64 offset;
+  int64 size;
+
+  int64 end() const {
+    return offset + size;
+  }
+};
+
+/**
+ * @brief Orders the reads by file and offset and merges the ones which overlap or are
+ *        separated by no more than `max_gap` bytes.
+ *
+ * The result describes the I/O to be issued for the reads; it does not change the order
+ * in which the samples are consumed.
+ */
+DLL_PUBLIC std::vector<ReadRange> PlanReads(std::vector<ReadRange> reads, int64 max_gap);
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_READER_LOADER_READ_PLANNER_H_
@@ -0,0 +1,65 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/loader/read_planner.h"
+
+namespace dali {
+
+namespace {
+
+bool operator==(const ReadRange &a, const ReadRange &b) {
+  return a.file_index == b.file_index && a.offset == b.offset && a.size == b.size;
+}
+
+}  // namespace
+
+TEST(ReadPlannerTest, SortAndMerge) {
+  std::vector<ReadRange> reads = {
+    { 1, 300, 100 },
+    { 0, 200, 50 },
+    { 0, 0, 100 },
+    { 1, 0, 100 },
+    { 0, 100, 100 },
+    { 1, 100, 100 },
+  };
+  auto plan = PlanReads(reads, 0);
+  std::vector<ReadRange> expected = {
+    { 0, 0, 250 },
+    { 1, 0, 200 },
+    { 1, 300, 100 },
+  };
+  ASSERT_EQ(plan.size(), expected.size());
+  for (size_t i = 0; i < plan.size(); i++)
+    EXPECT_TRUE(plan[i] == expected[i]) << "range " << i;
+}
+
+TEST(ReadPlannerTest, Gaps) {
+  std::vector<ReadRange> reads = {
+    { 0, 1000, 10 },
+    { 0, 0, 100 },
+    { 0, 150, 100 },
+    { 0, 120, 10 },  // contained in the merged range
+    { 0, 500, 0 },   // empty reads are dropped
+  };
+  auto plan = PlanReads(reads, 50);
+  ASSERT_EQ(plan.size(), 2u);
+  EXPECT_TRUE(plan[0] == (ReadRange{ 0, 0, 250 }));
+  EXPECT_TRUE(plan[1] == (ReadRange{ 0, 1000, 10 }));
+}
+
+}  // namespace dali
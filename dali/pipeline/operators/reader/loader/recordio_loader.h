@@ -77,10 +77,11 @@ class RecordIOLoader : public IndexedFileLoader {
   void ReadSample(Tensor<CPUBackend>& tensor) override {
     // if we moved to next shard wrap up
     MoveToNextShard(current_index_);
+    PlanReadAhead();
 
     int64 seek_pos, size;
     size_t file_index;
-    std::tie(seek_pos, size, file_index) = indices_[current_index_];
+    std::tie(seek_pos, size, file_index) = indices_[RecordIndex(current_index_)];
 
     ++current_index_;
 
@@ -100,7 +101,11 @@ class RecordIOLoader : public IndexedFileLoader {
       return;
     }
 
-    if (should_seek_) {
+    if (!record_order_.empty() && file_index != current_file_index_) {
+      SwitchToFile(file_index);
+    }
+
+    if (should_seek_ || !record_order_.empty()) {
       current_file_->Seek(seek_pos);
       should_seek_ = false;
     }
@@ -137,7 +142,7 @@ class RecordIOLoader : public IndexedFileLoader {
         DALI_ENFORCE(current_file_index_ + 1 < uris_.size(),
           "Incomplete or corrupted record files");
         // Release previously opened file
-        current_file_ = FileStream::Open(uris_[++current_file_index_], read_ahead_);
+        SwitchToFile(current_file_index_ + 1);
         continue;
       }
     }
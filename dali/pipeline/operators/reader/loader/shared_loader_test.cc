@@ -0,0 +1,191 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dali/core/common.h"
+#include "dali/pipeline/data/backend.h"
+#include "dali/pipeline/operators/op_spec.h"
+#include "dali/pipeline/operators/reader/loader/loader.h"
+
+namespace dali {
+
+/**
+ * @brief Produces samples holding consecutive integers
+ */
+class CountingLoader : public Loader<CPUBackend, Tensor<CPUBackend>> {
+ public:
+  explicit CountingLoader(const OpSpec& spec)
+    : Loader<CPUBackend, Tensor<CPUBackend>>(spec) {
+    instances++;
+  }
+
+  void ReadSample(Tensor<CPUBackend> &t) override {
+    t.Resize({1});
+    t.mutable_data<int>()[0] = next_++;
+  }
+
+  static int instances;
+
+ protected:
+  Index SizeImpl() override {
+    return 1000;
+  }
+
+  void Reset(bool) override {}
+
+ private:
+  int next_ = 0;
+};
+
+int CountingLoader::instances = 0;
+
+class NonShareableLoader : public CountingLoader {
+ public:
+  using CountingLoader::CountingLoader;
+  static constexpr bool kShareable = false;
+};
+
+DALI_SCHEMA(SharedLoaderTestReader)
+  .DocStr("Dummy")
+  .NumInput(0)
+  .NumOutput(1)
+  .AddParent("LoaderBase");
+
+namespace {
+
+OpSpec SharedSpec(const std::string &key, const std::string &mode = "shard") {
+  return OpSpec("SharedLoaderTestReader")
+    .AddArg("batch_size", 4)
+    .AddArg("device_id", 0)
+    .AddArg("shared_loader", key)
+    .AddArg("shared_loader_mode", mode);
+}
+
+int SampleValue(const std::shared_ptr<Tensor<CPUBackend>> &sample) {
+  return sample->data<int>()[0];
+}
+
+}  // namespace
+
+TEST(SharedLoaderTest, NotShared) {
+  int instances = CountingLoader::instances;
+  auto a = InitLoader<CountingLoader>(SharedSpec(""));
+  auto b = InitLoader<CountingLoader>(SharedSpec(""));
+  EXPECT_EQ(CountingLoader::instances, instances + 2);
+  EXPECT_EQ(SampleValue(a->ReadOne(false)), 0);
+  EXPECT_EQ(SampleValue(b->ReadOne(false)), 0);
+}
+
+TEST(SharedLoaderTest, Shard) {
+  int instances = CountingLoader::instances;
+  auto a = InitLoader<CountingLoader>(SharedSpec("shard_test"));
+  auto b = InitLoader<CountingLoader>(SharedSpec("shard_test"));
+  auto c = InitLoader<CountingLoader>(SharedSpec("shard_test"));
+  EXPECT_EQ(CountingLoader::instances, instances + 1);
+  // each reader sees its part of the dataset
+  EXPECT_EQ(a->Size(), 1000 / 3);
+
+  std::vector<bool> seen(30, false);
+  for (int i = 0; i < 10; i++) {
+    int va = SampleValue(a->ReadOne(false));
+    int vb = SampleValue(b->ReadOne(false));
+    int vc = SampleValue(c->ReadOne(false));
+    // consumers running in lockstep get the samples round-robin
+    EXPECT_EQ(va, 3 * i);
+    EXPECT_EQ(vb, 3 * i + 1);
+    EXPECT_EQ(vc, 3 * i + 2);
+    for (int v : { va, vb, vc }) {
+      ASSERT_LT(v, 30);
+      EXPECT_FALSE(seen[v]);
+      seen[v] = true;
+    }
+  }
+
+  EXPECT_THROW(InitLoader<CountingLoader>(SharedSpec("shard_test")), DALIException);
+
+  // the last sample of the epoch doesn't make a full round and is skipped
+  for (int i = 10; i < 333; i++) {
+    EXPECT_EQ(SampleValue(a->ReadOne(false)), 3 * i);
+    EXPECT_EQ(SampleValue(b->ReadOne(false)), 3 * i + 1);
+    EXPECT_EQ(SampleValue(c->ReadOne(false)), 3 * i + 2);
+  }
+  EXPECT_EQ(SampleValue(a->ReadOne(false)), 1000);
+  EXPECT_EQ(SampleValue(b->ReadOne(false)), 1001);
+}
+
+TEST(SharedLoaderTest, ShardIndependentOfReadOrder) {
+  auto a = InitLoader<CountingLoader>(SharedSpec("order_test"));
+  auto b = InitLoader<CountingLoader>(SharedSpec("order_test"));
+  for (int i = 0; i < 3; i++)
+    EXPECT_EQ(SampleValue(b->ReadOne(false)), 2 * i + 1);
+  for (int i = 0; i < 3; i++)
+    EXPECT_EQ(SampleValue(a->ReadOne(false)), 2 * i);
+}
+
+TEST(SharedLoaderTest, Replicate) {
+  auto a = InitLoader<CountingLoader>(SharedSpec("replicate_test", "replicate"));
+  auto b = InitLoader<CountingLoader>(SharedSpec("replicate_test", "replicate"));
+  for (int i = 0; i < 3; i++)
+    EXPECT_EQ(SampleValue(a->ReadOne(false)), i);
+  for (int i = 0; i < 3; i++)
+    EXPECT_EQ(SampleValue(b->ReadOne(false)), i);
+
+  // a consumer lagging behind by more than the queue limit (batch_size * prefetch_queue_depth)
+  // loses the oldest samples
+  for (int i = 3; i < 13; i++)
+    EXPECT_EQ(SampleValue(a->ReadOne(false)), i);
+  for (int i = 9; i < 13; i++)
+    EXPECT_EQ(SampleValue(b->ReadOne(false)), i);
+}
+
+TEST(SharedLoaderTest, SlowConsumer) {
+  auto a = InitLoader<CountingLoader>(SharedSpec("slow_test"));
+  auto b = InitLoader<CountingLoader>(SharedSpec("slow_test"));
+  // `a` runs ahead and has to wait for `b` instead of running out of tensors
+  // or taking the samples of `b`
+  std::thread fast([&]() {
+    for (int i = 0; i < 100; i++)
+      EXPECT_EQ(SampleValue(a->ReadOne(false)), 2 * i);
+  });
+  for (int i = 0; i < 100; i++) {
+    std::this_thread::yield();
+    EXPECT_EQ(SampleValue(b->ReadOne(false)), 2 * i + 1);
+  }
+  fast.join();
+}
+
+TEST(SharedLoaderTest, NotShareable) {
+  EXPECT_NO_THROW(InitLoader<NonShareableLoader>(SharedSpec("")));
+  EXPECT_THROW(InitLoader<NonShareableLoader>(SharedSpec("not_shareable")), DALIException);
+}
+
+TEST(SharedLoaderTest, Release) {
+  int instances = CountingLoader::instances;
+  {
+    auto a = InitLoader<CountingLoader>(SharedSpec("release_test"));
+    EXPECT_EQ(SampleValue(a->ReadOne(false)), 0);
+  }
+  // the shared loader died with its last consumer
+  auto b = InitLoader<CountingLoader>(SharedSpec("release_test"));
+  EXPECT_EQ(CountingLoader::instances, instances + 2);
+  EXPECT_EQ(SampleValue(b->ReadOne(false)), 0);
+}
+
+}  // namespace dali
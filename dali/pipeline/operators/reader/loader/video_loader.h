@@ -116,6 +116,9 @@ struct sequence_meta {
 
 class VideoLoader : public Loader<GPUBackend, SequenceWrapper> {
  public:
+  // VideoReader queries the loader for the frame size
+  static constexpr bool kShareable = false;
+
   explicit inline VideoLoader(const OpSpec& spec,
     const std::vector<std::string>& filenames)
     : Loader<GPUBackend, SequenceWrapper>(spec),
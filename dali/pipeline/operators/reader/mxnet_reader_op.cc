@@ -32,6 +32,12 @@ It is generated by the MXNet's `im2rec.py` script
 together with RecordIO file. It can also be
 generated using `rec2idx` script distributed with DALI.)code",
       DALI_STRING_VEC)
+  .AddOptionalArg("shuffle_chunk_size",
+      R"code(If greater than 0, the records are read in chunks of contiguous records of up to
+this many bytes, with the order of the chunks shuffled in every pass over the data.
+Each chunk is still read sequentially; combine with `random_shuffle` to also mix samples
+of different chunks in the `initial_fill` buffer.)code",
+      0)
   .AddParent("LoaderBase");
 
 }  // namespace dali
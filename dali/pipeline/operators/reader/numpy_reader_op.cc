@@ -0,0 +1,59 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <string>
+#include <vector>
+
+#include "dali/pipeline/operators/reader/numpy_reader_op.h"
+
+namespace dali {
+
+DALI_REGISTER_OPERATOR(NumpyReader, NumpyReader, CPU);
+
+DALI_SCHEMA(NumpyReader)
+  .DocStr(R"code(Read arrays stored in NumPy (.npy) files.
+Each sample is a tensor with the data type and shape stored in the file header.
+Arrays in Fortran order are transposed to C order.
+Files are memory-mapped and, when the requested data is contiguous in the file,
+samples are taken directly from the mapping without an intermediate copy.)code")
+  .NumInput(0)
+  .NumOutput(1)
+  .AddArg("file_root",
+      R"code(Path to a directory containing the .npy files.
+Unless `file_list` is given, the directory is traversed recursively and all files matching
+`file_filter` are read in alphabetical order.)code",
+      DALI_STRING)
+  .AddOptionalArg("file_list",
+      R"code(Path to the file with a list of pairs ``file label``, with paths relative
+to `file_root` (leave empty to traverse the `file_root` directory))code",
+      std::string())
+  .AddOptionalArg("file_filter",
+      R"code(Suffix of the files to read when traversing `file_root`.)code",
+      std::string(".npy"))
+  .AddOptionalArg("roi_start",
+      R"code(Start of the region of interest to read, in array coordinates.
+Missing trailing dimensions start at 0.)code",
+      std::vector<int>{})
+  .AddOptionalArg("roi_shape",
+      R"code(Shape of the region of interest to read. Missing trailing dimensions extend
+to the end of the array.)code",
+      std::vector<int>{})
+  .AddOptionalArg("shuffle_after_epoch",
+      R"code(If true, reader shuffles whole dataset after each epoch. It is exclusive with
+`stick_to_shard` and `random_shuffle`.)code",
+      false)
+  .AddParent("LoaderBase");
+
+}  // namespace dali
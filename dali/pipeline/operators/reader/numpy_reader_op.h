@@ -0,0 +1,54 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_PIPELINE_OPERATORS_READER_NUMPY_READER_OP_H_
+#define DALI_PIPELINE_OPERATORS_READER_NUMPY_READER_OP_H_
+
+#include "dali/pipeline/operators/reader/reader_op.h"
+#include "dali/pipeline/operators/reader/loader/numpy_loader.h"
+
+namespace dali {
+
+class NumpyReader : public DataReader<CPUBackend, ImageLabelWrapper> {
+ public:
+  explicit NumpyReader(const OpSpec& spec)
+    : DataReader<CPUBackend, ImageLabelWrapper>(spec) {
+    bool shuffle_after_epoch = spec.GetArgument<bool>("shuffle_after_epoch");
+    loader_ = InitLoader<NumpyLoader>(spec, shuffle_after_epoch);
+  }
+
+  void RunImpl(SampleWorkspace &ws) override {
+    const int idx = ws.data_idx();
+
+    const auto& sample = GetSample(idx);
+
+    // copy from the (possibly mapped) sample -> outputs directly
+    auto &output = ws.Output<CPUBackend>(0);
+    output.set_type(sample.image.type());
+    output.ResizeLike(sample.image);
+
+    std::memcpy(output.raw_mutable_data(),
+                sample.image.raw_data(),
+                sample.image.nbytes());
+    output.SetSourceInfo(sample.image.GetSourceInfo());
+  }
+
+ protected:
+  USE_READER_OPERATOR_MEMBERS(CPUBackend, ImageLabelWrapper);
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_OPERATORS_READER_NUMPY_READER_OP_H_
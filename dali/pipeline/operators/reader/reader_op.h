@@ -24,9 +24,11 @@
 #include <vector>
 #include <unordered_map>
 
+#include "dali/pipeline/data/memory_account.h"
 #include "dali/pipeline/operators/reader/loader/loader.h"
 #include "dali/pipeline/operators/reader/parser/parser.h"
 #include "dali/pipeline/operators/operator.h"
+#include "dali/pipeline/util/profiler.h"
 
 namespace dali {
 
@@ -70,6 +72,9 @@ class DataReader : public Operator<Backend> {
 
   ~DataReader() noexcept override {
     StopPrefetchThread();
+    if (memory_account_) {
+      memory_account_->RemoveReclaimer(reclaimer_id_);
+    }
     for (auto &batch : prefetched_batch_queue_) {
       // make share_ptr do their job while loader is still alive
       // and RecycleTensor could be safelly executed
@@ -92,6 +97,7 @@ class DataReader : public Operator<Backend> {
   // Main prefetch work loop
   void PrefetchWorker() {
     DeviceGuard g(device_id_);
+    MemoryAccountScope memory_scope(memory_account_, memory_tag_);
     ProducerWait();
     while (!finished_) {
       try {
@@ -110,6 +116,15 @@ class DataReader : public Operator<Backend> {
     std::lock_guard<std::mutex> lock(prefetch_access_mutex_);
     // if thread hasn't been started yet, start it
     if (prefetch_thread_.joinable()) return;
+    // The samples are charged to the pipeline and operator that started the thread
+    memory_account_ = MemoryAccount::Current();
+    memory_tag_ = MemoryAccount::CurrentTag();
+    if (memory_account_) {
+      reclaimer_id_ = memory_account_->AddReclaimer([this]() {
+        if (loader_)
+          loader_->ReleaseEmptyTensors();
+      });
+    }
     prefetch_thread_ = std::thread(&DataReader::PrefetchWorker, this);
   }
 
@@ -253,6 +268,8 @@ class DataReader : public Operator<Backend> {
   void ConsumerWait() {
     TimeRange tr("DataReader::ConsumerWait #" + to_string(curr_batch_consumer_),
                  TimeRange::kMagenta);
+    ProfilerRange stall(Profiler::Current(), Profiler::CurrentScope(),
+                        profiler_category::kReaderStall);
     std::unique_lock<std::mutex> prefetch_lock(prefetch_access_mutex_);
     consumer_.wait(prefetch_lock, [this]() { return finished_ || !IsPrefetchQueueEmpty(); });
     if (prefetch_error_) std::rethrow_exception(prefetch_error_);
@@ -283,6 +300,10 @@ class DataReader : public Operator<Backend> {
 
   std::thread prefetch_thread_;
 
+  MemoryAccount *memory_account_ = nullptr;
+  int memory_tag_ = -1;
+  int reclaimer_id_ = -1;
+
   // mutex to control access to the producer
   std::mutex prefetch_access_mutex_;
 
@@ -33,7 +33,13 @@ DALI_SCHEMA(_TFRecordReaderBase)
       R"code(List of paths to index files (1 index file for every TFRecord file).
 Index files may be obtained from TFRecord files using
 `tfrecord2idx` script distributed with DALI.)code",
-      DALI_STRING_VEC);
+      DALI_STRING_VEC)
+  .AddOptionalArg("shuffle_chunk_size",
+      R"code(If greater than 0, the records are read in chunks of contiguous records of up to
+this many bytes, with the order of the chunks shuffled in every pass over the data.
+Each chunk is still read sequentially; combine with `random_shuffle` to also mix samples
+of different chunks in the `initial_fill` buffer.)code",
+      0);
 
 DALI_SCHEMA(_TFRecordReader)
   .DocStr(R"code(Read sample data from a TensorFlow TFRecord file.)code")
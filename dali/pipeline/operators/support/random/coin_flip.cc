@@ -22,8 +22,12 @@ void CoinFlip::RunImpl(SupportWorkspace &ws) {
 
   int *out_data = output.template mutable_data<int>();
 
+  // Sample i always gets the i-th word of this iteration's stream
+  bits_.resize(batch_size_);
+  CounterRNG(seed_, RNGDomain::Support, 0, iteration_++).Fill(bits_.data(), batch_size_);
+
   for (int i = 0; i < batch_size_; ++i) {
-    out_data[i] = dis_(rng_) ? 1 : 0;
+    out_data[i] = bits_[i] < threshold_ ? 1 : 0;
   }
 }
 
@@ -15,10 +15,11 @@
 #ifndef DALI_PIPELINE_OPERATORS_SUPPORT_RANDOM_COIN_FLIP_H_
 #define DALI_PIPELINE_OPERATORS_SUPPORT_RANDOM_COIN_FLIP_H_
 
-#include <random>
+#include <algorithm>
 #include <vector>
 
 #include "dali/pipeline/operators/operator.h"
+#include "dali/pipeline/util/counter_rng.h"
 
 namespace dali {
 
@@ -26,8 +27,10 @@ class CoinFlip : public Operator<SupportBackend> {
  public:
   inline explicit CoinFlip(const OpSpec &spec) :
     Operator<SupportBackend>(spec),
-    dis_(spec.GetArgument<float>("probability")),
-    rng_(spec.GetArgument<int64_t>("seed")) {}
+    seed_(spec.GetArgument<int64_t>("seed")) {
+    float p = std::min(std::max(spec.GetArgument<float>("probability"), 0.0f), 1.0f);
+    threshold_ = static_cast<uint64_t>(static_cast<double>(p) * (1ull << 32));
+  }
 
   inline ~CoinFlip() override = default;
 
@@ -51,8 +54,11 @@ class CoinFlip : public Operator<SupportBackend> {
   void RunImpl(Workspace<SupportBackend> &ws) override;
 
  private:
-  std::bernoulli_distribution dis_;
-  std::mt19937 rng_;
+  int64_t seed_;
+  // a sample is 1 when its 32 random bits are below the threshold
+  uint64_t threshold_;
+  uint32_t iteration_ = 0;
+  std::vector<uint32_t> bits_;
 };
 
 }  // namespace dali
@@ -23,8 +23,15 @@ void Uniform::RunImpl(SupportWorkspace &ws) {
   auto &output = ws.Output<CPUBackend>(0);
   float *out_data = output.template mutable_data<float>();
 
+  // Sample i always gets the i-th word of this iteration's stream
+  bits_.resize(batch_size_);
+  CounterRNG(seed_, RNGDomain::Support, 0, iteration_++).Fill(bits_.data(), batch_size_);
+
+  const float lo = range_[0];
+  const float width = range_[1] - range_[0];
   for (int i = 0; i < batch_size_; ++i) {
-    out_data[i] = dis_(rng_);
+    // 24 random bits give a float in [0, 1) without rounding up to 1
+    out_data[i] = lo + width * ((bits_[i] >> 8) * (1.0f / (1 << 24)));
   }
 }
 
@@ -15,11 +15,11 @@
 #ifndef DALI_PIPELINE_OPERATORS_SUPPORT_RANDOM_UNIFORM_H_
 #define DALI_PIPELINE_OPERATORS_SUPPORT_RANDOM_UNIFORM_H_
 
-#include <random>
 #include <vector>
 
 #include "dali/pipeline/operators/operator.h"
 #include "dali/pipeline/operators/common.h"
+#include "dali/pipeline/util/counter_rng.h"
 
 namespace dali {
 
@@ -27,10 +27,8 @@ class Uniform : public Operator<SupportBackend> {
  public:
   inline explicit Uniform(const OpSpec &spec) :
     Operator<SupportBackend>(spec),
-    rng_(spec.GetArgument<int64_t>("seed")) {
-    std::vector<float> range;
-    GetSingleOrRepeatedArg(spec, range, "range", 2);
-    dis_ = std::uniform_real_distribution<float>(range[0], range[1]);
+    seed_(spec.GetArgument<int64_t>("seed")) {
+    GetSingleOrRepeatedArg(spec, range_, "range", 2);
   }
 
   inline ~Uniform() override = default;
@@ -55,8 +53,10 @@ class Uniform : public Operator<SupportBackend> {
   void RunImpl(Workspace<SupportBackend> &ws) override;
 
  private:
-  std::uniform_real_distribution<float> dis_;
-  std::mt19937 rng_;
+  std::vector<float> range_;
+  int64_t seed_;
+  uint32_t iteration_ = 0;
+  std::vector<uint32_t> bits_;
 };
 
 }  // namespace dali
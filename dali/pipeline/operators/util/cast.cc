@@ -14,6 +14,7 @@
 
 
 #include "dali/pipeline/operators/util/cast.h"
+#include "dali/kernels/common/cast.h"
 
 namespace dali {
 
@@ -28,7 +29,7 @@ void Cast<CPUBackend>::RunImpl(SampleWorkspace &ws) {
       output.mutable_data<OType>();
       output.ResizeLike(input);
       DALI_TYPE_SWITCH_WITH_FP16(itype, IType,
-        CPUHelper<IType, OType>(
+        kernels::CastBuffer<OType, IType>(
           output.mutable_data<OType>(),
           input.data<IType>(),
           input.size());););
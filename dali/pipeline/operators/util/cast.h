@@ -42,13 +42,6 @@ class Cast : public Operator<Backend> {
   void RunImpl(Workspace<Backend> &ws) override;
 
  private:
-  template <typename IType, typename OType>
-  inline void CPUHelper(OType *out, const IType *in, size_t N) {
-    for (size_t i = 0; i < N; ++i) {
-      out[i] = clamp<OType>(in[i]);
-    }
-  }
-
   DALIDataType output_type_;
 
   USE_OPERATOR_MEMBERS();
@@ -23,6 +23,7 @@
 #include "dali/pipeline/operators/operator.h"
 #include "dali/core/static_switch.h"
 #include "dali/core/convert.h"
+#include "dali/kernels/common/cast.h"
 #include "dali/kernels/type_tag.h"
 
 namespace dali {
@@ -62,6 +63,17 @@ class LookupTable : public Operator<Backend> {
     DALI_ENFORCE(keys.size() == values_f.size(),
       "`keys` size should match `values` size");
 
+    if (output_type_ == DALI_FLOAT16) {
+      // the table is built in float and converted at once
+      std::vector<float> table(kLookupTableSize, default_value_f_);
+      for (size_t i = 0; i < keys.size(); i++) {
+        table[keys[i]] = values_f[i];
+      }
+      value_mem_ = {new float16[kLookupTableSize], detail::value_mem_deleter<float16>};
+      kernels::CastBuffer(static_cast<float16*>(value_mem_.get()), table.data(),
+                          kLookupTableSize);
+      return;
+    }
     TYPE_SWITCH(output_type_, dali::type2id, OutputType, (float, uint8_t, int16_t, int32_t), (
         value_mem_ = {new OutputType[kLookupTableSize], detail::value_mem_deleter<OutputType>};
         OutputType *values = static_cast<OutputType*>(value_mem_.get());
@@ -20,6 +20,7 @@
 #include <algorithm>
 #include <functional>
 #include <memory>
+#include <set>
 
 #include "dali/pipeline/executor/async_pipelined_executor.h"
 #include "dali/pipeline/executor/async_separated_pipelined_executor.h"
@@ -123,6 +124,12 @@ namespace dali {
     }
   }
 
+Pipeline::~Pipeline() {
+  if (memory_reclaimer_id_ >= 0) {
+    memory_account_->RemoveReclaimer(memory_reclaimer_id_);
+  }
+}
+
 void Pipeline::Init(int batch_size, int num_threads, int device_id, int64_t seed,
                     bool pipelined_execution, bool separated_execution, bool async_execution,
                     size_t bytes_per_sample_hint, bool set_affinity, int max_num_stream,
@@ -447,15 +454,36 @@ void Pipeline::Build(vector<std::pair<string, string>> output_names) {
   executor_ = GetExecutor(pipelined_execution_, separated_execution_, async_execution_, batch_size_,
                           num_threads_, device_id_, bytes_per_sample_hint_, set_affinity_,
                           max_num_stream_, default_cuda_stream_priority_, prefetch_queue_depth_);
+  executor_->SetProfiler(&profiler_);
+  executor_->SetMemoryAccount(memory_account_.get());
+  // When over the memory budget, stop prefetching ahead of the consumer. The synchronous
+  // executor runs the next iteration while the user still holds the previous outputs,
+  // so it can't work with fewer buffers than it was built with.
+  if (async_execution_ && memory_reclaimer_id_ < 0) {
+    memory_reclaimer_id_ = memory_account_->AddReclaimer([this]() {
+      memory_throttled_ = true;
+      executor_->LimitQueueDepth(1);
+    });
+  }
+  if (autotune_) {
+    executor_->EnableAutotune(autotune_min_queue_depth_, autotune_min_threads_);
+  }
   executor_->Init();
 
+  // Populate the specs with the pipeline arguments first, so that the seeds are assigned
+  // the same way regardless of fusion
+  vector<OpDefinition> op_defs = op_specs_;
+  for (auto& op_def : op_defs) {
+    PrepareOpSpec(&op_def.spec, op_def.logical_id);
+  }
+  if (fusion_enabled_) {
+    FuseOperators(op_defs, output_names);
+  }
+
   // Creating the graph
-  for (auto& name_op_spec : op_specs_) {
-    string& inst_name = name_op_spec.instance_name;
-    OpSpec op_spec = name_op_spec.spec;
-    PrepareOpSpec(&op_spec, name_op_spec.logical_id);
+  for (auto& op_def : op_defs) {
     try {
-      graph_.AddOp(op_spec, inst_name);
+      graph_.AddOp(op_def.spec, op_def.instance_name);
     } catch (std::exception &e) {
       throw std::runtime_error("Critical error in pipeline: "
           + std::string(e.what())
@@ -520,10 +548,16 @@ void Pipeline::Build(vector<std::pair<string, string>> output_names) {
     }
   }
 
-  graph_.InstantiateOperators();
+  {
+    MemoryAccountScope memory_scope(memory_account_.get(), "pipeline");
+    graph_.InstantiateOperators();
+  }
 
   // Load the final graph into the executor
-  executor_->Build(&graph_, outputs);
+  {
+    MemoryAccountScope memory_scope(memory_account_.get(), "executor");
+    executor_->Build(&graph_, outputs);
+  }
   built_ = true;
 }
 
@@ -560,6 +594,7 @@ void Pipeline::Outputs(DeviceWorkspace *ws) {
     } catch (...) {
       throw std::runtime_error("Unknown Critical error in pipeline");
     }
+  RestoreQueueDepth();
 }
 
 void Pipeline::ShareOutputs(DeviceWorkspace *ws) {
@@ -588,6 +623,16 @@ void Pipeline::ReleaseOutputs() {
     } catch (...) {
       throw std::runtime_error("Unknown Critical error in pipeline");
     }
+  RestoreQueueDepth();
+}
+
+void Pipeline::RestoreQueueDepth() {
+  // some headroom, so that the limit is not toggled on every iteration
+  constexpr double kRestoreFraction = 0.75;
+  if (memory_throttled_ && memory_account_->WithinBudget(kRestoreFraction)) {
+    memory_throttled_ = false;
+    executor_->LimitQueueDepth(std::numeric_limits<int>::max());
+  }
 }
 
 void Pipeline::SetupCPUInput(std::map<string, EdgeMeta>::iterator it, int input_idx, OpSpec *spec) {
@@ -622,6 +667,34 @@ void Pipeline::SetupGPUInput(std::map<string, EdgeMeta>::iterator it) {
   it->second.has_gpu = true;
 }
 
+void Pipeline::FuseOperators(vector<OpDefinition> &op_defs,
+                             const vector<std::pair<string, string>> &output_names) {
+  std::set<string> outputs;
+  for (const auto &output : output_names) {
+    outputs.insert(output.first);
+  }
+  auto is_available = [](const string &op_name, const string &device) {
+    if (device == "cpu") {
+      return CPUOperatorRegistry::Registry().IsRegistered(op_name);
+    } else if (device == "gpu") {
+      return GPUOperatorRegistry::Registry().IsRegistered(op_name);
+    } else if (device == "mixed") {
+      return MixedOperatorRegistry::Registry().IsRegistered(op_name);
+    }
+    return false;
+  };
+  fusion_log_ = dali::FuseOperators(op_defs, outputs, is_available, fusion_patterns_);
+  if (fusion_verbose_) {
+    for (const auto &record : fusion_log_) {
+      string chain;
+      for (size_t i = 0; i < record.replaced.size(); i++) {
+        chain += (i ? " -> " : "") + record.replaced[i];
+      }
+      DALI_WARN("Operator fusion (" + record.pattern + "): " + chain + " => " + record.fused_op);
+    }
+  }
+}
+
 void Pipeline::PrepareOpSpec(OpSpec *spec, int logical_id) {
   if (logical_id_to_seed_.find(logical_id) == logical_id_to_seed_.end()) {
     logical_id_to_seed_[logical_id] = seed_[current_seed_];
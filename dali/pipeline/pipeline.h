@@ -15,6 +15,7 @@
 #ifndef DALI_PIPELINE_PIPELINE_H_
 #define DALI_PIPELINE_PIPELINE_H_
 
+#include <atomic>
 #include <chrono>
 #include <limits>
 #include <map>
@@ -27,10 +28,13 @@
 #include "dali/core/common.h"
 #include "dali/pipeline/executor/executor.h"
 #include "dali/pipeline/data/backend.h"
+#include "dali/pipeline/data/memory_account.h"
 #include "dali/pipeline/data/tensor.h"
 #include "dali/pipeline/data/tensor_list.h"
 #include "dali/pipeline/operators/util/external_source.h"
+#include "dali/pipeline/graph/op_fusion.h"
 #include "dali/pipeline/graph/op_graph.h"
+#include "dali/pipeline/util/profiler.h"
 
 
 namespace dali {
@@ -101,7 +105,7 @@ class DLL_PUBLIC Pipeline {
                       size_t bytes_per_sample_hint = 0, bool set_affinity = false,
                       int max_num_stream = -1, int default_cuda_stream_priority = 0);
 
-  DLL_PUBLIC ~Pipeline() = default;
+  DLL_PUBLIC ~Pipeline();
 
   /**
    * @brief Creates a placeholder for an external input with the given name
@@ -337,6 +341,101 @@ class DLL_PUBLIC Pipeline {
    */
   DLL_PUBLIC std::map<std::string, Index> EpochSize();
 
+  /**
+   * @brief Enables or disables recording of per-stage, per-operator and per-task timing
+   */
+  DLL_PUBLIC inline void EnableProfiling(bool enabled = true) { profiler_.Enable(enabled); }
+
+  /**
+   * @brief Returns the timing aggregated by category and name, keyed "category/name"
+   */
+  DLL_PUBLIC inline std::map<std::string, ProfilerStats> ProfilerStatistics() const {
+    return profiler_.GetStats();
+  }
+
+  /**
+   * @brief Returns the recorded timing in Chrome trace format (chrome://tracing)
+   */
+  DLL_PUBLIC inline std::string ProfilerTrace() const { return profiler_.ChromeTrace(); }
+
+  /**
+   * @brief Discards the recorded events and statistics
+   */
+  DLL_PUBLIC inline void ResetProfiler() { profiler_.Reset(); }
+
+  /**
+   * @brief Lets the executor adjust the CPU prefetch queue depth and the number of active
+   * worker threads at runtime, based on the observed stalls.
+   *
+   * The values stay between the given minimums and the ones the pipeline was created with.
+   * Must be called before Build().
+   */
+  DLL_PUBLIC inline void EnableAutotune(bool enabled = true, int min_queue_depth = 1,
+                                        int min_threads = 1) {
+    DALI_ENFORCE(!built_, "Autotuning must be enabled before the pipeline is built");
+    autotune_ = enabled;
+    autotune_min_queue_depth_ = min_queue_depth;
+    autotune_min_threads_ = min_threads;
+  }
+
+  /**
+   * @brief Returns the decisions made by the autotuner so far
+   */
+  DLL_PUBLIC inline std::vector<AutotuneDecision> AutotuneLog() const {
+    return executor_ ? executor_->GetAutotuneLog() : std::vector<AutotuneDecision>{};
+  }
+
+  /**
+   * @brief Lets Build() replace chains of operators with their fused equivalents,
+   * e.g. ImageDecoder followed by Crop with ImageDecoderCrop.
+   *
+   * Empty `patterns` selects the ones which don't change the results, see
+   * `DefaultFusionPatterns()`. With `verbose`, every rewrite is printed as it is applied.
+   * Must be called before Build().
+   */
+  DLL_PUBLIC inline void EnableOperatorFusion(bool enabled = true,
+                                              std::vector<std::string> patterns = {},
+                                              bool verbose = false) {
+    DALI_ENFORCE(!built_, "Operator fusion must be enabled before the pipeline is built");
+    fusion_enabled_ = enabled;
+    fusion_patterns_ = std::move(patterns);
+    fusion_verbose_ = verbose;
+  }
+
+  /**
+   * @brief Returns the rewrites applied by operator fusion during Build()
+   */
+  DLL_PUBLIC inline const std::vector<FusionRecord> &FusionLog() const {
+    return fusion_log_;
+  }
+
+  /**
+   * @brief Sets the budget for the host (including pinned) and GPU memory allocated by the
+   * pipeline, 0 means unlimited.
+   *
+   * When an allocation would exceed the budget, the pipeline first reduces the prefetching
+   * (asynchronous execution only, until the usage drops back) and frees the memory of the
+   * readers' idle sample buffers; if that is not enough, the allocation fails with an error
+   * listing the usage per operator.
+   */
+  DLL_PUBLIC inline void SetMemoryBudget(size_t host_bytes, size_t gpu_bytes) {
+    memory_account_->SetBudget(host_bytes, gpu_bytes);
+  }
+
+  /**
+   * @brief Returns the current and peak memory allocated by the pipeline
+   */
+  DLL_PUBLIC inline MemoryStats MemoryUsage() const {
+    return memory_account_->Total();
+  }
+
+  /**
+   * @brief Returns the current and peak memory allocated by the pipeline, per operator
+   */
+  DLL_PUBLIC inline std::map<std::string, MemoryStats> MemoryUsageByOperator() const {
+    return memory_account_->ByTag();
+  }
+
   /**
    * @brief Returns the number of threads used by the pipeline.
    */
@@ -405,8 +504,15 @@ class DLL_PUBLIC Pipeline {
   // Helper to add pipeline meta-data
   void PrepareOpSpec(OpSpec *spec, int logical_id);
 
+  // Applies operator fusion to the prepared specs and records the rewrites
+  void FuseOperators(vector<OpDefinition> &op_defs,
+                     const vector<std::pair<string, string>> &output_names);
+
   void PropagateMemoryHint(OpNode &node);
 
+  // Lifts the queue depth limit set by the memory reclaimer once the usage drops back
+  void RestoreQueueDepth();
+
   // Helper for hybrid decoder split_stages special handling
   inline void AddSplitHybridDecoder(OpSpec &spec, const std::string &inst_name, int logical_id);
 
@@ -429,11 +535,25 @@ class DLL_PUBLIC Pipeline {
   int next_logical_id_ = 0;
   int next_internal_logical_id_ = -1;
   QueueSizes prefetch_queue_depth_;
+  bool autotune_ = false;
+  int autotune_min_queue_depth_ = 1;
+  int autotune_min_threads_ = 1;
+  bool fusion_enabled_ = false;
+  bool fusion_verbose_ = false;
+  std::vector<std::string> fusion_patterns_;
+  std::vector<FusionRecord> fusion_log_;
 
   std::vector<int64_t> seed_;
   int original_seed_;
   size_t current_seed_;
 
+  // needs to outlive the executor
+  Profiler profiler_;
+  // needs to outlive the operators; kept alive by the allocations charged to it
+  std::shared_ptr<MemoryAccount> memory_account_ = std::make_shared<MemoryAccount>();
+  int memory_reclaimer_id_ = -1;
+  // set when the reclaimer limited the queue depth, cleared when the depth is restored
+  std::atomic<bool> memory_throttled_{false};
   OpGraph graph_;
   std::unique_ptr<ExecutorBase> executor_;
   std::map<string, EdgeMeta> edge_names_;
@@ -443,12 +563,6 @@ class DLL_PUBLIC Pipeline {
   // serialized form
   vector<string> external_inputs_;
 
-  struct OpDefinition {
-    std::string instance_name;
-    OpSpec spec;
-    int logical_id;
-  };
-
   vector<OpDefinition> op_specs_;
   vector<OpDefinition> op_specs_for_serialization_;
   vector<std::pair<string, string>> output_names_;
@@ -174,6 +174,10 @@ class PipelineTest : public DALITest {
   inline OpGraph& GetGraph(Pipeline *pipe) {
     return pipe->graph_;
   }
+
+  inline MemoryAccount& GetMemoryAccount(Pipeline *pipe) {
+    return *pipe->memory_account_;
+  }
 };
 
 template <int number_of_threads>
@@ -218,6 +222,46 @@ TEST_F(PipelineTestOnce, TestTriggerCopyToDevice) {
   RunTestTrigger("gpu");
 }
 
+TEST_F(PipelineTestOnce, MemoryReclaimSyncExecutor) {
+  const int batch_size = 4;
+  Pipeline pipe(batch_size, 1, 0);
+  // pipelined, synchronous
+  pipe.SetExecutionTypes(true, false, false);
+  pipe.AddExternalInput("data");
+  pipe.AddOperator(
+      OpSpec("Copy")
+      .AddArg("device", "cpu")
+      .AddInput("data", "cpu")
+      .AddOutput("copy_out", "cpu"));
+  pipe.Build({{"copy_out", "cpu"}});
+
+  TensorList<CPUBackend> data;
+  data.set_type(TypeInfo::Create<uint8>());
+  data.Resize(kernels::uniform_list_shape(batch_size, {16}));
+
+  DeviceWorkspace ws;
+  pipe.SetExternalInput("data", data);
+  pipe.RunCPU();
+  pipe.RunGPU();
+  pipe.Outputs(&ws);
+
+  // an allocation over the budget calls the reclaimers
+  auto &account = this->GetMemoryAccount(&pipe);
+  account.SetBudget(1, 0);
+  EXPECT_THROW(account.Charge(account.TagId("test"), MemoryKind::Host, 1024), std::runtime_error);
+  account.SetBudget(0, 0);
+
+  // the outputs are still held when the next iteration runs - the queue depth
+  // must not have been limited below that
+  for (int i = 0; i < 3; i++) {
+    pipe.SetExternalInput("data", data);
+    pipe.RunCPU();
+    pipe.RunGPU();
+    pipe.Outputs(&ws);
+  }
+  EXPECT_EQ(ws.NumOutput(), 1);
+}
+
 TYPED_TEST(PipelineTest, TestExternalSource) {
   int num_thread = TypeParam::nt;
   int batch_size = this->jpegs_.nImages();
@@ -15,43 +15,38 @@
 #ifndef DALI_PIPELINE_UTIL_BATCH_RNG_H_
 #define DALI_PIPELINE_UTIL_BATCH_RNG_H_
 
-#include <random>
 #include <vector>
 
-#include "dali/core/span.h"
+#include "dali/pipeline/util/counter_rng.h"
 
 namespace dali {
 
-template <typename RNG = std::mt19937>
 class BatchRNG {
  public:
   /**
    * @brief Used to keep batch of RNGs, so Operators can be immune to order of sample processing
    * while using randomness
    *
-   * @param seed Used to generate seed_seq to initialize batch of RNGs
+   * Each sample gets its own counter-based stream keyed by the seed and the sample index,
+   * so there is no per-sample seeding cost and no large per-sample state.
+   *
+   * @param seed Key of all the streams
    * @param batch_size How many RNGs to store
-   * @param state_size How many seed are used to initialize one RNG. Used to lower probablity of
-   * collisions between seeds used to initialize RNGs in different operators.
+   * @param domain Distinguishes the streams of different users of the same seed
    */
-  BatchRNG(int64_t seed, int batch_size, int state_size = 4) : seed_(seed) {
-    std::seed_seq seq{seed_};
-    std::vector<uint32_t> seeds(batch_size * state_size);
-    seq.generate(seeds.begin(), seeds.end());
+  BatchRNG(int64_t seed, int batch_size, RNGDomain domain = RNGDomain::Default) : seed_(seed) {
     rngs_.reserve(batch_size);
-    for (int i = 0; i < batch_size * state_size; i += state_size) {
-      std::seed_seq s(seeds.begin() + i, seeds.begin() + i + state_size);
-      rngs_.emplace_back(s);
-    }
+    for (int i = 0; i < batch_size; i++)
+      rngs_.emplace_back(seed, domain, i);
   }
 
-  RNG &operator[](int sample) noexcept {
+  CounterRNG &operator[](int sample) noexcept {
     return rngs_[sample];
   }
 
  private:
   int64_t seed_;
-  std::vector<RNG> rngs_;
+  std::vector<CounterRNG> rngs_;
 };
 
 }  // namespace dali
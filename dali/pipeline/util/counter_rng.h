@@ -0,0 +1,163 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_PIPELINE_UTIL_COUNTER_RNG_H_
+#define DALI_PIPELINE_UTIL_COUNTER_RNG_H_
+
+#ifdef __SSE2__
+#include <emmintrin.h>
+#endif
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+#include "dali/core/philox.h"
+
+namespace dali {
+
+/**
+ * @brief Identifies the consumer of a random stream, so that operators sharing a seed
+ * (e.g. a reader and a crop with the same user-provided seed) don't get correlated numbers.
+ */
+enum class RNGDomain : uint32_t {
+  Default = 0,
+  Loader = 1,
+  CropWindow = 2,
+  Support = 3,
+};
+
+/**
+ * @brief Random bit generator backed by Philox4x32-10, keyed by
+ *        (seed, domain, stream, epoch, draw)
+ *
+ * The generator state is just the key, the counter and one buffered block, so creating one
+ * per sample costs nothing compared to seeding an mt19937. The i-th number of a stream depends
+ * only on the key and the counter - never on how many numbers other streams have drawn -
+ * which keeps the results independent of the order in which samples are processed.
+ *
+ * Satisfies UniformRandomBitGenerator, so it can be used with standard distributions.
+ *
+ * Counter layout: the upper 64 bits hold the domain and the stream (usually the sample index),
+ * the lower 64 bits hold the epoch (upper half) and the index of the 4-word block (lower half).
+ */
+class CounterRNG {
+ public:
+  using result_type = uint32_t;
+
+  CounterRNG() : CounterRNG(0) {}
+
+  explicit CounterRNG(uint64_t seed, RNGDomain domain = RNGDomain::Default,
+                      uint32_t stream = 0, uint32_t epoch = 0)
+  : key_(seed)
+  , ctr_hi_(static_cast<uint64_t>(domain) << 32 | stream)
+  , draw_(static_cast<uint64_t>(epoch) << 32) {}
+
+  static constexpr result_type min() { return 0; }
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  result_type operator()() {
+    if (idx_ == 4) {
+      block_ = Philox4x32_10::Generate(key_, ctr_hi_, draw_++);
+      idx_ = 0;
+    }
+    return block_[idx_++];
+  }
+
+  /**
+   * @brief Fills `out` with the next `n` numbers of the stream.
+   *
+   * The result is identical to calling operator() `n` times, but whole blocks are generated
+   * four at a time with SSE2 when available.
+   */
+  void Fill(result_type *out, size_t n) {
+    size_t i = 0;
+    for (; i < n && idx_ < 4; i++)
+      out[i] = block_[idx_++];
+#ifdef __SSE2__
+    for (; i + 16 <= n; i += 16, draw_ += 4)
+      Generate4Blocks(out + i);
+#endif
+    for (; i + 4 <= n; i += 4) {
+      auto block = Philox4x32_10::Generate(key_, ctr_hi_, draw_++);
+      for (int k = 0; k < 4; k++)
+        out[i + k] = block[k];
+    }
+    for (; i < n; i++)
+      out[i] = (*this)();
+  }
+
+ private:
+#ifdef __SSE2__
+  static inline void MulHiLo(__m128i a, __m128i mul, __m128i &hi, __m128i &lo) {
+    const __m128i low_mask = _mm_set_epi32(0, -1, 0, -1);
+    __m128i even = _mm_mul_epu32(a, mul);
+    __m128i odd = _mm_mul_epu32(_mm_srli_epi64(a, 32), mul);
+    lo = _mm_or_si128(_mm_and_si128(even, low_mask), _mm_slli_epi64(odd, 32));
+    hi = _mm_or_si128(_mm_srli_epi64(even, 32), _mm_andnot_si128(low_mask, odd));
+  }
+
+  /**
+   * @brief Generates blocks draw_..draw_+3 into out[0..15]; lane j of each register
+   *        holds one word of block j.
+   */
+  void Generate4Blocks(result_type *out) const {
+    uint32_t lo[4], hi[4];
+    for (int j = 0; j < 4; j++) {
+      lo[j] = static_cast<uint32_t>(draw_ + j);
+      hi[j] = static_cast<uint32_t>((draw_ + j) >> 32);
+    }
+    __m128i v0 = _mm_setr_epi32(lo[0], lo[1], lo[2], lo[3]);
+    __m128i v1 = _mm_setr_epi32(hi[0], hi[1], hi[2], hi[3]);
+    __m128i v2 = _mm_set1_epi32(static_cast<uint32_t>(ctr_hi_));
+    __m128i v3 = _mm_set1_epi32(static_cast<uint32_t>(ctr_hi_ >> 32));
+    const __m128i mul0 = _mm_set1_epi32(Philox4x32_10::kMul0);
+    const __m128i mul1 = _mm_set1_epi32(Philox4x32_10::kMul1);
+    uint32_t k0 = static_cast<uint32_t>(key_);
+    uint32_t k1 = static_cast<uint32_t>(key_ >> 32);
+    for (int r = 0; r < Philox4x32_10::kRounds; r++) {
+      if (r) {
+        k0 += Philox4x32_10::kWeyl0;
+        k1 += Philox4x32_10::kWeyl1;
+      }
+      __m128i hi0, lo0, hi1, lo1;
+      MulHiLo(v0, mul0, hi0, lo0);
+      MulHiLo(v2, mul1, hi1, lo1);
+      v0 = _mm_xor_si128(_mm_xor_si128(hi1, v1), _mm_set1_epi32(k0));
+      v1 = lo1;
+      v2 = _mm_xor_si128(_mm_xor_si128(hi0, v3), _mm_set1_epi32(k1));
+      v3 = lo0;
+    }
+    // transpose from word-major to block-major
+    __m128i t0 = _mm_unpacklo_epi32(v0, v1);
+    __m128i t1 = _mm_unpacklo_epi32(v2, v3);
+    __m128i t2 = _mm_unpackhi_epi32(v0, v1);
+    __m128i t3 = _mm_unpackhi_epi32(v2, v3);
+    auto *dst = reinterpret_cast<__m128i *>(out);
+    _mm_storeu_si128(dst + 0, _mm_unpacklo_epi64(t0, t1));
+    _mm_storeu_si128(dst + 1, _mm_unpackhi_epi64(t0, t1));
+    _mm_storeu_si128(dst + 2, _mm_unpacklo_epi64(t2, t3));
+    _mm_storeu_si128(dst + 3, _mm_unpackhi_epi64(t2, t3));
+  }
+#endif
+
+  uint64_t key_;
+  uint64_t ctr_hi_;
+  uint64_t draw_;
+  Philox4x32_10::Block block_ = {{0, 0, 0, 0}};
+  int idx_ = 4;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_UTIL_COUNTER_RNG_H_
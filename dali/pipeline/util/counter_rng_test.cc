@@ -0,0 +1,85 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <random>
+#include <utility>
+#include <vector>
+#include "dali/pipeline/util/batch_rng.h"
+#include "dali/pipeline/util/counter_rng.h"
+
+namespace dali {
+
+TEST(CounterRNG, MatchesPhilox) {
+  CounterRNG rng(1234, RNGDomain::Loader, 7, 3);
+  uint64_t ctr_hi = static_cast<uint64_t>(RNGDomain::Loader) << 32 | 7;
+  uint64_t ctr_lo = 3ull << 32;
+  for (int b = 0; b < 3; b++) {
+    auto block = Philox4x32_10::Generate(1234, ctr_hi, ctr_lo + b);
+    for (int k = 0; k < 4; k++)
+      EXPECT_EQ(rng(), block[k]);
+  }
+}
+
+TEST(CounterRNG, FillMatchesScalar) {
+  for (size_t offset : {0, 1, 3, 4}) {
+    for (size_t n : {0, 1, 5, 16, 17, 63, 64, 100}) {
+      CounterRNG scalar(42, RNGDomain::Default, 5), bulk(42, RNGDomain::Default, 5);
+      for (size_t i = 0; i < offset; i++) {
+        scalar();
+        bulk();
+      }
+      std::vector<uint32_t> out(n);
+      bulk.Fill(out.data(), n);
+      for (size_t i = 0; i < n; i++)
+        ASSERT_EQ(out[i], scalar()) << "offset " << offset << " n " << n << " at " << i;
+      EXPECT_EQ(bulk(), scalar());
+    }
+  }
+}
+
+TEST(CounterRNG, StreamsAreIndependent) {
+  CounterRNG a(42, RNGDomain::Default, 0), b(42, RNGDomain::Default, 1);
+  CounterRNG c(42, RNGDomain::Loader, 0), d(43, RNGDomain::Default, 0);
+  CounterRNG e(42, RNGDomain::Default, 0, 1);
+  uint32_t x = a();
+  EXPECT_NE(x, b());
+  EXPECT_NE(x, c());
+  EXPECT_NE(x, d());
+  EXPECT_NE(x, e());
+}
+
+TEST(CounterRNG, WorksWithStdDistributions) {
+  CounterRNG rng(42);
+  std::uniform_int_distribution<int> dist(0, 9);
+  std::vector<int> histogram(10);
+  for (int i = 0; i < 10000; i++)
+    histogram[dist(rng)]++;
+  for (int count : histogram)
+    EXPECT_GT(count, 800);
+}
+
+TEST(BatchRNG, IndependentOfSampleOrder) {
+  const int batch_size = 8;
+  BatchRNG forward(1234, batch_size), backward(1234, batch_size);
+  std::vector<uint32_t> fwd(batch_size), bwd(batch_size);
+  for (int i = 0; i < batch_size; i++)
+    fwd[i] = forward[i]();
+  for (int i = batch_size - 1; i >= 0; i--)
+    bwd[i] = backward[i]();
+  EXPECT_EQ(fwd, bwd);
+}
+
+}  // namespace dali
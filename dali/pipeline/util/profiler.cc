@@ -0,0 +1,159 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include "dali/pipeline/util/profiler.h"
+#include <fstream>
+#include <sstream>
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+namespace {
+
+thread_local Profiler *current_profiler = nullptr;
+thread_local const std::string *current_scope = nullptr;
+
+std::string StatKey(const std::string &name, const char *category) {
+  return std::string(category) + "/" + name;
+}
+
+void WriteJSONString(std::ostream &os, const std::string &str) {
+  os << '"';
+  for (char c : str) {
+    switch (c) {
+      case '"':
+        os << "\\\"";
+        break;
+      case '\\':
+        os << "\\\\";
+        break;
+      case '\n':
+        os << "\\n";
+        break;
+      case '\t':
+        os << "\\t";
+        break;
+      default:
+        if (static_cast<unsigned char>(c) < 0x20) {
+          os << ' ';
+        } else {
+          os << c;
+        }
+    }
+  }
+  os << '"';
+}
+
+}  // namespace
+
+constexpr size_t Profiler::kDefaultMaxEvents;
+
+Profiler::Profiler(size_t max_events)
+    : enabled_(false), origin_(clock::now()), max_events_(max_events) {}
+
+void Profiler::Enable(bool enabled) {
+  enabled_ = enabled;
+}
+
+int Profiler::ThreadId() {
+  static std::atomic<int> next_id{0};
+  thread_local int id = next_id++;
+  return id;
+}
+
+void Profiler::Record(const std::string &name, const char *category,
+                      clock::time_point start, clock::time_point end) {
+  using std::chrono::duration_cast;
+  using std::chrono::microseconds;
+  int64_t duration_us = duration_cast<microseconds>(end - start).count();
+  int tid = ThreadId();
+  std::lock_guard<std::mutex> lock(mutex_);
+  int64_t start_us = duration_cast<microseconds>(start - origin_).count();
+  stats_[StatKey(name, category)].Add(duration_us);
+  if (events_.size() < max_events_) {
+    events_.push_back({name, category, tid, start_us, duration_us});
+  }
+}
+
+void Profiler::AddStat(const std::string &name, const char *category, clock::duration duration) {
+  int64_t duration_us = std::chrono::duration_cast<std::chrono::microseconds>(duration).count();
+  std::lock_guard<std::mutex> lock(mutex_);
+  stats_[StatKey(name, category)].Add(duration_us);
+}
+
+std::map<std::string, ProfilerStats> Profiler::GetStats() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return stats_;
+}
+
+std::vector<ProfilerEvent> Profiler::GetEvents() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return events_;
+}
+
+std::string Profiler::ChromeTrace() const {
+  std::stringstream ss;
+  ss << "{\"traceEvents\":[";
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (size_t i = 0; i < events_.size(); i++) {
+      auto &event = events_[i];
+      if (i)
+        ss << ",\n";
+      ss << "{\"name\":";
+      WriteJSONString(ss, event.name);
+      ss << ",\"cat\":\"" << event.category << "\",\"ph\":\"X\""
+         << ",\"ts\":" << event.start_us << ",\"dur\":" << event.duration_us
+         << ",\"pid\":0,\"tid\":" << event.thread_id << "}";
+    }
+  }
+  ss << "],\"displayTimeUnit\":\"ms\"}";
+  return ss.str();
+}
+
+void Profiler::SaveChromeTrace(const std::string &filename) const {
+  std::ofstream ofs(filename);
+  DALI_ENFORCE(ofs.good(), "Cannot open file for writing: " + filename);
+  ofs << ChromeTrace();
+}
+
+void Profiler::Reset() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  events_.clear();
+  stats_.clear();
+  origin_ = clock::now();
+}
+
+Profiler *Profiler::Current() {
+  return current_profiler;
+}
+
+const std::string &Profiler::CurrentScope() {
+  static const std::string empty;
+  return current_scope ? *current_scope : empty;
+}
+
+ProfilerScope::ProfilerScope(Profiler *profiler, const std::string &name, const char *category)
+    : prev_profiler_(current_profiler), prev_name_(current_scope), name_(name),
+      range_(profiler, name, category) {
+  current_profiler = profiler;
+  current_scope = &name_;
+}
+
+ProfilerScope::~ProfilerScope() {
+  current_profiler = prev_profiler_;
+  current_scope = prev_name_;
+}
+
+}  // namespace dali
@@ -0,0 +1,197 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_PIPELINE_UTIL_PROFILER_H_
+#define DALI_PIPELINE_UTIL_PROFILER_H_
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <limits>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include "dali/core/common.h"
+
+namespace dali {
+
+/**
+ * @brief Categories of the events recorded by the pipeline
+ */
+namespace profiler_category {
+static constexpr const char *kStage = "stage";
+static constexpr const char *kOp = "op";
+static constexpr const char *kTask = "task";
+static constexpr const char *kTaskWait = "task_wait";
+static constexpr const char *kQueueWait = "queue_wait";
+static constexpr const char *kOutputWait = "output_wait";
+static constexpr const char *kReaderStall = "reader_stall";
+}  // namespace profiler_category
+
+struct ProfilerEvent {
+  std::string name;
+  const char *category;
+  int thread_id;
+  int64_t start_us;
+  int64_t duration_us;
+};
+
+/**
+ * @brief Aggregated timing of all events with the same name and category
+ */
+struct ProfilerStats {
+  int64_t count = 0;
+  int64_t total_us = 0;
+  int64_t min_us = std::numeric_limits<int64_t>::max();
+  int64_t max_us = 0;
+
+  void Add(int64_t duration_us) {
+    count++;
+    total_us += duration_us;
+    min_us = std::min(min_us, duration_us);
+    max_us = std::max(max_us, duration_us);
+  }
+};
+
+/**
+ * @brief Wall-clock profiler of the pipeline execution.
+ *
+ * Records time ranges of stages, operators and thread pool tasks, aggregates them
+ * and exports them in Chrome trace format (chrome://tracing).
+ * Recording is thread-safe. When disabled, the overhead of a range is a single atomic load.
+ */
+class DLL_PUBLIC Profiler {
+ public:
+  using clock = std::chrono::steady_clock;
+
+  static constexpr size_t kDefaultMaxEvents = 1 << 20;
+
+  DLL_PUBLIC explicit Profiler(size_t max_events = kDefaultMaxEvents);
+
+  DLL_PUBLIC void Enable(bool enabled = true);
+
+  DLL_PUBLIC inline bool IsEnabled() const {
+    return enabled_.load(std::memory_order_relaxed);
+  }
+
+  /**
+   * @brief Records an event in the trace and in the aggregated stats.
+   *
+   * Once `max_events` are stored, new events are only aggregated.
+   */
+  DLL_PUBLIC void Record(const std::string &name, const char *category,
+                         clock::time_point start, clock::time_point end);
+
+  /**
+   * @brief Adds a duration to the aggregated stats only, without storing an event
+   */
+  DLL_PUBLIC void AddStat(const std::string &name, const char *category, clock::duration duration);
+
+  /**
+   * @brief Returns the stats aggregated by `category` and `name`, keyed "category/name"
+   */
+  DLL_PUBLIC std::map<std::string, ProfilerStats> GetStats() const;
+
+  DLL_PUBLIC std::vector<ProfilerEvent> GetEvents() const;
+
+  /**
+   * @brief Returns the recorded events as Chrome trace JSON
+   */
+  DLL_PUBLIC std::string ChromeTrace() const;
+
+  DLL_PUBLIC void SaveChromeTrace(const std::string &filename) const;
+
+  DLL_PUBLIC void Reset();
+
+  /**
+   * @brief Profiler assigned to the calling thread with ProfilerScope, or nullptr
+   */
+  DLL_PUBLIC static Profiler *Current();
+
+  /**
+   * @brief Name of the innermost ProfilerScope of the calling thread
+   */
+  DLL_PUBLIC static const std::string &CurrentScope();
+
+  DISABLE_COPY_MOVE_ASSIGN(Profiler);
+
+ private:
+  friend class ProfilerScope;
+
+  static int ThreadId();
+
+  std::atomic<bool> enabled_;
+  clock::time_point origin_;
+  size_t max_events_;
+  mutable std::mutex mutex_;
+  std::vector<ProfilerEvent> events_;
+  std::map<std::string, ProfilerStats> stats_;
+};
+
+/**
+ * @brief RAII time range recorded in `profiler`, if it is not null and is enabled.
+ */
+class DLL_PUBLIC ProfilerRange {
+ public:
+  DLL_PUBLIC ProfilerRange(Profiler *profiler, const std::string &name, const char *category)
+      : category_(category) {
+    if (profiler && profiler->IsEnabled()) {
+      profiler_ = profiler;
+      name_ = name;
+      start_ = Profiler::clock::now();
+    }
+  }
+
+  DLL_PUBLIC ~ProfilerRange() { stop(); }
+
+  DLL_PUBLIC void stop() {
+    if (profiler_) {
+      profiler_->Record(name_, category_, start_, Profiler::clock::now());
+      profiler_ = nullptr;
+    }
+  }
+
+  DISABLE_COPY_MOVE_ASSIGN(ProfilerRange);
+
+ private:
+  Profiler *profiler_ = nullptr;
+  std::string name_;
+  const char *category_;
+  Profiler::clock::time_point start_;
+};
+
+/**
+ * @brief Records a range and makes `profiler` and `name` current for the calling thread.
+ *
+ * Work issued to the ThreadPool within the scope and code that has no direct access to
+ * the pipeline (e.g. readers) use Profiler::Current() to attribute their time.
+ */
+class DLL_PUBLIC ProfilerScope {
+ public:
+  DLL_PUBLIC ProfilerScope(Profiler *profiler, const std::string &name, const char *category);
+  DLL_PUBLIC ~ProfilerScope();
+
+  DISABLE_COPY_MOVE_ASSIGN(ProfilerScope);
+
+ private:
+  Profiler *prev_profiler_;
+  const std::string *prev_name_;
+  std::string name_;
+  ProfilerRange range_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_PIPELINE_UTIL_PROFILER_H_
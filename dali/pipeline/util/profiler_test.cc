@@ -0,0 +1,97 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#include <gtest/gtest.h>
+#include <string>
+#include "dali/pipeline/util/profiler.h"
+#include "dali/pipeline/util/thread_pool.h"
+
+namespace dali {
+
+TEST(ProfilerTest, DisabledRecordsNothing) {
+  Profiler profiler;
+  {
+    ProfilerRange range(&profiler, "range", profiler_category::kStage);
+  }
+  EXPECT_TRUE(profiler.GetEvents().empty());
+  EXPECT_TRUE(profiler.GetStats().empty());
+}
+
+TEST(ProfilerTest, RangesAndStats) {
+  Profiler profiler;
+  profiler.Enable();
+  for (int i = 0; i < 3; i++) {
+    ProfilerRange range(&profiler, "cpu", profiler_category::kStage);
+  }
+  {
+    ProfilerRange range(&profiler, "cpu", profiler_category::kQueueWait);
+    range.stop();
+    range.stop();  // stopping twice records a single event
+  }
+  auto stats = profiler.GetStats();
+  ASSERT_EQ(stats.size(), 2u);
+  EXPECT_EQ(stats["stage/cpu"].count, 3);
+  EXPECT_EQ(stats["queue_wait/cpu"].count, 1);
+  EXPECT_LE(stats["stage/cpu"].min_us, stats["stage/cpu"].max_us);
+  EXPECT_EQ(profiler.GetEvents().size(), 4u);
+
+  profiler.Reset();
+  EXPECT_TRUE(profiler.GetEvents().empty());
+  EXPECT_TRUE(profiler.GetStats().empty());
+}
+
+TEST(ProfilerTest, EventLimit) {
+  Profiler profiler(2);
+  profiler.Enable();
+  for (int i = 0; i < 5; i++) {
+    ProfilerRange range(&profiler, "op", profiler_category::kOp);
+  }
+  EXPECT_EQ(profiler.GetEvents().size(), 2u);
+  EXPECT_EQ(profiler.GetStats()["op/op"].count, 5);
+}
+
+TEST(ProfilerTest, ScopeAttributesThreadPoolTasks) {
+  Profiler profiler;
+  profiler.Enable();
+  ThreadPool tp(2, 0, false);
+  EXPECT_EQ(Profiler::Current(), nullptr);
+  {
+    ProfilerScope scope(&profiler, "MyOp", profiler_category::kOp);
+    EXPECT_EQ(Profiler::Current(), &profiler);
+    EXPECT_EQ(Profiler::CurrentScope(), "MyOp");
+    for (int i = 0; i < 4; i++) {
+      tp.DoWorkWithID([](int) {});
+    }
+    tp.WaitForWork();
+  }
+  EXPECT_EQ(Profiler::Current(), nullptr);
+  EXPECT_EQ(Profiler::CurrentScope(), "");
+  auto stats = profiler.GetStats();
+  EXPECT_EQ(stats["op/MyOp"].count, 1);
+  EXPECT_EQ(stats["task/MyOp"].count, 4);
+  EXPECT_EQ(stats["task_wait/MyOp"].count, 4);
+}
+
+TEST(ProfilerTest, ChromeTrace) {
+  Profiler profiler;
+  profiler.Enable();
+  {
+    ProfilerRange range(&profiler, "quoted \"name\"", profiler_category::kOp);
+  }
+  std::string trace = profiler.ChromeTrace();
+  EXPECT_EQ(trace.find("{\"traceEvents\":[{\"name\":\"quoted \\\"name\\\"\",\"cat\":\"op\""), 0u);
+  EXPECT_NE(trace.find("\"ph\":\"X\""), std::string::npos);
+}
+
+}  // namespace dali
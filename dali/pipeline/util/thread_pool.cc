@@ -15,6 +15,8 @@
 #include <cstdlib>
 
 #include "dali/pipeline/util/thread_pool.h"
+#include "dali/pipeline/data/memory_account.h"
+#include "dali/pipeline/util/profiler.h"
 #if NVML_ENABLED
 #include "dali/util/nvml.h"
 #endif
@@ -23,8 +25,32 @@
 
 namespace dali {
 
+namespace {
+
+thread_local ThreadPool::WorkGroup *current_group = nullptr;
+
+}  // namespace
+
+ThreadPool::WorkGroup::~WorkGroup() {
+  WorkGroupScope scope(this);
+  pool_->WaitForWork(false);
+}
+
+ThreadPool::WorkGroupScope::WorkGroupScope(WorkGroup *group) : previous_(current_group) {
+  current_group = group;
+}
+
+ThreadPool::WorkGroupScope::~WorkGroupScope() {
+  current_group = previous_;
+}
+
+ThreadPool::WorkGroup *ThreadPool::CurrentGroup() {
+  return current_group && current_group->pool_ == this ? current_group : nullptr;
+}
+
 ThreadPool::ThreadPool(int num_thread, int device_id, bool set_affinity)
-    : threads_(num_thread), running_(true), work_complete_(true), active_threads_(0) {
+    : threads_(num_thread), running_(true), work_complete_(true), active_threads_(0),
+      num_active_limit_(num_thread) {
   DALI_ENFORCE(num_thread > 0, "Thread pool must have non-zero size");
 #if NVML_ENABLED
   nvml::Init();
@@ -54,19 +80,79 @@ ThreadPool::~ThreadPool() {
 }
 
 void ThreadPool::DoWorkWithID(Work work) {
+  if (MemoryAccount *account = MemoryAccount::Current()) {
+    // charge the memory allocated by the task to the issuing operator
+    work = [work, account, tag = MemoryAccount::CurrentTag()](int thread_id) {
+      MemoryAccountScope scope(account, tag);
+      work(thread_id);
+    };
+  }
+  Profiler *profiler = Profiler::Current();
+  if (profiler && profiler->IsEnabled()) {
+    // attribute the task to the scope (usually an operator) that issued it
+    auto queued = Profiler::clock::now();
+    work = [work, profiler, queued, name = Profiler::CurrentScope()](int thread_id) {
+      auto start = Profiler::clock::now();
+      profiler->AddStat(name, profiler_category::kTaskWait, start - queued);
+      try {
+        work(thread_id);
+      } catch (...) {
+        profiler->Record(name, profiler_category::kTask, start, Profiler::clock::now());
+        throw;
+      }
+      profiler->Record(name, profiler_category::kTask, start, Profiler::clock::now());
+    };
+  }
+  WorkGroup *group = CurrentGroup();
+  if (group) {
+    // errors are kept in the group, so that they are reported only to its own WaitForWork
+    work = [this, work, group](int thread_id) {
+      string error;
+      try {
+        work(thread_id);
+      } catch (std::exception &e) {
+        error = e.what();
+      } catch (...) {
+        error = "Caught unknown exception";
+      }
+      std::lock_guard<std::mutex> lock(mutex_);
+      if (!error.empty())
+        group->errors_.push("Error in thread " + std::to_string(thread_id) + ": " + error);
+      if (--group->pending_ == 0)
+        completed_.notify_all();
+    };
+  }
+  bool limited;
   {
     // Add work to the queue
     std::lock_guard<std::mutex> lock(mutex_);
+    if (group)
+      group->pending_++;
     work_queue_.push(work);
     work_complete_ = false;
+    limited = num_active_limit_ < size();
+  }
+  // Signal a thread to complete the work. If some threads are inactive,
+  // the one woken up might not be allowed to take the work, so we wake them all.
+  if (limited) {
+    condition_.notify_all();
+  } else {
+    condition_.notify_one();
   }
-  // Signal a thread to complete the work
-  condition_.notify_one();
 }
 
 // Blocks until all work issued to the thread pool is complete
 void ThreadPool::WaitForWork(bool checkForErrors) {
   std::unique_lock<std::mutex> lock(mutex_);
+  if (WorkGroup *group = CurrentGroup()) {
+    completed_.wait(lock, [group] { return group->pending_ == 0; });
+    if (checkForErrors && !group->errors_.empty()) {
+      string error = group->errors_.front();
+      group->errors_.pop();
+      throw std::runtime_error(error);
+    }
+    return;
+  }
   completed_.wait(lock, [this] { return this->work_complete_; });
 
   if (checkForErrors) {
@@ -86,6 +172,21 @@ int ThreadPool::size() const {
   return threads_.size();
 }
 
+void ThreadPool::SetNumActiveThreads(int num_threads) {
+  DALI_ENFORCE(num_threads > 0 && num_threads <= size(),
+               "Number of active threads must be in range [1, " + to_string(size()) + "]");
+  {
+    std::lock_guard<std::mutex> lock(mutex_);
+    num_active_limit_ = num_threads;
+  }
+  condition_.notify_all();
+}
+
+int ThreadPool::NumActiveThreads() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return num_active_limit_;
+}
+
 void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
   DeviceGuard g(device_id);
   try {
@@ -115,7 +216,9 @@ void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
   while (running_) {
     // Block on the condition to wait for work
     std::unique_lock<std::mutex> lock(mutex_);
-    condition_.wait(lock, [this] { return !(running_ && work_queue_.empty()); });
+    condition_.wait(lock, [this, thread_id] {
+      return !running_ || (!work_queue_.empty() && thread_id < num_active_limit_);
+    });
     // If we're no longer running, exit the run loop
     if (!running_) break;
 
@@ -124,13 +227,18 @@ void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
     Work work = work_queue_.front();
     work_queue_.pop();
     bool should_wake_next = !work_queue_.empty();
+    bool limited = num_active_limit_ < size();
     ++active_threads_;
 
     // Unlock the lock
     lock.unlock();
 
     if (should_wake_next) {
-      condition_.notify_one();
+      if (limited) {
+        condition_.notify_all();
+      } else {
+        condition_.notify_one();
+      }
     }
 
     // If an error occurs, we save it in tl_errors_. When
@@ -153,7 +261,7 @@ void ThreadPool::ThreadMain(int thread_id, int device_id, bool set_affinity) {
     --active_threads_;
     if (work_queue_.empty() && active_threads_ == 0) {
       work_complete_ = true;
-      completed_.notify_one();
+      completed_.notify_all();
     }
   }
 }
@@ -33,29 +33,75 @@ class DLL_PUBLIC ThreadPool {
   // Basic unit of work that our threads do
   typedef std::function<void(int)> Work;
 
+  /**
+   * @brief Completion and errors of the work issued by one of several clients sharing the pool.
+   *
+   * While a WorkGroupScope for the group is active on the issuing thread, work issued to the
+   * pool is counted in the group, and WaitForWork waits only for that work and reports only
+   * its errors. The destructor waits for the remaining work of the group.
+   */
+  class DLL_PUBLIC WorkGroup {
+   public:
+    explicit WorkGroup(ThreadPool *pool) : pool_(pool) {}
+    ~WorkGroup();
+    DISABLE_COPY_MOVE_ASSIGN(WorkGroup);
+
+   private:
+    friend class ThreadPool;
+    ThreadPool *pool_;
+    int pending_ = 0;
+    std::queue<string> errors_;
+  };
+
+  /**
+   * @brief Makes `group` the current work group of the calling thread
+   */
+  class DLL_PUBLIC WorkGroupScope {
+   public:
+    explicit WorkGroupScope(WorkGroup *group);
+    ~WorkGroupScope();
+    DISABLE_COPY_MOVE_ASSIGN(WorkGroupScope);
+
+   private:
+    WorkGroup *previous_;
+  };
+
   DLL_PUBLIC ThreadPool(int num_thread, int device_id, bool set_affinity);
 
   DLL_PUBLIC ~ThreadPool();
 
   DLL_PUBLIC void DoWorkWithID(Work work);
 
-  // Blocks until all work issued to the thread pool is complete
+  // Blocks until all work issued to the thread pool is complete.
+  // Within a WorkGroupScope, blocks only until the work of that group is complete.
   DLL_PUBLIC void WaitForWork(bool checkForErrors = true);
 
   DLL_PUBLIC int size() const;
 
+  /**
+   * @brief Limits the number of threads that pick up work to `num_threads` first threads.
+   *
+   * The remaining threads stay idle until the limit is raised again.
+   */
+  DLL_PUBLIC void SetNumActiveThreads(int num_threads);
+
+  DLL_PUBLIC int NumActiveThreads() const;
+
   DISABLE_COPY_MOVE_ASSIGN(ThreadPool);
 
  private:
   DLL_PUBLIC void ThreadMain(int thread_id, int device_id, bool set_affinity);
 
+  WorkGroup *CurrentGroup();
+
   vector<std::thread> threads_;
   std::queue<Work> work_queue_;
 
   bool running_;
   bool work_complete_;
   int active_threads_;
-  std::mutex mutex_;
+  int num_active_limit_;
+  mutable std::mutex mutex_;
   std::condition_variable condition_;
   std::condition_variable completed_;
 
@@ -0,0 +1,76 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+
+#include <atomic>
+#include <chrono>
+#include <stdexcept>
+#include <thread>
+
+#include "dali/pipeline/util/thread_pool.h"
+
+namespace dali {
+
+TEST(ThreadPoolTest, WorkGroupsWaitOnlyForTheirWork) {
+  ThreadPool pool(4, 0, false);
+  std::atomic<bool> release{false};
+  std::atomic<int> done{0};
+
+  ThreadPool::WorkGroup slow(&pool);
+  {
+    ThreadPool::WorkGroupScope scope(&slow);
+    pool.DoWorkWithID([&](int) {
+      while (!release)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    });
+  }
+
+  ThreadPool::WorkGroup fast(&pool);
+  {
+    ThreadPool::WorkGroupScope scope(&fast);
+    for (int i = 0; i < 10; i++)
+      pool.DoWorkWithID([&](int) { done++; });
+    // returns although the work of the other group is still running
+    pool.WaitForWork();
+    EXPECT_EQ(done, 10);
+  }
+
+  release = true;
+  ThreadPool::WorkGroupScope scope(&slow);
+  pool.WaitForWork();
+}
+
+TEST(ThreadPoolTest, WorkGroupErrors) {
+  ThreadPool pool(2, 0, false);
+  ThreadPool::WorkGroup failing(&pool), other(&pool);
+  {
+    ThreadPool::WorkGroupScope scope(&failing);
+    pool.DoWorkWithID([](int) { throw std::runtime_error("failing group"); });
+  }
+  {
+    ThreadPool::WorkGroupScope scope(&other);
+    pool.DoWorkWithID([](int) {});
+    EXPECT_NO_THROW(pool.WaitForWork());
+  }
+  {
+    ThreadPool::WorkGroupScope scope(&failing);
+    EXPECT_THROW(pool.WaitForWork(), std::runtime_error);
+  }
+  // the error is not reported outside of the group either
+  EXPECT_NO_THROW(pool.WaitForWork());
+}
+
+}  // namespace dali
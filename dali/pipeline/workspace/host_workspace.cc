@@ -18,6 +18,51 @@
 
 namespace dali {
 
+HostWorkspace::HostWorkspace() = default;
+
+HostWorkspace::~HostWorkspace() = default;
+
+HostWorkspace::HostWorkspace(const HostWorkspace &other)
+    : WorkspaceBase<HostInputType, HostOutputType>(other)
+    , thread_pool_(other.thread_pool_) {}
+
+HostWorkspace &HostWorkspace::operator=(const HostWorkspace &other) {
+  if (this != &other) {
+    WorkspaceBase<HostInputType, HostOutputType>::operator=(other);
+    thread_pool_ = other.thread_pool_;
+    samples_.clear();
+    samples_valid_ = false;
+  }
+  return *this;
+}
+
+HostWorkspace::HostWorkspace(HostWorkspace &&other) = default;
+
+HostWorkspace &HostWorkspace::operator=(HostWorkspace &&other) = default;
+
+void HostWorkspace::PrepareSamples(int batch_size) {
+  if (samples_valid_ && samples_version_ == layout_version_ &&
+      static_cast<int>(samples_.size()) == batch_size)
+    return;
+  samples_.resize(batch_size);
+  for (int data_idx = 0; data_idx < batch_size; data_idx++) {
+    if (!samples_[data_idx])
+      samples_[data_idx].reset(new SampleWorkspace());
+    GetSample(samples_[data_idx].get(), data_idx, 0);
+  }
+  samples_version_ = layout_version_;
+  samples_valid_ = true;
+}
+
+SampleWorkspace &HostWorkspace::GetSample(int data_idx, int thread_idx) {
+  DALI_ENFORCE(samples_valid_ && samples_version_ == layout_version_,
+               "Per-sample workspaces are not prepared. Call PrepareSamples first.");
+  DALI_ENFORCE_VALID_INDEX(data_idx, samples_.size());
+  auto &sample = *samples_[data_idx];
+  sample.set_thread_idx(thread_idx);
+  return sample;
+}
+
 void HostWorkspace::GetSample(SampleWorkspace* ws, int data_idx, int thread_idx) {
   DALI_ENFORCE(ws != nullptr, "Input workspace is nullptr.");
   ws->Clear();
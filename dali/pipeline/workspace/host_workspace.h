@@ -45,8 +45,17 @@ class DLL_PUBLIC HostWorkspace : public WorkspaceBase<HostInputType, HostOutputT
   using WorkspaceBase<HostInputType, HostOutputType>::input_t;
   using WorkspaceBase<HostInputType, HostOutputType>::output_t;
 
-  DLL_PUBLIC inline HostWorkspace() {}
-  DLL_PUBLIC inline ~HostWorkspace() override = default;
+  DLL_PUBLIC HostWorkspace();
+  DLL_PUBLIC ~HostWorkspace() override;
+
+  /**
+   * @brief Copies the inputs, outputs and the thread pool; the per-sample views
+   * are not shared and are rebuilt by the copy when needed.
+   */
+  DLL_PUBLIC HostWorkspace(const HostWorkspace &other);
+  DLL_PUBLIC HostWorkspace &operator=(const HostWorkspace &other);
+  DLL_PUBLIC HostWorkspace(HostWorkspace &&other);
+  DLL_PUBLIC HostWorkspace &operator=(HostWorkspace &&other);
 
   /**
    * @brief Returns a sample workspace for the given sample
@@ -54,6 +63,25 @@ class DLL_PUBLIC HostWorkspace : public WorkspaceBase<HostInputType, HostOutputT
    */
   DLL_PUBLIC void GetSample(SampleWorkspace *ws, int data_idx, int thread_idx);
 
+  /**
+   * @brief Builds the per-sample views of this workspace for `batch_size` samples.
+   *
+   * The views are rebuilt only when the inputs, outputs or argument inputs of the workspace
+   * have changed since the last call, so for workspaces kept across iterations this
+   * happens once. Must be called from a single thread, before `GetSample(data_idx, thread_idx)`
+   * is used concurrently.
+   */
+  DLL_PUBLIC void PrepareSamples(int batch_size);
+
+  /**
+   * @brief Returns the prepared per-sample view for the given sample, with its
+   * thread index set to `thread_idx`.
+   *
+   * Unlike `GetSample(SampleWorkspace*, ...)`, this does not copy the tensor handles,
+   * so it doesn't touch any reference counts. Different `data_idx` may be used concurrently.
+   */
+  DLL_PUBLIC SampleWorkspace &GetSample(int data_idx, int thread_idx);
+
   /**
    * @brief Returns the number of Tensors in the input set of
    * tensors at the given index.
@@ -110,6 +138,11 @@ class DLL_PUBLIC HostWorkspace : public WorkspaceBase<HostInputType, HostOutputT
   }
 
   ThreadPool* thread_pool_ = nullptr;
+
+  std::vector<std::unique_ptr<SampleWorkspace>> samples_;
+  // layout_version_ the per-sample views were built for
+  unsigned samples_version_ = 0;
+  bool samples_valid_ = false;
 };
 
 }  // namespace dali
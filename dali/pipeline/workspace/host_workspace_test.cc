@@ -0,0 +1,63 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <memory>
+
+#include "dali/pipeline/workspace/host_workspace.h"
+#include "dali/pipeline/workspace/sample_workspace.h"
+
+namespace dali {
+
+TEST(HostWorkspace, SampleWorkspacesAreReused) {
+  const int batch_size = 3;
+  auto input = std::make_shared<TensorVector<CPUBackend>>(batch_size);
+  auto output = std::make_shared<TensorVector<CPUBackend>>(batch_size);
+  HostWorkspace ws;
+  ws.AddInput(input);
+  ws.AddOutput(output);
+
+  ws.PrepareSamples(batch_size);
+  SampleWorkspace *first = &ws.GetSample(1, 2);
+  EXPECT_EQ(first->data_idx(), 1);
+  EXPECT_EQ(first->thread_idx(), 2);
+  EXPECT_EQ(&first->Input<CPUBackend>(0), &(*input)[1]);
+  EXPECT_EQ(&first->Output<CPUBackend>(0), &(*output)[1]);
+
+  ws.PrepareSamples(batch_size);
+  EXPECT_EQ(&ws.GetSample(1, 0), first);
+  EXPECT_EQ(first->thread_idx(), 0);
+}
+
+TEST(HostWorkspace, SampleWorkspacesFollowInputChanges) {
+  const int batch_size = 2;
+  auto input = std::make_shared<TensorVector<CPUBackend>>(batch_size);
+  auto other = std::make_shared<TensorVector<CPUBackend>>(batch_size);
+  HostWorkspace ws;
+  ws.AddInput(input);
+  ws.PrepareSamples(batch_size);
+
+  ws.SetInput(0, other);
+  EXPECT_THROW(ws.GetSample(0, 0), std::runtime_error);
+  ws.PrepareSamples(batch_size);
+  EXPECT_EQ(&ws.GetSample(0, 0).Input<CPUBackend>(0), &(*other)[0]);
+
+  HostWorkspace copy = ws;
+  EXPECT_THROW(copy.GetSample(0, 0), std::runtime_error);
+  copy.PrepareSamples(batch_size);
+  EXPECT_NE(&copy.GetSample(0, 0), &ws.GetSample(0, 0));
+}
+
+}  // namespace dali
@@ -48,16 +48,19 @@ class ArgumentWorkspace {
 
   inline void Clear() {
     argument_inputs_.clear();
+    layout_version_++;
   }
 
   void AddArgumentInput(shared_ptr<TensorList<CPUBackend>> input, const std::string &arg_name) {
     argument_inputs_[arg_name] = std::move(input);
+    layout_version_++;
   }
 
   void SetArgumentInput(shared_ptr<TensorList<CPUBackend>> input, const std::string &arg_name) {
     DALI_ENFORCE(argument_inputs_.find(arg_name) != argument_inputs_.end(),
         "Argument \"" + arg_name + "\" not found.");
     argument_inputs_[arg_name] = std::move(input);
+    layout_version_++;
   }
 
   const TensorList<CPUBackend>& ArgumentInput(const std::string &arg_name) const {
@@ -69,6 +72,10 @@ class ArgumentWorkspace {
  protected:
   // Argument inputs
   std::unordered_map<std::string, shared_ptr<TensorList<CPUBackend>>> argument_inputs_;
+
+  // Bumped whenever inputs, outputs or argument inputs are added, replaced or cleared,
+  // so that derived workspaces can tell when data cached from them is stale
+  unsigned layout_version_ = 0;
 };
 
 /**
@@ -319,6 +326,7 @@ class WorkspaceBase : public ArgumentWorkspace {
                  StorageDevice storage_device) {
     // Save the vector of tensors
     vec->push_back(entry);
+    layout_version_++;
 
     // Update the input index map
     index_map->emplace_back(storage_device, vec->size()-1);
@@ -361,6 +369,7 @@ class WorkspaceBase : public ArgumentWorkspace {
 
     // Now we insert the new input and update its meta data
     vec->push_back(entry);
+    layout_version_++;
     index->push_back(idx);
     (*index_map)[idx] = InOutMeta(storage_device, vec->size()-1);
   }
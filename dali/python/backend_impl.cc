@@ -20,7 +20,9 @@
 #include "dali/pipeline/pipeline.h"
 #include "dali/pipeline/data/tensor.h"
 #include "dali/pipeline/data/tensor_list.h"
+#include "dali/pipeline/operators/python_function/util/copy_with_stride.h"
 #include "dali/python/python3_compat.h"
+#include "dali/util/file_cache.h"
 #include "dali/util/user_stream.h"
 #include "dali/pipeline/operators/reader/parser/tfrecord_parser.h"
 #include "dali/plugin/copy.h"
@@ -46,6 +48,19 @@ static void* ctypes_void_ptr(const py::object& object) {
   return ptr;
 }
 
+/**
+ * @brief Checks whether the buffer is C-contiguous and can be wrapped without a copy
+ */
+static bool IsDense(const py::buffer_info &info) {
+  ssize_t dim_prod = 1;
+  for (int i = info.strides.size()-1; i >= 0; --i) {
+    if (info.shape[i] != 1 && info.strides[i] != info.itemsize*dim_prod)
+      return false;
+    dim_prod *= info.shape[i];
+  }
+  return true;
+}
+
 template <int ndim>
 py::list as_py_list(const kernels::TensorShape<ndim> &shape) {
   py::list ret(shape.size());
@@ -97,19 +112,18 @@ void ExposeTensor(py::module &m) { // NOLINT
           }
           size_t bytes = volume(i_shape) * info.itemsize;
 
-          // Validate the stride
-          ssize_t dim_prod = 1;
-          for (int i = info.strides.size()-1; i >= 0; --i) {
-            DALI_ENFORCE(info.strides[i] == info.itemsize*dim_prod,
-                "Strided data not supported. Detected on dimension " + std::to_string(i));
-            dim_prod *= info.shape[i];
-          }
-
           // Create the Tensor and wrap the data
           auto t = new Tensor<CPUBackend>;
           TypeInfo type = TypeFromFormatStr(info.format);
-          t->ShareData(info.ptr, bytes);
-          t->set_type(type);
+          if (IsDense(info)) {
+            t->ShareData(info.ptr, bytes);
+            t->set_type(type);
+          } else {
+            t->set_type(type);
+            t->Resize(i_shape);
+            CopyWithStride<CPUBackend>(t->raw_mutable_data(), info.ptr, info.strides.data(),
+                                       info.shape.data(), info.ndim, info.itemsize);
+          }
           t->SetLayout(layout);
           t->Resize(i_shape);
           return t;
@@ -208,19 +222,18 @@ void ExposeTensorList(py::module &m) { // NOLINT
           auto i_shape = kernels::uniform_list_shape(info.shape[0], tensor_shape);
           size_t bytes = volume(tensor_shape)*i_shape.size()*info.itemsize;
 
-          // Validate the stride
-          ssize_t dim_prod = 1;
-          for (int i = info.strides.size()-1; i >= 0; --i) {
-            DALI_ENFORCE(info.strides[i] == info.itemsize*dim_prod,
-                "Strided data not supported. Detected on dimension " + std::to_string(i));
-            dim_prod *= info.shape[i];
-          }
-
           // Create the Tensor and wrap the data
           auto t = new TensorList<CPUBackend>;
           TypeInfo type = TypeFromFormatStr(info.format);
-          t->ShareData(info.ptr, bytes);
-          t->set_type(type);
+          if (IsDense(info)) {
+            t->ShareData(info.ptr, bytes);
+            t->set_type(type);
+          } else {
+            t->set_type(type);
+            t->Resize(i_shape);
+            CopyWithStride<CPUBackend>(t->raw_mutable_data(), info.ptr, info.strides.data(),
+                                       info.shape.data(), info.ndim, info.itemsize);
+          }
           t->SetLayout(layout);
           t->Resize(i_shape);
           return t;
@@ -510,6 +523,21 @@ PYBIND11_MODULE(backend_impl, m) {
 
   m.def("GetCxx11AbiFlag", &GetCxx11AbiFlag);
 
+  // Statistics of the local file cache, None if DALI_FILE_CACHE_DIR is not set
+  m.def("GetFileCacheStats", []() -> py::object {
+    FileCache *cache = FileCache::Instance();
+    if (!cache)
+      return py::none();
+    auto stats = cache->GetStats();
+    py::dict d;
+    d["hits"] = stats.hits;
+    d["misses"] = stats.misses;
+    d["hit_bytes"] = stats.hit_bytes;
+    d["miss_bytes"] = stats.miss_bytes;
+    d["evicted_bytes"] = stats.evicted_bytes;
+    return d;
+  });
+
   // Types
   py::module types_m = m.def_submodule("types");
   types_m.doc() = "Datatypes and options used by DALI";
@@ -743,6 +771,62 @@ PYBIND11_MODULE(backend_impl, m) {
           DALI_ENFORCE(sizes.find(op_name) != sizes.end(),
               "Operator " + op_name + " does not expose valid epoch size.");
           return sizes[op_name];
+        })
+    .def("EnableProfiling", &Pipeline::EnableProfiling)
+    .def("ProfilerTrace", &Pipeline::ProfilerTrace)
+    .def("ResetProfiler", &Pipeline::ResetProfiler)
+    .def("ProfilerStatistics",
+        [](Pipeline* p) {
+          py::dict result;
+          for (auto &entry : p->ProfilerStatistics()) {
+            auto &stats = entry.second;
+            result[py::str(entry.first)] = py::dict(
+                "count"_a = stats.count, "total_us"_a = stats.total_us,
+                "min_us"_a = stats.min_us, "max_us"_a = stats.max_us);
+          }
+          return result;
+        })
+    .def("SetMemoryBudget", &Pipeline::SetMemoryBudget)
+    .def("MemoryUsage",
+        [](Pipeline* p) {
+          auto stats_to_dict = [](const MemoryStats &stats) {
+            return py::dict(
+                "host"_a = stats.Current(MemoryKind::Host),
+                "pinned"_a = stats.Current(MemoryKind::Pinned),
+                "gpu"_a = stats.Current(MemoryKind::GPU),
+                "peak_host"_a = stats.Peak(MemoryKind::Host),
+                "peak_pinned"_a = stats.Peak(MemoryKind::Pinned),
+                "peak_gpu"_a = stats.Peak(MemoryKind::GPU));
+          };
+          py::dict by_op;
+          for (auto &entry : p->MemoryUsageByOperator()) {
+            by_op[py::str(entry.first)] = stats_to_dict(entry.second);
+          }
+          return py::dict("total"_a = stats_to_dict(p->MemoryUsage()), "operators"_a = by_op);
+        })
+    .def("EnableAutotune", &Pipeline::EnableAutotune,
+        "enabled"_a = true, "min_queue_depth"_a = 1, "min_threads"_a = 1)
+    .def("AutotuneLog",
+        [](Pipeline* p) {
+          py::list result;
+          for (auto &decision : p->AutotuneLog()) {
+            result.append(py::dict(
+                "iteration"_a = decision.iteration, "queue_depth"_a = decision.queue_depth,
+                "num_threads"_a = decision.num_threads, "reason"_a = decision.reason));
+          }
+          return result;
+        })
+    .def("EnableOperatorFusion", &Pipeline::EnableOperatorFusion,
+        "enabled"_a = true, "patterns"_a = std::vector<std::string>{}, "verbose"_a = false)
+    .def("FusionLog",
+        [](Pipeline* p) {
+          py::list result;
+          for (auto &record : p->FusionLog()) {
+            result.append(py::dict(
+                "pattern"_a = record.pattern, "replaced"_a = record.replaced,
+                "fused_op"_a = record.fused_op));
+          }
+          return result;
         });
 
 #define DALI_OPSPEC_ADDARG(T) \
@@ -94,6 +94,8 @@ DEPS_LIST=(
     "/usr/local/lib/libavfilter.so.6"
     "/usr/local/lib/libavutil.so.55"
     "/usr/local/lib/libtiff.so.5"
+    "/usr/local/lib/libpng16.so.16"
+    "/usr/local/lib/libwebp.so.7"
 )
 
 DEPS_SONAME=(
@@ -103,6 +105,8 @@ DEPS_SONAME=(
     "libavfilter.so.6"
     "libavutil.so.55"
     "libtiff.so.5"
+    "libpng16.so.16"
+    "libwebp.so.7"
 )
 
 TMPDIR=$(mktemp -d)
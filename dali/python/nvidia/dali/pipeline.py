@@ -80,11 +80,40 @@ class Pipeline(object):
         unrestricted number of streams is assumed).
     `default_cuda_stream_priority` : int, optional, default = 0
         CUDA stream priority used by DALI. See `cudaStreamCreateWithPriority` in CUDA documentation
+    `enable_profiling` : bool, optional, default = False
+        Whether to record wall time of pipeline stages, operators, thread pool tasks,
+        queue waits and reader stalls. See :meth:`nvidia.dali.pipeline.Pipeline.profiler_stats`
+        and :meth:`nvidia.dali.pipeline.Pipeline.save_profiler_trace`.
+    `autotune` : bool, optional, default = False
+        Whether to adjust the cpu prefetch queue depth and the number of active CPU
+        threads at runtime, based on how long the consumer waits for outputs and how long
+        the CPU stage waits for free buffers. The values never exceed `prefetch_queue_depth`
+        and `num_threads`. See :meth:`nvidia.dali.pipeline.Pipeline.autotune_log`.
+    `fuse_operators` : bool or list of str, optional, default = False
+        Whether to replace chains of operators with their fused equivalents when the pipeline
+        is built, e.g. `ImageDecoder` followed by `Crop` with `ImageDecoderCrop`. `True` applies
+        the rewrites which don't change the results; a list selects the rewrites by name
+        (``decoder_crop_flip``, ``decoder_crop``, ``decoder_slice``,
+        ``decoder_random_resized_crop``, ``crop_mirror_normalize``, ``resize_crop_mirror``).
+        ``decoder_random_resized_crop`` and ``resize_crop_mirror`` may change the results
+        slightly and are only applied when listed.
+        See :meth:`nvidia.dali.pipeline.Pipeline.fusion_log`.
+    `host_memory_budget` : int, optional, default = 0
+        Maximum number of bytes of host (including pinned) memory the pipeline may allocate.
+        When exceeded, the pipeline reduces prefetching (with `exec_async` only, until the usage
+        drops back) and frees idle reader buffers before failing.
+        Value of 0 does not impose a limit.
+        See :meth:`nvidia.dali.pipeline.Pipeline.memory_usage`.
+    `gpu_memory_budget` : int, optional, default = 0
+        Maximum number of bytes of GPU memory the pipeline may allocate.
+        Value of 0 does not impose a limit.
     """
     def __init__(self, batch_size = -1, num_threads = -1, device_id = -1, seed = -1,
                  exec_pipelined=True, prefetch_queue_depth=2,
                  exec_async=True, bytes_per_sample=0,
-                 set_affinity=False, max_streams=-1, default_cuda_stream_priority = 0):
+                 set_affinity=False, max_streams=-1, default_cuda_stream_priority = 0,
+                 enable_profiling=False, autotune=False, fuse_operators=False,
+                 host_memory_budget=0, gpu_memory_budget=0):
         self._sinks = []
         self._batch_size = batch_size
         self._num_threads = num_threads
@@ -104,6 +133,11 @@ class Pipeline(object):
         self._set_affinity = set_affinity
         self._max_streams = max_streams
         self._default_cuda_stream_priority = default_cuda_stream_priority
+        self._enable_profiling = enable_profiling
+        self._autotune = autotune
+        self._fuse_operators = fuse_operators
+        self._host_memory_budget = host_memory_budget
+        self._gpu_memory_budget = gpu_memory_budget
         self._api_type = None
         self._skip_api_check = False
         if type(prefetch_queue_depth) is dict:
@@ -236,6 +270,10 @@ class Pipeline(object):
                                 self._default_cuda_stream_priority)
         self._pipe.SetExecutionTypes(self._exec_pipelined, self._exec_separated, self._exec_async)
         self._pipe.SetQueueSizes(self._cpu_queue_size, self._gpu_queue_size)
+        self._pipe.EnableProfiling(self._enable_profiling)
+        self._pipe.EnableAutotune(self._autotune)
+        self._enable_operator_fusion()
+        self._pipe.SetMemoryBudget(self._host_memory_budget, self._gpu_memory_budget)
         prev_pipeline = Pipeline.set_current(self)
         outputs = self.define_graph()
         Pipeline.set_current(prev_pipeline)
@@ -559,6 +597,10 @@ class Pipeline(object):
                                 self._default_cuda_stream_priority)
         self._pipe.SetExecutionTypes(self._exec_pipelined, self._exec_separated, self._exec_async)
         self._pipe.SetQueueSizes(self._cpu_queue_size, self._gpu_queue_size)
+        self._pipe.EnableProfiling(self._enable_profiling)
+        self._pipe.EnableAutotune(self._autotune)
+        self._enable_operator_fusion()
+        self._pipe.SetMemoryBudget(self._host_memory_budget, self._gpu_memory_budget)
         self._prepared = True
         self._pipe.Build()
         self._built = True
@@ -575,6 +617,72 @@ class Pipeline(object):
             raise RuntimeError("Pipeline must be built first.")
         self._pipe.SaveGraphToDotFile(filename)
 
+    def profiler_stats(self):
+        """Returns the timing recorded by the pipeline profiler.
+
+        The result is a dictionary keyed ``"category/name"``, where category is one of
+        ``stage``, ``op``, ``task``, ``task_wait``, ``queue_wait``, ``output_wait``
+        or ``reader_stall`` and name is the stage or operator name. Each value is
+        a dictionary with ``count``, ``total_us``, ``min_us`` and ``max_us``.
+        Profiling needs to be enabled with the `enable_profiling` argument.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        return self._pipe.ProfilerStatistics()
+
+    def save_profiler_trace(self, filename):
+        """Saves the events recorded by the pipeline profiler in Chrome trace
+        format, which can be opened with chrome://tracing.
+
+        Parameters
+        ----------
+        filename : str
+                   Name of the file to which the trace is written.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        with open(filename, "w") as f:
+            f.write(self._pipe.ProfilerTrace())
+
+    def reset_profiler(self):
+        """Discards the events and statistics recorded so far by the pipeline profiler."""
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        self._pipe.ResetProfiler()
+
+    def autotune_log(self):
+        """Returns the decisions made so far by the autotuner as a list of dictionaries
+        with ``iteration``, ``queue_depth``, ``num_threads`` and ``reason``."""
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        return self._pipe.AutotuneLog()
+
+    def fusion_log(self):
+        """Returns the operator chains replaced by fused operators when the pipeline was built,
+        as a list of dictionaries with ``pattern``, ``replaced`` (names of the replaced
+        operators) and ``fused_op``."""
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        return self._pipe.FusionLog()
+
+    def _enable_operator_fusion(self):
+        if isinstance(self._fuse_operators, (list, tuple)):
+            self._pipe.EnableOperatorFusion(True, list(self._fuse_operators))
+        else:
+            self._pipe.EnableOperatorFusion(bool(self._fuse_operators))
+
+    def memory_usage(self):
+        """Returns the memory allocated by the pipeline.
+
+        The result is a dictionary with ``total`` usage and ``operators``, a dictionary
+        of the usage of each operator. Usage is a dictionary with the current number of bytes
+        of ``host``, ``pinned`` and ``gpu`` memory and their peaks: ``peak_host``,
+        ``peak_pinned`` and ``peak_gpu``.
+        """
+        if not self._built:
+            raise RuntimeError("Pipeline must be built first.")
+        return self._pipe.MemoryUsage()
+
     def define_graph(self):
         """This function is defined by the user to construct the
         graph of operations for their pipeline.
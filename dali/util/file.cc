@@ -13,20 +13,89 @@
 // limitations under the License.
 
 
+#include <cctype>
+#include <map>
+#include <mutex>
 #include <string>
+#include <utility>
 
+#include "dali/core/error_handling.h"
 #include "dali/util/file.h"
+#include "dali/util/file_cache.h"
+#include "dali/util/http_file.h"
 #include "dali/util/local_file.h"
 
 namespace dali {
 
-std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_ahead) {
-  if (uri.find("file://") == 0) {
-    return std::unique_ptr<FileStream>(
+namespace {
+
+std::mutex &SchemeRegistryMutex() {
+  static std::mutex mutex;
+  return mutex;
+}
+
+std::map<std::string, FileStream::Factory> &SchemeRegistry() {
+  static std::map<std::string, FileStream::Factory> registry = {
+    { "file", [](const std::string& uri, bool read_ahead) {
+        return std::unique_ptr<FileStream>(
             new LocalFileStream(uri.substr(std::string("file://").size()), read_ahead));
-  } else {
+      } },
+    { "http", [](const std::string& uri, bool read_ahead) {
+        return std::unique_ptr<FileStream>(new HttpFileStream(uri, read_ahead));
+      } },
+    { "s3", [](const std::string& uri, bool read_ahead) {
+        return std::unique_ptr<FileStream>(new HttpFileStream(S3UriToHttp(uri), read_ahead));
+      } },
+  };
+  return registry;
+}
+
+/**
+ * @brief Returns the scheme of the URI or an empty string for plain paths
+ */
+std::string UriScheme(const std::string& uri) {
+  auto pos = uri.find("://");
+  if (pos == std::string::npos || pos == 0)
+    return {};
+  for (size_t i = 0; i < pos; i++) {
+    char c = uri[i];
+    if (!std::isalnum(c) && c != '+' && c != '-' && c != '.')
+      return {};
+  }
+  return uri.substr(0, pos);
+}
+
+std::unique_ptr<FileStream> OpenUncached(const std::string& uri, bool read_ahead) {
+  std::string scheme = UriScheme(uri);
+  if (scheme.empty()) {
     return std::unique_ptr<FileStream>(new LocalFileStream(uri, read_ahead));
   }
+  FileStream::Factory factory;
+  {
+    std::lock_guard<std::mutex> lock(SchemeRegistryMutex());
+    auto &registry = SchemeRegistry();
+    auto it = registry.find(scheme);
+    DALI_ENFORCE(it != registry.end(), "Unsupported URI scheme `" + scheme + "`: " + uri);
+    factory = it->second;
+  }
+  return factory(uri, read_ahead);
+}
+
+}  // namespace
+
+std::unique_ptr<FileStream> FileStream::Open(const std::string& uri, bool read_ahead) {
+  FileCache *cache = FileCache::Instance();
+  if (cache && cache->ShouldCache(uri)) {
+    // the cache reads in blocks, reading the whole file ahead would defeat it
+    return std::unique_ptr<FileStream>(new CachingFileStream(
+        cache, uri, FileCache::Identity(uri), [uri]() { return OpenUncached(uri, false); }));
+  }
+  return OpenUncached(uri, read_ahead);
+}
+
+void FileStream::RegisterScheme(const std::string& scheme, Factory factory) {
+  std::lock_guard<std::mutex> lock(SchemeRegistryMutex());
+  SchemeRegistry()[scheme] = std::move(factory);
 }
 
 bool FileStream::ReserveFileMappings(unsigned int num) {
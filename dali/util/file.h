@@ -16,6 +16,7 @@
 #define DALI_UTIL_FILE_H_
 
 #include <cstdio>
+#include <functional>
 #include <string>
 #include <memory>
 
@@ -70,13 +71,33 @@ class DLL_PUBLIC FileStream {
    private:
      unsigned int reserved;
   };
+  using Factory = std::function<std::unique_ptr<FileStream>(const std::string& uri,
+                                                            bool read_ahead)>;
+
+  /**
+   * @brief Opens the stream for `uri`.
+   *
+   * The stream type is selected by the URI scheme (e.g. `http://`), paths without a scheme
+   * and `file://` URIs are local files. `http` and `s3` are available by default.
+   */
   static std::unique_ptr<FileStream> Open(const std::string& uri, bool read_ahead);
 
+  /**
+   * @brief Makes `Open` use `factory` for URIs starting with `scheme://`.
+   *        The factory receives the complete URI.
+   */
+  static void RegisterScheme(const std::string& scheme, Factory factory);
+
   virtual void Close() = 0;
   virtual size_t Read(uint8_t * buffer, size_t n_bytes) = 0;
   virtual shared_ptr<void>  Get(size_t n_bytes) = 0;
   virtual void Seek(int64 pos) = 0;
   virtual size_t Size() const = 0;
+  /**
+   * @brief Hints that `n_bytes` starting at `pos` are going to be read soon.
+   *        Streams which can't make use of it ignore it.
+   */
+  virtual void ReadAhead(int64 pos, size_t n_bytes) {}
   virtual ~FileStream() {}
 
  protected:
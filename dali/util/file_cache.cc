@@ -0,0 +1,469 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include "dali/util/file_cache.h"
+
+#include <dirent.h>
+#include <fcntl.h>
+#include <sys/file.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cerrno>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+
+namespace dali {
+
+constexpr size_t CachingFileStream::kBlockSize;
+
+namespace {
+
+constexpr int64_t kDefaultCapacity = 10ll << 30;
+// after eviction the cache is filled to this fraction of the capacity, so that every insertion
+// doesn't trigger a directory scan
+constexpr double kEvictionWatermark = 0.9;
+
+uint64_t Fnv1a(const std::string &s, uint64_t hash) {
+  for (unsigned char c : s) {
+    hash ^= c;
+    hash *= 0x100000001b3ull;
+  }
+  return hash;
+}
+
+std::string Hex(uint64_t value) {
+  char buf[17];
+  snprintf(buf, sizeof(buf), "%016llx", static_cast<unsigned long long>(value));  // NOLINT
+  return buf;
+}
+
+bool ReadAll(int fd, void *buffer, size_t n, off_t offset) {
+  auto *out = static_cast<uint8_t *>(buffer);
+  while (n > 0) {
+    ssize_t r = pread(fd, out, n, offset);
+    if (r < 0 && errno == EINTR)
+      continue;
+    if (r <= 0)
+      return false;
+    out += r;
+    offset += r;
+    n -= r;
+  }
+  return true;
+}
+
+bool WriteAll(int fd, const void *data, size_t n, off_t offset) {
+  auto *in = static_cast<const uint8_t *>(data);
+  while (n > 0) {
+    ssize_t r = pwrite(fd, in, n, offset);
+    if (r < 0 && errno == EINTR)
+      continue;
+    if (r <= 0)
+      return false;
+    in += r;
+    offset += r;
+    n -= r;
+  }
+  return true;
+}
+
+bool IsLocal(const std::string &uri) {
+  return uri.find("://") == std::string::npos || uri.compare(0, 7, "file://") == 0;
+}
+
+std::string LocalPath(const std::string &uri) {
+  return uri.compare(0, 7, "file://") == 0 ? uri.substr(7) : uri;
+}
+
+/**
+ * @brief Holds both the in-process mutex and the inter-process file lock.
+ *        `flock` alone doesn't exclude threads sharing the file descriptor.
+ */
+class CacheLock {
+ public:
+  CacheLock(std::mutex &mutex, int fd) : lock_(mutex), fd_(fd) {
+    while (flock(fd_, LOCK_EX) != 0 && errno == EINTR) {}
+  }
+  ~CacheLock() {
+    flock(fd_, LOCK_UN);
+  }
+
+ private:
+  std::lock_guard<std::mutex> lock_;
+  int fd_;
+};
+
+}  // namespace
+
+FileCache::FileCache(const std::string &dir, int64_t capacity,
+                     std::vector<std::string> local_prefixes)
+    : dir_(dir), capacity_(capacity), local_prefixes_(std::move(local_prefixes)) {
+  DALI_ENFORCE(capacity_ > 0, "File cache capacity must be positive");
+  while (dir_.size() > 1 && dir_.back() == '/')
+    dir_.pop_back();
+  for (auto path : { dir_, dir_ + "/tmp" }) {
+    DALI_ENFORCE(mkdir(path.c_str(), 0755) == 0 || errno == EEXIST,
+                 "Could not create file cache directory " + path + ": " + strerror(errno));
+  }
+  std::string lock_path = dir_ + "/lock";
+  lock_fd_ = open(lock_path.c_str(), O_RDWR | O_CREAT, 0644);
+  DALI_ENFORCE(lock_fd_ >= 0, "Could not open " + lock_path + ": " + strerror(errno));
+
+  CacheLock lock(lock_mutex_, lock_fd_);
+  struct stat st;
+  if (fstat(lock_fd_, &st) != 0 || st.st_size < static_cast<off_t>(sizeof(int64_t))) {
+    // new or damaged cache - recount whatever is there
+    EvictLocked();
+  }
+}
+
+FileCache::~FileCache() {
+  if (lock_fd_ >= 0)
+    close(lock_fd_);
+}
+
+FileCache *FileCache::Instance() {
+  static std::unique_ptr<FileCache> instance = []() -> std::unique_ptr<FileCache> {
+    const char *dir = std::getenv("DALI_FILE_CACHE_DIR");
+    if (!dir || !*dir)
+      return nullptr;
+    int64_t capacity = kDefaultCapacity;
+    if (const char *size = std::getenv("DALI_FILE_CACHE_SIZE"))
+      capacity = ParseCapacity(size);
+    std::vector<std::string> prefixes;
+    if (const char *paths = std::getenv("DALI_FILE_CACHE_PATHS")) {
+      std::string list = paths;
+      size_t start = 0;
+      while (start <= list.size()) {
+        size_t end = std::min(list.find(':', start), list.size());
+        if (end > start)
+          prefixes.push_back(list.substr(start, end - start));
+        start = end + 1;
+      }
+    }
+    return std::unique_ptr<FileCache>(new FileCache(dir, capacity, std::move(prefixes)));
+  }();
+  return instance.get();
+}
+
+int64_t FileCache::ParseCapacity(const std::string &value) {
+  const char *str = value.c_str();
+  char *end = nullptr;
+  errno = 0;
+  long long capacity = std::strtoll(str, &end, 10);  // NOLINT
+  DALI_ENFORCE(end != str && *end == '\0',
+               "DALI_FILE_CACHE_SIZE must be a number of bytes, got \"" + value + "\"");
+  DALI_ENFORCE(errno != ERANGE, "DALI_FILE_CACHE_SIZE is out of range: " + value);
+  DALI_ENFORCE(capacity > 0, "DALI_FILE_CACHE_SIZE must be positive, got " + value);
+  return capacity;
+}
+
+bool FileCache::ShouldCache(const std::string &uri) const {
+  if (!IsLocal(uri))
+    return true;
+  std::string path = LocalPath(uri);
+  for (auto &prefix : local_prefixes_) {
+    if (path.compare(0, prefix.size(), prefix) == 0)
+      return true;
+  }
+  return false;
+}
+
+std::string FileCache::Identity(const std::string &uri) {
+  if (!IsLocal(uri))
+    return uri;
+  struct stat st;
+  if (stat(LocalPath(uri).c_str(), &st) != 0)
+    return uri;
+  return uri + "\n" + std::to_string(st.st_size) + "\n" + std::to_string(st.st_mtim.tv_sec) +
+         "." + std::to_string(st.st_mtim.tv_nsec);
+}
+
+std::string FileCache::EntryPath(const std::string &key) const {
+  // two differently seeded 64-bit hashes, so that collisions are not a practical concern
+  std::string name = Hex(Fnv1a(key, 0xcbf29ce484222325ull)) +
+                     Hex(Fnv1a(key, 0x84222325cbf29ce4ull));
+  return dir_ + "/" + name.substr(0, 2) + "/" + name.substr(2);
+}
+
+bool FileCache::Lookup(const std::string &key, size_t entry_size, size_t offset,
+                       void *buffer, size_t n) {
+  DALI_ENFORCE(offset + n <= entry_size, "Lookup past the end of a file cache entry");
+  int fd = open(EntryPath(key).c_str(), O_RDONLY);
+  bool hit = false;
+  if (fd >= 0) {
+    struct stat st;
+    hit = fstat(fd, &st) == 0 && st.st_size == static_cast<off_t>(entry_size) &&
+          ReadAll(fd, buffer, n, offset);
+    if (hit) {
+      // refresh the LRU timestamp
+      futimens(fd, nullptr);
+    }
+    close(fd);
+  }
+  if (hit) {
+    hits_++;
+    hit_bytes_ += n;
+  } else {
+    misses_++;
+    miss_bytes_ += n;
+  }
+  return hit;
+}
+
+void FileCache::Insert(const std::string &key, const void *data, size_t n) {
+  // The cache is best-effort: failing to store an entry (e.g. full disk) is not an error.
+  std::string path = EntryPath(key);
+  std::string subdir = path.substr(0, path.rfind('/'));
+  if (mkdir(subdir.c_str(), 0755) != 0 && errno != EEXIST)
+    return;
+  std::string tmp = dir_ + "/tmp/" + std::to_string(getpid()) + "." +
+                    std::to_string(tmp_counter_++);
+  int fd = open(tmp.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644);
+  if (fd < 0)
+    return;
+  bool written = WriteAll(fd, data, n, 0);
+  close(fd);
+  if (!written) {
+    unlink(tmp.c_str());
+    return;
+  }
+
+  CacheLock lock(lock_mutex_, lock_fd_);
+  struct stat st;
+  if (stat(path.c_str(), &st) == 0 || rename(tmp.c_str(), path.c_str()) != 0) {
+    // already inserted by someone else
+    unlink(tmp.c_str());
+    return;
+  }
+  int64_t size = ReadSize() + n;
+  WriteSize(size);
+  if (size > capacity_)
+    EvictLocked();
+}
+
+void FileCache::Evict() {
+  CacheLock lock(lock_mutex_, lock_fd_);
+  EvictLocked();
+}
+
+int64_t FileCache::ReadSize() const {
+  int64_t size = 0;
+  if (!ReadAll(lock_fd_, &size, sizeof(size), 0))
+    return 0;
+  return size;
+}
+
+void FileCache::WriteSize(int64_t size) {
+  WriteAll(lock_fd_, &size, sizeof(size), 0);
+}
+
+void FileCache::EvictLocked() {
+  struct Entry {
+    std::string path;
+    struct timespec mtime;
+    int64_t size;
+  };
+  std::vector<Entry> entries;
+  int64_t total = 0;
+
+  DIR *root = opendir(dir_.c_str());
+  if (!root)
+    return;
+  while (dirent *d = readdir(root)) {
+    // only the entry shards, e.g. "3f"
+    if (strlen(d->d_name) != 2 || !isxdigit(d->d_name[0]) || !isxdigit(d->d_name[1]))
+      continue;
+    std::string subdir = dir_ + "/" + d->d_name;
+    DIR *sub = opendir(subdir.c_str());
+    if (!sub)
+      continue;
+    while (dirent *e = readdir(sub)) {
+      if (e->d_name[0] == '.')
+        continue;
+      Entry entry;
+      entry.path = subdir + "/" + e->d_name;
+      struct stat st;
+      if (stat(entry.path.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+        continue;
+      entry.mtime = st.st_mtim;
+      entry.size = st.st_size;
+      total += entry.size;
+      entries.push_back(std::move(entry));
+    }
+    closedir(sub);
+  }
+  closedir(root);
+
+  if (total > capacity_) {
+    std::sort(entries.begin(), entries.end(), [](const Entry &a, const Entry &b) {
+      return a.mtime.tv_sec != b.mtime.tv_sec ? a.mtime.tv_sec < b.mtime.tv_sec
+                                              : a.mtime.tv_nsec < b.mtime.tv_nsec;
+    });
+    auto target = static_cast<int64_t>(capacity_ * kEvictionWatermark);
+    for (auto &entry : entries) {
+      if (total <= target)
+        break;
+      if (unlink(entry.path.c_str()) == 0) {
+        total -= entry.size;
+        evicted_bytes_ += entry.size;
+      }
+    }
+  }
+  WriteSize(total);
+}
+
+size_t FileCache::ObjectSize(const std::string &identity,
+                             const std::function<size_t()> &get_size) {
+  {
+    std::lock_guard<std::mutex> lock(sizes_mutex_);
+    auto it = sizes_.find(identity);
+    if (it != sizes_.end())
+      return it->second;
+  }
+  uint64_t size = 0;
+  std::string key = identity + "\nsize";
+  if (!Lookup(key, &size, sizeof(size))) {
+    size = get_size();
+    Insert(key, &size, sizeof(size));
+  }
+  std::lock_guard<std::mutex> lock(sizes_mutex_);
+  sizes_[identity] = size;
+  return size;
+}
+
+FileCacheStats FileCache::GetStats() const {
+  FileCacheStats stats;
+  stats.hits = hits_;
+  stats.misses = misses_;
+  stats.hit_bytes = hit_bytes_;
+  stats.miss_bytes = miss_bytes_;
+  stats.evicted_bytes = evicted_bytes_;
+  return stats;
+}
+
+CachingFileStream::CachingFileStream(FileCache *cache, const std::string &path,
+                                     const std::string &identity, StreamFactory open)
+    : FileStream(path), cache_(cache), identity_(identity), open_(std::move(open)) {
+  length_ = cache_->ObjectSize(identity_, [this]() { return Inner().Size(); });
+}
+
+FileStream &CachingFileStream::Inner() {
+  if (!inner_)
+    inner_ = open_();
+  return *inner_;
+}
+
+std::string CachingFileStream::BlockKey(size_t block) const {
+  return identity_ + "\n" + std::to_string(block);
+}
+
+void CachingFileStream::Close() {
+  if (inner_)
+    inner_->Close();
+  inner_.reset();
+}
+
+void CachingFileStream::ReadBlocks(uint8_t *buffer, size_t offset, size_t n_bytes) {
+  if (n_bytes == 0)
+    return;
+  size_t end = offset + n_bytes;
+  size_t first = offset / kBlockSize;
+  size_t last = (end - 1) / kBlockSize;
+  std::vector<uint8_t> staging;
+
+  // copies the part of [src_offset, src_offset + n) falling into the requested range
+  auto copy_out = [&](size_t src_offset, const uint8_t *src, size_t n) {
+    size_t from = std::max(src_offset, offset);
+    size_t to = std::min(src_offset + n, end);
+    memcpy(buffer + (from - offset), src + (from - src_offset), to - from);
+  };
+
+  // consecutive missing blocks are fetched with a single read
+  auto fetch = [&](size_t begin_block, size_t end_block) {
+    size_t start = begin_block * kBlockSize;
+    size_t len = std::min(end_block * kBlockSize, length_) - start;
+    staging.resize(len);
+    auto &inner = Inner();
+    inner.Seek(start);
+    DALI_ENFORCE(inner.Read(staging.data(), len) == len,
+                 "Could not read " + std::to_string(len) + " bytes at " + std::to_string(start) +
+                 " from " + path_);
+    for (size_t b = begin_block; b < end_block; b++) {
+      size_t block_start = (b - begin_block) * kBlockSize;
+      cache_->Insert(BlockKey(b), staging.data() + block_start,
+                     std::min(kBlockSize, len - block_start));
+    }
+    copy_out(start, staging.data(), len);
+  };
+
+  size_t miss_begin = last + 1;
+  for (size_t b = first; b <= last; b++) {
+    size_t block_start = b * kBlockSize;
+    size_t block_len = std::min(kBlockSize, length_ - block_start);
+    // only the requested part of a cached block is read
+    size_t from = std::max(block_start, offset);
+    size_t to = std::min(block_start + block_len, end);
+    if (cache_->Lookup(BlockKey(b), block_len, from - block_start, buffer + (from - offset),
+                       to - from)) {
+      if (miss_begin <= last) {
+        fetch(miss_begin, b);
+        miss_begin = last + 1;
+      }
+    } else if (miss_begin > last) {
+      miss_begin = b;
+    }
+  }
+  if (miss_begin <= last)
+    fetch(miss_begin, last + 1);
+}
+
+size_t CachingFileStream::Read(uint8_t *buffer, size_t n_bytes) {
+  n_bytes = std::min(n_bytes, length_ - pos_);
+  ReadBlocks(buffer, pos_, n_bytes);
+  pos_ += n_bytes;
+  return n_bytes;
+}
+
+shared_ptr<void> CachingFileStream::Get(size_t n_bytes) {
+  if (pos_ + n_bytes > length_) {
+    return nullptr;
+  }
+  std::shared_ptr<uint8_t> buffer(new uint8_t[n_bytes], std::default_delete<uint8_t[]>());
+  ReadBlocks(buffer.get(), pos_, n_bytes);
+  pos_ += n_bytes;
+  return buffer;
+}
+
+void CachingFileStream::Seek(int64 pos) {
+  // seeking to the end is valid, also for empty files
+  DALI_ENFORCE(pos >= 0 && pos <= (int64)length_, "Invalid seek");
+  pos_ = pos;
+}
+
+size_t CachingFileStream::Size() const {
+  return length_;
+}
+
+}  // namespace dali
@@ -0,0 +1,187 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_UTIL_FILE_CACHE_H_
+#define DALI_UTIL_FILE_CACHE_H_
+
+#include <atomic>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <unordered_map>
+#include <vector>
+
+#include "dali/core/api_helper.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+struct FileCacheStats {
+  int64_t hits = 0;
+  int64_t misses = 0;
+  int64_t hit_bytes = 0;
+  int64_t miss_bytes = 0;
+  int64_t evicted_bytes = 0;
+};
+
+/**
+ * @brief Size-bounded, node-local cache of file blocks, shared between processes.
+ *
+ * Entries are stored as `<dir>/<2 hex digits>/<30 hex digits>`: the 32 hex digits of a hash
+ * of the entry key, the first two of which name the subdirectory. Entries are written to
+ * a temporary file and renamed into place, so readers never see partial data and need no
+ * locking. The total size is kept in `<dir>/lock`, which is updated under `flock`; when it
+ * exceeds the capacity, the least recently used entries (by modification time, refreshed
+ * on every hit) are removed.
+ */
+class DLL_PUBLIC FileCache {
+ public:
+  /**
+   * @param local_prefixes  local paths starting with any of these are cached too
+   */
+  FileCache(const std::string &dir, int64_t capacity,
+            std::vector<std::string> local_prefixes = {});
+  ~FileCache();
+
+  /**
+   * @brief Process-wide cache configured through the environment, or nullptr if disabled.
+   *
+   * DALI_FILE_CACHE_DIR enables the cache, DALI_FILE_CACHE_SIZE sets its capacity in bytes
+   * (10 GB by default) and DALI_FILE_CACHE_PATHS optionally lists colon-separated local path
+   * prefixes (e.g. NFS mounts) to be cached in addition to the remote URI schemes.
+   */
+  static FileCache *Instance();
+
+  /**
+   * @brief Parses the capacity given in DALI_FILE_CACHE_SIZE, a positive number of bytes
+   */
+  static int64_t ParseCapacity(const std::string &value);
+
+  /**
+   * @brief Copies `n` bytes of the entry to `buffer`. Returns false on miss.
+   */
+  bool Lookup(const std::string &key, void *buffer, size_t n) {
+    return Lookup(key, n, 0, buffer, n);
+  }
+
+  /**
+   * @brief Copies `n` bytes at `offset` of the entry, which has `entry_size` bytes, to `buffer`.
+   *        Returns false on miss.
+   */
+  bool Lookup(const std::string &key, size_t entry_size, size_t offset, void *buffer, size_t n);
+
+  void Insert(const std::string &key, const void *data, size_t n);
+
+  /**
+   * @brief Removes least recently used entries until the total size is within the capacity
+   */
+  void Evict();
+
+  /**
+   * @brief Size of the object identified by `identity`; `get_size` is called if it's not cached.
+   *
+   * The sizes are also kept in memory, so only the first stream of an object in the process
+   * looks its size up in the cache directory.
+   */
+  size_t ObjectSize(const std::string &identity, const std::function<size_t()> &get_size);
+
+  /**
+   * @brief Whether streams for `uri` should go through the cache
+   */
+  bool ShouldCache(const std::string &uri) const;
+
+  /**
+   * @brief String identifying the current content of `uri`.
+   *
+   * Local files are identified by path, size and modification time. Remote objects are
+   * identified by URI only - they are assumed not to change in place.
+   */
+  static std::string Identity(const std::string &uri);
+
+  FileCacheStats GetStats() const;
+
+  const std::string &dir() const {
+    return dir_;
+  }
+
+  int64_t capacity() const {
+    return capacity_;
+  }
+
+ private:
+  std::string EntryPath(const std::string &key) const;
+  int64_t ReadSize() const;
+  void WriteSize(int64_t size);
+  void EvictLocked();
+
+  std::string dir_;
+  int64_t capacity_;
+  std::vector<std::string> local_prefixes_;
+  int lock_fd_ = -1;
+  std::mutex lock_mutex_;
+  std::atomic<uint64_t> tmp_counter_{0};
+  std::mutex sizes_mutex_;
+  std::unordered_map<std::string, size_t> sizes_;
+
+  std::atomic<int64_t> hits_{0};
+  std::atomic<int64_t> misses_{0};
+  std::atomic<int64_t> hit_bytes_{0};
+  std::atomic<int64_t> miss_bytes_{0};
+  std::atomic<int64_t> evicted_bytes_{0};
+};
+
+/**
+ * @brief FileStream serving reads from FileCache in fixed-size blocks.
+ *
+ * The underlying stream is opened only on the first miss, so a fully cached file costs
+ * no access to the original storage at all. The object size is cached as well.
+ */
+class DLL_PUBLIC CachingFileStream : public FileStream {
+ public:
+  using StreamFactory = std::function<std::unique_ptr<FileStream>()>;
+
+  static constexpr size_t kBlockSize = 1 << 20;
+
+  /**
+   * @param identity  uniquely identifies the content of the file, e.g. the URI followed by
+   *                  the modification time
+   */
+  CachingFileStream(FileCache *cache, const std::string &path, const std::string &identity,
+                    StreamFactory open);
+
+  void Close() override;
+  size_t Read(uint8_t *buffer, size_t n_bytes) override;
+  shared_ptr<void> Get(size_t n_bytes) override;
+  void Seek(int64 pos) override;
+  size_t Size() const override;
+
+ private:
+  FileStream &Inner();
+  std::string BlockKey(size_t block) const;
+  void ReadBlocks(uint8_t *buffer, size_t offset, size_t n_bytes);
+
+  FileCache *cache_;
+  std::string identity_;
+  StreamFactory open_;
+  std::unique_ptr<FileStream> inner_;
+  size_t length_ = 0;
+  size_t pos_ = 0;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_FILE_CACHE_H_
@@ -0,0 +1,236 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <dirent.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cstring>
+#include <memory>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/util/file_cache.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief In-memory stream counting the reads which reach it
+ */
+class MemoryStream : public FileStream {
+ public:
+  MemoryStream(const std::vector<uint8_t> &data, int *reads)
+      : FileStream("memory"), data_(data), reads_(reads) {}
+
+  void Close() override {}
+
+  size_t Read(uint8_t *buffer, size_t n_bytes) override {
+    (*reads_)++;
+    n_bytes = std::min(n_bytes, data_.size() - pos_);
+    memcpy(buffer, data_.data() + pos_, n_bytes);
+    pos_ += n_bytes;
+    return n_bytes;
+  }
+
+  shared_ptr<void> Get(size_t n_bytes) override {
+    return nullptr;
+  }
+
+  void Seek(int64 pos) override {
+    pos_ = pos;
+  }
+
+  size_t Size() const override {
+    return data_.size();
+  }
+
+ private:
+  const std::vector<uint8_t> &data_;
+  int *reads_;
+  size_t pos_ = 0;
+};
+
+void RemoveTree(const std::string &path) {
+  if (DIR *dir = opendir(path.c_str())) {
+    while (dirent *e = readdir(dir)) {
+      if (strcmp(e->d_name, ".") && strcmp(e->d_name, ".."))
+        RemoveTree(path + "/" + e->d_name);
+    }
+    closedir(dir);
+    rmdir(path.c_str());
+  } else {
+    unlink(path.c_str());
+  }
+}
+
+}  // namespace
+
+class FileCacheTest : public ::testing::Test {
+ protected:
+  void SetUp() override {
+    char tmpl[] = "/tmp/dali_file_cache_XXXXXX";
+    ASSERT_NE(mkdtemp(tmpl), nullptr);
+    dir_ = tmpl;
+    data_.resize(CachingFileStream::kBlockSize * 3 + 1000);
+    for (size_t i = 0; i < data_.size(); i++)
+      data_[i] = static_cast<uint8_t>(i * 13 + i / 1021);
+  }
+
+  void TearDown() override {
+    RemoveTree(dir_);
+  }
+
+  std::unique_ptr<FileStream> Open(FileCache *cache) {
+    return std::unique_ptr<FileStream>(new CachingFileStream(cache, "memory", "data", [this]() {
+      opens_++;
+      return std::unique_ptr<FileStream>(new MemoryStream(data_, &reads_));
+    }));
+  }
+
+  std::string dir_;
+  std::vector<uint8_t> data_;
+  int opens_ = 0;
+  int reads_ = 0;
+};
+
+TEST_F(FileCacheTest, ReadThrough) {
+  FileCache cache(dir_, 1 << 30);
+  const size_t kBlock = CachingFileStream::kBlockSize;
+  std::vector<uint8_t> buffer(data_.size());
+  {
+    auto file = Open(&cache);
+    EXPECT_EQ(file->Size(), data_.size());
+    // reading the middle of the second block caches only that block
+    file->Seek(kBlock + 100);
+    EXPECT_EQ(file->Read(buffer.data(), 200), 200u);
+    EXPECT_EQ(memcmp(buffer.data(), data_.data() + kBlock + 100, 200), 0);
+    EXPECT_EQ(reads_, 1);
+    // blocks 0 and 2-3 are missing - each run is fetched with a single read
+    file->Seek(0);
+    EXPECT_EQ(file->Read(buffer.data(), buffer.size()), data_.size());
+    EXPECT_EQ(buffer, data_);
+    EXPECT_EQ(reads_, 3);
+  }
+  EXPECT_EQ(opens_, 1);
+
+  // everything, including the size, is served from the cache without opening the file
+  auto file = Open(&cache);
+  EXPECT_EQ(file->Size(), data_.size());
+  file->Seek(kBlock - 10);
+  auto p = file->Get(kBlock + 20);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(memcmp(p.get(), data_.data() + kBlock - 10, kBlock + 20), 0);
+  EXPECT_EQ(opens_, 1);
+  EXPECT_EQ(reads_, 3);
+  // seeking to the end is valid, nothing is read from there
+  file->Seek(data_.size());
+  EXPECT_EQ(file->Read(buffer.data(), 1), 0u);
+  EXPECT_THROW(file->Seek(data_.size() + 1), DALIException);
+
+  // the size is remembered in memory after the first stream
+  auto stats = cache.GetStats();
+  EXPECT_EQ(stats.misses, 1 + 4);
+  EXPECT_EQ(stats.hits, 1 + 3);
+  EXPECT_EQ(stats.evicted_bytes, 0);
+
+  // another process looks the size up in the cache directory once
+  FileCache other(dir_, 1 << 30);
+  for (int i = 0; i < 3; i++)
+    EXPECT_EQ(Open(&other)->Size(), data_.size());
+  EXPECT_EQ(other.GetStats().hits, 1);
+  EXPECT_EQ(other.GetStats().misses, 0);
+  EXPECT_EQ(opens_, 1);
+}
+
+TEST_F(FileCacheTest, PartialBlockHit) {
+  FileCache cache(dir_, 1 << 30);
+  std::vector<uint8_t> buffer(100);
+  Open(&cache)->Read(buffer.data(), buffer.size());
+  // a small read from a cached block reads only the requested bytes of the entry
+  auto file = Open(&cache);
+  file->Seek(1000);
+  EXPECT_EQ(file->Read(buffer.data(), buffer.size()), buffer.size());
+  EXPECT_EQ(memcmp(buffer.data(), data_.data() + 1000, buffer.size()), 0);
+  EXPECT_EQ(cache.GetStats().hit_bytes, 100);
+  EXPECT_EQ(reads_, 1);
+
+  std::vector<uint8_t> value = { 1, 2, 3, 4 }, out(2);
+  cache.Insert("key", value.data(), value.size());
+  EXPECT_TRUE(cache.Lookup("key", value.size(), 1, out.data(), out.size()));
+  EXPECT_EQ(out, std::vector<uint8_t>({ 2, 3 }));
+  // entries of a different size are misses
+  EXPECT_FALSE(cache.Lookup("key", 5, 1, out.data(), out.size()));
+  EXPECT_THROW(cache.Lookup("key", value.size(), 3, out.data(), out.size()), DALIException);
+}
+
+TEST_F(FileCacheTest, ParseCapacity) {
+  EXPECT_EQ(FileCache::ParseCapacity("1000"), 1000);
+  EXPECT_EQ(FileCache::ParseCapacity("10737418240"), 10ll << 30);
+  EXPECT_THROW(FileCache::ParseCapacity(""), DALIException);
+  EXPECT_THROW(FileCache::ParseCapacity("10GB"), DALIException);
+  EXPECT_THROW(FileCache::ParseCapacity("abc"), DALIException);
+  EXPECT_THROW(FileCache::ParseCapacity("-1"), DALIException);
+  EXPECT_THROW(FileCache::ParseCapacity("0"), DALIException);
+  EXPECT_THROW(FileCache::ParseCapacity("99999999999999999999"), DALIException);
+}
+
+TEST_F(FileCacheTest, SharedBetweenInstances) {
+  FileCache writer(dir_, 1 << 30);
+  FileCache reader(dir_, 1 << 30);
+  std::vector<uint8_t> value = { 1, 2, 3, 4 }, out(4);
+  EXPECT_FALSE(reader.Lookup("key", out.data(), out.size()));
+  writer.Insert("key", value.data(), value.size());
+  EXPECT_TRUE(reader.Lookup("key", out.data(), out.size()));
+  EXPECT_EQ(out, value);
+  // a second insertion of the same key is not counted twice
+  reader.Insert("key", value.data(), value.size());
+  FileCache recount(dir_, 1 << 30);
+  recount.Evict();
+  EXPECT_EQ(recount.GetStats().evicted_bytes, 0);
+}
+
+TEST_F(FileCacheTest, LeastRecentlyUsedEviction) {
+  FileCache cache(dir_, 2500);
+  std::vector<uint8_t> value(1000, 42), out(1000);
+  auto wait = []() { std::this_thread::sleep_for(std::chrono::milliseconds(20)); };
+  cache.Insert("a", value.data(), value.size());
+  wait();
+  cache.Insert("b", value.data(), value.size());
+  wait();
+  // touching "a" makes "b" the least recently used entry
+  EXPECT_TRUE(cache.Lookup("a", out.data(), out.size()));
+  wait();
+  cache.Insert("c", value.data(), value.size());
+  EXPECT_TRUE(cache.Lookup("a", out.data(), out.size()));
+  EXPECT_FALSE(cache.Lookup("b", out.data(), out.size()));
+  EXPECT_TRUE(cache.Lookup("c", out.data(), out.size()));
+  EXPECT_EQ(cache.GetStats().evicted_bytes, 1000);
+}
+
+TEST_F(FileCacheTest, ShouldCache) {
+  FileCache cache(dir_, 1 << 30, { "/mnt/nfs/" });
+  EXPECT_TRUE(cache.ShouldCache("http://host/file"));
+  EXPECT_TRUE(cache.ShouldCache("/mnt/nfs/data/file"));
+  EXPECT_TRUE(cache.ShouldCache("file:///mnt/nfs/data/file"));
+  EXPECT_FALSE(cache.ShouldCache("/data/file"));
+}
+
+}  // namespace dali
@@ -0,0 +1,458 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <netdb.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <cctype>
+#include <cstdlib>
+#include <cstring>
+#include <exception>
+#include <map>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/util/http_file.h"
+
+namespace dali {
+
+constexpr size_t HttpFileStream::kParallelReadThreshold;
+constexpr size_t HttpFileStream::kMinParallelPart;
+constexpr int HttpFileStream::kMaxParallelParts;
+
+namespace {
+
+constexpr int kSocketTimeoutSec = 60;
+// a response body larger than that is not worth draining to reuse the connection
+constexpr size_t kMaxDrainBytes = 1 << 20;
+
+int Connect(const HttpUrl &url) {
+  addrinfo hints = {};
+  hints.ai_family = AF_UNSPEC;
+  hints.ai_socktype = SOCK_STREAM;
+  addrinfo *addresses = nullptr;
+  int ret = getaddrinfo(url.host.c_str(), std::to_string(url.port).c_str(), &hints, &addresses);
+  DALI_ENFORCE(ret == 0, "Could not resolve " + url.host + ": " + gai_strerror(ret));
+
+  int fd = -1;
+  for (addrinfo *a = addresses; a != nullptr; a = a->ai_next) {
+    fd = socket(a->ai_family, a->ai_socktype, a->ai_protocol);
+    if (fd < 0)
+      continue;
+    if (connect(fd, a->ai_addr, a->ai_addrlen) == 0)
+      break;
+    close(fd);
+    fd = -1;
+  }
+  freeaddrinfo(addresses);
+  DALI_ENFORCE(fd >= 0, "Could not connect to " + url.host + ":" + std::to_string(url.port));
+
+  int one = 1;
+  setsockopt(fd, IPPROTO_TCP, TCP_NODELAY, &one, sizeof(one));
+  timeval timeout = { kSocketTimeoutSec, 0 };
+  setsockopt(fd, SOL_SOCKET, SO_RCVTIMEO, &timeout, sizeof(timeout));
+  setsockopt(fd, SOL_SOCKET, SO_SNDTIMEO, &timeout, sizeof(timeout));
+  return fd;
+}
+
+/**
+ * @brief Idle keep-alive connections, per host
+ */
+class ConnectionPool {
+ public:
+  static ConnectionPool &Instance() {
+    static ConnectionPool pool;
+    return pool;
+  }
+
+  int Acquire(const HttpUrl &url, bool *reused) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto &idle = idle_[Key(url)];
+      if (!idle.empty()) {
+        int fd = idle.back();
+        idle.pop_back();
+        *reused = true;
+        return fd;
+      }
+    }
+    *reused = false;
+    return Connect(url);
+  }
+
+  void Release(const HttpUrl &url, int fd) {
+    {
+      std::lock_guard<std::mutex> lock(mutex_);
+      auto &idle = idle_[Key(url)];
+      if (idle.size() < kMaxIdlePerHost) {
+        idle.push_back(fd);
+        return;
+      }
+    }
+    close(fd);
+  }
+
+  ~ConnectionPool() {
+    for (auto &host : idle_) {
+      for (int fd : host.second)
+        close(fd);
+    }
+  }
+
+ private:
+  static constexpr size_t kMaxIdlePerHost = 32;
+
+  static std::string Key(const HttpUrl &url) {
+    return url.host + ":" + std::to_string(url.port);
+  }
+
+  std::mutex mutex_;
+  std::map<std::string, std::vector<int>> idle_;
+};
+
+bool SendAll(int fd, const std::string &data) {
+  size_t sent = 0;
+  while (sent < data.size()) {
+    ssize_t n = send(fd, data.data() + sent, data.size() - sent, MSG_NOSIGNAL);
+    if (n <= 0)
+      return false;
+    sent += n;
+  }
+  return true;
+}
+
+struct HttpResponse {
+  int status = 0;
+  bool has_length = false;
+  size_t content_length = 0;
+  bool keep_alive = false;
+  // part of the body received together with the headers
+  std::string body_prefix;
+};
+
+std::string ToLower(std::string s) {
+  std::transform(s.begin(), s.end(), s.begin(), [](unsigned char c) { return std::tolower(c); });
+  return s;
+}
+
+bool ReadHeaders(int fd, HttpResponse *response) {
+  std::string data;
+  size_t headers_end;
+  char buffer[4096];
+  while ((headers_end = data.find("\r\n\r\n")) == std::string::npos) {
+    ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+    if (n <= 0)
+      return false;
+    data.append(buffer, n);
+  }
+  response->body_prefix = data.substr(headers_end + 4);
+
+  size_t line_end = data.find("\r\n");
+  std::string status_line = data.substr(0, line_end);
+  DALI_ENFORCE(status_line.compare(0, 5, "HTTP/") == 0 && status_line.size() >= 12,
+               "Invalid HTTP response: " + status_line);
+  bool http_1_0 = status_line.compare(0, 8, "HTTP/1.0") == 0;
+  response->status = std::atoi(status_line.c_str() + 9);
+  response->keep_alive = !http_1_0;
+
+  size_t pos = line_end + 2;
+  while (pos < headers_end) {
+    line_end = data.find("\r\n", pos);
+    std::string line = data.substr(pos, line_end - pos);
+    pos = line_end + 2;
+    auto colon = line.find(':');
+    if (colon == std::string::npos)
+      continue;
+    std::string name = ToLower(line.substr(0, colon));
+    size_t value_start = line.find_first_not_of(" \t", colon + 1);
+    std::string value = value_start == std::string::npos ? "" : line.substr(value_start);
+    if (name == "content-length") {
+      response->has_length = true;
+      response->content_length = std::strtoull(value.c_str(), nullptr, 10);
+    } else if (name == "connection") {
+      value = ToLower(value);
+      if (value == "close")
+        response->keep_alive = false;
+      else if (value == "keep-alive")
+        response->keep_alive = true;
+    } else if (name == "transfer-encoding") {
+      DALI_ENFORCE(ToLower(value) == "identity",
+                   "Unsupported HTTP transfer encoding: " + value);
+    }
+  }
+  return true;
+}
+
+/**
+ * @brief Reads `n` bytes of the body into `out` (or discards them if `out` is null)
+ */
+bool ReadBody(int fd, HttpResponse *response, uint8_t *out, size_t n) {
+  auto &prefix = response->body_prefix;
+  size_t from_prefix = std::min(n, prefix.size());
+  if (out)
+    memcpy(out, prefix.data(), from_prefix);
+  prefix.erase(0, from_prefix);
+  size_t received = from_prefix;
+  char discard[4096];
+  while (received < n) {
+    size_t to_read = n - received;
+    ssize_t r = out ? recv(fd, out + received, to_read, 0)
+                    : recv(fd, discard, std::min(to_read, sizeof(discard)), 0);
+    if (r <= 0)
+      return false;
+    received += r;
+  }
+  return true;
+}
+
+/**
+ * @brief Sends a request and reads the response headers, retrying once on a fresh connection
+ *        if a pooled one turns out to be closed.
+ *
+ * The retry doesn't take another pooled connection: when the server drops idle connections,
+ * it usually drops all of them.
+ */
+int StartRequest(const HttpUrl &url, const std::string &request, HttpResponse *response) {
+  bool reused;
+  int fd = ConnectionPool::Instance().Acquire(url, &reused);
+  for (;;) {
+    if (SendAll(fd, request) && ReadHeaders(fd, response))
+      return fd;
+    close(fd);
+    DALI_ENFORCE(reused,
+                 "HTTP request to " + url.host + ":" + std::to_string(url.port) + url.path +
+                 " failed");
+    fd = Connect(url);
+    reused = false;
+  }
+}
+
+void FinishRequest(const HttpUrl &url, int fd, const HttpResponse &response, bool complete) {
+  if (complete && response.keep_alive)
+    ConnectionPool::Instance().Release(url, fd);
+  else
+    close(fd);
+}
+
+/**
+ * @brief Percent-encodes the characters which can't appear in the request target
+ *        (e.g. spaces in object keys), leaving the delimiters and existing escapes intact
+ */
+std::string EncodePath(const std::string &path) {
+  static const char kAllowed[] = "-._~!$&'()*+,;=:@/?%";
+  static const char kHex[] = "0123456789ABCDEF";
+  std::string result;
+  result.reserve(path.size());
+  for (unsigned char c : path) {
+    if ((c < 128 && std::isalnum(c)) || (c && std::strchr(kAllowed, c))) {
+      result += c;
+    } else {
+      result += '%';
+      result += kHex[c >> 4];
+      result += kHex[c & 15];
+    }
+  }
+  return result;
+}
+
+std::string RequestHeaders(const char *method, const HttpUrl &url) {
+  return std::string(method) + " " + EncodePath(url.path) + " HTTP/1.1\r\n"
+         "Host: " + url.host + ":" + std::to_string(url.port) + "\r\n"
+         "Connection: keep-alive\r\n";
+}
+
+size_t HeadContentLength(const HttpUrl &url) {
+  HttpResponse response;
+  int fd = StartRequest(url, RequestHeaders("HEAD", url) + "\r\n", &response);
+  FinishRequest(url, fd, response, true);
+  DALI_ENFORCE(response.status == 200,
+               "HTTP status " + std::to_string(response.status) + " for " + url.path);
+  DALI_ENFORCE(response.has_length, "Unknown size of " + url.path);
+  return response.content_length;
+}
+
+void GetRange(const HttpUrl &url, uint8_t *buffer, size_t offset, size_t n_bytes) {
+  std::string request = RequestHeaders("GET", url) +
+      "Range: bytes=" + std::to_string(offset) + "-" + std::to_string(offset + n_bytes - 1) +
+      "\r\n\r\n";
+  HttpResponse response;
+  int fd = StartRequest(url, request, &response);
+  bool ok = false;
+  try {
+    DALI_ENFORCE(response.has_length, "Unknown length of the response for " + url.path);
+    if (response.status == 206) {
+      DALI_ENFORCE(response.content_length == n_bytes,
+                   "Unexpected length of the HTTP range response for " + url.path);
+      ok = ReadBody(fd, &response, buffer, n_bytes);
+    } else if (response.status == 200) {
+      // the server ignored the range - skip to the requested part of the whole file
+      DALI_ENFORCE(response.content_length >= offset + n_bytes,
+                   "Unexpected length of the HTTP response for " + url.path);
+      size_t rest = response.content_length - offset - n_bytes;
+      ok = ReadBody(fd, &response, nullptr, offset) &&
+           ReadBody(fd, &response, buffer, n_bytes);
+      if (ok && rest > 0) {
+        ok = rest <= kMaxDrainBytes && ReadBody(fd, &response, nullptr, rest);
+        if (!ok) {
+          // the data was read, only the connection can't be reused
+          close(fd);
+          return;
+        }
+      }
+    } else {
+      DALI_FAIL("HTTP status " + std::to_string(response.status) + " for " + url.path);
+    }
+  } catch (...) {
+    close(fd);
+    throw;
+  }
+  FinishRequest(url, fd, response, ok);
+  DALI_ENFORCE(ok, "Incomplete HTTP response for " + url.path);
+}
+
+}  // namespace
+
+HttpUrl ParseHttpUrl(const std::string &url) {
+  const std::string prefix = "http://";
+  DALI_ENFORCE(url.compare(0, prefix.size(), prefix) == 0,
+               "Only plain http:// URLs are supported: " + url);
+  HttpUrl result;
+  size_t host_start = prefix.size();
+  size_t path_start = url.find('/', host_start);
+  std::string authority = url.substr(host_start, path_start - host_start);
+  result.path = path_start == std::string::npos ? "/" : url.substr(path_start);
+  auto colon = authority.rfind(':');
+  if (colon != std::string::npos && authority.find(']', colon) == std::string::npos) {
+    result.host = authority.substr(0, colon);
+    result.port = std::atoi(authority.c_str() + colon + 1);
+  } else {
+    result.host = authority;
+  }
+  DALI_ENFORCE(!result.host.empty() && result.port > 0 && result.port < 65536,
+               "Invalid URL: " + url);
+  return result;
+}
+
+std::string S3UriToHttp(const std::string &uri) {
+  const std::string prefix = "s3://";
+  DALI_ENFORCE(uri.compare(0, prefix.size(), prefix) == 0, "Not an S3 URI: " + uri);
+  const char *endpoint = std::getenv("DALI_S3_ENDPOINT");
+  DALI_ENFORCE(endpoint != nullptr && *endpoint,
+               "DALI_S3_ENDPOINT must be set to the URL of an S3-compatible endpoint to read " +
+               uri);
+  std::string result = endpoint;
+  while (!result.empty() && result.back() == '/')
+    result.pop_back();
+  return result + "/" + uri.substr(prefix.size());
+}
+
+HttpFileStream::HttpFileStream(const std::string &url, bool read_ahead)
+    : FileStream(url), url_(ParseHttpUrl(url)) {
+  length_ = HeadContentLength(url_);
+  if (read_ahead && length_ > 0) {
+    std::shared_ptr<uint8_t> data(new uint8_t[length_], std::default_delete<uint8_t[]>());
+    ReadRange(data.get(), 0, length_);
+    data_ = std::move(data);
+  }
+}
+
+void HttpFileStream::Close() {
+  data_.reset();
+  length_ = 0;
+  pos_ = 0;
+}
+
+void HttpFileStream::ReadRange(uint8_t *buffer, size_t offset, size_t n_bytes) const {
+  if (n_bytes == 0)
+    return;
+  if (data_) {
+    memcpy(buffer, data_.get() + offset, n_bytes);
+    return;
+  }
+  int parts = 1;
+  if (n_bytes >= kParallelReadThreshold)
+    parts = std::min<size_t>(kMaxParallelParts, n_bytes / kMinParallelPart);
+  if (parts == 1) {
+    GetRange(url_, buffer, offset, n_bytes);
+    return;
+  }
+
+  size_t part_size = (n_bytes + parts - 1) / parts;
+  std::vector<std::exception_ptr> errors(parts);
+  auto fetch = [&](int part) {
+    try {
+      size_t start = part * part_size;
+      size_t size = std::min(part_size, n_bytes - start);
+      GetRange(url_, buffer + start, offset + start, size);
+    } catch (...) {
+      errors[part] = std::current_exception();
+    }
+  };
+  std::vector<std::thread> threads;
+  for (int part = 1; part < parts; part++)
+    threads.emplace_back(fetch, part);
+  fetch(0);
+  for (auto &t : threads)
+    t.join();
+  for (auto &error : errors) {
+    if (error)
+      std::rethrow_exception(error);
+  }
+}
+
+size_t HttpFileStream::Read(uint8_t *buffer, size_t n_bytes) {
+  n_bytes = std::min(n_bytes, length_ - pos_);
+  ReadRange(buffer, pos_, n_bytes);
+  pos_ += n_bytes;
+  return n_bytes;
+}
+
+shared_ptr<void> HttpFileStream::Get(size_t n_bytes) {
+  if (pos_ + n_bytes > length_) {
+    return nullptr;
+  }
+  shared_ptr<void> p;
+  if (data_) {
+    // share the prefetched file
+    p = shared_ptr<void>(data_, data_.get() + pos_);
+  } else {
+    std::shared_ptr<uint8_t> buffer(new uint8_t[n_bytes], std::default_delete<uint8_t[]>());
+    ReadRange(buffer.get(), pos_, n_bytes);
+    p = buffer;
+  }
+  pos_ += n_bytes;
+  return p;
+}
+
+void HttpFileStream::Seek(int64 pos) {
+  // seeking to the end is valid, also for empty objects
+  DALI_ENFORCE(pos >= 0 && pos <= (int64)length_, "Invalid seek");
+  pos_ = pos;
+}
+
+size_t HttpFileStream::Size() const {
+  return length_;
+}
+
+}  // namespace dali
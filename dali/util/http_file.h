@@ -0,0 +1,81 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#ifndef DALI_UTIL_HTTP_FILE_H_
+#define DALI_UTIL_HTTP_FILE_H_
+
+#include <memory>
+#include <string>
+
+#include "dali/core/common.h"
+#include "dali/util/file.h"
+
+namespace dali {
+
+struct HttpUrl {
+  std::string host;
+  int port = 80;
+  // path with the query string, starting with '/'
+  std::string path;
+};
+
+DLL_PUBLIC HttpUrl ParseHttpUrl(const std::string &url);
+
+/**
+ * @brief Maps `s3://bucket/key` to a path-style URL of the S3-compatible endpoint given
+ *        in the DALI_S3_ENDPOINT environment variable (e.g. `http://localhost:9000`).
+ *
+ * Requests are not signed, so the objects must be readable anonymously.
+ */
+DLL_PUBLIC std::string S3UriToHttp(const std::string &uri);
+
+/**
+ * @brief Reads a file served over HTTP/1.1 with range requests.
+ *
+ * Connections are kept alive and reused across streams through a per-host pool.
+ * Large reads are split into ranges fetched in parallel. With `read_ahead`,
+ * the whole file is fetched when the stream is opened.
+ */
+class DLL_PUBLIC HttpFileStream : public FileStream {
+ public:
+  HttpFileStream(const std::string &url, bool read_ahead);
+
+  void Close() override;
+  size_t Read(uint8_t *buffer, size_t n_bytes) override;
+  shared_ptr<void> Get(size_t n_bytes) override;
+  void Seek(int64 pos) override;
+  size_t Size() const override;
+
+  /**
+   * @brief Reads `n_bytes` at `offset`, without moving the stream position
+   */
+  void ReadRange(uint8_t *buffer, size_t offset, size_t n_bytes) const;
+
+  // reads at least this large are split into parallel range requests
+  static constexpr size_t kParallelReadThreshold = 8 << 20;
+  static constexpr size_t kMinParallelPart = 2 << 20;
+  static constexpr int kMaxParallelParts = 8;
+
+ private:
+  HttpUrl url_;
+  size_t length_ = 0;
+  size_t pos_ = 0;
+  // whole file contents, when read ahead
+  std::shared_ptr<uint8_t> data_;
+};
+
+}  // namespace dali
+
+#endif  // DALI_UTIL_HTTP_FILE_H_
@@ -0,0 +1,296 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+
+#include <gtest/gtest.h>
+#include <netinet/in.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+#include <atomic>
+#include <cstdlib>
+#include <cstring>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "dali/core/error_handling.h"
+#include "dali/util/http_file.h"
+
+namespace dali {
+
+namespace {
+
+/**
+ * @brief Minimal keep-alive HTTP/1.1 server of a single file, supporting HEAD and ranged GET
+ */
+class TestHttpServer {
+ public:
+  explicit TestHttpServer(std::string content, bool support_ranges = true)
+      : content_(std::move(content)), support_ranges_(support_ranges) {
+    listen_fd_ = socket(AF_INET, SOCK_STREAM, 0);
+    sockaddr_in addr = {};
+    addr.sin_family = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port = 0;
+    EXPECT_EQ(bind(listen_fd_, reinterpret_cast<sockaddr *>(&addr), sizeof(addr)), 0);
+    EXPECT_EQ(listen(listen_fd_, 64), 0);
+    socklen_t len = sizeof(addr);
+    getsockname(listen_fd_, reinterpret_cast<sockaddr *>(&addr), &len);
+    port_ = ntohs(addr.sin_port);
+    accept_thread_ = std::thread([this]() { AcceptLoop(); });
+  }
+
+  ~TestHttpServer() {
+    shutdown(listen_fd_, SHUT_RDWR);
+    close(listen_fd_);
+    accept_thread_.join();
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : client_fds_)
+      shutdown(fd, SHUT_RDWR);
+    for (auto &t : client_threads_)
+      t.join();
+  }
+
+  std::string url(const std::string &path = "/data.bin") const {
+    return "http://127.0.0.1:" + std::to_string(port_) + path;
+  }
+
+  int connections() const { return connections_; }
+
+  /**
+   * @brief Closes the connections kept alive by the clients, like a server's idle timeout
+   */
+  void CloseConnections() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    for (int fd : client_fds_)
+      shutdown(fd, SHUT_RDWR);
+    client_fds_.clear();
+  }
+  int requests() const { return requests_; }
+
+  /**
+   * @brief The request target of the last request received
+   */
+  std::string last_target() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    return last_target_;
+  }
+
+ private:
+  void AcceptLoop() {
+    for (;;) {
+      int fd = accept(listen_fd_, nullptr, nullptr);
+      if (fd < 0)
+        return;
+      connections_++;
+      std::lock_guard<std::mutex> lock(mutex_);
+      client_fds_.push_back(fd);
+      client_threads_.emplace_back([this, fd]() { Serve(fd); });
+    }
+  }
+
+  void Serve(int fd) {
+    std::string data;
+    char buffer[4096];
+    for (;;) {
+      size_t end;
+      while ((end = data.find("\r\n\r\n")) == std::string::npos) {
+        ssize_t n = recv(fd, buffer, sizeof(buffer), 0);
+        if (n <= 0) {
+          close(fd);
+          return;
+        }
+        data.append(buffer, n);
+      }
+      std::string request = data.substr(0, end);
+      data.erase(0, end + 4);
+      requests_++;
+      {
+        size_t target = request.find(' ') + 1;
+        std::lock_guard<std::mutex> lock(mutex_);
+        last_target_ = request.substr(target, request.find(' ', target) - target);
+      }
+
+      std::string response;
+      if (request.compare(0, 5, "HEAD ") == 0) {
+        response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(content_.size()) +
+                   "\r\n\r\n";
+      } else {
+        auto range = request.find("Range: bytes=");
+        if (support_ranges_ && range != std::string::npos) {
+          size_t first = std::strtoull(request.c_str() + range + 13, nullptr, 10);
+          size_t last = std::strtoull(request.c_str() + request.find('-', range + 13) + 1,
+                                      nullptr, 10);
+          std::string body = content_.substr(first, last - first + 1);
+          response = "HTTP/1.1 206 Partial Content\r\nContent-Length: " +
+                     std::to_string(body.size()) + "\r\n\r\n" + body;
+        } else {
+          response = "HTTP/1.1 200 OK\r\nContent-Length: " + std::to_string(content_.size()) +
+                     "\r\n\r\n" + content_;
+        }
+      }
+      if (send(fd, response.data(), response.size(), MSG_NOSIGNAL) != (ssize_t)response.size()) {
+        close(fd);
+        return;
+      }
+    }
+  }
+
+  std::string content_;
+  bool support_ranges_;
+  int listen_fd_;
+  int port_;
+  std::thread accept_thread_;
+  std::mutex mutex_;
+  std::vector<int> client_fds_;
+  std::vector<std::thread> client_threads_;
+  std::string last_target_;
+  std::atomic<int> connections_{0};
+  std::atomic<int> requests_{0};
+};
+
+std::string TestContent(size_t size) {
+  std::string content(size, '\0');
+  for (size_t i = 0; i < size; i++)
+    content[i] = static_cast<char>(i * 7 + i / 251);
+  return content;
+}
+
+}  // namespace
+
+TEST(HttpFileTest, ParseUrl) {
+  auto url = ParseHttpUrl("http://example.com:8080/a/b?c=d");
+  EXPECT_EQ(url.host, "example.com");
+  EXPECT_EQ(url.port, 8080);
+  EXPECT_EQ(url.path, "/a/b?c=d");
+  url = ParseHttpUrl("http://example.com");
+  EXPECT_EQ(url.port, 80);
+  EXPECT_EQ(url.path, "/");
+  EXPECT_THROW(ParseHttpUrl("https://example.com/"), DALIException);
+}
+
+TEST(HttpFileTest, S3Uri) {
+  setenv("DALI_S3_ENDPOINT", "http://localhost:9000/", 1);
+  EXPECT_EQ(S3UriToHttp("s3://bucket/dir/key.rec"), "http://localhost:9000/bucket/dir/key.rec");
+  unsetenv("DALI_S3_ENDPOINT");
+  EXPECT_THROW(S3UriToHttp("s3://bucket/key"), DALIException);
+}
+
+TEST(HttpFileTest, ReadAndReuseConnections) {
+  auto content = TestContent(10000);
+  TestHttpServer server(content);
+
+  for (int i = 0; i < 3; i++) {
+    auto file = FileStream::Open(server.url(), false);
+    ASSERT_EQ(file->Size(), content.size());
+    file->Seek(100);
+    std::vector<uint8_t> buffer(1000);
+    EXPECT_EQ(file->Read(buffer.data(), buffer.size()), buffer.size());
+    EXPECT_EQ(memcmp(buffer.data(), content.data() + 100, buffer.size()), 0);
+
+    auto p = file->Get(500);
+    ASSERT_NE(p, nullptr);
+    EXPECT_EQ(memcmp(p.get(), content.data() + 1100, 500), 0);
+
+    // reading past the end is truncated
+    file->Seek(9900);
+    EXPECT_EQ(file->Read(buffer.data(), buffer.size()), 100u);
+    EXPECT_EQ(file->Get(1), nullptr);
+    file->Close();
+  }
+  // all requests (HEAD + 3 ranged GETs per file) went through a single kept-alive connection
+  EXPECT_EQ(server.connections(), 1);
+  EXPECT_EQ(server.requests(), 12);
+}
+
+TEST(HttpFileTest, ParallelRanges) {
+  auto content = TestContent(HttpFileStream::kParallelReadThreshold + 12345);
+  TestHttpServer server(content);
+  auto file = FileStream::Open(server.url(), false);
+  std::vector<uint8_t> buffer(content.size());
+  EXPECT_EQ(file->Read(buffer.data(), buffer.size()), content.size());
+  EXPECT_EQ(memcmp(buffer.data(), content.data(), content.size()), 0);
+  // HEAD + one request per part
+  int parts = content.size() / HttpFileStream::kMinParallelPart;
+  EXPECT_EQ(server.requests(), 1 + parts);
+}
+
+TEST(HttpFileTest, ReconnectWhenIdleConnectionsClosed) {
+  auto content = TestContent(HttpFileStream::kParallelReadThreshold + 12345);
+  TestHttpServer server(content);
+  {
+    // parallel parts leave several idle connections in the pool
+    auto file = FileStream::Open(server.url(), false);
+    std::vector<uint8_t> buffer(content.size());
+    EXPECT_EQ(file->Read(buffer.data(), buffer.size()), content.size());
+  }
+  ASSERT_GT(server.connections(), 2);
+  server.CloseConnections();
+  int connections = server.connections();
+
+  // the first pooled connection fails, the retry must not take another stale one
+  auto file = FileStream::Open(server.url(), false);
+  EXPECT_EQ(file->Size(), content.size());
+  EXPECT_EQ(server.connections(), connections + 1);
+}
+
+TEST(HttpFileTest, ReadAhead) {
+  auto content = TestContent(5000);
+  TestHttpServer server(content);
+  auto file = FileStream::Open(server.url(), true);
+  int requests = server.requests();
+  file->Seek(1234);
+  auto p = file->Get(2000);
+  ASSERT_NE(p, nullptr);
+  EXPECT_EQ(memcmp(p.get(), content.data() + 1234, 2000), 0);
+  // served from memory
+  EXPECT_EQ(server.requests(), requests);
+}
+
+TEST(HttpFileTest, ServerWithoutRanges) {
+  auto content = TestContent(3000);
+  TestHttpServer server(content, false);
+  auto file = FileStream::Open(server.url(), false);
+  file->Seek(1000);
+  std::vector<uint8_t> buffer(500);
+  EXPECT_EQ(file->Read(buffer.data(), buffer.size()), buffer.size());
+  EXPECT_EQ(memcmp(buffer.data(), content.data() + 1000, buffer.size()), 0);
+}
+
+TEST(HttpFileTest, EmptyObject) {
+  TestHttpServer server("");
+  auto file = FileStream::Open(server.url(), false);
+  EXPECT_EQ(file->Size(), 0u);
+  file->Seek(0);
+  uint8_t byte;
+  EXPECT_EQ(file->Read(&byte, 1), 0u);
+  EXPECT_THROW(file->Seek(1), DALIException);
+}
+
+TEST(HttpFileTest, EncodesPath) {
+  TestHttpServer server("data");
+  auto file = FileStream::Open(server.url("/my data/a%2Bb.bin?v=1&x"), false);
+  EXPECT_EQ(server.last_target(), "/my%20data/a%2Bb.bin?v=1&x");
+  EXPECT_EQ(file->Size(), 4u);
+}
+
+TEST(HttpFileTest, UnknownScheme) {
+  EXPECT_THROW(FileStream::Open("foo://bar", false), DALIException);
+}
+
+}  // namespace dali
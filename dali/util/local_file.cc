@@ -205,6 +205,18 @@ size_t LocalFileStream::Size() const {
   return length_;
 }
 
+void LocalFileStream::ReadAhead(int64 pos, size_t n_bytes) {
+  if (read_ahead_whole_file_ || !p_ || pos < 0 || static_cast<size_t>(pos) >= length_)
+    return;
+  n_bytes = std::min(n_bytes, length_ - pos);
+#if !defined(__AARCH64_QNX__) && !defined(__AARCH64_GNU__)
+  // madvise needs a page-aligned address; the mapping itself is page-aligned
+  static const size_t page_size = sysconf(_SC_PAGESIZE);
+  size_t start = pos / page_size * page_size;
+  madvise(static_cast<uint8_t*>(p_.get()) + start, pos + n_bytes - start, MADV_WILLNEED);
+#endif
+}
+
 bool LocalFileStream::ReserveFileMappings(unsigned int num) {
   if (num + dali_reserved_mv_cnt > dali_max_mv_cnt) {
     return false;
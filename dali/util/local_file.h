@@ -34,6 +34,7 @@ class LocalFileStream : public FileStream {
   size_t Read(uint8_t * buffer, size_t n_bytes) override;
   void Seek(int64 pos) override;
   size_t Size() const override;
+  void ReadAhead(int64 pos, size_t n_bytes) override;
 
   ~LocalFileStream() override {
     Close();
@@ -23,12 +23,14 @@ RandomCropGenerator::RandomCropGenerator(
     AspectRatioRange aspect_ratio_range,
     AreaRange area_range,
     int64_t seed,
-    int num_attempts)
+    int num_attempts,
+    uint32_t stream)
   : aspect_ratio_range_(aspect_ratio_range)
   , aspect_ratio_log_dis_(std::log(aspect_ratio_range.first), std::log(aspect_ratio_range.second))
   , area_dis_(area_range.first, area_range.second)
-  , rand_gen_(seed)
+  , rand_gen_(seed, RNGDomain::CropWindow, stream)
   , seed_(seed)
+  , stream_(stream)
   , num_attempts_(num_attempts) {
 }
 
@@ -107,13 +109,10 @@ CropWindow RandomCropGenerator::GenerateCropWindow(const kernels::TensorShape<>&
 std::vector<CropWindow>
 RandomCropGenerator::GenerateCropWindows(const kernels::TensorShape<>& shape,
                                          std::size_t N) {
-  std::seed_seq seq{seed_};
-  std::vector<int64_t> seeds(N);
-  seq.generate(seeds.begin(), seeds.end());
-
   std::vector<CropWindow> crop_windows;
   for (std::size_t i = 0; i < N; i++) {
-    rand_gen_.seed(seeds[i]);
+    // each window is drawn from its own epoch of this generator's stream
+    rand_gen_ = CounterRNG(seed_, RNGDomain::CropWindow, stream_, static_cast<uint32_t>(i));
     crop_windows.push_back(GenerateCropWindowImpl(shape));
   }
   return crop_windows;
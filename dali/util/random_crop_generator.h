@@ -19,6 +19,7 @@
 #include <random>
 #include <utility>
 #include "dali/core/common.h"
+#include "dali/pipeline/util/counter_rng.h"
 #include "dali/util/crop_window.h"
 
 namespace dali {
@@ -32,7 +33,8 @@ class DLL_PUBLIC RandomCropGenerator {
     AspectRatioRange aspect_ratio_range = { 3.0f/4, 4.0f/3 },
     AreaRange area_range = { 0.08, 1 },
     int64_t seed = time(0),
-    int num_attempts_ = 10);
+    int num_attempts_ = 10,
+    uint32_t stream = 0);
 
   DLL_PUBLIC CropWindow GenerateCropWindow(const kernels::TensorShape<>& shape);
   DLL_PUBLIC std::vector<CropWindow> GenerateCropWindows(const kernels::TensorShape<>& shape,
@@ -45,8 +47,9 @@ class DLL_PUBLIC RandomCropGenerator {
   // This provides natural symmetry and smoothness of the distribution.
   std::uniform_real_distribution<float> aspect_ratio_log_dis_;
   std::uniform_real_distribution<float> area_dis_;
-  std::mt19937 rand_gen_;
+  CounterRNG rand_gen_;
   int64_t seed_;
+  uint32_t stream_;
   int num_attempts_;
 };
 
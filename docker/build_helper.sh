@@ -31,6 +31,8 @@ export BUILD_LMDB=${BUILD_LMDB:-ON}
 export BUILD_JPEG_TURBO=${BUILD_JPEG_TURBO:-ON}
 export BUILD_NVJPEG=${BUILD_NVJPEG:-ON}
 export BUILD_LIBTIFF=${BUILD_LIBTIFF:-ON}
+export BUILD_LIBPNG=${BUILD_LIBPNG:-ON}
+export BUILD_LIBWEBP=${BUILD_LIBWEBP:-ON}
 export BUILD_NVOF=${BUILD_NVOF:-ON}
 export BUILD_NVDEC=${BUILD_NVDEC:-ON}
 export BUILD_NVML=${BUILD_NVML:-ON}
@@ -49,6 +51,7 @@ cmake ../ -DCMAKE_INSTALL_PREFIX=. -DCMAKE_BUILD_TYPE=${CMAKE_BUILD_TYPE} \
       -DBUILD_JPEG_TURBO=${BUILD_JPEG_TURBO} \
       -DBUILD_NVJPEG=${BUILD_NVJPEG} \
       -DBUILD_LIBTIFF=${BUILD_LIBTIFF} \
+      -DBUILD_LIBPNG=${BUILD_LIBPNG} -DBUILD_LIBWEBP=${BUILD_LIBWEBP} \
       -DBUILD_NVOF=${BUILD_NVOF} -DBUILD_NVDEC=${BUILD_NVDEC} \
       -DBUILD_NVML=${BUILD_NVML} \
       -DWERROR=${WERROR} \
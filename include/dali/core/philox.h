@@ -0,0 +1,82 @@
+// Copyright (c) 2019, NVIDIA CORPORATION. All rights reserved.
+//
+// Licensed under the Apache License, Version 2.0 (the "License");
+// you may not use this file except in compliance with the License.
+// You may obtain a copy of the License at
+//
+//     http://www.apache.org/licenses/LICENSE-2.0
+//
+// Unless required by applicable law or agreed to in writing, software
+// distributed under the License is distributed on an "AS IS" BASIS,
+// WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+// See the License for the specific language governing permissions and
+// limitations under the License.
+
+#ifndef DALI_CORE_PHILOX_H_
+#define DALI_CORE_PHILOX_H_
+
+#include <cstdint>
+#include "dali/core/host_dev.h"
+
+namespace dali {
+
+/**
+ * @brief Philox4x32-10 counter-based random number generator
+ *
+ * The generator has no state - each call maps a 128-bit counter and a 64-bit key
+ * to 128 random bits. This makes it possible to generate random numbers for any
+ * element independently (and in any order) by using, e.g., the element's index as
+ * a part of the counter.
+ *
+ * See: J. Salmon et al., "Parallel Random Numbers: As Easy as 1, 2, 3", SC'11
+ */
+struct Philox4x32_10 {
+  struct Block {
+    uint32_t v[4];
+
+    DALI_HOST_DEV constexpr uint32_t operator[](int i) const { return v[i]; }
+  };
+
+  /**
+   * @brief Generates 4 random 32-bit words for given key and counter
+   *
+   * @param key       the key, usually derived from the seed
+   * @param ctr_hi    upper 64 bits of the counter
+   * @param ctr_lo    lower 64 bits of the counter
+   */
+  DALI_HOST_DEV static inline Block Generate(uint64_t key, uint64_t ctr_hi, uint64_t ctr_lo) {
+    Block ctr = {{
+      static_cast<uint32_t>(ctr_lo), static_cast<uint32_t>(ctr_lo >> 32),
+      static_cast<uint32_t>(ctr_hi), static_cast<uint32_t>(ctr_hi >> 32)
+    }};
+    uint32_t k0 = static_cast<uint32_t>(key);
+    uint32_t k1 = static_cast<uint32_t>(key >> 32);
+    for (int r = 0; r < kRounds; r++) {
+      if (r) {
+        k0 += kWeyl0;
+        k1 += kWeyl1;
+      }
+      ctr = Round(ctr, k0, k1);
+    }
+    return ctr;
+  }
+
+  static constexpr int kRounds = 10;
+  static constexpr uint32_t kMul0 = 0xD2511F53u;
+  static constexpr uint32_t kMul1 = 0xCD9E8D57u;
+  static constexpr uint32_t kWeyl0 = 0x9E3779B9u;
+  static constexpr uint32_t kWeyl1 = 0xBB67AE85u;
+
+ private:
+  DALI_HOST_DEV static inline Block Round(const Block &ctr, uint32_t k0, uint32_t k1) {
+    uint64_t p0 = static_cast<uint64_t>(kMul0) * ctr.v[0];
+    uint64_t p1 = static_cast<uint64_t>(kMul1) * ctr.v[2];
+    uint32_t hi0 = static_cast<uint32_t>(p0 >> 32), lo0 = static_cast<uint32_t>(p0);
+    uint32_t hi1 = static_cast<uint32_t>(p1 >> 32), lo1 = static_cast<uint32_t>(p1);
+    return {{ hi1 ^ ctr.v[1] ^ k0, lo1, hi0 ^ ctr.v[3] ^ k1, lo0 }};
+  }
+};
+
+}  // namespace dali
+
+#endif  // DALI_CORE_PHILOX_H_